@@ -0,0 +1,24 @@
+#version 330 core
+in vec2 TexCord;
+
+out vec4 FragColor;
+
+uniform sampler2D gPosition;
+uniform sampler2D gAlbedoSpec;
+uniform sampler2D lightAccumulation;
+
+uniform vec3 ambientColor;
+uniform vec3 clearColor;
+
+void main()
+{
+	if (texture(gPosition, TexCord).w == 0.0)
+	{
+		FragColor = vec4(clearColor, 1.0);
+		return;
+	}
+
+	//Ambient
+	vec3 ambient = 0.1 * ambientColor * texture(gAlbedoSpec, TexCord).rgb;
+	FragColor = vec4(ambient + texture(lightAccumulation, TexCord).rgb, 1.0);
+}
@@ -0,0 +1,45 @@
+#version 330 core
+out vec4 FragColor;
+
+uniform sampler2D gPosition;
+uniform sampler2D gNormal;
+uniform sampler2D gAlbedoSpec;
+
+uniform vec2 screenSize;
+uniform vec3 viewPos;
+
+uniform vec4 lightPositionRadius;
+uniform vec4 lightColorIntensity;
+
+void main()
+{
+	vec2 uv = gl_FragCoord.xy / screenSize;
+	vec4 position = texture(gPosition, uv);
+	if (position.w == 0.0)
+		discard;
+
+	vec3 FragPos = position.xyz;
+	vec3 norm = texture(gNormal, uv).xyz;
+	vec4 albedoSpec = texture(gAlbedoSpec, uv);
+
+	vec3 toLight = lightPositionRadius.xyz - FragPos;
+	float dist = length(toLight);
+	float radius = lightPositionRadius.w;
+	if (dist >= radius)
+		discard;
+
+	float falloff = 1.0 - (dist * dist) / (radius * radius);
+	float attenuation = falloff * falloff;
+
+	//Diffuse
+	vec3 lightDir = toLight / dist;
+	float diff = max(dot(norm, lightDir), 0.0);
+
+	//Specular
+	vec3 viewDir = normalize(viewPos - FragPos);
+	vec3 reflectDir = reflect(-lightDir, norm);
+	float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
+
+	vec3 light = (diff + albedoSpec.a * spec) * lightColorIntensity.rgb * lightColorIntensity.a * attenuation;
+	FragColor = vec4(light * albedoSpec.rgb, 1.0);
+}
@@ -0,0 +1,27 @@
+#version 330 core
+layout (location = 0) out vec4 gPosition;
+layout (location = 1) out vec4 gNormal;
+layout (location = 2) out vec4 gAlbedoSpec;
+
+in vec3 Normal;
+in vec3 FragPos;
+in vec2 TexCord;
+flat in float TexLayer;
+flat in vec3 objectColor;
+flat in float specularStrength;
+
+
+//albedo iz TexturePackera, bez njega boja dolazi samo iz objectColor
+uniform sampler2DArray textureArray;
+uniform bool useTextureArray;
+
+void main()
+{
+	//w = 1 oznacava da je piksel prekriven geometrijom
+	gPosition = vec4(FragPos, 1.0);
+	gNormal = vec4(normalize(Normal), 0.0);
+	vec3 albedo = objectColor;
+	if (useTextureArray)
+		albedo *= texture(textureArray, vec3(TexCord, TexLayer)).rgb;
+	gAlbedoSpec = vec4(albedo, specularStrength);
+}
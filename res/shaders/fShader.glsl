@@ -1,22 +1,29 @@
 #version 330 core
 in vec3 Normal;
 in vec3 FragPos;
+in vec4 BakedLight;
+in vec2 TexCord;
+flat in float TexLayer;
+flat in vec3 objectColor;
+flat in float specularStrength;
 
 out vec4 FragColor;
 
 uniform vec3 viewPos;
-uniform vec3 objectColor;
 uniform vec3 lightColor;
-uniform float specularStrength;
 
 uniform vec3 lightPos;
 
+//albedo iz TexturePackera, bez njega boja dolazi samo iz objectColor
+uniform sampler2DArray textureArray;
+uniform bool useTextureArray;
+
 void main()
 {
    	float ambientStrength = 0.1;
 
 	//Ambient
-    vec3 ambient = ambientStrength * lightColor;
+    vec3 ambient = ambientStrength * lightColor * BakedLight.rgb;
 	
 
     //vec3 result = ambient * objectColor;
@@ -35,6 +42,9 @@ void main()
 	vec3 specular = specularStrength * spec * lightColor;
 
 	//Linearna kombinacija
-	vec3 result = (ambient + diffuse + specular) * objectColor;
+	vec3 albedo = objectColor;
+	if (useTextureArray)
+		albedo *= texture(textureArray, vec3(TexCord, TexLayer)).rgb;
+	vec3 result = (ambient + diffuse + specular) * albedo;
 	FragColor = vec4(result, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,92 @@
+#version 430 core
+in vec3 Normal;
+in vec3 FragPos;
+in vec4 BakedLight;
+in vec2 TexCord;
+flat in float TexLayer;
+flat in vec3 objectColor;
+flat in float specularStrength;
+
+out vec4 FragColor;
+
+struct PointLight
+{
+	vec4 positionRadius;
+	vec4 colorIntensity;
+};
+
+layout(std430, binding = 0) readonly buffer Lights { PointLight lights[]; };
+layout(std430, binding = 1) readonly buffer ClusterGrid { uvec2 clusters[]; };
+layout(std430, binding = 2) readonly buffer LightIndices { uint lightIndices[]; };
+
+uniform mat4 view;
+uniform int tilesX;
+uniform int tilesY;
+uniform int slices;
+uniform float zNear;
+uniform float zFar;
+uniform vec2 screenSize;
+uniform int lightCount;
+
+//bruteForce racuna sva svjetla za svaki fragment (usporedba s klasterima)
+uniform bool bruteForce;
+
+uniform vec3 viewPos;
+uniform vec3 ambientColor;
+
+//albedo iz TexturePackera, bez njega boja dolazi samo iz objectColor
+uniform sampler2DArray textureArray;
+uniform bool useTextureArray;
+
+vec3 ShadePointLight(PointLight light, vec3 norm, vec3 viewDir)
+{
+	vec3 toLight = light.positionRadius.xyz - FragPos;
+	float dist = length(toLight);
+	float radius = light.positionRadius.w;
+	if (dist >= radius)
+		return vec3(0.0);
+
+	float falloff = 1.0 - (dist * dist) / (radius * radius);
+	float attenuation = falloff * falloff;
+
+	//Diffuse
+	vec3 lightDir = toLight / dist;
+	float diff = max(dot(norm, lightDir), 0.0);
+
+	//Specular
+	vec3 reflectDir = reflect(-lightDir, norm);
+	float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
+
+	return (diff + specularStrength * spec) * light.colorIntensity.rgb * light.colorIntensity.a * attenuation;
+}
+
+void main()
+{
+	vec3 norm = normalize(Normal);
+	vec3 viewDir = normalize(viewPos - FragPos);
+
+	//Ambient
+	vec3 result = 0.1 * ambientColor * BakedLight.rgb;
+
+	if (bruteForce)
+	{
+		for (int i = 0; i < lightCount; i++)
+			result += ShadePointLight(lights[i], norm, viewDir);
+	}
+	else
+	{
+		float viewDepth = -(view * vec4(FragPos, 1.0)).z;
+		int x = clamp(int(gl_FragCoord.x / screenSize.x * tilesX), 0, tilesX - 1);
+		int y = clamp(int(gl_FragCoord.y / screenSize.y * tilesY), 0, tilesY - 1);
+		int z = clamp(int(log(max(viewDepth, zNear) / zNear) / log(zFar / zNear) * slices), 0, slices - 1);
+
+		uvec2 cluster = clusters[(z * tilesY + y) * tilesX + x];
+		for (uint i = 0; i < cluster.y; i++)
+			result += ShadePointLight(lights[lightIndices[cluster.x + i]], norm, viewDir);
+	}
+
+	vec3 albedo = objectColor;
+	if (useTextureArray)
+		albedo *= texture(textureArray, vec3(TexCord, TexLayer)).rgb;
+	FragColor = vec4(result * albedo, 1.0);
+}
@@ -0,0 +1,91 @@
+#version 330 core
+in vec3 Normal;
+in vec3 FragPos;
+in vec4 BakedLight;
+in vec2 TexCord;
+flat in float TexLayer;
+flat in vec3 objectColor;
+flat in float specularStrength;
+
+out vec4 FragColor;
+
+uniform vec3 viewPos;
+uniform vec3 lightColor;
+
+uniform vec3 lightPos;
+
+//albedo iz TexturePackera, bez njega boja dolazi samo iz objectColor
+uniform sampler2DArray textureArray;
+uniform bool useTextureArray;
+
+//usmjereno svjetlo s kaskadnim sjenama
+uniform vec3 sunDirection;
+uniform vec3 sunColor;
+uniform mat4 cameraView;
+
+uniform sampler2DArrayShadow shadowMap;
+uniform mat4 cascadeMatrices[4];
+uniform float cascadeSplits[4];
+uniform int cascadeCount;
+
+float SunShadow(vec3 norm)
+{
+	float viewDepth = -(cameraView * vec4(FragPos, 1.0)).z;
+
+	int cascade = cascadeCount;
+	for (int i = cascadeCount - 1; i >= 0; i--)
+	{
+		if (viewDepth < cascadeSplits[i])
+			cascade = i;
+	}
+	if (cascade == cascadeCount)
+		return 1.0;
+
+	//pomak duz normale smanjuje samosjenjenje na plohama pod kosim kutom
+	vec4 lightSpace = cascadeMatrices[cascade] * vec4(FragPos + norm * 0.02, 1.0);
+	vec3 coords = lightSpace.xyz / lightSpace.w * 0.5 + 0.5;
+	if (coords.z > 1.0)
+		return 1.0;
+
+	//PCF 3x3
+	vec2 texel = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+	float lit = 0.0;
+	for (int x = -1; x <= 1; x++)
+	{
+		for (int y = -1; y <= 1; y++)
+			lit += texture(shadowMap, vec4(coords.xy + vec2(x, y) * texel, float(cascade), coords.z));
+	}
+	return lit / 9.0;
+}
+
+void main()
+{
+   	float ambientStrength = 0.1;
+
+	//Ambient
+    vec3 ambient = ambientStrength * lightColor * BakedLight.rgb;
+
+	//Diffuse
+	vec3 norm = normalize(Normal);
+	vec3 lightDir = normalize(lightPos - FragPos);
+	float diff = max(dot(norm, lightDir), 0.0);
+	vec3 diffuse = diff * lightColor;
+
+	//Specular
+	vec3 viewDir = normalize(viewPos - FragPos);
+	vec3 reflectDir = reflect(-lightDir, norm);
+	float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
+	vec3 specular = specularStrength * spec * lightColor;
+
+	//Sunce
+	vec3 sunDir = normalize(-sunDirection);
+	float sunDiff = max(dot(norm, sunDir), 0.0);
+	vec3 sun = sunDiff * sunColor * SunShadow(norm);
+
+	//Linearna kombinacija
+	vec3 albedo = objectColor;
+	if (useTextureArray)
+		albedo *= texture(textureArray, vec3(TexCord, TexLayer)).rgb;
+	vec3 result = (ambient + diffuse + specular + sun) * albedo;
+	FragColor = vec4(result, 1.0);
+}
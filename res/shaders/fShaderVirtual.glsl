@@ -0,0 +1,70 @@
+#version 330 core
+in vec3 Normal;
+in vec3 FragPos;
+in vec4 BakedLight;
+in vec2 TexCord;
+flat in vec3 objectColor;
+flat in float specularStrength;
+
+out vec4 FragColor;
+
+uniform vec3 viewPos;
+uniform vec3 lightColor;
+
+uniform vec3 lightPos;
+
+//virtualna tekstura (VirtualTexture): fizicki cache stranica i indirekcija s mipom po nivou
+uniform sampler2D virtualCache;
+uniform sampler2D virtualIndirection;
+uniform vec2 virtualSize;
+uniform vec2 virtualScale;
+uniform float pageSize;
+uniform float pageBorder;
+uniform float cacheTexels;
+uniform int virtualLevels;
+
+vec3 SampleVirtual(vec2 texCord)
+{
+	vec2 uv = fract(texCord) * virtualScale;
+	vec2 dx = dFdx(uv * virtualSize);
+	vec2 dy = dFdy(uv * virtualSize);
+	int level = int(clamp(floor(0.5 * log2(max(dot(dx, dx), dot(dy, dy)))), 0.0, float(virtualLevels - 1)));
+	ivec2 pages = max(ivec2(1), ivec2(virtualSize / pageSize) >> level);
+	ivec2 page = clamp(ivec2(uv * max(vec2(1.0), virtualSize / exp2(float(level))) / pageSize), ivec2(0), pages - 1);
+
+	//slot i nivo stranice koja je stvarno u cacheu, trazena ili njen najblizi rezidentni predak
+	vec3 entry = floor(texelFetch(virtualIndirection, page, level).xyz * 255.0 + 0.5);
+	vec2 texel = uv * max(vec2(1.0), virtualSize / exp2(entry.z));
+	vec2 inPage = texel - floor(texel / pageSize) * pageSize;
+	vec2 physical = (entry.xy * (pageSize + 2.0 * pageBorder) + pageBorder + inPage) / cacheTexels;
+	return textureLod(virtualCache, physical, 0.0).rgb;
+}
+
+void main()
+{
+   	float ambientStrength = 0.1;
+
+	//Ambient
+    vec3 ambient = ambientStrength * lightColor * BakedLight.rgb;
+	
+
+    //vec3 result = ambient * objectColor;
+    //FragColor = vec4(result, 1.0);
+
+	//Diffuse
+	vec3 norm = normalize(Normal);
+	vec3 lightDir = normalize(lightPos - FragPos);
+	float diff = max(dot(norm, lightDir), 0.0);
+	vec3 diffuse = diff * lightColor;
+
+	//Specular
+	vec3 viewDir = normalize(viewPos - FragPos);
+	vec3 reflectDir = reflect(-lightDir, norm);
+	float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
+	vec3 specular = specularStrength * spec * lightColor;
+
+	//Linearna kombinacija
+	vec3 albedo = objectColor * SampleVirtual(TexCord);
+	vec3 result = (ambient + diffuse + specular) * albedo;
+	FragColor = vec4(result, 1.0);
+}
\ No newline at end of file
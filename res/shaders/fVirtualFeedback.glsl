@@ -0,0 +1,25 @@
+#version 330 core
+in vec2 TexCord;
+
+//stranica virtualne teksture koju bi ovaj piksel uzorkovao, kodirana kao VirtualPage::Encode
+layout (location = 0) out uint FeedbackPage;
+
+uniform vec2 virtualSize;
+uniform vec2 virtualScale;
+uniform float pageSize;
+uniform int virtualLevels;
+//feedback je manje rezolucije pa su derivacije vece, pomak vraca nivo koji bi imao puni ekran
+uniform float feedbackBias;
+
+void main()
+{
+	vec2 uv = fract(TexCord) * virtualScale;
+	vec2 dx = dFdx(uv * virtualSize);
+	vec2 dy = dFdy(uv * virtualSize);
+	int level = int(clamp(floor(0.5 * log2(max(dot(dx, dx), dot(dy, dy))) + feedbackBias), 0.0, float(virtualLevels - 1)));
+
+	vec2 levelSize = max(vec2(1.0), virtualSize / exp2(float(level)));
+	ivec2 pages = max(ivec2(1), ivec2(virtualSize / pageSize) >> level);
+	ivec2 page = clamp(ivec2(uv * levelSize / pageSize), ivec2(0), pages - 1);
+	FeedbackPage = (uint(level) << 24) | (uint(page.y) << 12) | uint(page.x);
+}
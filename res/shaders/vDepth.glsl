@@ -0,0 +1,12 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+
+//isti izraz kao u vShader.glsl, invariant jamci jednake dubine za GL_EQUAL u glavnom prolazu
+invariant gl_Position;
+
+uniform mat4 mvp;
+
+void main()
+{
+	gl_Position = mvp * vec4(aPos, 1.0);
+}
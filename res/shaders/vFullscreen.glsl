@@ -0,0 +1,10 @@
+#version 330 core
+out vec2 TexCord;
+
+//jedan trokut koji prekriva cijeli ekran, bez vertex buffera
+void main()
+{
+	vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+	TexCord = position;
+	gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,10 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+
+uniform mat4 viewProjection;
+uniform vec4 lightPositionRadius;
+
+void main()
+{
+	gl_Position = viewProjection * vec4(aPos * lightPositionRadius.w + lightPositionRadius.xyz, 1.0);
+}
@@ -1,23 +1,45 @@
-#version 330 core
+#version 420 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCord;
+//peceni ambient iz LightBakera: rgb irradijancija, a okluzija; bez pecenja (1, 1, 1, 1)
+layout (location = 3) in vec4 aBakedLight;
 
 out vec3 FragPos;  
 out vec3 Normal;
 out vec2 TexCord;
+out vec4 BakedLight;
+flat out float TexLayer;
+flat out vec3 objectColor;
+flat out float specularStrength;
+
+//mora odgovarati vDepth.glsl kako bi depth pre-pass i glavni prolaz dali iste dubine
+invariant gl_Position;
 
 uniform vec3 offset;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+//podaci jednog poziva crtanja (DrawData u Model.h), Renderer veze raspon ring buffera na Mesh::DRAW_DATA_BINDING
+layout (std140, binding = 0) uniform DrawBlock
+{
+	mat4 model;
+	mat4 mvp;
+	mat3 normalMatrix;
+	//xyz boja objekta, w spekularna jakost
+	vec4 colorSpecular;
+	//pravokutnik i sloj teksture u nizu iz TexturePackera (xy pomak, zw skala), bez pakiranja cijela tekstura
+	vec4 uvRect;
+	vec4 textureLayer;
+} draw;
 
 void main()
 { 
-	gl_Position = projection * view * model * vec4(aPos, 1.0);
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = aNormal;
-	TexCord = aTexCord;
+	gl_Position = draw.mvp * vec4(aPos, 1.0);
+    FragPos = vec3(draw.model * vec4(aPos, 1.0));
+    Normal = draw.normalMatrix * aNormal;
+	TexCord = draw.uvRect.xy + aTexCord * draw.uvRect.zw;
+	TexLayer = draw.textureLayer.x;
+	BakedLight = aBakedLight;
+	objectColor = draw.colorSpecular.rgb;
+	specularStrength = draw.colorSpecular.w;
 
 }
\ No newline at end of file
@@ -0,0 +1,302 @@
+#include "AssetCooker.h"
+
+#include "AssetPack.h"
+#include "FileSystem.h"
+#include "ImageDecoder.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+//mijenja se kad god neki kuhar promijeni izlaz, time se ponistavaju svi kljucevi u postojecim manifestima
+static const unsigned int COOKER_VERSION = 1;
+
+const char* AssetCooker::MANIFEST_NAME = "assetcook.manifest";
+
+static double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	return elapsed.count();
+}
+
+static std::uint64_t HashBytes(std::uint64_t hash, const std::uint8_t* data, std::size_t size)
+{
+	for (std::size_t i = 0; i < size; i++)
+	{
+		hash ^= data[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+static bool EndsWith(const std::string& path, const std::string& suffix)
+{
+	return path.size() > suffix.size() && path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static std::string TrimSeparator(std::string path)
+{
+	path = AssetPack::NormalizePath(path);
+	while (path.size() > 1 && path.back() == '/')
+		path.pop_back();
+	return path;
+}
+
+//prva linija je verzija formata, zatim "hash izvor" po liniji
+static void LoadManifest(const std::string& path, std::unordered_map<std::string, std::uint64_t>& manifest)
+{
+	std::ifstream file(path);
+	std::string line;
+	if (!std::getline(file, line) || line != "assetcook " + std::to_string(COOKER_VERSION))
+		return;
+
+	while (std::getline(file, line))
+	{
+		std::size_t separator = line.find(' ');
+		if (separator == std::string::npos)
+			continue;
+		std::uint64_t hash = 0;
+		std::istringstream(line.substr(0, separator)) >> std::hex >> hash;
+		manifest[line.substr(separator + 1)] = hash;
+	}
+}
+
+static bool SaveManifest(const std::string& path, const std::vector<AssetCookRecord>& records)
+{
+	//novi manifest zamjenjuje stari tek kad je cijeli zapisan
+	std::string temporary = path + ".tmp";
+	{
+		std::ofstream file(temporary);
+		if (!file)
+		{
+			std::cerr << "FILE COULD NOT OPEN: " << temporary << std::endl;
+			return false;
+		}
+		file << "assetcook " << COOKER_VERSION << "\n";
+		for (const AssetCookRecord& record : records)
+		{
+			if (record.failed)
+				continue;
+			char hash[17];
+			std::snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)record.hash);
+			file << hash << ' ' << record.source << "\n";
+		}
+		if (!file)
+			return false;
+	}
+
+	std::error_code error;
+	std::filesystem::rename(temporary, path, error);
+	if (error)
+	{
+		std::cerr << "MANIFEST COULD NOT BE WRITTEN: " << path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+AssetCooker::AssetCooker(JobSystem* jobs)
+	: m_Jobs(jobs)
+{
+}
+
+bool AssetCooker::Cook(const std::string& root, const std::string& outputDir, const AssetCookSettings& settings)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	m_Stats = AssetCookStats();
+	m_Stats.threads = m_Jobs ? m_Jobs->GetThreadCount() : 1;
+	m_Records.clear();
+
+	//kuhane kopije koje Texture drzi uz izvore i sve sto je vec u izlaznom direktoriju nisu izvori
+	std::string outputPrefix = TrimSeparator(outputDir) + "/";
+	std::error_code error;
+	for (const auto& item : std::filesystem::recursive_directory_iterator(root, error))
+	{
+		if (!item.is_regular_file())
+			continue;
+		std::string path = AssetPack::NormalizePath(item.path().generic_string());
+		if (path.compare(0, outputPrefix.size(), outputPrefix) == 0 || EndsWith(path, ".ctex") || MeshCooker::IsCookedPath(path))
+			continue;
+
+		AssetCookRecord record;
+		record.source = path;
+		record.output = GetOutputPath(root, outputDir, path);
+		record.kind = GetKind(path);
+		if (!record.output.empty())
+			m_Records.push_back(record);
+	}
+	if (error || m_Records.empty())
+	{
+		std::cerr << "NO ASSETS TO COOK IN: " << root << std::endl;
+		return false;
+	}
+	std::sort(m_Records.begin(), m_Records.end(), [](const AssetCookRecord& a, const AssetCookRecord& b) { return a.source < b.source; });
+
+	std::unordered_map<std::string, std::uint64_t> manifest;
+	std::string manifestPath = outputPrefix + MANIFEST_NAME;
+	if (!settings.force)
+		LoadManifest(manifestPath, manifest);
+
+	std::string settingsKeys[3];
+	for (int kind = 0; kind < 3; kind++)
+		settingsKeys[kind] = GetSettingsKey((AssetCookKind)kind, settings);
+
+	//svaki asset je jedan posao; TextureCooker unutar njega dijeli blokove na isti JobSystem
+	auto cookAssets = [&](std::uint32_t begin, std::uint32_t end)
+	{
+		for (std::uint32_t i = begin; i < end; i++)
+		{
+			AssetCookRecord& record = m_Records[i];
+			auto assetStart = std::chrono::high_resolution_clock::now();
+			FileData data;
+			if (!FileSystem::Read(record.source, data))
+			{
+				record.failed = true;
+				continue;
+			}
+			const std::string& key = settingsKeys[(int)record.kind];
+			record.inputBytes = data.GetSize();
+			record.hash = HashBytes(HashBytes(14695981039346656037ull, (const std::uint8_t*)key.data(), key.size() + 1), data.GetData(), data.GetSize());
+			record.hashMs = ElapsedMs(assetStart);
+
+			std::error_code outputError;
+			auto found = manifest.find(record.source);
+			if (found != manifest.end() && found->second == record.hash && std::filesystem::is_regular_file(record.output, outputError))
+			{
+				record.cached = true;
+				record.outputBytes = std::filesystem::file_size(record.output, outputError);
+				continue;
+			}
+
+			assetStart = std::chrono::high_resolution_clock::now();
+			CookAsset(record, data.GetData(), data.GetSize(), settings);
+			record.cookMs = ElapsedMs(assetStart);
+		}
+	};
+	if (m_Jobs)
+		m_Jobs->ParallelFor((std::uint32_t)m_Records.size(), 1, cookAssets);
+	else
+		cookAssets(0, (std::uint32_t)m_Records.size());
+
+	for (const AssetCookRecord& record : m_Records)
+	{
+		m_Stats.assets++;
+		if (record.failed)
+			m_Stats.failed++;
+		else if (record.cached)
+			m_Stats.cacheHits++;
+		else
+			m_Stats.cooked++;
+		m_Stats.inputBytes += record.inputBytes;
+		m_Stats.outputBytes += record.outputBytes;
+		m_Stats.hashMs += record.hashMs;
+		m_Stats.cookMs += record.cookMs;
+	}
+
+	bool saved = SaveManifest(manifestPath, m_Records);
+	m_Stats.totalMs = ElapsedMs(start);
+	return saved && m_Stats.failed == 0;
+}
+
+void AssetCooker::CookAsset(AssetCookRecord& record, const std::uint8_t* data, std::size_t size, const AssetCookSettings& settings)
+{
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(record.output).parent_path(), error);
+
+	bool cooked = false;
+	switch (record.kind)
+	{
+	case AssetCookKind::Mesh:
+	{
+		//parser .obj cita putanju preko FileSystema, izvor je vec u cacheu stranica od hashiranja
+		CookedMesh mesh;
+		cooked = MeshCooker::Cook(record.source, mesh, record.mesh, settings.mesh) && MeshCooker::Save(record.output, mesh);
+		break;
+	}
+	case AssetCookKind::Texture:
+	{
+		DecodedImage image;
+		CookedTexture texture;
+		TextureCooker cooker(m_Jobs);
+		cooked = ImageDecoder::DecodeMemory(data, size, record.source, image) &&
+			cooker.Cook(image.pixels.data(), image.width, image.height, settings.textureFormat, texture, image.srgb) &&
+			TextureCooker::Save(record.output, texture);
+		break;
+	}
+	case AssetCookKind::Copy:
+	{
+		std::ofstream file(record.output, std::ios::binary);
+		file.write((const char*)data, size);
+		cooked = (bool)file;
+		if (!cooked)
+			std::cerr << "FILE COULD NOT BE WRITTEN: " << record.output << std::endl;
+		break;
+	}
+	}
+
+	record.failed = !cooked;
+	if (cooked)
+		record.outputBytes = std::filesystem::file_size(record.output, error);
+	else
+		std::cerr << "ASSET COULD NOT BE COOKED: " << record.source << std::endl;
+}
+
+std::string AssetCooker::GetSettingsKey(AssetCookKind kind, const AssetCookSettings& settings)
+{
+	std::string key = "assetcook " + std::to_string(COOKER_VERSION) + " " + GetKindName(kind);
+	if (kind == AssetCookKind::Mesh)
+		key += " cache " + std::to_string(settings.mesh.cacheSize) + " weld " + std::to_string(settings.mesh.normalWeldAngle);
+	else if (kind == AssetCookKind::Texture)
+		key += std::string(" format ") + TextureCooker::GetFormatName(settings.textureFormat);
+	return key;
+}
+
+std::string AssetCooker::GetOutputPath(const std::string& root, const std::string& outputDir, const std::string& source)
+{
+	std::string rootPrefix = TrimSeparator(root) + "/";
+	std::string path = AssetPack::NormalizePath(source);
+	if (path.size() <= rootPrefix.size() || path.compare(0, rootPrefix.size(), rootPrefix) != 0)
+		return std::string();
+
+	std::string output = TrimSeparator(outputDir) + "/" + path.substr(rootPrefix.size());
+	AssetCookKind kind = GetKind(path);
+	if (kind == AssetCookKind::Mesh)
+		output += ".cmesh";
+	else if (kind == AssetCookKind::Texture)
+		output += ".ctex";
+	return output;
+}
+
+std::string AssetCooker::Resolve(const std::string& root, const std::string& outputDir, const std::string& source)
+{
+	std::string output = GetOutputPath(root, outputDir, source);
+	return !output.empty() && FileSystem::Exists(output) ? output : source;
+}
+
+AssetCookKind AssetCooker::GetKind(const std::string& path)
+{
+	std::string extension = std::filesystem::path(path).extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+	if (extension == ".obj")
+		return AssetCookKind::Mesh;
+	if (extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" || extension == ".bmp")
+		return AssetCookKind::Texture;
+	return AssetCookKind::Copy;
+}
+
+const char* AssetCooker::GetKindName(AssetCookKind kind)
+{
+	switch (kind)
+	{
+	case AssetCookKind::Mesh: return "mesh";
+	case AssetCookKind::Texture: return "texture";
+	default: return "copy";
+	}
+}
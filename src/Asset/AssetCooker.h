@@ -0,0 +1,95 @@
+#pragma once
+
+#include "TextureCooker.h"
+#include "MeshCooker.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class JobSystem;
+
+enum class AssetCookKind
+{
+	//.obj -> .cmesh (MeshCooker)
+	Mesh,
+	//slike -> .ctex (TextureCooker)
+	Texture,
+	//shaderi i ostalo se kopira bez promjene
+	Copy
+};
+
+struct AssetCookSettings
+{
+	TextureFormat textureFormat = TextureFormat::BC7;
+	MeshCookSettings mesh;
+	//zanemaruje manifest i kuha sve ispocetka
+	bool force = false;
+};
+
+struct AssetCookRecord
+{
+	//putanje oblika "res/models/dragon.obj" i "cooked/models/dragon.obj.cmesh"
+	std::string source;
+	std::string output;
+	AssetCookKind kind = AssetCookKind::Copy;
+	std::uint64_t hash = 0;
+	bool cached = false;
+	bool failed = false;
+	std::uint64_t inputBytes = 0;
+	std::uint64_t outputBytes = 0;
+	//samo za Mesh koji je upravo kuhan
+	MeshCookStats mesh;
+	//citanje i hash izvora, pa kuhanje i pisanje izlaza
+	double hashMs = 0.0;
+	double cookMs = 0.0;
+};
+
+struct AssetCookStats
+{
+	unsigned int assets = 0;
+	unsigned int cooked = 0;
+	unsigned int cacheHits = 0;
+	unsigned int failed = 0;
+	unsigned int threads = 0;
+	std::uint64_t inputBytes = 0;
+	std::uint64_t outputBytes = 0;
+	//zbroj po assetima sa svih dretvi
+	double hashMs = 0.0;
+	double cookMs = 0.0;
+	double totalMs = 0.0;
+};
+
+//offline kuhanje cijelog direktorija (res/) u izlazni (cooked/) uz istu strukturu poddirektorija, asseti se kuhaju paralelno
+//kljuc svakog izlaza je FNV-1a 64 nad verzijom kuhara, postavkama te vrste asseta i bajtovima izvora; manifest u izlaznom
+//direktoriju pamti kljuceve pa ponovno pokretanje kuha samo izvore ili postavke koji su se promijenili (ne ovisi o vremenima datoteka)
+class AssetCooker
+{
+public:
+	AssetCooker(JobSystem* jobs = nullptr);
+
+	//false ako nema izvora ili barem jedan nije uspio, manifest tada sadrzi samo uspjele
+	bool Cook(const std::string& root, const std::string& outputDir, const AssetCookSettings& settings = AssetCookSettings());
+
+	inline const AssetCookStats& GetStats() const { return m_Stats; }
+	inline const std::vector<AssetCookRecord>& GetRecords() const { return m_Records; }
+
+	//outputDir + putanja izvora ispod root + .cmesh ili .ctex; prazno ako izvor nije ispod root
+	static std::string GetOutputPath(const std::string& root, const std::string& outputDir, const std::string& source);
+	//kuhana verzija izvora ako postoji, inace sam izvor
+	static std::string Resolve(const std::string& root, const std::string& outputDir, const std::string& source);
+	static AssetCookKind GetKind(const std::string& path);
+	static const char* GetKindName(AssetCookKind kind);
+
+	static const char* MANIFEST_NAME;
+
+private:
+	void CookAsset(AssetCookRecord& record, const std::uint8_t* data, std::size_t size, const AssetCookSettings& settings);
+	static std::string GetSettingsKey(AssetCookKind kind, const AssetCookSettings& settings);
+
+private:
+	JobSystem* m_Jobs;
+	AssetCookStats m_Stats;
+	std::vector<AssetCookRecord> m_Records;
+};
@@ -0,0 +1,315 @@
+#include "AssetPack.h"
+#include "Compression.h"
+
+#include "JobSystem.h"
+#include "TextureCooker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+static const std::uint32_t PACK_MAGIC = 0x4B415041; //"APAK"
+static const std::uint32_t PACK_VERSION = 1;
+
+struct AssetPackHeader
+{
+	std::uint32_t magic;
+	std::uint32_t version;
+	std::uint32_t entryCount;
+	std::uint32_t reserved;
+	std::uint64_t tocOffset;
+	std::uint64_t namesOffset;
+	std::uint64_t namesSize;
+};
+
+static_assert(sizeof(AssetPackHeader) == 40, "AssetPackHeader layout");
+static_assert(sizeof(AssetPackEntry) == 48, "AssetPackEntry layout");
+
+static double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	return elapsed.count();
+}
+
+static bool ReadLooseFile(const std::string& path, std::vector<std::uint8_t>& out)
+{
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file)
+		return false;
+	out.resize((std::size_t)file.tellg());
+	file.seekg(0);
+	return (bool)file.read((char*)out.data(), out.size());
+}
+
+static void WritePadding(std::ofstream& file, std::uint64_t& position, unsigned int alignment)
+{
+	static const char zeros[256] = {};
+	std::uint64_t aligned = (position + alignment - 1) / alignment * alignment;
+	while (position < aligned)
+	{
+		std::size_t count = (std::size_t)std::min<std::uint64_t>(aligned - position, sizeof(zeros));
+		file.write(zeros, count);
+		position += count;
+	}
+}
+
+AssetPack::AssetPack()
+	: m_Entries(nullptr), m_EntryCount(0), m_Names(nullptr), m_NamesSize(0)
+{
+}
+
+bool AssetPack::Open(const std::string& path)
+{
+	m_Entries = nullptr;
+	m_EntryCount = 0;
+	m_Names = nullptr;
+	m_NamesSize = 0;
+	if (!m_File.Open(path))
+		return false;
+
+	AssetPackHeader header;
+	const std::uint8_t* data = m_File.GetData();
+	std::size_t size = m_File.GetSize();
+	if (size < sizeof(header))
+	{
+		std::cerr << "NOT AN ASSET PACK: " << path << std::endl;
+		m_File.Close();
+		return false;
+	}
+	std::memcpy(&header, data, sizeof(header));
+
+	bool valid = header.magic == PACK_MAGIC && header.version == PACK_VERSION && header.tocOffset % alignof(AssetPackEntry) == 0 &&
+		header.tocOffset <= size && (size - header.tocOffset) / sizeof(AssetPackEntry) >= header.entryCount &&
+		header.namesOffset <= size && size - header.namesOffset >= header.namesSize;
+	if (valid)
+	{
+		const AssetPackEntry* entries = (const AssetPackEntry*)(data + header.tocOffset);
+		for (std::uint32_t i = 0; i < header.entryCount && valid; i++)
+		{
+			const AssetPackEntry& entry = entries[i];
+			//nekomprimirani unos se cita izravno iz mape, Read i FileSystem pritom vjeruju rawSize
+			valid = entry.offset <= size && size - entry.offset >= entry.size && (std::uint64_t)entry.nameOffset + entry.nameLength <= header.namesSize &&
+				((entry.flags & AssetPackEntry::COMPRESSED) || entry.rawSize == entry.size) && (i == 0 || entries[i - 1].hash <= entry.hash);
+		}
+	}
+	if (!valid)
+	{
+		std::cerr << "NOT AN ASSET PACK: " << path << std::endl;
+		m_File.Close();
+		return false;
+	}
+
+	m_Entries = (const AssetPackEntry*)(data + header.tocOffset);
+	m_EntryCount = header.entryCount;
+	m_Names = (const char*)(data + header.namesOffset);
+	m_NamesSize = (std::size_t)header.namesSize;
+	return true;
+}
+
+bool AssetPack::IsName(const AssetPackEntry& entry, const std::string& path) const
+{
+	return entry.nameLength == path.size() && std::memcmp(m_Names + entry.nameOffset, path.data(), path.size()) == 0;
+}
+
+const AssetPackEntry* AssetPack::Find(const std::string& path) const
+{
+	if (!m_Entries)
+		return nullptr;
+
+	std::string normalized = NormalizePath(path);
+	std::uint64_t hash = HashPath(normalized);
+	const AssetPackEntry* end = m_Entries + m_EntryCount;
+	const AssetPackEntry* it = std::lower_bound(m_Entries, end, hash, [](const AssetPackEntry& entry, std::uint64_t value) { return entry.hash < value; });
+	for (; it != end && it->hash == hash; ++it)
+	{
+		if (IsName(*it, normalized))
+			return it;
+	}
+	return nullptr;
+}
+
+bool AssetPack::Read(const AssetPackEntry& entry, std::vector<std::uint8_t>& out) const
+{
+	out.resize((std::size_t)entry.rawSize);
+	if (!(entry.flags & AssetPackEntry::COMPRESSED))
+	{
+		std::memcpy(out.data(), GetData(entry), out.size());
+		return true;
+	}
+
+	if (!Compression::Decompress(GetData(entry), (std::size_t)entry.size, out.data(), out.size()))
+	{
+		std::cerr << "ASSET PACK ENTRY CORRUPTED: " << GetName(entry) << std::endl;
+		out.clear();
+		return false;
+	}
+	return true;
+}
+
+std::string AssetPack::GetName(const AssetPackEntry& entry) const
+{
+	return std::string(m_Names + entry.nameOffset, entry.nameLength);
+}
+
+std::string AssetPack::NormalizePath(const std::string& path)
+{
+	std::string normalized = path;
+	std::replace(normalized.begin(), normalized.end(), '\\', '/');
+	while (normalized.compare(0, 2, "./") == 0)
+		normalized.erase(0, 2);
+	return normalized;
+}
+
+std::uint64_t AssetPack::HashPath(const std::string& path)
+{
+	std::uint64_t hash = 14695981039346656037ull;
+	for (char c : path)
+	{
+		hash ^= (std::uint8_t)c;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+bool AssetPack::Build(const std::string& root, const std::string& output, const AssetPackBuildOptions& options,
+	AssetPackBuildStats& stats, JobSystem* jobs)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	stats = AssetPackBuildStats();
+
+	std::error_code error, ignored;
+	std::vector<std::string> paths;
+	for (const auto& item : std::filesystem::recursive_directory_iterator(root, error))
+	{
+		if (!item.is_regular_file() || std::filesystem::equivalent(item.path(), output, ignored))
+			continue;
+
+		std::string path = NormalizePath(item.path().generic_string());
+		const std::string cookedExtension = ".ctex";
+		if (path.size() > cookedExtension.size() && path.compare(path.size() - cookedExtension.size(), cookedExtension.size(), cookedExtension) == 0)
+		{
+			std::string source = path.substr(0, path.size() - cookedExtension.size());
+			if (std::filesystem::exists(source, ignored) && !TextureCooker::IsCookedUpToDate(source))
+				continue;
+		}
+		paths.push_back(path);
+	}
+	if (error || paths.empty())
+	{
+		std::cerr << "NO ASSETS TO PACK IN: " << root << std::endl;
+		return false;
+	}
+	std::sort(paths.begin(), paths.end());
+
+	//citanje i kompresija po datoteci na radnim dretvama, pisanje ide redom
+	struct PendingEntry
+	{
+		std::vector<std::uint8_t> raw;
+		std::vector<std::uint8_t> compressed;
+		bool loaded = false;
+	};
+	std::vector<PendingEntry> pending(paths.size());
+	auto compressStart = std::chrono::high_resolution_clock::now();
+	auto loadEntries = [&](std::uint32_t begin, std::uint32_t end)
+	{
+		for (std::uint32_t i = begin; i < end; i++)
+		{
+			PendingEntry& entry = pending[i];
+			entry.loaded = ReadLooseFile(paths[i], entry.raw);
+			if (!entry.loaded || !options.compress || entry.raw.empty())
+				continue;
+
+			std::size_t size = Compression::Compress(entry.raw.data(), entry.raw.size(), entry.compressed);
+			if ((double)size > entry.raw.size() * (1.0 - options.minSavings))
+				entry.compressed.clear();
+		}
+	};
+	if (jobs)
+		jobs->ParallelFor((std::uint32_t)paths.size(), 1, loadEntries);
+	else
+		loadEntries(0, (std::uint32_t)paths.size());
+	stats.compressMs = ElapsedMs(compressStart);
+
+	std::ofstream file(output, std::ios::binary);
+	if (!file)
+	{
+		std::cerr << "FILE COULD NOT OPEN: " << output << std::endl;
+		return false;
+	}
+
+	unsigned int alignment = std::max(8u, options.alignment);
+	AssetPackHeader header = {};
+	file.write((const char*)&header, sizeof(header));
+	std::uint64_t position = sizeof(header);
+
+	std::vector<AssetPackEntry> entries;
+	std::string names;
+	for (std::size_t i = 0; i < paths.size(); i++)
+	{
+		const PendingEntry& source = pending[i];
+		if (!source.loaded)
+		{
+			std::cerr << "FILE COULD NOT OPEN: " << paths[i] << std::endl;
+			return false;
+		}
+
+		WritePadding(file, position, alignment);
+		bool compressed = !source.compressed.empty();
+		const std::vector<std::uint8_t>& blob = compressed ? source.compressed : source.raw;
+		file.write((const char*)blob.data(), blob.size());
+
+		AssetPackEntry entry = {};
+		entry.hash = HashPath(paths[i]);
+		entry.offset = position;
+		entry.size = blob.size();
+		entry.rawSize = source.raw.size();
+		entry.nameOffset = (std::uint32_t)names.size();
+		entry.nameLength = (std::uint32_t)paths[i].size();
+		entry.flags = compressed ? AssetPackEntry::COMPRESSED : 0;
+		entries.push_back(entry);
+		names += paths[i];
+		position += blob.size();
+
+		stats.files++;
+		stats.compressedFiles += compressed ? 1 : 0;
+		stats.rawBytes += source.raw.size();
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const AssetPackEntry& a, const AssetPackEntry& b) { return a.hash < b.hash; });
+	for (std::size_t i = 1; i < entries.size(); i++)
+	{
+		if (entries[i - 1].hash == entries[i].hash)
+		{
+			std::cerr << "ASSET PACK PATH HASH COLLISION: " << names.substr(entries[i].nameOffset, entries[i].nameLength) << std::endl;
+			return false;
+		}
+	}
+
+	WritePadding(file, position, alignment);
+	header.magic = PACK_MAGIC;
+	header.version = PACK_VERSION;
+	header.entryCount = (std::uint32_t)entries.size();
+	header.tocOffset = position;
+	file.write((const char*)entries.data(), entries.size() * sizeof(AssetPackEntry));
+	position += entries.size() * sizeof(AssetPackEntry);
+
+	header.namesOffset = position;
+	header.namesSize = names.size();
+	file.write(names.data(), names.size());
+	position += names.size();
+
+	file.seekp(0);
+	file.write((const char*)&header, sizeof(header));
+	if (!file)
+	{
+		std::cerr << "ASSET PACK COULD NOT BE WRITTEN: " << output << std::endl;
+		return false;
+	}
+
+	stats.packBytes = position;
+	stats.totalMs = ElapsedMs(start);
+	return true;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class JobSystem;
+
+//zapis u tablici sadrzaja, tablica je sortirana po hashu putanje
+struct AssetPackEntry
+{
+	static const std::uint32_t COMPRESSED = 1;
+
+	std::uint64_t hash;
+	std::uint64_t offset;
+	//bajtova u packu, nakon kompresije
+	std::uint64_t size;
+	std::uint64_t rawSize;
+	std::uint32_t nameOffset;
+	std::uint32_t nameLength;
+	std::uint32_t flags;
+	std::uint32_t reserved;
+};
+
+struct AssetPackBuildOptions
+{
+	bool compress = true;
+	//poravnanje pocetka svakog unosa u datoteci
+	unsigned int alignment = 64;
+	//unos ostaje komprimiran samo ako usteda barem ovaj dio velicine, PNG i JPEG zato ostaju kakvi jesu
+	float minSavings = 0.125f;
+};
+
+struct AssetPackBuildStats
+{
+	unsigned int files = 0;
+	unsigned int compressedFiles = 0;
+	std::uint64_t rawBytes = 0;
+	std::uint64_t packBytes = 0;
+	double compressMs = 0.0;
+	double totalMs = 0.0;
+};
+
+//jedna datoteka s hashiranom tablicom sadrzaja, poravnatim unosima i opcionalnom kompresijom po unosu (Compression)
+//pack se mapira jednom pa nekomprimirani unosi nemaju ni otvaranje datoteke ni kopiju, a komprimirani samo raspakiravanje
+//zaglavlje (magic, verzija, broj unosa, pomaci tablice i imena), unosi, tablica sadrzaja, imena bez nul znakova
+class AssetPack
+{
+public:
+	AssetPack();
+
+	AssetPack(const AssetPack&) = delete;
+	AssetPack& operator=(const AssetPack&) = delete;
+
+	bool Open(const std::string& path);
+
+	//nullptr ako putanje nema u packu
+	const AssetPackEntry* Find(const std::string& path) const;
+	//pokazivac u mapiranu datoteku, za komprimirane unose to su komprimirani bajtovi
+	inline const std::uint8_t* GetData(const AssetPackEntry& entry) const { return m_File.GetData() + entry.offset; }
+	//raspakirani sadrzaj unosa u out
+	bool Read(const AssetPackEntry& entry, std::vector<std::uint8_t>& out) const;
+
+	std::string GetName(const AssetPackEntry& entry) const;
+	inline std::uint32_t GetEntryCount() const { return m_EntryCount; }
+	inline const AssetPackEntry& GetEntry(std::uint32_t index) const { return m_Entries[index]; }
+	inline const std::string& GetPath() const { return m_File.GetPath(); }
+	inline std::size_t GetSize() const { return m_File.GetSize(); }
+
+	//kose crte umjesto obrnutih i bez vodeceg "./", u tom obliku se putanje spremaju i traze
+	static std::string NormalizePath(const std::string& path);
+	//FNV-1a 64 normalizirane putanje
+	static std::uint64_t HashPath(const std::string& path);
+
+	//pakira sve datoteke ispod root (putanje ostaju oblika "res/shaders/vShader.glsl"); zastarjele .ctex datoteke se preskacu
+	static bool Build(const std::string& root, const std::string& output, const AssetPackBuildOptions& options,
+		AssetPackBuildStats& stats, JobSystem* jobs = nullptr);
+
+private:
+	bool IsName(const AssetPackEntry& entry, const std::string& path) const;
+
+private:
+	MappedFile m_File;
+	const AssetPackEntry* m_Entries;
+	std::uint32_t m_EntryCount;
+	const char* m_Names;
+	std::size_t m_NamesSize;
+};
@@ -0,0 +1,558 @@
+#include "AsyncIO.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+static double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	return elapsed.count();
+}
+
+//datoteke se otvaraju za citanje s pomakom (pread, na Windowsima ReadFile s OVERLAPPED pomakom) pa jedan deskriptor dijele sve dretve
+#ifdef _WIN32
+
+static std::intptr_t OpenForRead(const std::string& path, std::uint64_t& size)
+{
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	LARGE_INTEGER fileSize;
+	if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize))
+	{
+		if (file != INVALID_HANDLE_VALUE)
+			CloseHandle(file);
+		return -1;
+	}
+	size = (std::uint64_t)fileSize.QuadPart;
+	return (std::intptr_t)file;
+}
+
+static void CloseFile(std::intptr_t file)
+{
+	CloseHandle((HANDLE)file);
+}
+
+static long long ReadAt(std::intptr_t file, std::uint8_t* target, std::uint32_t size, std::uint64_t offset)
+{
+	OVERLAPPED overlapped = {};
+	overlapped.Offset = (DWORD)(offset & 0xFFFFFFFF);
+	overlapped.OffsetHigh = (DWORD)(offset >> 32);
+	DWORD read = 0;
+	if (!ReadFile((HANDLE)file, target, size, &read, &overlapped))
+		return GetLastError() == ERROR_HANDLE_EOF ? 0 : -1;
+	return read;
+}
+
+#else
+
+static std::intptr_t OpenForRead(const std::string& path, std::uint64_t& size)
+{
+	int file = open(path.c_str(), O_RDONLY);
+	struct stat status;
+	if (file < 0 || fstat(file, &status) != 0)
+	{
+		if (file >= 0)
+			close(file);
+		return -1;
+	}
+	size = (std::uint64_t)status.st_size;
+	return file;
+}
+
+static void CloseFile(std::intptr_t file)
+{
+	close((int)file);
+}
+
+static long long ReadAt(std::intptr_t file, std::uint8_t* target, std::uint32_t size, std::uint64_t offset)
+{
+	ssize_t result;
+	do
+	{
+		result = pread((int)file, target, size, (off_t)offset);
+	} while (result < 0 && errno == EINTR);
+	return result < 0 ? -errno : result;
+}
+
+#endif
+
+#ifdef __linux__
+
+//prstenovi io_uringa mapirani iz jezgre i registrirani bufferi; bez liburinga, samo sistemski pozivi
+struct AsyncIO::IoUring
+{
+	int fd = -1;
+	void* sqRing = nullptr;
+	std::size_t sqRingSize = 0;
+	void* cqRing = nullptr;
+	std::size_t cqRingSize = 0;
+	io_uring_sqe* sqes = nullptr;
+	std::size_t sqesSize = 0;
+
+	unsigned int* sqHead = nullptr;
+	unsigned int* sqTail = nullptr;
+	unsigned int* sqArray = nullptr;
+	unsigned int sqMask = 0;
+	unsigned int sqEntries = 0;
+	unsigned int* cqHead = nullptr;
+	unsigned int* cqTail = nullptr;
+	io_uring_cqe* cqes = nullptr;
+	unsigned int cqMask = 0;
+
+	//jedan blok po mjestu u redu, user_data citanja je indeks buffera
+	std::vector<std::uint8_t> memory;
+	std::size_t bufferSize = 0;
+	bool registered = false;
+
+	bool Setup(unsigned int depth, std::size_t blockSize)
+	{
+		io_uring_params params;
+		std::memset(&params, 0, sizeof(params));
+		fd = (int)syscall(__NR_io_uring_setup, depth, &params);
+		if (fd < 0)
+			return false;
+
+		sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+		cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+		if (singleMap)
+			sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+
+		sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+		if (sqRing == MAP_FAILED)
+		{
+			sqRing = nullptr;
+			return false;
+		}
+		if (singleMap)
+		{
+			cqRing = sqRing;
+		}
+		else
+		{
+			cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+			if (cqRing == MAP_FAILED)
+			{
+				cqRing = nullptr;
+				return false;
+			}
+		}
+		sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+		void* sqeMemory = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+		if (sqeMemory == MAP_FAILED)
+			return false;
+		sqes = (io_uring_sqe*)sqeMemory;
+
+		std::uint8_t* sq = (std::uint8_t*)sqRing;
+		sqHead = (unsigned int*)(sq + params.sq_off.head);
+		sqTail = (unsigned int*)(sq + params.sq_off.tail);
+		sqArray = (unsigned int*)(sq + params.sq_off.array);
+		sqMask = *(unsigned int*)(sq + params.sq_off.ring_mask);
+		sqEntries = params.sq_entries;
+		std::uint8_t* cq = (std::uint8_t*)cqRing;
+		cqHead = (unsigned int*)(cq + params.cq_off.head);
+		cqTail = (unsigned int*)(cq + params.cq_off.tail);
+		cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+		cqMask = *(unsigned int*)(cq + params.cq_off.ring_mask);
+
+		//registracija zakljucava stranice; ako je RLIMIT_MEMLOCK premalen citanja idu kao obican IORING_OP_READ u iste buffere
+		bufferSize = blockSize;
+		memory.resize(bufferSize * depth);
+		std::vector<iovec> buffers(depth);
+		for (unsigned int i = 0; i < depth; i++)
+		{
+			buffers[i].iov_base = memory.data() + i * bufferSize;
+			buffers[i].iov_len = bufferSize;
+		}
+		registered = syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, buffers.data(), depth) == 0;
+		return true;
+	}
+
+	~IoUring()
+	{
+		if (sqes)
+			munmap(sqes, sqesSize);
+		if (cqRing && cqRing != sqRing)
+			munmap(cqRing, cqRingSize);
+		if (sqRing)
+			munmap(sqRing, sqRingSize);
+		if (fd >= 0)
+			close(fd);
+	}
+};
+
+bool AsyncIO::IsIoUringSupported()
+{
+	static const bool supported = []()
+	{
+		io_uring_params params;
+		std::memset(&params, 0, sizeof(params));
+		int fd = (int)syscall(__NR_io_uring_setup, 2, &params);
+		if (fd < 0)
+			return false;
+		close(fd);
+		return true;
+	}();
+	return supported;
+}
+
+#else
+
+struct AsyncIO::IoUring
+{
+};
+
+bool AsyncIO::IsIoUringSupported()
+{
+	return false;
+}
+
+#endif
+
+const char* AsyncIO::GetBackendName(AsyncIOBackend backend)
+{
+	switch (backend)
+	{
+	case AsyncIOBackend::IoUring: return "io_uring";
+	case AsyncIOBackend::ThreadPool: return "pread pool";
+	default: return "auto";
+	}
+}
+
+AsyncIO::AsyncIO(const AsyncIOSettings& settings)
+	: m_Settings(settings), m_Backend(AsyncIOBackend::ThreadPool), m_Stop(false)
+{
+	m_Settings.queueDepth = std::min(std::max(1u, m_Settings.queueDepth), 64u);
+	m_Settings.blockSize = std::max<std::size_t>(4096, m_Settings.blockSize);
+
+#ifdef __linux__
+	if (m_Settings.backend != AsyncIOBackend::ThreadPool && IsIoUringSupported())
+	{
+		m_Ring = std::make_unique<IoUring>();
+		if (m_Ring->Setup(m_Settings.queueDepth, m_Settings.blockSize))
+			m_Backend = AsyncIOBackend::IoUring;
+		else
+			m_Ring.reset();
+	}
+#endif
+	if (m_Settings.backend == AsyncIOBackend::IoUring && m_Backend != AsyncIOBackend::IoUring)
+		std::cerr << "IO_URING NOT AVAILABLE, USING PREAD THREAD POOL" << std::endl;
+
+	if (m_Backend == AsyncIOBackend::ThreadPool)
+		StartThreadPool();
+}
+
+void AsyncIO::StartThreadPool()
+{
+	for (unsigned int i = 0; i < m_Settings.queueDepth; i++)
+		m_Workers.emplace_back(&AsyncIO::WorkerLoop, this);
+}
+
+AsyncIO::~AsyncIO()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stop = true;
+	}
+	m_WorkReady.notify_all();
+	for (std::thread& worker : m_Workers)
+		worker.join();
+}
+
+bool AsyncIO::Read(const std::vector<AsyncReadRequest>& requests, const CompletionFunction& onComplete)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	m_Stats = AsyncIOStats();
+	m_Stats.requests = (unsigned int)requests.size();
+	m_Pending.clear();
+	m_Pending.resize(requests.size());
+	m_Requests.clear();
+	for (const AsyncReadRequest& request : requests)
+		m_Requests.push_back(&request);
+
+	std::deque<Block> blocks;
+	std::vector<std::size_t> empty;
+	for (std::size_t i = 0; i < requests.size(); i++)
+	{
+		const AsyncReadRequest& request = requests[i];
+		PendingRequest& pending = m_Pending[i];
+		std::uint64_t fileSize = 0;
+		pending.file = OpenForRead(request.path, fileSize);
+		if (pending.file < 0 || request.offset > fileSize || (request.size != AsyncReadRequest::WHOLE_FILE && request.size > fileSize - request.offset))
+		{
+			std::cerr << "ASYNC READ COULD NOT OPEN: " << request.path << std::endl;
+			pending.failed = true;
+			continue;
+		}
+
+		std::uint64_t size = request.size == AsyncReadRequest::WHOLE_FILE ? fileSize - request.offset : request.size;
+		pending.data.resize((std::size_t)size);
+		pending.remaining = size;
+		if (size == 0)
+			empty.push_back(i);
+		for (std::uint64_t offset = 0; offset < size; offset += m_Settings.blockSize)
+		{
+			std::uint32_t blockSize = (std::uint32_t)std::min<std::uint64_t>(m_Settings.blockSize, size - offset);
+			blocks.push_back({ (std::uint32_t)i, pending.file, request.offset + offset, pending.data.data() + offset, blockSize });
+		}
+	}
+	for (std::size_t i : empty)
+		onComplete(i, m_Pending[i].data);
+
+#ifdef __linux__
+	if (m_Backend == AsyncIOBackend::IoUring)
+		ReadIoUring(blocks, onComplete);
+	else
+#endif
+		ReadThreadPool(blocks, onComplete);
+
+	for (PendingRequest& pending : m_Pending)
+	{
+		if (pending.file >= 0)
+			CloseFile(pending.file);
+		m_Stats.failed += pending.failed ? 1 : 0;
+	}
+	m_Pending.clear();
+	m_Requests.clear();
+	m_Stats.wallMs = ElapsedMs(start);
+	return m_Stats.failed == 0;
+}
+
+bool AsyncIO::FinishBlock(const Block& block, long long result, std::deque<Block>& blocks)
+{
+	PendingRequest& pending = m_Pending[block.request];
+	m_Stats.blockReads++;
+	if (pending.failed)
+		return false;
+
+	//0 prije kraja znaci da je datoteka skracena u meduvremenu
+	if (result <= 0)
+	{
+		std::cerr << "ASYNC READ FAILED: " << m_Requests[block.request]->path << std::endl;
+		pending.failed = true;
+		return false;
+	}
+
+	m_Stats.bytes += (std::uint64_t)result;
+	pending.remaining -= (std::uint64_t)result;
+	if ((std::uint32_t)result < block.size)
+		blocks.push_front({ block.request, block.file, block.fileOffset + result, block.target + result, block.size - (std::uint32_t)result });
+	return pending.remaining == 0;
+}
+
+#ifdef __linux__
+
+bool AsyncIO::ReadIoUring(std::deque<Block>& blocks, const CompletionFunction& onComplete)
+{
+	IoUring& ring = *m_Ring;
+	std::vector<Block> inFlight(m_Settings.queueDepth);
+	std::vector<bool> busy(m_Settings.queueDepth, false);
+	std::vector<unsigned int> freeBuffers;
+	for (unsigned int i = m_Settings.queueDepth; i > 0; i--)
+		freeBuffers.push_back(i - 1);
+
+	unsigned int inFlightCount = 0;
+	auto reapCompletions = [&]()
+	{
+		unsigned int cqHead = *ring.cqHead;
+		unsigned int cqTail = __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE);
+		for (; cqHead != cqTail; cqHead++)
+		{
+			const io_uring_cqe& cqe = ring.cqes[cqHead & ring.cqMask];
+			unsigned int buffer = (unsigned int)cqe.user_data;
+			Block block = inFlight[buffer];
+			if (cqe.res > 0)
+				std::memcpy(block.target, ring.memory.data() + buffer * ring.bufferSize, (std::size_t)cqe.res);
+			busy[buffer] = false;
+			freeBuffers.push_back(buffer);
+			inFlightCount--;
+
+			if (FinishBlock(block, cqe.res, blocks))
+				onComplete(block.request, m_Pending[block.request].data);
+		}
+		__atomic_store_n(ring.cqHead, cqHead, __ATOMIC_RELEASE);
+	};
+
+	while (!blocks.empty() || inFlightCount > 0)
+	{
+		//svi slobodni bufferi dobiju blok, jezgra ih vidi tek nakon spremanja repa
+		unsigned int tail = *ring.sqTail;
+		unsigned int head = __atomic_load_n(ring.sqHead, __ATOMIC_ACQUIRE);
+		unsigned int toSubmit = 0;
+		while (!blocks.empty() && !freeBuffers.empty() && tail - head < ring.sqEntries)
+		{
+			Block block = blocks.front();
+			blocks.pop_front();
+			if (m_Pending[block.request].failed)
+				continue;
+
+			unsigned int buffer = freeBuffers.back();
+			freeBuffers.pop_back();
+			inFlight[buffer] = block;
+			busy[buffer] = true;
+
+			unsigned int index = tail & ring.sqMask;
+			io_uring_sqe& sqe = ring.sqes[index];
+			std::memset(&sqe, 0, sizeof(sqe));
+			sqe.opcode = ring.registered ? IORING_OP_READ_FIXED : IORING_OP_READ;
+			sqe.fd = (int)block.file;
+			sqe.off = block.fileOffset;
+			sqe.addr = (std::uint64_t)(std::uintptr_t)(ring.memory.data() + buffer * ring.bufferSize);
+			sqe.len = block.size;
+			sqe.buf_index = (std::uint16_t)buffer;
+			sqe.user_data = buffer;
+			ring.sqArray[index] = index;
+			tail++;
+			toSubmit++;
+		}
+		__atomic_store_n(ring.sqTail, tail, __ATOMIC_RELEASE);
+		inFlightCount += toSubmit;
+		if (inFlightCount == 0)
+			continue;
+
+		//tail - head ukljucuje i unose koje prekinuti poziv nije predao
+		int entered = (int)syscall(__NR_io_uring_enter, ring.fd, tail - head, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+		m_Stats.submitCalls++;
+		if (entered < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+		{
+			std::cerr << "IO_URING_ENTER FAILED: " << std::strerror(errno) << ", USING PREAD THREAD POOL" << std::endl;
+			break;
+		}
+		reapCompletions();
+	}
+	if (blocks.empty() && inFlightCount == 0)
+		return true;
+
+	//unosi koje jezgra nije preuzela (izmedu glave i repa reda) nisu predani: vracaju se na pocetak serije
+	unsigned int sqHead = __atomic_load_n(ring.sqHead, __ATOMIC_ACQUIRE);
+	for (unsigned int tail = *ring.sqTail; tail != sqHead; tail--)
+	{
+		unsigned int buffer = (unsigned int)ring.sqes[(tail - 1) & ring.sqMask].user_data;
+		blocks.push_front(inFlight[buffer]);
+		busy[buffer] = false;
+		freeBuffers.push_back(buffer);
+		inFlightCount--;
+	}
+
+	//jezgra jos posjeduje predane blokove i pise u njihove buffere: prsten se ne smije ponovno koristiti dok se svi ne vrate,
+	//inace bi sljedeci Read pokupio stare zavrsetke i kopirao ih u tude zahtjeve
+	bool drained = true;
+	while (inFlightCount > 0)
+	{
+		int entered = (int)syscall(__NR_io_uring_enter, ring.fd, 0, inFlightCount, IORING_ENTER_GETEVENTS, nullptr, 0);
+		if (entered < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+		{
+			drained = false;
+			break;
+		}
+		reapCompletions();
+	}
+
+	//neispraznjeni prsten se namjerno ne oslobada jer jezgra jos moze pisati u njegove buffere; ti zahtjevi ostaju neuspjeli
+	if (drained)
+	{
+		m_Ring.reset();
+	}
+	else
+	{
+		std::cerr << "IO_URING COULD NOT BE DRAINED, " << inFlightCount << " READS ABANDONED" << std::endl;
+		for (unsigned int buffer = 0; buffer < busy.size(); buffer++)
+		{
+			if (busy[buffer])
+				m_Pending[inFlight[buffer].request].failed = true;
+		}
+		m_Ring.release();
+	}
+
+	//ostatak ove i sve sljedece serije citaju radnici
+	m_Backend = AsyncIOBackend::ThreadPool;
+	StartThreadPool();
+	return ReadThreadPool(blocks, onComplete);
+}
+
+#endif
+
+void AsyncIO::WorkerLoop()
+{
+	for (;;)
+	{
+		Block block;
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_WorkReady.wait(lock, [this]() { return m_Stop || !m_Work.empty(); });
+			if (m_Work.empty())
+				return;
+			block = m_Work.front();
+			m_Work.pop_front();
+		}
+
+		long long result = ReadAt(block.file, block.target, block.size, block.fileOffset);
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Results.push_back({ block, result });
+		}
+		m_ResultReady.notify_one();
+	}
+}
+
+bool AsyncIO::ReadThreadPool(std::deque<Block>& blocks, const CompletionFunction& onComplete)
+{
+	std::size_t outstanding = blocks.size();
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Work.insert(m_Work.end(), blocks.begin(), blocks.end());
+	}
+	blocks.clear();
+	m_WorkReady.notify_all();
+
+	std::deque<BlockResult> results;
+	while (outstanding > 0)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_ResultReady.wait(lock, [this]() { return !m_Results.empty(); });
+			results.swap(m_Results);
+		}
+
+		for (const BlockResult& result : results)
+		{
+			outstanding--;
+			m_Stats.submitCalls++;
+			if (FinishBlock(result.block, result.result, blocks))
+				onComplete(result.block.request, m_Pending[result.block.request].data);
+		}
+		results.clear();
+
+		//ostaci kratkih citanja idu natrag radnicima
+		if (!blocks.empty())
+		{
+			outstanding += blocks.size();
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_Work.insert(m_Work.end(), blocks.begin(), blocks.end());
+			}
+			blocks.clear();
+			m_WorkReady.notify_all();
+		}
+	}
+	return true;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class AsyncIOBackend
+{
+	//io_uring ako ga jezgra dopusta, inace ThreadPool
+	Auto,
+	IoUring,
+	ThreadPool
+};
+
+struct AsyncIOSettings
+{
+	AsyncIOBackend backend = AsyncIOBackend::Auto;
+	//citanja u letu: velicina io_uring reda, odnosno broj pread dretvi (najvise 64)
+	unsigned int queueDepth = 32;
+	//najveca velicina jednog citanja, ujedno velicina svakog registriranog buffera
+	std::size_t blockSize = 256 * 1024;
+};
+
+//cijela datoteka ili raspon u njoj, npr. unos AssetPacka
+struct AsyncReadRequest
+{
+	static const std::uint64_t WHOLE_FILE = ~0ull;
+
+	std::string path;
+	std::uint64_t offset = 0;
+	std::uint64_t size = WHOLE_FILE;
+};
+
+struct AsyncIOStats
+{
+	unsigned int requests = 0;
+	unsigned int failed = 0;
+	unsigned int blockReads = 0;
+	//io_uring_enter pozivi, odnosno pread pozivi u ThreadPool nacinu
+	unsigned int submitCalls = 0;
+	std::uint64_t bytes = 0;
+	double wallMs = 0.0;
+
+	inline double GetMBPerSecond() const { return wallMs > 0.0 ? bytes / (wallMs * 1000.0) : 0.0; }
+	inline double GetIOPS() const { return wallMs > 0.0 ? blockReads * 1000.0 / wallMs : 0.0; }
+};
+
+//skupno citanje datoteka: svaki zahtjev se dijeli na blokove do blockSize, a do queueDepth blokova je u letu odjednom
+//io_uring (Linux): jedan io_uring_enter salje sve slobodne blokove i ceka barem jedan zavrsetak, citanja idu u registrirane buffere
+//(IORING_OP_READ_FIXED) iz kojih se kopiraju u rezultat; ThreadPool: queueDepth dretvi radi blokirajuci pread ravno u rezultat
+//zavrsetak cijelog zahtjeva javlja se na pozivajucoj dretvi cim stigne, pa dekodiranje krece dok ostalo jos putuje;
+//zasad ga koristi samo ImageDecoder, .obj i shaderi se i dalje citaju sinkrono kroz FileSystem
+class AsyncIO
+{
+public:
+	//index zahtjeva i njegovi bajtovi, vektor se smije preuzeti (swap ili move)
+	using CompletionFunction = std::function<void(std::size_t, std::vector<std::uint8_t>&)>;
+
+	AsyncIO(const AsyncIOSettings& settings = AsyncIOSettings());
+	~AsyncIO();
+
+	AsyncIO(const AsyncIO&) = delete;
+	AsyncIO& operator=(const AsyncIO&) = delete;
+
+	//vraca tek kad su svi zahtjevi gotovi; neuspjeli zahtjevi se ne javljaju, tada je rezultat false
+	bool Read(const std::vector<AsyncReadRequest>& requests, const CompletionFunction& onComplete);
+
+	//nakon greske io_uring_enter prelazi na ThreadPool do kraja zivota objekta
+	inline AsyncIOBackend GetBackend() const { return m_Backend; }
+	inline unsigned int GetQueueDepth() const { return m_Settings.queueDepth; }
+	inline const AsyncIOStats& GetStats() const { return m_Stats; }
+
+	static bool IsIoUringSupported();
+	static const char* GetBackendName(AsyncIOBackend backend);
+
+private:
+	struct Block
+	{
+		std::uint32_t request;
+		std::intptr_t file;
+		std::uint64_t fileOffset;
+		std::uint8_t* target;
+		std::uint32_t size;
+	};
+
+	struct PendingRequest
+	{
+		std::intptr_t file = -1;
+		std::vector<std::uint8_t> data;
+		std::uint64_t remaining = 0;
+		bool failed = false;
+	};
+
+	struct BlockResult
+	{
+		Block block;
+		long long result;
+	};
+
+	//zajednicko za oba nacina: upisuje procitano, za kratko citanje vraca ostatak u blocks; true ako je zahtjev upravo gotov
+	bool FinishBlock(const Block& block, long long result, std::deque<Block>& blocks);
+	bool ReadIoUring(std::deque<Block>& blocks, const CompletionFunction& onComplete);
+	bool ReadThreadPool(std::deque<Block>& blocks, const CompletionFunction& onComplete);
+	void StartThreadPool();
+	void WorkerLoop();
+
+private:
+	struct IoUring;
+
+	AsyncIOSettings m_Settings;
+	AsyncIOBackend m_Backend;
+	AsyncIOStats m_Stats;
+	std::vector<PendingRequest> m_Pending;
+	std::vector<const AsyncReadRequest*> m_Requests;
+
+	std::unique_ptr<IoUring> m_Ring;
+
+	std::vector<std::thread> m_Workers;
+	std::mutex m_Mutex;
+	std::condition_variable m_WorkReady;
+	std::condition_variable m_ResultReady;
+	std::deque<Block> m_Work;
+	std::deque<BlockResult> m_Results;
+	bool m_Stop;
+};
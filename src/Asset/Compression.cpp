@@ -0,0 +1,158 @@
+#include "Compression.h"
+
+#include <algorithm>
+#include <cstring>
+
+static const std::size_t MIN_MATCH = 4;
+static const std::size_t MAX_OFFSET = 65535;
+static const unsigned int HASH_BITS = 14;
+static const std::size_t NO_POSITION = (std::size_t)-1;
+
+static inline std::uint32_t Read32(const std::uint8_t* data)
+{
+	std::uint32_t value;
+	std::memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+static inline std::uint32_t Hash(std::uint32_t sequence)
+{
+	return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+//duljine od 15 nadalje: ostatak u bajtovima od 255 i zavrsnom manjem bajtu
+static void WriteLength(std::vector<std::uint8_t>& out, std::size_t length)
+{
+	while (length >= 255)
+	{
+		out.push_back(255);
+		length -= 255;
+	}
+	out.push_back((std::uint8_t)length);
+}
+
+//matchLength 0 je zadnja sekvenca bloka, samo literali
+static void WriteSequence(std::vector<std::uint8_t>& out, const std::uint8_t* literals, std::size_t literalCount, std::size_t offset, std::size_t matchLength)
+{
+	std::size_t matchCode = matchLength > 0 ? matchLength - MIN_MATCH : 0;
+	out.push_back((std::uint8_t)((std::min<std::size_t>(literalCount, 15) << 4) | std::min<std::size_t>(matchCode, 15)));
+	if (literalCount >= 15)
+		WriteLength(out, literalCount - 15);
+	out.insert(out.end(), literals, literals + literalCount);
+	if (matchLength == 0)
+		return;
+
+	out.push_back((std::uint8_t)(offset & 0xFF));
+	out.push_back((std::uint8_t)(offset >> 8));
+	if (matchCode >= 15)
+		WriteLength(out, matchCode - 15);
+}
+
+std::size_t Compression::GetMaxCompressedSize(std::size_t size)
+{
+	return size + size / 255 + 16;
+}
+
+std::size_t Compression::Compress(const std::uint8_t* source, std::size_t size, std::vector<std::uint8_t>& out)
+{
+	out.clear();
+	out.reserve(GetMaxCompressedSize(size));
+
+	std::vector<std::size_t> table((std::size_t)1 << HASH_BITS, NO_POSITION);
+	std::size_t anchor = 0, i = 0;
+	unsigned int misses = 0;
+	if (size >= MIN_MATCH)
+	{
+		const std::size_t last = size - MIN_MATCH;
+		while (i <= last)
+		{
+			std::uint32_t sequence = Read32(source + i);
+			std::size_t& entry = table[Hash(sequence)];
+			std::size_t candidate = entry;
+			entry = i;
+
+			if (candidate != NO_POSITION && i - candidate <= MAX_OFFSET && Read32(source + candidate) == sequence)
+			{
+				std::size_t length = MIN_MATCH;
+				while (i + length < size && source[candidate + length] == source[i + length])
+					length++;
+
+				WriteSequence(out, source + anchor, i - anchor, i - candidate, length);
+				i += length;
+				anchor = i;
+				misses = 0;
+			}
+			else
+			{
+				//u nekompresibilnim podacima (PNG, JPEG) korak raste pa kompresija ne trosi vrijeme na svaki bajt
+				i += 1 + (misses++ >> 5);
+			}
+		}
+	}
+
+	WriteSequence(out, source + anchor, size - anchor, 0, 0);
+	return out.size();
+}
+
+bool Compression::Decompress(const std::uint8_t* source, std::size_t size, std::uint8_t* target, std::size_t rawSize)
+{
+	const std::uint8_t* input = source;
+	const std::uint8_t* inputEnd = source + size;
+	std::uint8_t* output = target;
+	std::uint8_t* outputEnd = target + rawSize;
+
+	auto readLength = [&](std::size_t& length)
+	{
+		std::uint8_t value;
+		do
+		{
+			if (input >= inputEnd)
+				return false;
+			value = *input++;
+			length += value;
+		} while (value == 255);
+		return true;
+	};
+
+	while (input < inputEnd)
+	{
+		std::uint8_t token = *input++;
+		std::size_t literals = token >> 4;
+		if (literals == 15 && !readLength(literals))
+			return false;
+		if ((std::size_t)(inputEnd - input) < literals || (std::size_t)(outputEnd - output) < literals)
+			return false;
+		std::memcpy(output, input, literals);
+		output += literals;
+		input += literals;
+
+		if (input == inputEnd)
+			break;
+		if (inputEnd - input < 2)
+			return false;
+
+		std::size_t offset = (std::size_t)input[0] | ((std::size_t)input[1] << 8);
+		input += 2;
+		std::size_t length = token & 15;
+		if (length == 15 && !readLength(length))
+			return false;
+		length += MIN_MATCH;
+		if (offset == 0 || offset > (std::size_t)(output - target) || (std::size_t)(outputEnd - output) < length)
+			return false;
+
+		//podudaranje se smije preklapati s onim sto se upravo pise (ponavljanje uzorka)
+		const std::uint8_t* match = output - offset;
+		if (offset >= length)
+		{
+			std::memcpy(output, match, length);
+		}
+		else
+		{
+			for (std::size_t k = 0; k < length; k++)
+				output[k] = match[k];
+		}
+		output += length;
+	}
+
+	return output == outputEnd;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//LZ77 blokovi u stilu LZ4: token s duljinom literala i podudaranja, literali, 16-bitni pomak unatrag
+//kompresija trazi podudaranja od 4 bajta kroz hash tablicu bez lanaca pa je brza i bez dodatne memorije,
+//a dekompresija samo kopira bajtove pa je ogranicena brzinom memorije; nekompresibilni podaci se preskacu sve vecim korakom
+class Compression
+{
+public:
+	//out se prepisuje, vraca velicinu komprimiranog bloka
+	static std::size_t Compress(const std::uint8_t* source, std::size_t size, std::vector<std::uint8_t>& out);
+	//target mora imati tocno rawSize bajtova; false ako je blok neispravan ili se ne raspakira u tocno rawSize
+	static bool Decompress(const std::uint8_t* source, std::size_t size, std::uint8_t* target, std::size_t rawSize);
+
+	static std::size_t GetMaxCompressedSize(std::size_t size);
+};
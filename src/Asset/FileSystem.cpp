@@ -0,0 +1,95 @@
+#include "FileSystem.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+std::mutex FileSystem::s_Mutex;
+std::vector<std::shared_ptr<const AssetPack>> FileSystem::s_Packs;
+
+bool FileSystem::Mount(const std::string& packPath)
+{
+	std::shared_ptr<AssetPack> pack = std::make_shared<AssetPack>();
+	if (!pack->Open(packPath))
+		return false;
+	Mount(std::move(pack));
+	return true;
+}
+
+void FileSystem::Mount(std::shared_ptr<const AssetPack> pack)
+{
+	std::lock_guard<std::mutex> lock(s_Mutex);
+	s_Packs.push_back(std::move(pack));
+}
+
+void FileSystem::UnmountAll()
+{
+	std::lock_guard<std::mutex> lock(s_Mutex);
+	s_Packs.clear();
+}
+
+const AssetPackEntry* FileSystem::Find(const std::string& path, std::shared_ptr<const AssetPack>& pack)
+{
+	std::lock_guard<std::mutex> lock(s_Mutex);
+	for (auto it = s_Packs.rbegin(); it != s_Packs.rend(); ++it)
+	{
+		if (const AssetPackEntry* entry = (*it)->Find(path))
+		{
+			pack = *it;
+			return entry;
+		}
+	}
+	return nullptr;
+}
+
+bool FileSystem::Read(const std::string& path, FileData& out)
+{
+	out = FileData();
+	std::shared_ptr<const AssetPack> pack;
+	if (const AssetPackEntry* entry = Find(path, pack))
+	{
+		if (!(entry->flags & AssetPackEntry::COMPRESSED))
+		{
+			out.m_Data = pack->GetData(*entry);
+			out.m_Size = (std::size_t)entry->rawSize;
+			out.m_Pack = std::move(pack);
+			return true;
+		}
+
+		if (!pack->Read(*entry, out.m_Storage))
+			return false;
+		out.m_Data = out.m_Storage.data();
+		out.m_Size = out.m_Storage.size();
+		return true;
+	}
+
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file)
+	{
+		std::cerr << "FILE COULD NOT OPEN: " << path << std::endl;
+		return false;
+	}
+	out.m_Storage.resize((std::size_t)file.tellg());
+	file.seekg(0);
+	if (!file.read((char*)out.m_Storage.data(), out.m_Storage.size()))
+	{
+		std::cerr << "FILE COULD NOT BE READ: " << path << std::endl;
+		out.m_Storage.clear();
+		return false;
+	}
+	out.m_Data = out.m_Storage.data();
+	out.m_Size = out.m_Storage.size();
+	return true;
+}
+
+bool FileSystem::Exists(const std::string& path)
+{
+	std::error_code error;
+	return IsPacked(path) || std::filesystem::is_regular_file(path, error);
+}
+
+bool FileSystem::IsPacked(const std::string& path)
+{
+	std::shared_ptr<const AssetPack> pack;
+	return Find(path, pack) != nullptr;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "AssetPack.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//sadrzaj jedne datoteke: nekomprimirani unos packa pokazuje ravno u mapiranu memoriju i drzi pack zivim,
+//a komprimirani unos i datoteka s diska su u vlastitom bufferu
+class FileData
+{
+public:
+	FileData() : m_Data(nullptr), m_Size(0) { }
+
+	FileData(const FileData&) = delete;
+	FileData& operator=(const FileData&) = delete;
+	FileData(FileData&&) = default;
+	FileData& operator=(FileData&&) = default;
+
+	inline const std::uint8_t* GetData() const { return m_Data; }
+	inline std::size_t GetSize() const { return m_Size; }
+	inline bool IsPacked() const { return m_Pack != nullptr; }
+	inline std::string ToString() const { return std::string((const char*)m_Data, m_Size); }
+
+private:
+	friend class FileSystem;
+
+	const std::uint8_t* m_Data;
+	std::size_t m_Size;
+	std::vector<std::uint8_t> m_Storage;
+	std::shared_ptr<const AssetPack> m_Pack;
+};
+
+//virtualni datotecni sustav za Model, Shader, Texture i ImageDecoder: putanja se prvo trazi u montiranim packovima
+//(zadnji montirani ima prednost), a ako je nema ondje cita se s diska; montirati treba prije ucitavanja, citanje je sigurno s vise dretvi
+class FileSystem
+{
+public:
+	static bool Mount(const std::string& packPath);
+	static void Mount(std::shared_ptr<const AssetPack> pack);
+	static void UnmountAll();
+
+	static bool Read(const std::string& path, FileData& out);
+	//postoji u packu ili na disku
+	static bool Exists(const std::string& path);
+	//postoji u nekom montiranom packu
+	static bool IsPacked(const std::string& path);
+
+	inline static std::size_t GetMountCount() { std::lock_guard<std::mutex> lock(s_Mutex); return s_Packs.size(); }
+
+private:
+	static const AssetPackEntry* Find(const std::string& path, std::shared_ptr<const AssetPack>& pack);
+
+private:
+	static std::mutex s_Mutex;
+	static std::vector<std::shared_ptr<const AssetPack>> s_Packs;
+};
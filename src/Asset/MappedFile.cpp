@@ -0,0 +1,142 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <iostream>
+
+MappedFile::MappedFile()
+	: m_Data(nullptr), m_Size(0)
+#ifdef _WIN32
+	, m_File(nullptr), m_Mapping(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& path)
+{
+	Close();
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		std::cerr << "FILE COULD NOT OPEN: " << path << std::endl;
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		std::cerr << "FILE IS EMPTY: " << path << std::endl;
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (!data)
+	{
+		std::cerr << "FILE COULD NOT BE MAPPED: " << path << std::endl;
+		if (mapping)
+			CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	m_Path = path;
+	m_File = file;
+	m_Mapping = mapping;
+	m_Data = (const std::uint8_t*)data;
+	m_Size = (std::size_t)size.QuadPart;
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_Data)
+		UnmapViewOfFile(m_Data);
+	if (m_Mapping)
+		CloseHandle(m_Mapping);
+	if (m_File)
+		CloseHandle(m_File);
+	m_Data = nullptr;
+	m_Mapping = nullptr;
+	m_File = nullptr;
+	m_Size = 0;
+}
+
+bool MappedFile::DropPageCache(const std::string&)
+{
+	return false;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& path)
+{
+	Close();
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		std::cerr << "FILE COULD NOT OPEN: " << path << std::endl;
+		return false;
+	}
+
+	struct stat status;
+	if (fstat(file, &status) != 0 || status.st_size == 0)
+	{
+		std::cerr << "FILE IS EMPTY: " << path << std::endl;
+		close(file);
+		return false;
+	}
+
+	//mapiranje ostaje valjano i nakon zatvaranja deskriptora
+	void* data = mmap(nullptr, (std::size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (data == MAP_FAILED)
+	{
+		std::cerr << "FILE COULD NOT BE MAPPED: " << path << std::endl;
+		return false;
+	}
+
+	m_Path = path;
+	m_Data = (const std::uint8_t*)data;
+	m_Size = (std::size_t)status.st_size;
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_Data)
+		munmap((void*)m_Data, m_Size);
+	m_Data = nullptr;
+	m_Size = 0;
+}
+
+bool MappedFile::DropPageCache(const std::string& path)
+{
+	int file = open(path.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+	//prljave stranice (netom zapisana datoteka) se ne izbacuju pa se prvo zapisu na disk
+	fdatasync(file);
+	bool dropped = posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED) == 0;
+	close(file);
+	return dropped;
+}
+
+#endif
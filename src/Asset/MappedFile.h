@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+//datoteka mapirana samo za citanje cijela odjednom (mmap, na Windowsima CreateFileMapping)
+//stranice dolaze s diska tek pri prvom pristupu, a nakon toga ih dijele svi koji citaju istu datoteku
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(const std::string& path);
+	void Close();
+
+	inline bool IsOpen() const { return m_Data != nullptr; }
+	inline const std::uint8_t* GetData() const { return m_Data; }
+	inline std::size_t GetSize() const { return m_Size; }
+	inline const std::string& GetPath() const { return m_Path; }
+
+	//izbacuje stranice datoteke iz page cachea (posix_fadvise), za mjerenje hladnog ucitavanja; false ako OS to ne podrzava
+	static bool DropPageCache(const std::string& path);
+
+private:
+	std::string m_Path;
+	const std::uint8_t* m_Data;
+	std::size_t m_Size;
+#ifdef _WIN32
+	void* m_File;
+	void* m_Mapping;
+#endif
+};
@@ -0,0 +1,1967 @@
+#include "Benchmark.h"
+
+#include "JobSystem.h"
+#include "Renderer.h"
+#include "Scene.h"
+#include "BatchMath.h"
+#include "ClusteredLighting.h"
+#include "RenderGraph.h"
+#include "CascadedShadowMaps.h"
+#include "SceneBVH.h"
+#include "Model.h"
+#include "MeshBVH.h"
+#include "LightBaker.h"
+#include "SoftwareRasterizer.h"
+#include "TextureCooker.h"
+#include "MipGenerator.h"
+#include "AtlasPacker.h"
+#include "TexturePacker.h"
+#include "TextureResidency.h"
+#include "ImageDecoder.h"
+#include "VirtualPageTable.h"
+#include "AssetPack.h"
+#include "FileSystem.h"
+#include "MappedFile.h"
+#include "AsyncIO.h"
+#include "MeshCooker.h"
+#include "AssetCooker.h"
+
+#include "stb_image/stb_image.h"
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include <random>
+#include <cfloat>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "glm/gtc/matrix_transform.hpp"
+
+struct BenchmarkEntry
+{
+	const char* name;
+	//false kad samoprovjera mjerenja ne prode
+	bool (*function)();
+};
+
+static double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	return elapsed.count();
+}
+
+static bool BenchJobScaling()
+{
+	const std::uint32_t count = 1 << 22;
+	const int repeats = 5;
+	std::vector<float> data(count);
+
+	unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+	double baseline = 0.0;
+
+	std::cout << "threads      ms   speedup" << std::endl;
+	for (unsigned int threads = 1; threads <= maxThreads; threads++)
+	{
+		JobSystem jobs(threads);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int r = 0; r < repeats; r++)
+		{
+			jobs.ParallelFor(count, 4096, [&data](std::uint32_t begin, std::uint32_t end)
+			{
+				for (std::uint32_t i = begin; i < end; i++)
+					data[i] = std::sqrt((float)i) * std::sin((float)i);
+			});
+		}
+		double ms = ElapsedMs(start) / repeats;
+		if (threads == 1)
+			baseline = ms;
+
+		std::cout << std::setw(7) << threads << std::setw(8) << std::fixed << std::setprecision(2) << ms
+			<< std::setw(10) << baseline / ms << std::endl;
+	}
+	return true;
+}
+
+static void RecordPackets(CommandBuffer& commands, std::uint32_t begin, std::uint32_t end)
+{
+	for (std::uint32_t i = begin; i < end; i++)
+	{
+		commands.BindProgram(1 + i % 4);
+		commands.BindTexture(0, 1 + i % 16);
+		commands.BindUniformBlock(0, 1, i * 256, 256);
+		commands.BindVertexArray(1 + i % 32);
+		commands.DrawIndexed(36 + i % 3);
+	}
+}
+
+static bool BenchCommandRecording()
+{
+	const std::uint32_t packets = 100000;
+	const int repeats = 10;
+
+	Renderer renderer;
+
+	renderer.BeginCommands(1, 1);
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int r = 0; r < repeats; r++)
+	{
+		renderer.GetCommandBuffer(0, 0).Clear();
+		RecordPackets(renderer.GetCommandBuffer(0, 0), 0, packets);
+	}
+	double serialMs = ElapsedMs(start) / repeats;
+	std::vector<RenderCommand> reference = renderer.MergeCommands();
+
+	std::cout << "serial: " << std::fixed << std::setprecision(2) << serialMs << " ms for " << packets << " packets" << std::endl;
+	std::cout << "threads      ms   speedup   match" << std::endl;
+	bool passed = true;
+
+	unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+	for (unsigned int threads = 1; threads <= maxThreads; threads++)
+	{
+		JobSystem jobs(threads);
+
+		//svaki buffer dobiva jedan uzastopni raspon paketa pa spajanje daje isti redoslijed kao serijsko snimanje
+		double ms = 0.0;
+		for (int r = 0; r < repeats; r++)
+		{
+			renderer.BeginCommands(1, threads);
+			start = std::chrono::high_resolution_clock::now();
+			jobs.ParallelFor(threads, 1, [&renderer, threads, packets](std::uint32_t begin, std::uint32_t end)
+			{
+				for (std::uint32_t t = begin; t < end; t++)
+				{
+					CommandBuffer& commands = renderer.GetCommandBuffer(0, t);
+					RecordPackets(commands, packets * t / threads, packets * (t + 1) / threads);
+				}
+			});
+			ms += ElapsedMs(start);
+		}
+		ms /= repeats;
+
+		bool match = renderer.MergeCommands() == reference;
+		std::cout << std::setw(7) << threads << std::setw(8) << ms << std::setw(10) << serialMs / ms
+			<< std::setw(8) << (match ? "yes" : "NO") << std::endl;
+		passed = passed && match;
+	}
+	return passed;
+}
+
+static bool BenchSceneUpdate()
+{
+	//1M entiteta: 1000 korijena, svaki s 999 potomaka rasporedenih u tri razine
+	const std::uint32_t roots = 1000;
+	const std::uint32_t perRoot = 999;
+
+	JobSystem jobs;
+	Scene scene;
+	scene.Reserve(roots * (perRoot + 1));
+
+	for (std::uint32_t r = 0; r < roots; r++)
+	{
+		Entity root = scene.CreateEntity(glm::vec3((float)r, 0.0f, 0.0f));
+		Entity parent = root;
+		for (std::uint32_t c = 0; c < perRoot; c++)
+		{
+			if (c % 333 == 0 && c > 0)
+				parent = scene.CreateEntity(glm::vec3(0.0f, 1.0f, 0.0f), parent);
+			else
+				scene.CreateEntity(glm::vec3(0.0f, 0.0f, (float)c), parent);
+		}
+	}
+
+	std::cout << "entities: " << scene.GetEntityCount() << std::endl;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	scene.UpdateTransforms(&jobs);
+	std::cout << "initial update:  " << std::fixed << std::setprecision(2) << ElapsedMs(start)
+		<< " ms (" << scene.GetStats().updatedEntities << " updated)" << std::endl;
+
+	const std::uint32_t changedCounts[] = { 0, 100, 10000, 100000 };
+	for (std::uint32_t changed : changedCounts)
+	{
+		//mijenjaju se listovi pa broj azuriranih entiteta prati broj promjena
+		std::uint32_t stride = changed ? (std::uint32_t)scene.GetEntityCount() / changed : 0;
+		for (std::uint32_t i = 0; i < changed; i++)
+		{
+			Entity entity = i * stride + 1;
+			scene.SetPosition(entity, scene.GetPosition(entity) + glm::vec3(0.01f));
+		}
+
+		start = std::chrono::high_resolution_clock::now();
+		scene.UpdateTransforms(&jobs);
+		std::cout << std::setw(7) << changed << " changed: " << std::setw(8) << ElapsedMs(start)
+			<< " ms (" << scene.GetStats().updatedEntities << " updated)" << std::endl;
+	}
+	return true;
+}
+
+static float MaxDifference(const float* a, const float* b, std::size_t count)
+{
+	float difference = 0.0f;
+	for (std::size_t i = 0; i < count; i++)
+		difference = std::max(difference, std::abs(a[i] - b[i]));
+	return difference;
+}
+
+static bool BenchBatchMath()
+{
+	using namespace BatchMath;
+
+	const std::size_t count = 10000;
+	const int repeats = 200;
+
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+	std::vector<glm::vec3> positions(count), scales(count);
+	std::vector<glm::quat> rotations(count);
+	for (std::size_t i = 0; i < count; i++)
+	{
+		positions[i] = glm::vec3(unit(random), unit(random), unit(random)) * 50.0f;
+		scales[i] = glm::vec3(1.5f) + glm::vec3(unit(random), unit(random), unit(random));
+		rotations[i] = glm::angleAxis(unit(random) * 3.14159f, glm::normalize(glm::vec3(unit(random), unit(random), unit(random)) + glm::vec3(0.0f, 0.01f, 0.0f)));
+	}
+	glm::mat4 viewProjection = glm::perspective(glm::radians(45.0f), 1.2f, 0.1f, 100.0f)
+		* glm::lookAt(glm::vec3(0.0f, 2.0f, 8.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+	//referenca je izracunata istim redoslijedom poziva kao stari kod u main.cpp
+	std::vector<glm::mat4> referenceModels(count), referenceMvps(count), referenceNormals(count);
+	for (std::size_t i = 0; i < count; i++)
+	{
+		referenceModels[i] = glm::translate(glm::mat4(1.0f), positions[i]) * glm::mat4_cast(rotations[i]) * glm::scale(glm::mat4(1.0f), scales[i]);
+		referenceMvps[i] = viewProjection * referenceModels[i];
+		glm::mat3 normal = glm::transpose(glm::inverse(glm::mat3(referenceModels[i])));
+		referenceNormals[i] = glm::mat4(glm::vec4(normal[0], 0.0f), glm::vec4(normal[1], 0.0f), glm::vec4(normal[2], 0.0f), glm::vec4(0.0f));
+	}
+
+	std::vector<glm::mat4> models(count), mvps(count), normals(count, glm::mat4(0.0f));
+
+	std::cout << "level     Mobj/s   maxErrModel   maxErrMvp   maxErrNormal" << std::endl;
+	for (int l = 0; l <= (int)GetBestSimdLevel(); l++)
+	{
+		SimdLevel level = (SimdLevel)l;
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int r = 0; r < repeats; r++)
+		{
+			ComposeTRS(positions.data(), rotations.data(), scales.data(), count, models.data(), sizeof(glm::mat4), level);
+			MultiplyMatrices(viewProjection, models.data(), count, mvps.data(), sizeof(glm::mat4), level);
+			ComputeNormalMatrices(models.data(), count, normals.data(), sizeof(glm::mat4), level);
+		}
+		double ms = ElapsedMs(start);
+
+		std::cout << std::setw(6) << GetSimdLevelName(level) << std::setw(11) << std::fixed << std::setprecision(2)
+			<< (double)count * repeats / (ms * 1000.0) << std::scientific << std::setprecision(2)
+			<< std::setw(14) << MaxDifference(&models[0][0][0], &referenceModels[0][0][0], count * 16)
+			<< std::setw(12) << MaxDifference(&mvps[0][0][0], &referenceMvps[0][0][0], count * 16)
+			<< std::setw(15) << MaxDifference(&normals[0][0][0], &referenceNormals[0][0][0], count * 16) << std::endl;
+	}
+	std::cout << std::fixed;
+	return true;
+}
+
+struct BenchFragment
+{
+	glm::vec3 position;
+	glm::vec2 pixel;
+	float viewDepth;
+};
+
+//fragmenti poda y = 0 dobiveni bacanjem zraka kroz rijetku mrezu piksela
+static std::vector<BenchFragment> MakeFloorFragments(const glm::mat4& projection, const glm::mat4& view,
+	float width, float height, int stepPixels)
+{
+	std::vector<BenchFragment> fragments;
+	glm::mat4 inverseViewProjection = glm::inverse(projection * view);
+	glm::vec3 eye = glm::vec3(glm::inverse(view)[3]);
+
+	for (float y = 0.5f; y < height; y += stepPixels)
+	{
+		for (float x = 0.5f; x < width; x += stepPixels)
+		{
+			glm::vec4 far = inverseViewProjection * glm::vec4(x / width * 2.0f - 1.0f, y / height * 2.0f - 1.0f, 1.0f, 1.0f);
+			glm::vec3 direction = glm::normalize(glm::vec3(far) / far.w - eye);
+			if (direction.y >= -1e-4f)
+				continue;
+
+			BenchFragment fragment;
+			fragment.position = eye + direction * (-eye.y / direction.y);
+			fragment.pixel = glm::vec2(x, y);
+			fragment.viewDepth = -(view * glm::vec4(fragment.position, 1.0f)).z;
+			if (fragment.viewDepth < 100.0f)
+				fragments.push_back(fragment);
+		}
+	}
+	return fragments;
+}
+
+static bool BenchClusteredLighting()
+{
+	const float width = 1200.0f, height = 1000.0f;
+	const glm::vec3 eye(0.0f, 6.0f, 20.0f);
+	const glm::vec3 normal(0.0f, 1.0f, 0.0f);
+
+	glm::mat4 projection = glm::perspective(glm::radians(45.0f), width / height, 0.1f, 100.0f);
+	glm::mat4 view = glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	std::vector<BenchFragment> fragments = MakeFloorFragments(projection, view, width, height, 4);
+
+	JobSystem jobs;
+	ClusteredLighting clusters;
+	clusters.SetProjection(projection, 0.1f, 100.0f);
+
+	std::mt19937 random(11);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	std::cout << fragments.size() << " fragments (every 4th pixel)" << std::endl;
+	std::cout << "lights   build ms   brute ms   clustered ms   lights/frag   dropped   maxDiff" << std::endl;
+
+	for (unsigned int count = 1; count <= 1024; count *= 4)
+	{
+		std::vector<PointLight> lights(count);
+		for (PointLight& light : lights)
+		{
+			light.position = glm::vec3(unit(random) * 60.0f - 30.0f, 0.5f + unit(random) * 2.5f, unit(random) * 60.0f - 40.0f);
+			light.radius = 2.0f + unit(random) * 4.0f;
+			light.color = glm::vec3(unit(random), unit(random), unit(random));
+			light.intensity = 1.0f;
+		}
+
+		clusters.Build(lights, view, &jobs);
+
+		std::vector<glm::vec3> brute(fragments.size()), clustered(fragments.size());
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for (std::size_t f = 0; f < fragments.size(); f++)
+		{
+			glm::vec3 result(0.0f);
+			for (const PointLight& light : lights)
+				result += ShadePointLight(light, fragments[f].position, normal, eye, 0.5f);
+			brute[f] = result;
+		}
+		double bruteMs = ElapsedMs(start);
+
+		unsigned long long evaluated = 0;
+		start = std::chrono::high_resolution_clock::now();
+		for (std::size_t f = 0; f < fragments.size(); f++)
+		{
+			const BenchFragment& fragment = fragments[f];
+			glm::uvec2 cluster = clusters.GetGrid()[clusters.GetClusterIndex(fragment.pixel.x, fragment.pixel.y, fragment.viewDepth, width, height)];
+
+			glm::vec3 result(0.0f);
+			for (unsigned int i = 0; i < cluster.y; i++)
+				result += ShadePointLight(lights[clusters.GetLightIndices()[cluster.x + i]], fragment.position, normal, eye, 0.5f);
+			clustered[f] = result;
+			evaluated += cluster.y;
+		}
+		double clusteredMs = ElapsedMs(start);
+
+		float maxDiff = MaxDifference(&brute[0].x, &clustered[0].x, brute.size() * 3);
+
+		std::cout << std::setw(6) << count << std::fixed << std::setprecision(3)
+			<< std::setw(11) << clusters.GetStats().buildMs << std::setw(11) << bruteMs << std::setw(15) << clusteredMs
+			<< std::setw(14) << (double)evaluated / fragments.size() << std::setw(10) << clusters.GetStats().droppedLightReferences
+			<< std::scientific << std::setprecision(2)
+			<< std::setw(10) << maxDiff << std::fixed << std::endl;
+	}
+	return true;
+}
+
+//tipican frame: sjene, G-buffer, SSAO, osvjetljenje, motion blur, bloom lanac, tonemap, FXAA i debug prolaz koji nitko ne cita
+static void BuildFrameGraph(RenderGraph& graph, unsigned int width, unsigned int height)
+{
+	auto nothing = [](const RenderGraph&) {};
+	RenderResource backbuffer = graph.Import("backbuffer", 0, { width, height, GL_RGBA8 });
+
+	RenderResource shadowMap, position, normal, albedo, depth, ssao, ssaoBlur, hdr, blurred, ldr, debug;
+	graph.AddPass("shadow", [&](RenderPassBuilder& builder)
+	{
+		shadowMap = builder.Create("shadowMap", { 2048, 2048, GL_DEPTH_COMPONENT32F });
+	}, nothing);
+	graph.AddPass("gbuffer", [&](RenderPassBuilder& builder)
+	{
+		position = builder.Create("position", { width, height, GL_RGBA16F });
+		normal = builder.Create("normal", { width, height, GL_RGBA16F });
+		albedo = builder.Create("albedo", { width, height, GL_RGBA8 });
+		depth = builder.Create("depth", { width, height, GL_DEPTH24_STENCIL8 });
+	}, nothing);
+	graph.AddPass("ssao", [&](RenderPassBuilder& builder)
+	{
+		builder.Read(position);
+		builder.Read(normal);
+		ssao = builder.Create("ssao", { width / 2, height / 2, GL_R8 });
+	}, nothing);
+	graph.AddPass("ssaoBlur", [&](RenderPassBuilder& builder)
+	{
+		builder.Read(ssao);
+		ssaoBlur = builder.Create("ssaoBlur", { width / 2, height / 2, GL_R8 });
+	}, nothing);
+	graph.AddPass("lighting", [&](RenderPassBuilder& builder)
+	{
+		builder.Read(position);
+		builder.Read(normal);
+		builder.Read(albedo);
+		builder.Read(shadowMap);
+		builder.Read(ssaoBlur);
+		hdr = builder.Create("hdr", { width, height, GL_RGBA16F });
+	}, nothing);
+	graph.AddPass("debugNormals", [&](RenderPassBuilder& builder)
+	{
+		builder.Read(normal);
+		debug = builder.Create("debug", { width, height, GL_RGBA8 });
+	}, nothing);
+
+	graph.AddPass("motionBlur", [&](RenderPassBuilder& builder)
+	{
+		builder.Read(hdr);
+		builder.Read(depth);
+		blurred = builder.Create("blurred", { width, height, GL_RGBA16F });
+	}, nothing);
+
+	//bloom: lanac smanjivanja pa povecavanja, svaka razina je zaseban target
+	std::vector<RenderResource> down;
+	RenderResource source = blurred;
+	for (unsigned int level = 1; level <= 5; level++)
+	{
+		graph.AddPass("bloomDown", [&](RenderPassBuilder& builder)
+		{
+			builder.Read(source);
+			source = builder.Create("bloomDown", { width >> level, height >> level, GL_RGBA16F });
+		}, nothing);
+		down.push_back(source);
+	}
+	for (unsigned int level = 4; level >= 1; level--)
+	{
+		graph.AddPass("bloomUp", [&](RenderPassBuilder& builder)
+		{
+			builder.Read(source);
+			builder.Read(down[level - 1]);
+			source = builder.Create("bloomUp", { width >> level, height >> level, GL_RGBA16F });
+		}, nothing);
+	}
+
+	graph.AddPass("tonemap", [&](RenderPassBuilder& builder)
+	{
+		builder.Read(blurred);
+		builder.Read(source);
+		ldr = builder.Create("ldr", { width, height, GL_RGBA8 });
+	}, nothing);
+	graph.AddPass("fxaa", [&](RenderPassBuilder& builder)
+	{
+		builder.Read(ldr);
+		builder.Write(backbuffer);
+	}, nothing);
+}
+
+static bool BenchRenderGraph()
+{
+	const int repeats = 10000;
+	const double mb = 1.0 / (1024.0 * 1024.0);
+
+	std::cout << "resolution   passes  culled  targets  physical  no alias MB  alias MB  peak live MB  compile us" << std::endl;
+	const unsigned int resolutions[][2] = { { 1280, 720 }, { 1920, 1080 }, { 3840, 2160 } };
+	for (const auto& resolution : resolutions)
+	{
+		RenderGraph graph;
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int r = 0; r < repeats; r++)
+		{
+			graph.Reset();
+			BuildFrameGraph(graph, resolution[0], resolution[1]);
+			graph.Compile();
+		}
+		double us = ElapsedMs(start) * 1000.0 / repeats;
+
+		const RenderGraphStats& stats = graph.GetStats();
+		std::cout << std::setw(5) << resolution[0] << "x" << std::setw(4) << resolution[1]
+			<< std::setw(9) << stats.passes << std::setw(8) << stats.culledPasses
+			<< std::setw(9) << stats.transientTargets << std::setw(10) << stats.physicalTargets << std::fixed << std::setprecision(1)
+			<< std::setw(13) << stats.bytesWithoutAliasing * mb << std::setw(10) << stats.bytesWithAliasing * mb
+			<< std::setw(14) << stats.peakLiveBytes * mb << std::setw(12) << std::setprecision(2) << us << std::endl;
+	}
+
+	RenderGraph graph;
+	BuildFrameGraph(graph, 1920, 1080);
+	graph.Compile();
+	std::cout << "order:";
+	for (unsigned int pass : graph.GetExecutionOrder())
+		std::cout << " " << graph.GetPassName(pass);
+	std::cout << std::endl;
+	return true;
+}
+
+//mreza staticnih kocki s dinamicnima koje se krecu, kamera se polako krece i okrece
+static bool BenchShadowCaching()
+{
+	const unsigned int gridSize = 40, dynamicCount = 64, frames = 300;
+	const std::vector<glm::vec4> meshBounds = { glm::vec4(0.0f, 0.0f, 0.0f, 0.87f) };
+
+	std::cout << gridSize * gridSize << " static, " << dynamicCount << " dynamic casters, 4 cascades, " << frames << " frames" << std::endl;
+	std::cout << "cache   draws/frame   static   dynamic   cascades/frame   culled/frame   update ms" << std::endl;
+
+	for (int caching = 1; caching >= 0; caching--)
+	{
+		Scene scene;
+		for (unsigned int x = 0; x < gridSize; x++)
+		{
+			for (unsigned int z = 0; z < gridSize; z++)
+			{
+				Entity entity = scene.CreateEntity(glm::vec3(x * 2.0f - gridSize, 0.0f, z * 2.0f - gridSize));
+				scene.SetStatic(entity, true);
+			}
+		}
+		std::vector<Entity> dynamic;
+		for (unsigned int i = 0; i < dynamicCount; i++)
+			dynamic.push_back(scene.CreateEntity(glm::vec3(0.0f)));
+
+		CascadedShadowMaps shadows;
+		shadows.SetCamera(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 40.0f);
+		shadows.SetCaching(caching == 1);
+
+		ShadowStats total;
+		SceneSnapshot snapshot;
+		for (unsigned int frame = 0; frame < frames; frame++)
+		{
+			float t = frame / 60.0f;
+			for (unsigned int i = 0; i < dynamicCount; i++)
+			{
+				float angle = t + i * 0.1f;
+				scene.SetPosition(dynamic[i], glm::vec3(std::cos(angle) * (5.0f + i * 0.3f), 1.5f, std::sin(angle) * (5.0f + i * 0.3f)));
+			}
+			scene.UpdateTransforms();
+			scene.Snapshot(snapshot);
+
+			glm::vec3 eye(t * 0.5f, 6.0f, 10.0f);
+			glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(std::sin(t * 0.2f), -0.5f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+			shadows.Update(snapshot, meshBounds, view, glm::normalize(glm::vec3(-0.4f, -1.0f, -0.3f)));
+
+			const ShadowStats& stats = shadows.GetStats();
+			total.drawCalls += stats.drawCalls;
+			total.staticDrawCalls += stats.staticDrawCalls;
+			total.dynamicDrawCalls += stats.dynamicDrawCalls;
+			total.refreshedCascades += stats.refreshedCascades;
+			total.culledCasters += stats.culledCasters;
+			total.updateMs += stats.updateMs;
+		}
+
+		std::cout << std::setw(5) << (caching ? "on" : "off") << std::fixed << std::setprecision(1)
+			<< std::setw(14) << (double)total.drawCalls / frames << std::setw(9) << (double)total.staticDrawCalls / frames
+			<< std::setw(10) << (double)total.dynamicDrawCalls / frames << std::setw(17) << (double)total.refreshedCascades / frames
+			<< std::setw(15) << (double)total.culledCasters / frames << std::setw(12) << std::setprecision(3) << total.updateMs / frames << std::endl;
+	}
+	return true;
+}
+
+//nasumicne kutije jednake gustoce, upiti preko BVH-a i linearnim prolazom uz provjeru jednakih rezultata
+static bool BenchSceneBVH()
+{
+	const unsigned int frustumQueries = 20, rayQueries = 200, boxQueries = 200;
+	JobSystem jobs;
+
+	std::cout << "objects   build ms  refit 1% ms   frustum us (bvh/linear)   ray us (bvh/linear)   aabb us (bvh/linear)  match" << std::endl;
+	bool passed = true;
+	for (unsigned int count = 1000; count <= 1000000; count *= 10)
+	{
+		std::mt19937 random(5);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		float side = std::cbrt((float)count) * 4.0f;
+
+		std::vector<AABB> bounds(count);
+		for (AABB& box : bounds)
+		{
+			glm::vec3 center(unit(random) * side, unit(random) * side, unit(random) * side);
+			glm::vec3 half(0.25f + unit(random) * 0.75f, 0.25f + unit(random) * 0.75f, 0.25f + unit(random) * 0.75f);
+			box = AABB(center - half, center + half);
+		}
+
+		SceneBVH bvh;
+		bvh.Build(bounds, &jobs);
+		double buildMs = bvh.GetStats().buildMs;
+
+		for (unsigned int i = 0; i < count / 100; i++)
+		{
+			std::uint32_t object = (std::uint32_t)(unit(random) * (count - 1));
+			glm::vec3 offset(unit(random) - 0.5f, unit(random) - 0.5f, unit(random) - 0.5f);
+			bounds[object] = AABB(bounds[object].minimum + offset, bounds[object].maximum + offset);
+			bvh.UpdateObject(object, bounds[object]);
+		}
+		bvh.Refit();
+		double refitMs = bvh.GetStats().refitMs;
+
+		bool match = true;
+		std::vector<std::uint32_t> fromBVH, fromScan;
+
+		std::vector<Frustum> frustums;
+		glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, side * 0.3f);
+		for (unsigned int q = 0; q < frustumQueries; q++)
+		{
+			glm::vec3 eye(unit(random) * side, unit(random) * side, unit(random) * side);
+			glm::vec3 direction(unit(random) - 0.5f, unit(random) - 0.5f, unit(random) - 0.5f);
+			frustums.push_back(Frustum::FromMatrix(projection * glm::lookAt(eye, eye + direction, glm::vec3(0.0f, 1.0f, 0.0f))));
+		}
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for (const Frustum& frustum : frustums)
+			bvh.QueryFrustum(frustum, fromBVH);
+		double frustumBVH = ElapsedMs(start) * 1000.0 / frustumQueries;
+
+		start = std::chrono::high_resolution_clock::now();
+		for (const Frustum& frustum : frustums)
+		{
+			for (std::uint32_t i = 0; i < count; i++)
+			{
+				if (frustum.IntersectsAABB(bounds[i].minimum, bounds[i].maximum))
+					fromScan.push_back(i);
+			}
+		}
+		double frustumScan = ElapsedMs(start) * 1000.0 / frustumQueries;
+		std::sort(fromBVH.begin(), fromBVH.end());
+		std::sort(fromScan.begin(), fromScan.end());
+		match = match && fromBVH == fromScan;
+
+		std::vector<glm::vec3> origins, directions;
+		for (unsigned int q = 0; q < rayQueries; q++)
+		{
+			origins.push_back(glm::vec3(unit(random) * side, unit(random) * side, unit(random) * side));
+			directions.push_back(glm::normalize(glm::vec3(unit(random) - 0.5f, unit(random) - 0.5f, unit(random) - 0.5f)));
+		}
+
+		std::vector<float> rayBVH(rayQueries), rayScan(rayQueries, FLT_MAX);
+		start = std::chrono::high_resolution_clock::now();
+		for (unsigned int q = 0; q < rayQueries; q++)
+			rayBVH[q] = bvh.Raycast(origins[q], directions[q]).distance;
+		double raysBVH = ElapsedMs(start) * 1000.0 / rayQueries;
+
+		start = std::chrono::high_resolution_clock::now();
+		for (unsigned int q = 0; q < rayQueries; q++)
+		{
+			glm::vec3 inverse = 1.0f / directions[q];
+			for (std::uint32_t i = 0; i < count; i++)
+			{
+				glm::vec3 t1 = (bounds[i].minimum - origins[q]) * inverse, t2 = (bounds[i].maximum - origins[q]) * inverse;
+				glm::vec3 tNear = glm::min(t1, t2), tFar = glm::max(t1, t2);
+				float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+				float exit = std::min(std::min(tFar.x, tFar.y), tFar.z);
+				if (enter <= exit && enter < rayScan[q])
+					rayScan[q] = enter;
+			}
+		}
+		double raysScan = ElapsedMs(start) * 1000.0 / rayQueries;
+		match = match && rayBVH == rayScan;
+
+		std::vector<AABB> boxes;
+		for (unsigned int q = 0; q < boxQueries; q++)
+		{
+			glm::vec3 center(unit(random) * side, unit(random) * side, unit(random) * side);
+			boxes.push_back(AABB(center - glm::vec3(2.0f), center + glm::vec3(2.0f)));
+		}
+
+		fromBVH.clear();
+		fromScan.clear();
+		start = std::chrono::high_resolution_clock::now();
+		for (const AABB& box : boxes)
+			bvh.QueryAABB(box, fromBVH);
+		double boxesBVH = ElapsedMs(start) * 1000.0 / boxQueries;
+
+		start = std::chrono::high_resolution_clock::now();
+		for (const AABB& box : boxes)
+		{
+			for (std::uint32_t i = 0; i < count; i++)
+			{
+				if (bounds[i].Overlaps(box))
+					fromScan.push_back(i);
+			}
+		}
+		double boxesScan = ElapsedMs(start) * 1000.0 / boxQueries;
+		std::sort(fromBVH.begin(), fromBVH.end());
+		std::sort(fromScan.begin(), fromScan.end());
+		match = match && fromBVH == fromScan;
+
+		std::cout << std::setw(7) << count << std::fixed << std::setprecision(2) << std::setw(11) << buildMs << std::setw(13) << refitMs
+			<< std::setw(14) << frustumBVH << " / " << std::setw(9) << frustumScan
+			<< std::setw(11) << raysBVH << " / " << std::setw(8) << raysScan
+			<< std::setw(11) << boxesBVH << " / " << std::setw(8) << boxesScan
+			<< std::setw(7) << (match ? "yes" : "NO") << std::endl;
+		passed = passed && match;
+	}
+	return passed;
+}
+
+//zrake kamere po plocicama 4x2 da svaki paket od 4 ili 8 zraka bude koherentan
+static void MakeCameraRays(const AABB& bounds, unsigned int width, unsigned int height, std::vector<glm::vec3>& origins, std::vector<glm::vec3>& directions)
+{
+	glm::vec3 center = bounds.Center();
+	float radius = glm::length(bounds.Extent()) * 0.5f;
+	glm::vec3 eye = center + glm::vec3(0.0f, 0.2f, 1.0f) * radius * 1.8f;
+	glm::mat4 inverse = glm::inverse(glm::perspective(glm::radians(60.0f), (float)width / height, 0.1f, 100.0f) *
+		glm::lookAt(eye, center, glm::vec3(0.0f, 1.0f, 0.0f)));
+
+	origins.clear();
+	directions.clear();
+	for (unsigned int tileY = 0; tileY < height; tileY += 2)
+	{
+		for (unsigned int tileX = 0; tileX < width; tileX += 4)
+		{
+			for (unsigned int y = tileY; y < tileY + 2; y++)
+			{
+				for (unsigned int x = tileX; x < tileX + 4; x++)
+				{
+					glm::vec4 point = inverse * glm::vec4((x + 0.5f) / width * 2.0f - 1.0f, 1.0f - (y + 0.5f) / height * 2.0f, 1.0f, 1.0f);
+					origins.push_back(eye);
+					directions.push_back(glm::normalize(glm::vec3(point) / point.w - eye));
+				}
+			}
+		}
+	}
+}
+
+static bool BenchMeshBVH()
+{
+	const unsigned int width = 512, height = 512;
+	const int repeats = 3;
+
+	std::vector<Vertex> vertices;
+	std::vector<int> indices;
+	Mesh::LoadMesh("res/models/dragon.obj", vertices, indices);
+	if (indices.empty())
+	{
+		std::cerr << "MESH BVH BENCHMARK NEEDS res/models/dragon.obj" << std::endl;
+		return false;
+	}
+
+	MeshBVH bvh;
+	bvh.Build(&vertices[0].position, sizeof(Vertex), indices.data(), indices.size());
+	const MeshBVHStats& stats = bvh.GetStats();
+	std::cout << "triangles " << stats.triangles << ", nodes " << stats.nodes << ", depth " << stats.maxDepth
+		<< ", build " << std::fixed << std::setprecision(2) << stats.buildMs << " ms" << std::endl;
+
+	std::vector<glm::vec3> origins, directions;
+	MakeCameraRays(bvh.GetBounds(), width, height, origins, directions);
+	std::size_t count = origins.size();
+
+	//sekundarne zrake iz pogodaka u nasumicnim smjerovima polusfere (AO), nekoherentne
+	std::vector<MeshHit> primary(count);
+	bvh.IntersectRays(origins.data(), directions.data(), count, primary.data(), FLT_MAX, BatchMath::SimdLevel::Scalar);
+	std::mt19937 random(11);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	std::vector<glm::vec3> aoOrigins, aoDirections;
+	for (std::size_t i = 0; i < count; i++)
+	{
+		if (!primary[i].IsHit())
+			continue;
+		const int* triangle = &indices[3 * primary[i].triangle];
+		glm::vec3 p0 = vertices[triangle[0]].position;
+		glm::vec3 normal = glm::normalize(glm::cross(vertices[triangle[1]].position - p0, vertices[triangle[2]].position - p0));
+		if (glm::dot(normal, directions[i]) > 0.0f)
+			normal = -normal;
+		glm::vec3 point = origins[i] + directions[i] * primary[i].distance + normal * 1e-3f;
+		for (int sample = 0; sample < 4; sample++)
+		{
+			glm::vec3 direction(unit(random), unit(random), unit(random));
+			if (glm::dot(direction, normal) < 0.0f)
+				direction = -direction;
+			aoOrigins.push_back(point);
+			aoDirections.push_back(glm::normalize(direction + glm::vec3(1e-4f)));
+		}
+	}
+	std::size_t aoCount = aoOrigins.size();
+	float aoDistance = glm::length(bvh.GetBounds().Extent()) * 0.1f;
+
+	JobSystem jobs;
+	unsigned int threads = jobs.GetThreadCount();
+	const std::uint32_t grain = 1024;
+
+	std::vector<MeshHit> referenceHits(count), hits(count);
+	std::vector<std::uint8_t> referenceOccluded(aoCount), occluded(aoCount);
+
+	std::cout << "level     closest Mrays/s (1 / " << threads << " threads)   any-hit Mrays/s (1 / " << threads << " threads)  match" << std::endl;
+	bool passed = true;
+	const BatchMath::SimdLevel levels[] = { BatchMath::SimdLevel::Scalar, BatchMath::SimdLevel::SSE, BatchMath::SimdLevel::AVX };
+	for (BatchMath::SimdLevel level : levels)
+	{
+		if (level > BatchMath::GetBestSimdLevel())
+			continue;
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int r = 0; r < repeats; r++)
+			bvh.IntersectRays(origins.data(), directions.data(), count, hits.data(), FLT_MAX, level);
+		double closestSingle = count * repeats / (ElapsedMs(start) * 1000.0);
+
+		start = std::chrono::high_resolution_clock::now();
+		for (int r = 0; r < repeats; r++)
+		{
+			jobs.ParallelFor((std::uint32_t)count, grain, [&](std::uint32_t begin, std::uint32_t end)
+			{
+				bvh.IntersectRays(&origins[begin], &directions[begin], end - begin, &hits[begin], FLT_MAX, level);
+			});
+		}
+		double closestParallel = count * repeats / (ElapsedMs(start) * 1000.0);
+
+		start = std::chrono::high_resolution_clock::now();
+		for (int r = 0; r < repeats; r++)
+			bvh.OccludedRays(aoOrigins.data(), aoDirections.data(), aoCount, occluded.data(), aoDistance, level);
+		double anySingle = aoCount * repeats / (ElapsedMs(start) * 1000.0);
+
+		start = std::chrono::high_resolution_clock::now();
+		for (int r = 0; r < repeats; r++)
+		{
+			jobs.ParallelFor((std::uint32_t)aoCount, grain, [&](std::uint32_t begin, std::uint32_t end)
+			{
+				bvh.OccludedRays(&aoOrigins[begin], &aoDirections[begin], end - begin, &occluded[begin], aoDistance, level);
+			});
+		}
+		double anyParallel = aoCount * repeats / (ElapsedMs(start) * 1000.0);
+
+		if (level == BatchMath::SimdLevel::Scalar)
+		{
+			referenceHits = hits;
+			referenceOccluded = occluded;
+		}
+
+		//isti trokut i udaljenost do na zaokruzivanje; sjene moraju biti identicne
+		bool match = referenceOccluded == occluded;
+		for (std::size_t i = 0; i < count && match; i++)
+		{
+			match = hits[i].triangle == referenceHits[i].triangle &&
+				(!hits[i].IsHit() || std::fabs(hits[i].distance - referenceHits[i].distance) <= 1e-4f * referenceHits[i].distance);
+		}
+
+		std::cout << std::left << std::setw(8) << BatchMath::GetSimdLevelName(level) << std::right << std::fixed << std::setprecision(2)
+			<< std::setw(15) << closestSingle << " / " << std::setw(8) << closestParallel
+			<< std::setw(22) << anySingle << " / " << std::setw(8) << anyParallel
+			<< std::setw(12) << (match ? "yes" : "NO") << std::endl;
+		passed = passed && match;
+	}
+	return passed;
+}
+
+static bool BenchLightBaking()
+{
+	std::vector<Vertex> vertices;
+	std::vector<int> indices;
+	Mesh::LoadMesh("res/models/dragon.obj", vertices, indices);
+	if (indices.empty())
+	{
+		std::cerr << "LIGHT BAKING BENCHMARK NEEDS res/models/dragon.obj" << std::endl;
+		return false;
+	}
+
+	//zmaj na podu kako bi donja strana imala sto zaklanjati
+	AABB bounds;
+	for (const Vertex& vertex : vertices)
+		bounds.Expand(vertex.position);
+	float floorY = bounds.minimum.y, floorSize = glm::length(bounds.Extent()) * 2.0f;
+	glm::vec3 center = bounds.Center();
+	std::vector<Vertex> floor = {
+		Vertex(glm::vec3(center.x - floorSize, floorY, center.z - floorSize), glm::vec3(0.0f, 1.0f, 0.0f)),
+		Vertex(glm::vec3(center.x - floorSize, floorY, center.z + floorSize), glm::vec3(0.0f, 1.0f, 0.0f)),
+		Vertex(glm::vec3(center.x + floorSize, floorY, center.z + floorSize), glm::vec3(0.0f, 1.0f, 0.0f)),
+		Vertex(glm::vec3(center.x + floorSize, floorY, center.z - floorSize), glm::vec3(0.0f, 1.0f, 0.0f)),
+	};
+	std::vector<int> floorIndices = { 0, 1, 2, 0, 2, 3 };
+
+	LightBaker baker;
+	baker.AddOccluder(vertices, indices, glm::mat4(1.0f));
+	baker.AddOccluder(floor, floorIndices, glm::mat4(1.0f));
+	baker.BuildOccluders();
+	std::cout << "occluder triangles " << baker.GetOccluders().GetStats().triangles << ", vertices " << vertices.size() << std::endl;
+
+	LightBakeSettings settings;
+	settings.samples = 64;
+	settings.maxDistance = glm::length(bounds.Extent()) * 0.25f;
+	settings.sunColor = glm::vec3(1.0f);
+	settings.sunDirection = glm::vec3(-0.4f, -1.0f, -0.3f);
+
+	unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+	std::vector<glm::vec4> reference, baked;
+	double baseline = 0.0;
+
+	std::cout << "threads        ms   Mrays/s   speedup   mean AO  deterministic" << std::endl;
+	bool passed = true;
+	for (unsigned int threads = 1; ; threads = std::min(threads * 2, maxThreads))
+	{
+		JobSystem jobs(threads);
+		baker.Bake(vertices, glm::mat4(1.0f), settings, baked, &jobs);
+		const LightBakeStats& stats = baker.GetStats();
+		if (threads == 1)
+		{
+			baseline = stats.bakeMs;
+			reference = baked;
+		}
+
+		double meanAO = 0.0;
+		for (const glm::vec4& value : baked)
+			meanAO += value.a;
+		meanAO /= baked.size();
+
+		//isti seed mora dati bitovno isti rezultat bez obzira na raspodjelu po dretvama
+		bool identical = baked == reference;
+		std::cout << std::setw(7) << threads << std::fixed << std::setprecision(2) << std::setw(10) << stats.bakeMs
+			<< std::setw(10) << stats.GetMraysPerSecond() << std::setw(10) << baseline / stats.bakeMs
+			<< std::setw(10) << meanAO << std::setw(15) << (identical ? "yes" : "NO") << std::endl;
+		passed = passed && identical;
+
+		if (threads == maxThreads)
+			break;
+	}
+
+	settings.seed = 2;
+	baker.Bake(vertices, glm::mat4(1.0f), settings, baked, nullptr);
+	std::cout << "different seed changes result: " << (baked != reference ? "yes" : "NO") << std::endl;
+	passed = passed && baked != reference;
+	return passed;
+}
+
+//referentna slika: svaki trokut skalarno nad cijelim svojim pravokutnikom, bez plocica, dretvi i buffera vidljivosti
+//scena mora biti unutar pogleda jer referenca ne reze trokute
+static void RenderReference(const std::vector<Vertex>& vertices, const std::vector<int>& indices, const std::vector<SoftwareDrawUniforms>& draws,
+	const glm::vec3& lightPos, const glm::vec3& lightColor, const glm::vec3& viewPos, unsigned int width, unsigned int height,
+	std::vector<std::uint32_t>& color)
+{
+	std::vector<float> depth((std::size_t)width * height, 1.0f);
+	color.assign((std::size_t)width * height, 0xFF000000u | (77u << 16) | (77u << 8) | 51u);
+
+	for (const SoftwareDrawUniforms& draw : draws)
+	{
+		for (std::size_t t = 0; t < indices.size(); t += 3)
+		{
+			glm::vec3 screen[3], world[3], normal[3];
+			float inverseW[3];
+			for (int v = 0; v < 3; v++)
+			{
+				const Vertex& vertex = vertices[indices[t + v]];
+				glm::vec4 clip = draw.mvp * glm::vec4(vertex.position, 1.0f);
+				inverseW[v] = 1.0f / clip.w;
+				screen[v] = glm::vec3((clip.x * inverseW[v] * 0.5f + 0.5f) * width, (0.5f - clip.y * inverseW[v] * 0.5f) * height,
+					clip.z * inverseW[v] * 0.5f + 0.5f);
+				world[v] = glm::vec3(draw.model * glm::vec4(vertex.position, 1.0f));
+				normal[v] = draw.normalMatrix * vertex.normal;
+			}
+
+			float area = (screen[1].x - screen[0].x) * (screen[2].y - screen[0].y) - (screen[2].x - screen[0].x) * (screen[1].y - screen[0].y);
+			if (area == 0.0f)
+				continue;
+
+			int minX = std::max(0, (int)std::floor(std::min(std::min(screen[0].x, screen[1].x), screen[2].x)));
+			int maxX = std::min((int)width - 1, (int)std::ceil(std::max(std::max(screen[0].x, screen[1].x), screen[2].x)));
+			int minY = std::max(0, (int)std::floor(std::min(std::min(screen[0].y, screen[1].y), screen[2].y)));
+			int maxY = std::min((int)height - 1, (int)std::ceil(std::max(std::max(screen[0].y, screen[1].y), screen[2].y)));
+			for (int y = minY; y <= maxY; y++)
+			{
+				for (int x = minX; x <= maxX; x++)
+				{
+					glm::vec2 p(x + 0.5f, y + 0.5f);
+					float l[3];
+					for (int e = 0; e < 3; e++)
+					{
+						const glm::vec3& a = screen[(e + 1) % 3];
+						const glm::vec3& b = screen[(e + 2) % 3];
+						l[e] = ((b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x)) / area;
+					}
+					if (l[0] < 0.0f || l[1] < 0.0f || l[2] < 0.0f)
+						continue;
+
+					float z = l[0] * screen[0].z + l[1] * screen[1].z + l[2] * screen[2].z;
+					std::size_t pixel = (std::size_t)y * width + x;
+					if (z >= depth[pixel])
+						continue;
+					depth[pixel] = z;
+
+					float w0 = l[0] * inverseW[0], w1 = l[1] * inverseW[1], w2 = l[2] * inverseW[2];
+					float sum = w0 + w1 + w2;
+					glm::vec3 fragPos = (world[0] * w0 + world[1] * w1 + world[2] * w2) / sum;
+					glm::vec3 norm = glm::normalize((normal[0] * w0 + normal[1] * w1 + normal[2] * w2) / sum);
+
+					glm::vec3 lightDir = glm::normalize(lightPos - fragPos);
+					glm::vec3 diffuse = std::max(glm::dot(norm, lightDir), 0.0f) * lightColor;
+					glm::vec3 reflectDir = glm::reflect(-lightDir, norm);
+					float spec = std::pow(std::max(glm::dot(glm::normalize(viewPos - fragPos), reflectDir), 0.0f), 32.0f);
+					glm::vec3 result = (0.1f * lightColor + diffuse + draw.specularStrength * spec * lightColor) * draw.objectColor;
+
+					glm::vec3 c = glm::clamp(result, 0.0f, 1.0f) * 255.0f + 0.5f;
+					color[pixel] = (std::uint32_t)c.r | ((std::uint32_t)c.g << 8) | ((std::uint32_t)c.b << 16) | 0xFF000000u;
+				}
+			}
+		}
+	}
+}
+
+static bool BenchSoftwareRasterizer()
+{
+	const unsigned int width = 1200, height = 1000;
+	const unsigned int frames = 5;
+
+	std::vector<Vertex> vertices;
+	std::vector<int> indices;
+	Mesh::LoadMesh("res/models/dragon.obj", vertices, indices);
+	if (indices.empty())
+	{
+		std::cerr << "SOFTWARE RASTERIZER BENCHMARK NEEDS res/models/dragon.obj" << std::endl;
+		return false;
+	}
+
+	//3x3 zmajeva koji se preklapaju kako bi bilo i prekrivanja i sitnih trokuta
+	glm::vec3 viewPos(0.0f, 0.6f, 3.2f), lightPos(2.0f, 3.0f, 2.0f), lightColor(1.0f, 0.95f, 0.9f);
+	glm::mat4 viewProjection = glm::perspective(glm::radians(45.0f), (float)width / height, 0.1f, 100.0f) *
+		glm::lookAt(viewPos, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	std::vector<SoftwareDrawUniforms> draws;
+	for (int i = 0; i < 9; i++)
+	{
+		SoftwareDrawUniforms draw;
+		draw.model = glm::translate(glm::mat4(1.0f), glm::vec3((i % 3 - 1) * 0.7f, (i / 3 - 1) * 0.45f, -(float)(i % 2) * 0.5f));
+		draw.model = glm::rotate(draw.model, i * 0.7f, glm::vec3(0.0f, 1.0f, 0.0f));
+		draw.mvp = viewProjection * draw.model;
+		draw.normalMatrix = glm::mat3(glm::transpose(glm::inverse(draw.model)));
+		draw.objectColor = glm::vec3(0.4f + 0.07f * i, 0.6f, 1.0f - 0.08f * i);
+		draw.specularStrength = 0.2f + 0.1f * i;
+		draws.push_back(draw);
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+	std::vector<std::uint32_t> reference;
+	RenderReference(vertices, indices, draws, lightPos, lightColor, viewPos, width, height, reference);
+	double referenceMs = ElapsedMs(start);
+	std::cout << draws.size() * indices.size() / 3 << " triangles at " << width << "x" << height
+		<< ", scalar reference " << std::fixed << std::setprecision(1) << referenceMs << " ms" << std::endl;
+
+	//zlatne slike su izlaz ovog benchmarka s jednom dretvom, pregledane i usporedene sa skalarnom referencom
+	//kad se sjencanje namjerno promijeni, nova slika se sprema pored za pregled i zamjenu
+	auto loadGolden = [](const char* path, unsigned int width, unsigned int height, std::vector<std::uint32_t>& golden)
+	{
+		unsigned int goldenWidth = 0, goldenHeight = 0;
+		if (!SoftwareRasterizer::LoadImage(path, goldenWidth, goldenHeight, golden) || goldenWidth != width || goldenHeight != height)
+		{
+			std::cerr << "GOLDEN IMAGE DOES NOT MATCH " << width << "x" << height << ": " << path << std::endl;
+			golden.clear();
+		}
+	};
+	auto checkGolden = [](const SoftwareRasterizer& raster, const char* path, const std::vector<std::uint32_t>& golden, const char* savePath)
+	{
+		ImageDifference difference = SoftwareRasterizer::CompareImages(raster.GetColorBuffer(), golden);
+		bool matches = SoftwareRasterizer::MatchesGolden(difference);
+		if (!matches && raster.SaveImage(savePath))
+			std::cerr << "SOFTWARE RASTERIZER DOES NOT MATCH " << path << ", IMAGE SAVED TO " << savePath << std::endl;
+		return difference;
+	};
+
+	const char* goldenPath = "res/reference/raster.ppm";
+	std::vector<std::uint32_t> golden;
+	loadGolden(goldenPath, width, height, golden);
+
+	unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+	std::vector<std::uint32_t> firstImage;
+	bool passed = true;
+	std::cout << "threads   ms/frame   geometry   raster   Mpix/s   ref PSNR   ref max   golden PSNR   golden off px   golden   same as 1 thread" << std::endl;
+	for (unsigned int threads = 1; ; threads = std::min(threads * 2, maxThreads))
+	{
+		JobSystem jobs(threads);
+		Renderer render(RenderBackend::Software, width, height, &jobs);
+		const SoftwareRasterizer& raster = *render.GetSoftwareRasterizer();
+		render.SetLight(lightPos, lightColor, viewPos);
+
+		start = std::chrono::high_resolution_clock::now();
+		for (unsigned int frame = 0; frame < frames; frame++)
+		{
+			render.Clear();
+			render.BeginMainPass();
+			for (const SoftwareDrawUniforms& draw : draws)
+				render.Draw(vertices, indices, draw);
+			render.EndMainPass();
+		}
+		double ms = ElapsedMs(start) / frames;
+		const SoftwareRasterStats& stats = raster.GetStats();
+
+		if (threads == 1)
+			firstImage = raster.GetColorBuffer();
+		ImageDifference toReference = SoftwareRasterizer::CompareImages(raster.GetColorBuffer(), reference);
+		ImageDifference toGolden = checkGolden(raster, goldenPath, golden, "raster.ppm");
+		bool matches = SoftwareRasterizer::MatchesGolden(toGolden);
+
+		std::cout << std::setw(7) << threads << std::fixed << std::setprecision(2) << std::setw(11) << ms
+			<< std::setw(11) << stats.geometryMs / frames << std::setw(9) << stats.rasterMs / frames
+			<< std::setw(9) << width * height / (ms * 1000.0) << std::setw(11) << toReference.psnr << std::setw(10) << toReference.maxDifference
+			<< std::setw(14) << toGolden.psnr << std::setw(16) << toGolden.differentPixels << std::setw(9) << (matches ? "yes" : "NO")
+			<< std::setw(19) << (raster.GetColorBuffer() == firstImage ? "yes" : "NO") << std::endl;
+		passed = passed && matches && raster.GetColorBuffer() == firstImage;
+
+		if (threads == maxThreads)
+			break;
+	}
+
+	//kamera medu zmajevima: trokuti sijeku blisku ravninu i izlaze iz pojasa pa se provjerava i rezanje, koje skalarna referenca nema
+	const unsigned int clippedWidth = 600, clippedHeight = 500;
+	const char* clippedPath = "res/reference/raster_clipped.ppm";
+	std::vector<std::uint32_t> clippedGolden;
+	loadGolden(clippedPath, clippedWidth, clippedHeight, clippedGolden);
+
+	glm::vec3 nearViewPos(0.05f, 0.02f, 0.2f);
+	glm::mat4 nearViewProjection = glm::perspective(glm::radians(60.0f), (float)clippedWidth / clippedHeight, 0.1f, 100.0f) *
+		glm::lookAt(nearViewPos, glm::vec3(0.0f, -0.1f, -0.5f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+	JobSystem jobs;
+	Renderer render(RenderBackend::Software, clippedWidth, clippedHeight, &jobs);
+	const SoftwareRasterizer& raster = *render.GetSoftwareRasterizer();
+	render.SetLight(lightPos, lightColor, nearViewPos);
+	render.Clear();
+	render.BeginMainPass();
+	for (SoftwareDrawUniforms draw : draws)
+	{
+		draw.mvp = nearViewProjection * draw.model;
+		render.Draw(vertices, indices, draw);
+	}
+	render.EndMainPass();
+
+	ImageDifference toGolden = checkGolden(raster, clippedPath, clippedGolden, "raster_clipped.ppm");
+	std::cout << "near camera " << clippedWidth << "x" << clippedHeight << ": " << raster.GetStats().clippedTriangles << " clipped triangles, golden PSNR "
+		<< std::setprecision(2) << toGolden.psnr << ", off px " << toGolden.differentPixels << ", golden " << (SoftwareRasterizer::MatchesGolden(toGolden) ? "yes" : "NO") << std::endl;
+	passed = passed && SoftwareRasterizer::MatchesGolden(toGolden);
+	return passed;
+}
+
+//kuhanje tekstura iz res/textures u sve blok formate: propusnost kodera, kvaliteta i usteda VRAM-a prema RGBA8 s mipovima
+static bool BenchTextureCooking()
+{
+	const char* paths[] = { "res/textures/container.jpg", "res/textures/HH.png", "res/textures/awesomeface.png" };
+	const TextureFormat formats[] = { TextureFormat::BC1, TextureFormat::BC3, TextureFormat::BC7 };
+
+	JobSystem jobs;
+	TextureCooker cooker(&jobs);
+	std::cout << "threads " << jobs.GetThreadCount() << std::endl;
+	std::cout << "texture                           size  format   levels   Mpix/s   PSNR dB   RGBA8 MB   cooked MB   saved" << std::endl;
+	for (const char* path : paths)
+	{
+		DecodedImage image;
+		if (!ImageDecoder::DecodeFile(path, image))
+		{
+			std::cerr << "TEXTURE COOKING BENCHMARK NEEDS " << path << std::endl;
+			continue;
+		}
+		const std::uint8_t* pixels = image.pixels.data();
+		unsigned int width = image.width, height = image.height;
+
+		for (TextureFormat format : formats)
+		{
+			CookedTexture cooked;
+			cooker.Cook(pixels, width, height, format, cooked);
+			const TextureCookStats& stats = cooker.GetStats();
+
+			std::string size = std::to_string(width) + "x" + std::to_string(height);
+			std::cout << std::left << std::setw(28) << path << std::right << std::setw(11) << size << std::setw(8) << TextureCooker::GetFormatName(format)
+				<< std::setw(9) << stats.levels << std::fixed << std::setprecision(2) << std::setw(9) << stats.GetMpixPerSecond()
+				<< std::setw(10) << stats.psnr << std::setw(11) << stats.uncompressedBytes / (1024.0 * 1024.0)
+				<< std::setw(12) << stats.compressedBytes / (1024.0 * 1024.0)
+				<< std::setw(7) << std::setprecision(0) << 100.0 * stats.GetSavedBytes() / stats.uncompressedBytes << "%" << std::endl;
+		}
+	}
+	return true;
+}
+
+//CPU mip lanac po teksturi: skalarno prema SSE-u i hladno ucitavanje (dekodiranje + mipovi + zapis cachea) prema toplom (citanje .ctex)
+//stari put je dekodiranje pa glGenerateMipmap na GPU-u, pa je stupac decode ono sto topli put vise ne placa
+static bool BenchMipGeneration()
+{
+	const char* paths[] = { "res/textures/container.jpg", "res/textures/HH.png", "res/textures/awesomeface.png" };
+	const int repeats = 5;
+
+	JobSystem jobs;
+	std::cout << "threads " << jobs.GetThreadCount() << ", " << repeats << " repeats" << std::endl;
+	std::cout << "texture                      decode ms  scalar ms     " << BatchMath::GetSimdLevelName(BatchMath::SimdLevel::SSE)
+		<< " ms  speedup  max diff  gamma diff   cold ms   warm ms" << std::endl;
+	for (const char* path : paths)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		DecodedImage image;
+		bool decoded = ImageDecoder::DecodeFile(path, image);
+		double decodeMs = ElapsedMs(start);
+		if (!decoded)
+		{
+			std::cerr << "MIP GENERATION BENCHMARK NEEDS " << path << std::endl;
+			continue;
+		}
+		const std::uint8_t* pixels = image.pixels.data();
+		unsigned int width = image.width, height = image.height;
+
+		CookedTexture scalar, simd, naive;
+		scalar.width = simd.width = naive.width = width;
+		scalar.height = simd.height = naive.height = height;
+
+		start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < repeats; i++)
+			MipGenerator::Generate(pixels, width, height, true, scalar.levels, &jobs, BatchMath::SimdLevel::Scalar);
+		double scalarMs = ElapsedMs(start) / repeats;
+
+		start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < repeats; i++)
+			MipGenerator::Generate(pixels, width, height, true, simd.levels, &jobs, BatchMath::SimdLevel::SSE);
+		double simdMs = ElapsedMs(start) / repeats;
+
+		//koliko se filtriranje u sRGB bajtovima (kao glGenerateMipmap nad RGBA8) razlikuje od linearnog
+		MipGenerator::Generate(pixels, width, height, false, naive.levels, &jobs);
+		int maxDifference = 0, gammaDifference = 0;
+		for (std::size_t level = 1; level < simd.levels.size(); level++)
+		{
+			for (std::size_t i = 0; i < simd.levels[level].data.size(); i++)
+			{
+				maxDifference = std::max(maxDifference, std::abs(simd.levels[level].data[i] - scalar.levels[level].data[i]));
+				gammaDifference = std::max(gammaDifference, std::abs(simd.levels[level].data[i] - naive.levels[level].data[i]));
+			}
+		}
+
+		std::string cachePath = (std::filesystem::temp_directory_path() / "bench_mips.ctex").string();
+		start = std::chrono::high_resolution_clock::now();
+		TextureCooker::Save(cachePath, simd);
+		double coldMs = decodeMs + simdMs + ElapsedMs(start);
+
+		CookedTexture warm;
+		start = std::chrono::high_resolution_clock::now();
+		TextureCooker::Load(cachePath, warm);
+		double warmMs = ElapsedMs(start);
+		std::filesystem::remove(cachePath);
+
+		std::cout << std::left << std::setw(28) << path << std::right << std::fixed << std::setprecision(2)
+			<< std::setw(11) << decodeMs << std::setw(11) << scalarMs << std::setw(10) << simdMs << std::setw(9) << scalarMs / simdMs
+			<< std::setw(10) << maxDifference << std::setw(12) << gammaDifference << std::setw(10) << coldMs << std::setw(10) << warmMs
+			<< (warm.levels.size() == simd.levels.size() ? "" : "  CACHE MISMATCH") << std::endl;
+	}
+	return true;
+}
+
+//skyline paker: popunjenost stranica i cijena umetanja za nasumicne pravokutnike s rubom od 8 texela,
+//zatim TexturePacker nad mjesavinom tekstura iste i razlicite velicine i broj vezanja tekstura za 1000 drawova
+static bool BenchAtlasPacking()
+{
+	const unsigned int pageSize = 2048;
+	const unsigned int padding = 8;
+	const unsigned int counts[] = { 64, 256, 1024 };
+
+	std::mt19937 rng(7);
+	std::uniform_int_distribution<unsigned int> sizeDistribution(16, 256);
+	std::cout << "rects   pages  occupancy   us/insert" << std::endl;
+	for (unsigned int count : counts)
+	{
+		std::vector<std::pair<unsigned int, unsigned int>> sizes(count);
+		for (auto& size : sizes)
+			size = { sizeDistribution(rng) + 2 * padding, sizeDistribution(rng) + 2 * padding };
+		std::sort(sizes.begin(), sizes.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+
+		auto start = std::chrono::high_resolution_clock::now();
+		std::vector<AtlasPacker> pages;
+		for (const auto& size : sizes)
+		{
+			AtlasRect rect;
+			std::size_t page = 0;
+			while (page < pages.size() && !pages[page].Insert(size.first, size.second, rect))
+				page++;
+			if (page == pages.size())
+			{
+				pages.emplace_back(pageSize, pageSize, padding);
+				pages.back().Insert(size.first, size.second, rect);
+			}
+		}
+		double ms = ElapsedMs(start);
+
+		float occupancy = 0.0f;
+		for (const AtlasPacker& page : pages)
+			occupancy += page.GetOccupancy();
+		occupancy /= pages.size();
+
+		std::cout << std::setw(5) << count << std::setw(8) << pages.size() << std::fixed << std::setprecision(1)
+			<< std::setw(10) << occupancy * 100.0f << "%" << std::setprecision(2) << std::setw(12) << ms * 1000.0 / count << std::endl;
+	}
+
+	//32 teksture 256x256 i 16 od 512x512 idu u nizove, 48 neparnih velicina u atlas
+	JobSystem jobs;
+	TexturePacker packer(pageSize, padding, &jobs);
+	std::vector<int> handles;
+	std::vector<std::uint8_t> pixels;
+	auto addTexture = [&](unsigned int width, unsigned int height)
+	{
+		pixels.resize((std::size_t)width * height * 4);
+		for (std::uint8_t& value : pixels)
+			value = (std::uint8_t)rng();
+		handles.push_back(packer.Add(pixels.data(), width, height));
+	};
+	for (int i = 0; i < 32; i++)
+		addTexture(256, 256);
+	for (int i = 0; i < 16; i++)
+		addTexture(512, 512);
+	for (int i = 0; i < 48; i++)
+		addTexture(sizeDistribution(rng) + 40, sizeDistribution(rng) + 40);
+	packer.Pack();
+
+	const TexturePackStats& stats = packer.GetStats();
+	std::cout << "TexturePacker: " << stats.textures << " textures -> " << stats.arrays << " arrays, " << stats.layers << " layers ("
+		<< stats.atlasPages << " atlas pages, " << std::setprecision(1) << stats.atlasOccupancy * 100.0f << "% occupancy), "
+		<< stats.bytes / (1024 * 1024) << " MB, " << std::setprecision(2) << stats.packMs << " ms, " << jobs.GetThreadCount() << " threads" << std::endl;
+
+	//draw po teksturi veze svoju teksturu, a nakon sortiranja po nizu veze se samo kad se niz promijeni
+	const int drawCount = 1000;
+	std::vector<unsigned int> drawArrays(drawCount);
+	for (unsigned int& array : drawArrays)
+		array = packer.GetRegion(handles[rng() % handles.size()]).array;
+	std::sort(drawArrays.begin(), drawArrays.end());
+	unsigned int binds = (unsigned int)(std::unique(drawArrays.begin(), drawArrays.end()) - drawArrays.begin());
+	std::cout << "texture binds for " << drawCount << " draws: " << drawCount << " per draw -> " << binds << " with arrays" << std::endl;
+	return true;
+}
+
+//politika rezidencije bez GL-a: kamera prolazi kroz red od 48 objekata s teksturama 256-1024, svaki frame trazi nivo iz projicirane velicine
+//za vise VRAM budzeta: prosjecni i najveci storage koji bi GL alocirao (uz streamer se realocira tocno toliko), CPU kopija u RAM-u,
+//zahtjevi i izbacivanja nivoa po frameu i udio zahtjeva kojima je trazeni nivo vec bio rezidentan
+static bool BenchTextureResidency()
+{
+	const unsigned int textureCount = 48;
+	const unsigned int frameCount = 600;
+	const float spacing = 4.0f;
+	const std::size_t budgets[] = { 8, 16, 32, 128 };
+
+	std::mt19937 rng(11);
+	std::vector<CookedTexture> textures(textureCount);
+	for (CookedTexture& texture : textures)
+	{
+		texture.width = texture.height = 256u << (rng() % 3);
+		for (unsigned int size = texture.width; ; size /= 2)
+		{
+			TextureLevel level;
+			level.width = level.height = size;
+			level.data.resize((std::size_t)size * size * 4);
+			texture.levels.push_back(std::move(level));
+			if (size == 1)
+				break;
+		}
+	}
+
+	std::cout << "VRAM budget MB   avg VRAM MB   peak VRAM MB   RAM MB   requests/frame   evictions/frame   satisfied" << std::endl;
+	for (std::size_t budget : budgets)
+	{
+		TextureResidency residency(budget * 1024 * 1024, nullptr);
+		std::vector<unsigned int> keys(textureCount);
+		for (unsigned int i = 0; i < textureCount; i++)
+		{
+			CookedTexture copy = textures[i];
+			keys[i] = residency.Register(std::move(copy));
+		}
+
+		double residentSum = 0.0;
+		unsigned long long requests = 0, satisfied = 0;
+		for (unsigned int frame = 0; frame < frameCount; frame++)
+		{
+			glm::vec3 camera(0.0f, 1.5f, -8.0f + spacing * textureCount * frame / frameCount);
+			std::vector<unsigned int> wanted(textureCount);
+			for (unsigned int i = 0; i < textureCount; i++)
+			{
+				glm::vec3 center(i % 2 ? 2.0f : -2.0f, 1.0f, spacing * i);
+				//iza kamere i dalje od 30 jedinica objekt nije vidljiv pa ne trazi nista
+				if (center.z < camera.z || center.z - camera.z > 30.0f)
+				{
+					wanted[i] = ~0u;
+					continue;
+				}
+				float pixels = TextureResidency::GetProjectedSize(center, 1.0f, camera, glm::radians(45.0f), 1000.0f);
+				wanted[i] = TextureResidency::GetRequiredLevel(textures[i].width, textures[i].height, pixels);
+				residency.Request(keys[i], wanted[i]);
+			}
+			residency.Update();
+
+			for (unsigned int i = 0; i < textureCount; i++)
+			{
+				if (wanted[i] == ~0u)
+					continue;
+				requests++;
+				if ((unsigned int)residency.GetResidentLevel(keys[i]) <= wanted[i])
+					satisfied++;
+			}
+			residentSum += residency.GetStats().residentBytes;
+		}
+
+		const TextureResidencyStats& stats = residency.GetStats();
+		const double MB = 1024.0 * 1024.0;
+		std::cout << std::setw(14) << budget << std::fixed << std::setprecision(2) << std::setw(14) << residentSum / frameCount / MB
+			<< std::setw(15) << stats.peakResidentBytes / MB << std::setw(9) << stats.fullBytes / MB
+			<< std::setw(17) << (double)stats.mipRequests / stats.frames << std::setw(18) << (double)stats.evictions / stats.frames
+			<< std::setw(11) << std::setprecision(1) << 100.0 * satisfied / std::max(1ull, requests) << "%" << std::endl;
+	}
+	return true;
+}
+
+//stari put (stbi_load s globalnim okretanjem i 4 kanala, slika po slika) prema ImageDecoderu s 1..N dretvi,
+//zatim kerneli pretvorbe u RGBA8 skalarno prema SSE2 nad sintetickom slikom 2048x2048
+static bool BenchImageDecode()
+{
+	const char* sources[] = { "res/textures/container.jpg", "res/textures/HH.png", "res/textures/awesomeface.png" };
+	const int copies = 4;
+	std::vector<std::string> paths;
+	for (int i = 0; i < copies; i++)
+		paths.insert(paths.end(), std::begin(sources), std::end(sources));
+
+	auto start = std::chrono::high_resolution_clock::now();
+	std::uint64_t pixels = 0;
+	stbi_set_flip_vertically_on_load(true);
+	for (const std::string& path : paths)
+	{
+		int width = 0, height = 0, channels = 0;
+		unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 4);
+		if (!data)
+		{
+			std::cerr << "IMAGE DECODE BENCHMARK NEEDS " << path << std::endl;
+			stbi_set_flip_vertically_on_load(false);
+			return false;
+		}
+		pixels += (std::uint64_t)width * height;
+		stbi_image_free(data);
+	}
+	stbi_set_flip_vertically_on_load(false);
+	double baselineMs = ElapsedMs(start);
+
+	std::cout << paths.size() << " images, " << pixels / 1000000.0 << " Mpix" << std::endl;
+	std::cout << "path              threads   wall ms    Mpix/s   Mpix/s/core   decode ms   convert ms" << std::endl;
+	std::cout << std::left << std::setw(18) << "stbi_load RGBA" << std::right << std::setw(7) << 1 << std::fixed << std::setprecision(2)
+		<< std::setw(10) << baselineMs << std::setw(10) << pixels / (baselineMs * 1000.0) << std::setw(14) << pixels / (baselineMs * 1000.0) << std::endl;
+
+	unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+	for (unsigned int threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		JobSystem jobs(threads);
+		ImageDecoder decoder(&jobs);
+		std::vector<DecodedImage> images;
+		decoder.Decode(paths, images);
+		const ImageDecodeStats& stats = decoder.GetStats();
+		std::cout << std::left << std::setw(18) << "ImageDecoder" << std::right << std::setw(7) << stats.threads << std::setw(10) << stats.wallMs
+			<< std::setw(10) << stats.GetMpixPerSecond() << std::setw(14) << stats.GetMpixPerSecondPerCore()
+			<< std::setw(12) << stats.decodeMs << std::setw(13) << stats.convertMs << std::endl;
+	}
+
+	const unsigned int size = 2048;
+	const int repeats = 5;
+	std::mt19937 rng(5);
+	std::vector<std::uint8_t> source((std::size_t)size * size * 4);
+	for (std::uint8_t& value : source)
+		value = (std::uint8_t)rng();
+	std::vector<std::uint8_t> scalar((std::size_t)size * size * 4), simd(scalar.size());
+
+	std::cout << "channels  premultiply   scalar Mpix/s     SSE2 Mpix/s   speedup   match" << std::endl;
+	bool passed = true;
+	for (unsigned int channels = 1; channels <= 4; channels++)
+	{
+		for (int premultiply = 0; premultiply < 2; premultiply++)
+		{
+			if (premultiply && (channels == 1 || channels == 3))
+				continue;
+
+			double ms[2];
+			std::vector<std::uint8_t>* targets[2] = { &scalar, &simd };
+			const BatchMath::SimdLevel levels[2] = { BatchMath::SimdLevel::Scalar, BatchMath::SimdLevel::SSE };
+			for (int i = 0; i < 2; i++)
+			{
+				start = std::chrono::high_resolution_clock::now();
+				for (int r = 0; r < repeats; r++)
+					ImageDecoder::ConvertToRGBA8(source.data(), channels, size, size, targets[i]->data(), true, premultiply != 0, levels[i]);
+				ms[i] = ElapsedMs(start) / repeats;
+			}
+
+			double mpix = size * size / 1000000.0;
+			std::cout << std::setw(8) << channels << std::setw(13) << (premultiply ? "yes" : "no") << std::setw(16) << mpix / (ms[0] / 1000.0)
+				<< std::setw(16) << mpix / (ms[1] / 1000.0) << std::setw(10) << ms[0] / ms[1] << std::setw(8) << (scalar == simd ? "yes" : "NO") << std::endl;
+			passed = passed && scalar == simd;
+		}
+	}
+	return passed;
+}
+
+//VirtualPageTable bez GPU-a: sinteticki feedback 160x90 (ekran 1280x720 / 8) kamere koja gleda ravninu pod kutom
+//i klizi i zumira preko virtualne teksture 32768x32768, za nekoliko velicina fizickog cachea
+static bool BenchVirtualTexture()
+{
+	const unsigned int virtualSize = 32768, pageSize = 128, uploadsPerFrame = 16;
+	const unsigned int feedbackWidth = 160, feedbackHeight = 90, divisor = 8;
+	const int frames = 600;
+	std::vector<std::uint32_t> feedback((std::size_t)feedbackWidth * feedbackHeight);
+
+	std::cout << "virtual " << virtualSize << "x" << virtualSize << ", page " << pageSize << ", feedback " << feedbackWidth << "x" << feedbackHeight
+		<< ", " << uploadsPerFrame << " uploads/frame, " << frames << " frames" << std::endl;
+	std::cout << "cache slots   cache MB   feedback ms   indirection ms   pages/frame   uploads/frame   evictions/frame   hit rate" << std::endl;
+	for (unsigned int cacheSize : { 8u, 16u, 32u, 64u })
+	{
+		VirtualPageTable table(virtualSize, virtualSize, pageSize, cacheSize, uploadsPerFrame);
+		double processMs = 0.0, indirectionMs = 0.0;
+		unsigned long long requested = 0, missing = 0;
+		for (int frame = 0; frame < frames; frame++)
+		{
+			//sredina pogleda klizi po krugu, sirina pogleda u uv-u se mijenja od 1/64 do 1/4 teksture
+			float t = frame / (float)frames * 2.0f * glm::pi<float>();
+			float centerU = 0.5f + 0.05f * std::cos(t), centerV = 0.5f + 0.05f * std::sin(t);
+			float extent = std::exp2(-4.0f - 2.0f * (1.0f + std::sin(3.0f * t)));
+			for (unsigned int y = 0; y < feedbackHeight; y++)
+			{
+				//ravnina pod kutom: gornji redovi su dalje pa pokrivaju vise teksture
+				float depth = 0.5f + 1.5f * (1.0f - (y + 0.5f) / feedbackHeight);
+				float rowExtent = extent * depth;
+				float texelsPerPixel = rowExtent * virtualSize / (feedbackWidth * divisor);
+				unsigned int level = (unsigned int)std::min(std::max(std::floor(std::log2(std::max(texelsPerPixel, 1.0f))), 0.0f), (float)table.GetLevelCount() - 1);
+				float v = centerV + (depth - 1.0f) * extent;
+				for (unsigned int x = 0; x < feedbackWidth; x++)
+				{
+					float u = centerU + ((x + 0.5f) / feedbackWidth - 0.5f) * rowExtent;
+					VirtualPage page;
+					page.level = level;
+					page.x = std::min((unsigned int)(std::min(std::max(u, 0.0f), 1.0f) * virtualSize) >> level, (virtualSize >> level) - 1) / pageSize;
+					page.y = std::min((unsigned int)(std::min(std::max(v, 0.0f), 1.0f) * virtualSize) >> level, (virtualSize >> level) - 1) / pageSize;
+					feedback[(std::size_t)y * feedbackWidth + x] = page.Encode();
+				}
+			}
+
+			table.ProcessFeedback(feedback.data(), feedback.size());
+			processMs += table.GetStats().lastProcessMs;
+			requested += table.GetStats().requestedPages;
+			missing += table.GetStats().missingPages;
+
+			auto start = std::chrono::high_resolution_clock::now();
+			table.UpdateIndirection();
+			indirectionMs += ElapsedMs(start);
+		}
+
+		const VirtualTextureStats& stats = table.GetStats();
+		unsigned int slots = cacheSize * cacheSize;
+		double cacheMB = (double)slots * pageSize * pageSize * 4 / (1024.0 * 1024.0);
+		std::cout << std::fixed << std::setprecision(3) << std::setw(11) << slots << std::setw(11) << std::setprecision(1) << cacheMB
+			<< std::setprecision(3) << std::setw(14) << processMs / frames << std::setw(17) << indirectionMs / frames
+			<< std::setprecision(1) << std::setw(14) << (double)requested / frames << std::setw(16) << (double)stats.totalUploads / frames
+			<< std::setw(18) << (double)stats.totalEvictions / frames
+			<< std::setw(10) << 100.0 * (requested - missing) / std::max(1ull, requested) << "%" << std::endl;
+	}
+	return true;
+}
+
+//pojedinacne datoteke iz res/ prema packu bez kompresije i s LZ kompresijom: samo citanje svih bajtova i puno ucitavanje
+//(izvor shadera, OBJ parser, dekodiranje slika), hladno nakon izbacivanja datoteka iz page cachea i toplo
+static bool BenchAssetPack()
+{
+	std::vector<std::string> paths;
+	std::error_code error;
+	for (const auto& item : std::filesystem::recursive_directory_iterator("res", error))
+	{
+		std::string extension = item.path().extension().string();
+		if (item.is_regular_file() && (extension == ".glsl" || extension == ".obj" || extension == ".png" || extension == ".jpg"))
+			paths.push_back(AssetPack::NormalizePath(item.path().generic_string()));
+	}
+	if (paths.empty())
+	{
+		std::cerr << "ASSET PACK BENCHMARK NEEDS res/" << std::endl;
+		return false;
+	}
+
+	JobSystem jobs;
+	const std::string packPaths[2] = {
+		(std::filesystem::temp_directory_path() / "bench_raw.pak").string(),
+		(std::filesystem::temp_directory_path() / "bench_lz.pak").string() };
+	for (int i = 0; i < 2; i++)
+	{
+		AssetPackBuildOptions options;
+		options.compress = i == 1;
+		AssetPackBuildStats stats;
+		if (!AssetPack::Build("res", packPaths[i], options, stats, &jobs))
+			return false;
+		std::cout << (i == 1 ? "LZ pack: " : "raw pack: ") << stats.files << " files, " << stats.compressedFiles << " compressed, "
+			<< stats.rawBytes / 1024 << " KB -> " << stats.packBytes / 1024 << " KB, built in " << std::fixed << std::setprecision(1) << stats.totalMs << " ms" << std::endl;
+	}
+
+	bool canDrop = MappedFile::DropPageCache(paths[0]);
+	if (!canDrop)
+		std::cout << "page cache cannot be dropped here, cold runs are warm" << std::endl;
+
+	//mapirane stranice se ucitavaju tek pri pristupu pa se dira svaki bajt
+	std::uint64_t checksum = 0;
+	auto readAll = [&]()
+	{
+		for (const std::string& path : paths)
+		{
+			FileData file;
+			if (!FileSystem::Read(path, file))
+				continue;
+			for (std::size_t i = 0; i < file.GetSize(); i += 64)
+				checksum += file.GetData()[i];
+		}
+	};
+	auto loadAll = [&]()
+	{
+		for (const std::string& path : paths)
+		{
+			std::string extension = std::filesystem::path(path).extension().string();
+			if (extension == ".glsl")
+			{
+				FileData file;
+				FileSystem::Read(path, file);
+				checksum += file.ToString().size();
+			}
+			else if (extension == ".obj")
+			{
+				std::vector<Vertex> vertices;
+				std::vector<int> indices;
+				Mesh::LoadMesh(path, vertices, indices);
+				checksum += indices.size();
+			}
+			else
+			{
+				DecodedImage image;
+				ImageDecoder::DecodeFile(path, image);
+				checksum += image.pixels.size();
+			}
+		}
+	};
+
+	//montiranje packa je dio mjerenja jer ga plati i pokretanje
+	const int warmRepeats = 5;
+	auto measure = [&](int source, const std::function<void()>& work, bool cold)
+	{
+		double total = 0.0;
+		int repeats = cold ? 1 : warmRepeats;
+		for (int r = 0; r < repeats; r++)
+		{
+			FileSystem::UnmountAll();
+			if (cold)
+			{
+				for (const std::string& path : paths)
+					MappedFile::DropPageCache(path);
+				MappedFile::DropPageCache(packPaths[0]);
+				MappedFile::DropPageCache(packPaths[1]);
+			}
+
+			auto start = std::chrono::high_resolution_clock::now();
+			if (source > 0)
+				FileSystem::Mount(packPaths[source - 1]);
+			work();
+			total += ElapsedMs(start);
+		}
+		FileSystem::UnmountAll();
+		return total / repeats;
+	};
+
+	std::cout << paths.size() << " assets" << std::endl;
+	std::cout << "source          read cold ms   read warm ms   load cold ms   load warm ms" << std::endl;
+	const char* names[3] = { "loose files", "raw pack", "LZ pack" };
+	for (int source = 0; source < 3; source++)
+	{
+		double readCold = measure(source, readAll, true);
+		double readWarm = measure(source, readAll, false);
+		double loadCold = measure(source, loadAll, true);
+		double loadWarm = measure(source, loadAll, false);
+		std::cout << std::left << std::setw(16) << names[source] << std::right << std::setprecision(2) << std::setw(13) << readCold
+			<< std::setw(15) << readWarm << std::setw(15) << loadCold << std::setw(15) << loadWarm << std::endl;
+	}
+
+	std::filesystem::remove(packPaths[0], error);
+	std::filesystem::remove(packPaths[1], error);
+	if (checksum == 0)
+		std::cout << "nothing was read" << std::endl;
+	return true;
+}
+
+//dosadasnje citanje ifstreamom datoteku po datoteku prema AsyncIO (pread dretve i io_uring) za vise dubina reda,
+//nad 48 sintetickih datoteka od 64 KB do 4 MB, hladno (posix_fadvise DONTNEED prije svakog prolaza) i toplo;
+//zatim rasponi unosa AssetPacka i dekodiranje slika s citanjem kroz AsyncIO
+static bool BenchAsyncIO()
+{
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "bench_asyncio";
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+
+	std::mt19937 rng(9);
+	std::vector<std::string> paths;
+	std::uint64_t totalBytes = 0;
+	for (int i = 0; i < 48; i++)
+	{
+		std::size_t size = (std::size_t)(65536.0 * std::exp2(6.0 * (rng() % 1000) / 1000.0));
+		std::string path = (directory / ("file" + std::to_string(i) + ".bin")).string();
+		if (std::filesystem::file_size(path, error) != size)
+		{
+			std::mt19937 content(i);
+			std::vector<std::uint8_t> data(size);
+			for (std::uint8_t& value : data)
+				value = (std::uint8_t)content();
+			std::ofstream(path, std::ios::binary).write((const char*)data.data(), data.size());
+		}
+		paths.push_back(path);
+		totalBytes += size;
+	}
+
+	bool canDrop = MappedFile::DropPageCache(paths[0]);
+	std::cout << paths.size() << " files, " << totalBytes / (1024 * 1024) << " MB, io_uring " << (AsyncIO::IsIoUringSupported() ? "available" : "not available")
+		<< (canDrop ? "" : ", page cache cannot be dropped so cold runs are warm") << std::endl;
+	auto dropAll = [&]()
+	{
+		for (const std::string& path : paths)
+			MappedFile::DropPageCache(path);
+	};
+
+	std::uint64_t checksum = 0;
+	auto streamRead = [&]()
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		for (const std::string& path : paths)
+		{
+			std::ifstream file(path, std::ios::binary | std::ios::ate);
+			std::vector<std::uint8_t> data((std::size_t)file.tellg());
+			file.seekg(0);
+			file.read((char*)data.data(), data.size());
+			checksum += data[data.size() / 2];
+		}
+		return ElapsedMs(start);
+	};
+
+	std::cout << "reader          depth   cold MB/s   cold IOPS   warm MB/s   submits" << std::endl;
+	dropAll();
+	double coldMs = streamRead();
+	double warmMs = streamRead();
+	std::cout << std::left << std::setw(16) << "ifstream" << std::right << std::setw(5) << 1 << std::fixed << std::setprecision(1)
+		<< std::setw(12) << totalBytes / (coldMs * 1000.0) << std::setw(12) << "-" << std::setw(12) << totalBytes / (warmMs * 1000.0)
+		<< std::setw(10) << paths.size() << std::endl;
+
+	std::vector<AsyncReadRequest> requests(paths.size());
+	for (std::size_t i = 0; i < paths.size(); i++)
+		requests[i].path = paths[i];
+	auto onComplete = [&](std::size_t, std::vector<std::uint8_t>& data) { checksum += data[data.size() / 2]; };
+
+	for (AsyncIOBackend backend : { AsyncIOBackend::ThreadPool, AsyncIOBackend::IoUring })
+	{
+		if (backend == AsyncIOBackend::IoUring && !AsyncIO::IsIoUringSupported())
+			continue;
+
+		for (unsigned int depth : { 1u, 4u, 16u, 32u })
+		{
+			AsyncIOSettings settings;
+			settings.backend = backend;
+			settings.queueDepth = depth;
+			AsyncIO io(settings);
+
+			dropAll();
+			io.Read(requests, onComplete);
+			AsyncIOStats cold = io.GetStats();
+			io.Read(requests, onComplete);
+			AsyncIOStats warm = io.GetStats();
+			std::cout << std::left << std::setw(16) << AsyncIO::GetBackendName(io.GetBackend()) << std::right << std::setw(5) << depth
+				<< std::setw(12) << cold.GetMBPerSecond() << std::setw(12) << std::setprecision(0) << cold.GetIOPS() << std::setprecision(1)
+				<< std::setw(12) << warm.GetMBPerSecond() << std::setw(10) << cold.submitCalls << std::endl;
+		}
+	}
+
+	//unosi packa kao rasponi jedne datoteke
+	const std::string packPath = (directory / "assets.pak").string();
+	AssetPackBuildOptions packOptions;
+	packOptions.compress = false;
+	AssetPackBuildStats packStats;
+	AssetPack pack;
+	if (AssetPack::Build("res", packPath, packOptions, packStats) && pack.Open(packPath))
+	{
+		std::vector<AsyncReadRequest> ranges(pack.GetEntryCount());
+		for (std::uint32_t i = 0; i < pack.GetEntryCount(); i++)
+		{
+			ranges[i].path = packPath;
+			ranges[i].offset = pack.GetEntry(i).offset;
+			ranges[i].size = pack.GetEntry(i).size;
+		}
+
+		AsyncIOSettings settings;
+		settings.queueDepth = 16;
+		AsyncIO io(settings);
+		MappedFile::DropPageCache(packPath);
+		io.Read(ranges, onComplete);
+		AsyncIOStats cold = io.GetStats();
+		io.Read(ranges, onComplete);
+		std::cout << pack.GetEntryCount() << " pack ranges through " << AsyncIO::GetBackendName(io.GetBackend()) << " depth 16: cold "
+			<< cold.GetMBPerSecond() << " MB/s, warm " << io.GetStats().GetMBPerSecond() << " MB/s" << std::endl;
+	}
+
+	//dekodiranje slika iz res/textures bez i s AsyncIO, hladno
+	std::vector<std::string> images;
+	for (const auto& entry : std::filesystem::directory_iterator("res/textures", error))
+	{
+		std::string extension = entry.path().extension().string();
+		if (extension == ".png" || extension == ".jpg")
+			images.push_back(entry.path().generic_string());
+	}
+	JobSystem jobs;
+	AsyncIO io;
+	for (int useIO = 0; useIO < 2 && !images.empty(); useIO++)
+	{
+		for (const std::string& path : images)
+			MappedFile::DropPageCache(path);
+		ImageDecoder decoder(&jobs, useIO ? &io : nullptr);
+		std::vector<DecodedImage> decoded;
+		decoder.Decode(images, decoded);
+		std::cout << "decode " << images.size() << " images cold " << (useIO ? "with AsyncIO: " : "reading in jobs: ") << decoder.GetStats().wallMs << " ms" << std::endl;
+	}
+
+	std::filesystem::remove(packPath, error);
+	if (checksum == 0)
+		std::cout << "nothing was read" << std::endl;
+	return true;
+}
+
+//kuhanje dragon.obj: spajanje vrhova, Forsyth redoslijed za vise velicina cachea (ACMR ne smije porasti), greska kvantizacije
+//prema koraku extent/65535, .cmesh mora se vratiti nepromijenjen, a njegovo ucitavanje se usporeduje s parserom OBJ-a;
+//zatim AssetCooker dvaput nad istim stablom, gdje drugo kuhanje mora sve uzeti iz cachea
+static bool BenchMeshCooking()
+{
+	std::vector<Vertex> vertices;
+	std::vector<int> indices;
+	auto start = std::chrono::high_resolution_clock::now();
+	Mesh::LoadMesh("res/models/dragon.obj", vertices, indices);
+	double objMs = ElapsedMs(start);
+	if (indices.size() < 3)
+	{
+		std::cerr << "MESH COOKING BENCHMARK NEEDS res/models/dragon.obj" << std::endl;
+		return false;
+	}
+	bool passed = true;
+
+	//dragon.obj nema vn pa svaki trokut ima svoju normalu: tek spajanje po kutu daje dijeljene vrhove za cache
+	MeshCookSettings meshSettings;
+	meshSettings.normalWeldAngle = 60.0f;
+	std::vector<Vertex> welded;
+	std::vector<std::uint32_t> weldedIndices;
+	for (float angle : { 0.0f, meshSettings.normalWeldAngle })
+	{
+		start = std::chrono::high_resolution_clock::now();
+		MeshCooker::Weld(vertices, indices, angle, welded, weldedIndices);
+		double weldMs = ElapsedMs(start);
+		std::cout << "weld angle " << std::fixed << std::setprecision(0) << angle << ": " << vertices.size() << " -> " << welded.size()
+			<< " vertices, " << weldedIndices.size() / 3 << " triangles, " << std::setprecision(2) << weldMs << " ms" << std::endl;
+	}
+
+	std::cout << "cache   ACMR before   ACMR after   optimize ms   not worse" << std::endl;
+	for (unsigned int cacheSize : { 8u, 16u, 32u, 64u })
+	{
+		std::vector<std::uint32_t> optimized = weldedIndices;
+		float before = MeshCooker::ComputeACMR(optimized, welded.size(), cacheSize);
+		start = std::chrono::high_resolution_clock::now();
+		MeshCooker::OptimizeVertexCache(optimized, welded.size(), cacheSize);
+		double optimizeMs = ElapsedMs(start);
+		float after = MeshCooker::ComputeACMR(optimized, welded.size(), cacheSize);
+
+		bool match = after <= before;
+		std::cout << std::setw(5) << cacheSize << std::setprecision(3) << std::setw(14) << before << std::setw(13) << after
+			<< std::setprecision(2) << std::setw(14) << optimizeMs << std::setw(12) << (match ? "yes" : "NO") << std::endl;
+		passed = passed && match;
+	}
+
+	//lround daje najvise pola koraka po osi, cijeli korak ostavlja mjesta za zaokruzivanje floata u Dequantize
+	CookedMesh quantized;
+	MeshCooker::Quantize(welded, quantized);
+	std::vector<Vertex> restored;
+	MeshCooker::Dequantize(quantized, restored);
+	glm::vec3 step = quantized.bounds.Extent() / 65535.0f;
+	glm::vec3 maxError(0.0f);
+	for (std::size_t i = 0; i < welded.size(); i++)
+		maxError = glm::max(maxError, glm::abs(restored[i].position - welded[i].position));
+	bool quantizeMatch = restored.size() == welded.size() && glm::all(glm::lessThanEqual(maxError, step));
+	std::cout << "max position error " << std::scientific << std::setprecision(2) << maxError.x << " " << maxError.y << " " << maxError.z
+		<< ", step " << step.x << " " << step.y << " " << step.z << (quantizeMatch ? "" : "  ERROR ABOVE STEP") << std::endl;
+	passed = passed && quantizeMatch;
+
+	CookedMesh cooked;
+	MeshCookStats cookStats;
+	start = std::chrono::high_resolution_clock::now();
+	MeshCooker::Cook(vertices, indices, cooked, cookStats, meshSettings);
+	double cookMs = ElapsedMs(start);
+
+	std::error_code error;
+	std::string cmeshPath = (std::filesystem::temp_directory_path() / "bench_dragon.obj.cmesh").string();
+	CookedMesh loaded;
+	bool roundTrip = MeshCooker::Save(cmeshPath, cooked) && MeshCooker::Load(cmeshPath, loaded) &&
+		loaded.bounds.minimum == cooked.bounds.minimum && loaded.bounds.maximum == cooked.bounds.maximum &&
+		loaded.indices == cooked.indices && loaded.vertices.size() == cooked.vertices.size() &&
+		std::memcmp(loaded.vertices.data(), cooked.vertices.data(), cooked.vertices.size() * sizeof(QuantizedVertex)) == 0;
+
+	std::vector<Vertex> cookedVertices;
+	std::vector<int> cookedIndices;
+	start = std::chrono::high_resolution_clock::now();
+	Mesh::LoadMesh(cmeshPath, cookedVertices, cookedIndices);
+	double cmeshMs = ElapsedMs(start);
+	std::filesystem::remove(cmeshPath, error);
+	std::cout << std::fixed << std::setprecision(2) << "cook " << cookMs << " ms, load .obj " << objMs << " ms, load .cmesh " << cmeshMs
+		<< " ms, " << cookStats.inputVertices * sizeof(Vertex) / 1024 << " KB -> " << cookStats.vertices * sizeof(QuantizedVertex) / 1024
+		<< " KB of vertices, round trip " << (roundTrip ? "exact" : "CHANGED") << std::endl;
+	passed = passed && roundTrip;
+
+	//kopija modela, shadera i tekstura; RGBA8 da kuhanje tekstura ne dominira
+	std::filesystem::path cookRoot = std::filesystem::temp_directory_path() / "bench_cook";
+	std::filesystem::remove_all(cookRoot, error);
+	std::filesystem::create_directories(cookRoot / "res", error);
+	for (const char* directory : { "models", "shaders", "textures" })
+		std::filesystem::copy(std::filesystem::path("res") / directory, cookRoot / "res" / directory, std::filesystem::copy_options::recursive, error);
+
+	AssetCookSettings settings;
+	settings.textureFormat = TextureFormat::RGBA8;
+	settings.mesh = meshSettings;
+	JobSystem jobs;
+	AssetCooker cooker(&jobs);
+	std::cout << "pass     assets   cooked   cache hits   failed       ms" << std::endl;
+	for (int pass = 0; pass < 2; pass++)
+	{
+		bool cookedAll = cooker.Cook((cookRoot / "res").string(), (cookRoot / "cooked").string(), settings);
+		const AssetCookStats& stats = cooker.GetStats();
+		bool match = cookedAll && stats.assets > 0 && stats.failed == 0 &&
+			(pass == 0 ? stats.cooked == stats.assets : stats.cacheHits == stats.assets && stats.cooked == 0);
+		std::cout << std::left << std::setw(6) << (pass == 0 ? "cold" : "again") << std::right << std::setw(9) << stats.assets
+			<< std::setw(9) << stats.cooked << std::setw(13) << stats.cacheHits << std::setw(9) << stats.failed
+			<< std::setw(9) << stats.totalMs << (match ? "" : "  - UNEXPECTED") << std::endl;
+		passed = passed && match;
+	}
+	std::filesystem::remove_all(cookRoot, error);
+	return passed;
+}
+
+static const BenchmarkEntry s_Benchmarks[] = {
+	{ "jobs", BenchJobScaling },
+	{ "commands", BenchCommandRecording },
+	{ "scene", BenchSceneUpdate },
+	{ "batchmath", BenchBatchMath },
+	{ "clustered", BenchClusteredLighting },
+	{ "rendergraph", BenchRenderGraph },
+	{ "shadows", BenchShadowCaching },
+	{ "bvh", BenchSceneBVH },
+	{ "meshbvh", BenchMeshBVH },
+	{ "bake", BenchLightBaking },
+	{ "raster", BenchSoftwareRasterizer },
+	{ "texcook", BenchTextureCooking },
+	{ "mips", BenchMipGeneration },
+	{ "atlas", BenchAtlasPacking },
+	{ "residency", BenchTextureResidency },
+	{ "decode", BenchImageDecode },
+	{ "vt", BenchVirtualTexture },
+	{ "pack", BenchAssetPack },
+	{ "asyncio", BenchAsyncIO },
+	{ "meshcook", BenchMeshCooking },
+};
+
+int RunBenchmarks(const std::string& name)
+{
+	bool found = false;
+	unsigned int failed = 0;
+	for (const BenchmarkEntry& entry : s_Benchmarks)
+	{
+		if (!name.empty() && name != entry.name)
+			continue;
+
+		std::cout << "---- " << entry.name << " ----" << std::endl;
+		if (!entry.function())
+		{
+			std::cerr << "BENCHMARK SELF-CHECK FAILED: " << entry.name << std::endl;
+			failed++;
+		}
+		found = true;
+	}
+
+	if (!found)
+	{
+		std::cerr << "UNKNOWN BENCHMARK: " << name << std::endl;
+		return 1;
+	}
+	return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <string>
+
+//pokretanje: <program> --bench [ime], bez imena se pokrecu sva mjerenja
+//vraca 1 ako neko mjerenje ne postoji ili mu samoprovjera (usporedba s referencom, zlatnom slikom) ne prode
+int RunBenchmarks(const std::string& name);
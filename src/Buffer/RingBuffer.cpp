@@ -0,0 +1,166 @@
+#include "RingBuffer.h"
+
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+
+static std::size_t AlignUp(std::size_t value, std::size_t alignment)
+{
+	if (alignment <= 1)
+		return value;
+	return ((value + alignment - 1) / alignment) * alignment;
+}
+
+RingBuffer::RingBuffer(std::size_t bytesPerFrame)
+	: m_RenderID(0), m_Mapped(nullptr), m_FrameSize(0), m_Head(0), m_FrameIndex(0),
+	m_UniformAlignment(256), m_StorageAlignment(256)
+{
+	for (unsigned int i = 0; i < FRAME_COUNT; i++)
+		m_Fences[i] = nullptr;
+
+	GLint uniformAlignment = 0, storageAlignment = 0;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+	if (uniformAlignment > 0)
+		m_UniformAlignment = uniformAlignment;
+	if (storageAlignment > 0)
+		m_StorageAlignment = storageAlignment;
+
+	//svaka regija pocinje na granici koja zadovoljava sve vrste bindanja
+	m_FrameSize = AlignUp(bytesPerFrame, std::max(m_UniformAlignment, m_StorageAlignment));
+
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	glGenBuffers(1, &m_RenderID);
+	glBindBuffer(GL_ARRAY_BUFFER, m_RenderID);
+	glBufferStorage(GL_ARRAY_BUFFER, m_FrameSize * FRAME_COUNT, nullptr, flags);
+	m_Mapped = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, m_FrameSize * FRAME_COUNT, flags);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	if (!m_Mapped)
+		std::cerr << "RING BUFFER COULD NOT BE MAPPED" << std::endl;
+}
+
+RingBuffer::~RingBuffer()
+{
+	for (unsigned int i = 0; i < FRAME_COUNT; i++)
+	{
+		if (m_Fences[i])
+			glDeleteSync(m_Fences[i]);
+	}
+
+	if (m_Mapped)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, m_RenderID);
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+	glDeleteBuffers(1, &m_RenderID);
+}
+
+void RingBuffer::BeginFrame()
+{
+	WaitForFence(m_FrameIndex);
+
+	m_Head = 0;
+	m_Stats.bytesThisFrame = 0;
+}
+
+void RingBuffer::EndFrame()
+{
+	m_Fences[m_FrameIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	m_Stats.frames++;
+	m_Stats.peakBytesPerFrame = std::max(m_Stats.peakBytesPerFrame, m_Stats.bytesThisFrame);
+
+	m_FrameIndex = (m_FrameIndex + 1) % FRAME_COUNT;
+}
+
+void RingBuffer::WaitForFence(unsigned int frame)
+{
+	GLsync fence = m_Fences[frame];
+	m_Stats.lastFenceWaitMs = 0.0;
+	if (!fence)
+		return;
+
+	//fence koji je vec signaliziran ne predstavlja zastoj
+	GLenum result = glClientWaitSync(fence, 0, 0);
+	if (result == GL_TIMEOUT_EXPIRED)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+
+		GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+		do
+		{
+			result = glClientWaitSync(fence, waitFlags, 1000000);
+			waitFlags = 0;
+		} while (result == GL_TIMEOUT_EXPIRED);
+
+		std::chrono::duration<double, std::milli> waited = std::chrono::high_resolution_clock::now() - start;
+		m_Stats.stalledFrames++;
+		m_Stats.lastFenceWaitMs = waited.count();
+		m_Stats.totalFenceWaitMs += waited.count();
+		m_Stats.maxFenceWaitMs = std::max(m_Stats.maxFenceWaitMs, waited.count());
+	}
+
+	if (result == GL_WAIT_FAILED)
+		std::cerr << "RING BUFFER FENCE WAIT FAILED" << std::endl;
+
+	glDeleteSync(fence);
+	m_Fences[frame] = nullptr;
+}
+
+BufferSlice RingBuffer::Allocate(std::size_t size, std::size_t alignment)
+{
+	BufferSlice slice;
+
+	//poravnava se apsolutni offset u bufferu, ne offset unutar regije
+	std::size_t begin = AlignUp(GetFrameOffset() + m_Head, alignment) - GetFrameOffset();
+	if (!m_Mapped || begin + size > m_FrameSize)
+	{
+		m_Stats.failedAllocations++;
+		std::cerr << "RING BUFFER FRAME REGION EXHAUSTED (" << size << " bytes requested)" << std::endl;
+		return slice;
+	}
+
+	slice.buffer = m_RenderID;
+	slice.offset = GetFrameOffset() + begin;
+	slice.size = size;
+	slice.data = m_Mapped + slice.offset;
+
+	m_Stats.bytesThisFrame += (begin + size) - m_Head;
+	m_Head = begin + size;
+
+	return slice;
+}
+
+BufferSlice RingBuffer::AllocateUniform(std::size_t size)
+{
+	return Allocate(size, m_UniformAlignment);
+}
+
+BufferSlice RingBuffer::AllocateStorage(std::size_t size)
+{
+	return Allocate(size, m_StorageAlignment);
+}
+
+BufferSlice RingBuffer::AllocateVertex(std::size_t size, std::size_t stride)
+{
+	//poravnanje na stride omogucuje koristenje offset / stride kao baseVertex ili baseInstance
+	return Allocate(size, stride);
+}
+
+void RingBuffer::BindUniform(unsigned int binding, const BufferSlice& slice) const
+{
+	glBindBufferRange(GL_UNIFORM_BUFFER, binding, slice.buffer, slice.offset, slice.size);
+}
+
+void RingBuffer::BindStorage(unsigned int binding, const BufferSlice& slice) const
+{
+	glBindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, slice.buffer, slice.offset, slice.size);
+}
+
+void RingBuffer::ResetStats()
+{
+	m_Stats = RingBufferStats();
+}
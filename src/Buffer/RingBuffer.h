@@ -0,0 +1,79 @@
+#pragma once
+#include "glad/glad.h"
+
+#include <cstddef>
+
+//dio mapiranog buffera koji je alociran za trenutni frame
+struct BufferSlice
+{
+	unsigned int buffer = 0;
+	std::size_t offset = 0;
+	std::size_t size = 0;
+	void* data = nullptr;
+
+	inline bool IsValid() const { return data != nullptr; }
+};
+
+struct RingBufferStats
+{
+	unsigned long long frames = 0;
+	unsigned long long stalledFrames = 0;
+	unsigned long long failedAllocations = 0;
+
+	double lastFenceWaitMs = 0.0;
+	double maxFenceWaitMs = 0.0;
+	double totalFenceWaitMs = 0.0;
+
+	std::size_t bytesThisFrame = 0;
+	std::size_t peakBytesPerFrame = 0;
+};
+
+//trajno mapiran buffer podijeljen na FRAME_COUNT regija, svaka regija je zasticena fenceom
+class RingBuffer
+{
+public:
+	static const unsigned int FRAME_COUNT = 3;
+
+	RingBuffer() = delete;
+	RingBuffer(std::size_t bytesPerFrame);
+	~RingBuffer();
+
+	RingBuffer(const RingBuffer&) = delete;
+	RingBuffer& operator=(const RingBuffer&) = delete;
+
+	void BeginFrame();
+	void EndFrame();
+
+	BufferSlice Allocate(std::size_t size, std::size_t alignment);
+	BufferSlice AllocateUniform(std::size_t size);
+	BufferSlice AllocateStorage(std::size_t size);
+	BufferSlice AllocateVertex(std::size_t size, std::size_t stride);
+
+	void BindUniform(unsigned int binding, const BufferSlice& slice) const;
+	void BindStorage(unsigned int binding, const BufferSlice& slice) const;
+
+	void ResetStats();
+
+	inline unsigned int GetID() const { return m_RenderID; }
+	inline std::size_t GetFrameSize() const { return m_FrameSize; }
+	inline std::size_t GetFrameOffset() const { return m_FrameIndex * m_FrameSize; }
+	inline const RingBufferStats& GetStats() const { return m_Stats; }
+
+private:
+	void WaitForFence(unsigned int frame);
+
+private:
+	unsigned int m_RenderID;
+	unsigned char* m_Mapped;
+
+	std::size_t m_FrameSize;
+	std::size_t m_Head;
+	unsigned int m_FrameIndex;
+
+	GLsync m_Fences[FRAME_COUNT];
+
+	std::size_t m_UniformAlignment;
+	std::size_t m_StorageAlignment;
+
+	RingBufferStats m_Stats;
+};
@@ -0,0 +1,221 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+//dretva moze pripadati vise sustava (npr. glavna dretva koja ih je stvorila nekoliko), zato se index pamti po sustavu
+struct ThreadSlot
+{
+	const JobSystem* owner;
+	int index;
+};
+
+static thread_local std::vector<ThreadSlot> t_Slots;
+
+static void RegisterThread(const JobSystem* owner, int index)
+{
+	t_Slots.push_back({ owner, index });
+}
+
+static void UnregisterThread(const JobSystem* owner)
+{
+	t_Slots.erase(std::remove_if(t_Slots.begin(), t_Slots.end(), [owner](const ThreadSlot& slot) { return slot.owner == owner; }), t_Slots.end());
+}
+
+JobSystem::JobSystem(unsigned int threadCount)
+	: m_NextQueue(0), m_PendingJobs(0), m_Running(true)
+{
+	if (threadCount == 0)
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+	for (unsigned int i = 0; i < threadCount; i++)
+		m_Queues.push_back(std::make_unique<WorkQueue>());
+
+	//dretva koja stvara sustav je dretva 0 i radi poslove dok ceka u Wait
+	RegisterThread(this, 0);
+
+	for (unsigned int i = 1; i < threadCount; i++)
+		m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_SleepMutex);
+		m_Running = false;
+	}
+	m_SleepCondition.notify_all();
+
+	for (auto& worker : m_Workers)
+		worker.join();
+
+	UnregisterThread(this);
+}
+
+int JobSystem::GetThreadIndex() const
+{
+	for (const ThreadSlot& slot : t_Slots)
+	{
+		if (slot.owner == this)
+			return slot.index;
+	}
+	return -1;
+}
+
+void JobSystem::Run(std::function<void()> function, JobCounter* counter, JobCounter* dependency)
+{
+	Job job;
+	job.function = std::move(function);
+	job.counter = counter;
+
+	if (counter)
+		counter->m_Value.fetch_add(1, std::memory_order_relaxed);
+
+	if (dependency)
+	{
+		std::lock_guard<std::mutex> lock(dependency->m_Mutex);
+		if (!dependency->IsDone())
+		{
+			dependency->m_Waiting.push_back(std::move(job));
+			return;
+		}
+	}
+
+	Schedule(std::move(job));
+}
+
+void JobSystem::Schedule(Job job)
+{
+	//poslovi stvoreni na radnoj dretvi idu u njen red, ostali se rasporeduju redom
+	int threadIndex = GetThreadIndex();
+	unsigned int index;
+	if (threadIndex >= 0)
+		index = (unsigned int)threadIndex;
+	else
+		index = m_NextQueue.fetch_add(1, std::memory_order_relaxed) % GetThreadCount();
+
+	{
+		std::lock_guard<std::mutex> lock(m_Queues[index]->mutex);
+		m_Queues[index]->jobs.push_back(std::move(job));
+	}
+
+	m_PendingJobs.fetch_add(1, std::memory_order_release);
+	{
+		std::lock_guard<std::mutex> lock(m_SleepMutex);
+	}
+	m_SleepCondition.notify_one();
+}
+
+bool JobSystem::PopLocal(unsigned int index, Job& job)
+{
+	WorkQueue& queue = *m_Queues[index];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.jobs.empty())
+		return false;
+
+	//vlasnik uzima s kraja (najtopliji posao), kradljivci s pocetka
+	job = std::move(queue.jobs.back());
+	queue.jobs.pop_back();
+	return true;
+}
+
+bool JobSystem::Steal(int thief, Job& job)
+{
+	//strana dretva (thief -1) nema svoj red pa obilazi sve
+	unsigned int count = GetThreadCount();
+	unsigned int first = thief >= 0 ? (unsigned int)thief + 1 : 0;
+	unsigned int queues = thief >= 0 ? count - 1 : count;
+	for (unsigned int i = 0; i < queues; i++)
+	{
+		WorkQueue& queue = *m_Queues[(first + i) % count];
+		std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+		if (!lock.owns_lock() || queue.jobs.empty())
+			continue;
+
+		job = std::move(queue.jobs.front());
+		queue.jobs.pop_front();
+		return true;
+	}
+	return false;
+}
+
+bool JobSystem::TryRunOne(int index)
+{
+	Job job;
+	if ((index < 0 || !PopLocal((unsigned int)index, job)) && !Steal(index, job))
+		return false;
+
+	m_PendingJobs.fetch_sub(1, std::memory_order_relaxed);
+	Execute(job);
+	return true;
+}
+
+void JobSystem::Execute(Job& job)
+{
+	job.function();
+
+	JobCounter* counter = job.counter;
+	if (!counter)
+		return;
+
+	std::vector<Job> released;
+	{
+		std::lock_guard<std::mutex> lock(counter->m_Mutex);
+		if (counter->m_Value.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			released.swap(counter->m_Waiting);
+	}
+
+	for (auto& waiting : released)
+		Schedule(std::move(waiting));
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+	int index = GetThreadIndex();
+
+	while (!counter.IsDone())
+	{
+		if (!TryRunOne(index))
+			std::this_thread::yield();
+	}
+
+	//dretva koja je spustila brojac na nulu jos moze drzati njegov mutex
+	std::lock_guard<std::mutex> lock(counter.m_Mutex);
+}
+
+void JobSystem::ParallelFor(std::uint32_t count, std::uint32_t grainSize, const std::function<void(std::uint32_t, std::uint32_t)>& function)
+{
+	if (count == 0)
+		return;
+	if (grainSize == 0)
+		grainSize = std::max(1u, count / (GetThreadCount() * 4));
+
+	if (count <= grainSize || GetThreadCount() == 1)
+	{
+		function(0, count);
+		return;
+	}
+
+	JobCounter counter;
+	for (std::uint32_t begin = 0; begin < count; begin += grainSize)
+	{
+		std::uint32_t end = std::min(count, begin + grainSize);
+		Run([&function, begin, end]() { function(begin, end); }, &counter);
+	}
+	Wait(counter);
+}
+
+void JobSystem::WorkerLoop(unsigned int index)
+{
+	RegisterThread(this, (int)index);
+
+	while (true)
+	{
+		if (TryRunOne((int)index))
+			continue;
+
+		std::unique_lock<std::mutex> lock(m_SleepMutex);
+		m_SleepCondition.wait(lock, [this]() { return !m_Running || m_PendingJobs.load(std::memory_order_acquire) > 0; });
+		if (!m_Running)
+			break;
+	}
+}
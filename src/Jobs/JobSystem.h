@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem;
+
+struct Job
+{
+	std::function<void()> function;
+	class JobCounter* counter = nullptr;
+};
+
+//broji nedovrsene poslove, poslovi koji ovise o brojacu krecu tek kad on padne na nulu
+class JobCounter
+{
+public:
+	JobCounter() : m_Value(0) { }
+
+	JobCounter(const JobCounter&) = delete;
+	JobCounter& operator=(const JobCounter&) = delete;
+
+	inline bool IsDone() const { return m_Value.load(std::memory_order_acquire) == 0; }
+	inline int GetValue() const { return m_Value.load(std::memory_order_acquire); }
+
+private:
+	friend class JobSystem;
+
+	std::atomic<int> m_Value;
+	std::mutex m_Mutex;
+	std::vector<Job> m_Waiting;
+};
+
+class JobSystem
+{
+public:
+	//threadCount ukljucuje i pozivajucu (glavnu) dretvu, 0 znaci broj jezgri
+	JobSystem(unsigned int threadCount = 0);
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	void Run(std::function<void()> function, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+	void Wait(JobCounter& counter);
+
+	//poziva function(begin, end) nad [0, count) u komadima velicine grainSize i ceka kraj
+	void ParallelFor(std::uint32_t count, std::uint32_t grainSize, const std::function<void(std::uint32_t, std::uint32_t)>& function);
+
+	inline unsigned int GetThreadCount() const { return (unsigned int)m_Queues.size(); }
+	//index pozivajuce dretve u ovom sustavu, -1 ako nije ni radna ni dretva koja ga je stvorila
+	int GetThreadIndex() const;
+
+private:
+	struct WorkQueue
+	{
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	void Schedule(Job job);
+	bool PopLocal(unsigned int index, Job& job);
+	bool Steal(int thief, Job& job);
+	bool TryRunOne(int index);
+	void Execute(Job& job);
+	void WorkerLoop(unsigned int index);
+
+private:
+	std::vector<std::unique_ptr<WorkQueue>> m_Queues;
+	std::vector<std::thread> m_Workers;
+
+	std::atomic<unsigned int> m_NextQueue;
+	std::atomic<int> m_PendingJobs;
+	std::atomic<bool> m_Running;
+
+	std::mutex m_SleepMutex;
+	std::condition_variable m_SleepCondition;
+};
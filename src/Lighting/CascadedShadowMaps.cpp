@@ -0,0 +1,285 @@
+#include "glad/glad.h"
+
+#include "CascadedShadowMaps.h"
+#include "Frustum.h"
+#include "Model.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string>
+
+//koliko je podrucje kaskade vece od sfere isjecka kad je cache ukljucen
+static const float CASCADE_SLACK = 0.25f;
+//bacaci sjene izmedu svjetla i isjecka, ispred kaskade u smjeru svjetla
+static const float CASTER_EXTENSION = 50.0f;
+
+CascadedShadowMaps::CascadedShadowMaps(unsigned int cascadeCount, unsigned int resolution)
+	: m_CascadeCount(std::min(std::max(cascadeCount, 1u), MAX_CASCADES)), m_Resolution(resolution),
+	m_Fovy(glm::radians(45.0f)), m_Aspect(1.0f), m_Near(0.1f), m_Splits(),
+	m_LightDirection(0.0f, -1.0f, 0.0f), m_LightView(1.0f), m_StaticVersion(0), m_Caching(true), m_LightValid(false),
+	m_ShadowMap(0), m_StaticMap(0), m_Framebuffer(0)
+{
+	SetCamera(m_Fovy, m_Aspect, m_Near, 30.0f);
+}
+
+CascadedShadowMaps::~CascadedShadowMaps()
+{
+	if (m_Framebuffer)
+		glDeleteFramebuffers(1, &m_Framebuffer);
+	if (m_ShadowMap)
+		glDeleteTextures(1, &m_ShadowMap);
+	if (m_StaticMap)
+		glDeleteTextures(1, &m_StaticMap);
+}
+
+void CascadedShadowMaps::SetCamera(float fovy, float aspect, float nearPlane, float shadowDistance, float splitLambda)
+{
+	m_Fovy = fovy;
+	m_Aspect = aspect;
+	m_Near = nearPlane;
+
+	for (unsigned int i = 0; i < m_CascadeCount; i++)
+	{
+		float p = (float)(i + 1) / m_CascadeCount;
+		float logarithmic = nearPlane * std::pow(shadowDistance / nearPlane, p);
+		float uniform = nearPlane + (shadowDistance - nearPlane) * p;
+		m_Splits[i] = splitLambda * logarithmic + (1.0f - splitLambda) * uniform;
+	}
+
+	Invalidate();
+}
+
+void CascadedShadowMaps::SetCaching(bool enabled)
+{
+	m_Caching = enabled;
+	Invalidate();
+}
+
+void CascadedShadowMaps::Invalidate()
+{
+	for (Cascade& cascade : m_Cascades)
+	{
+		cascade.placed = false;
+		cascade.staticValid = false;
+	}
+}
+
+void CascadedShadowMaps::Update(const SceneSnapshot& scene, const std::vector<glm::vec4>& meshBounds, const glm::mat4& view, const glm::vec3& lightDirection)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	m_Stats = ShadowStats();
+
+	bool lightChanged = !m_LightValid || lightDirection != m_LightDirection;
+	if (lightChanged)
+	{
+		m_LightDirection = lightDirection;
+		glm::vec3 up = std::abs(lightDirection.y) > 0.99f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+		m_LightView = glm::lookAt(glm::vec3(0.0f), lightDirection, up);
+		m_LightValid = true;
+	}
+	bool staticChanged = scene.GetStaticVersion() != m_StaticVersion;
+	m_StaticVersion = scene.GetStaticVersion();
+
+	//sfere bacaca u svijetu, racunaju se jednom i koriste za sve kaskade
+	std::size_t entityCount = scene.GetEntityCount();
+	m_CasterSpheres.resize(entityCount);
+	for (Entity entity = 0; entity < entityCount; entity++)
+	{
+		const glm::mat4& world = scene.GetWorldMatrix(entity);
+		const glm::vec4& bounds = meshBounds[scene.GetMesh(entity)];
+		float scale = std::max(glm::length(glm::vec3(world[0])), std::max(glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2]))));
+		m_CasterSpheres[entity] = glm::vec4(glm::vec3(world * glm::vec4(glm::vec3(bounds), 1.0f)), bounds.w * scale);
+	}
+
+	glm::mat4 inverseView = glm::inverse(view);
+	float tanHalfFovy = std::tan(m_Fovy * 0.5f);
+	float sliceNear = m_Near;
+
+	for (unsigned int c = 0; c < m_CascadeCount; c++)
+	{
+		Cascade& cascade = m_Cascades[c];
+		float sliceFar = m_Splits[c];
+
+		//sfera oko isjecka frustuma kamere, radijus ne ovisi o rotaciji kamere
+		glm::vec3 corners[8];
+		glm::vec3 center(0.0f);
+		for (int i = 0; i < 8; i++)
+		{
+			float z = (i & 4) ? sliceFar : sliceNear;
+			float y = z * tanHalfFovy * ((i & 2) ? 1.0f : -1.0f);
+			float x = z * tanHalfFovy * m_Aspect * ((i & 1) ? 1.0f : -1.0f);
+			corners[i] = glm::vec3(inverseView * glm::vec4(x, y, -z, 1.0f));
+			center += corners[i] / 8.0f;
+		}
+		float radius = 0.0f;
+		for (const glm::vec3& corner : corners)
+			radius = std::max(radius, glm::length(corner - center));
+		radius = std::ceil(radius * 16.0f) / 16.0f;
+		sliceNear = sliceFar;
+
+		glm::vec3 lightCenter = glm::vec3(m_LightView * glm::vec4(center, 1.0f));
+		glm::vec3 offset = glm::abs(lightCenter - cascade.center);
+		bool contained = cascade.placed && std::max(offset.x, std::max(offset.y, offset.z)) + radius <= cascade.halfExtent;
+
+		bool moved = lightChanged || !contained || !m_Caching;
+		if (moved)
+		{
+			//sredina se zaokruzuje na teksel kako pomicanje kaskade ne bi treperilo rubove sjena
+			cascade.halfExtent = radius * (m_Caching ? 1.0f + CASCADE_SLACK : 1.0f);
+			float texel = 2.0f * cascade.halfExtent / m_Resolution;
+			cascade.center = glm::vec3(std::floor(lightCenter.x / texel) * texel, std::floor(lightCenter.y / texel) * texel, lightCenter.z);
+			cascade.placed = true;
+
+			glm::mat4 projection = glm::ortho(cascade.center.x - cascade.halfExtent, cascade.center.x + cascade.halfExtent,
+				cascade.center.y - cascade.halfExtent, cascade.center.y + cascade.halfExtent,
+				-(cascade.center.z + cascade.halfExtent + CASTER_EXTENSION), -(cascade.center.z - cascade.halfExtent));
+			cascade.viewProjection = projection * m_LightView;
+		}
+
+		cascade.refreshStatic = m_Caching && (moved || staticChanged || !cascade.staticValid);
+		cascade.staticValid = m_Caching;
+		if (cascade.refreshStatic || !m_Caching)
+			m_Stats.refreshedCascades++;
+
+		cascade.staticDraws.clear();
+		cascade.dynamicDraws.clear();
+
+		Frustum frustum = Frustum::FromMatrix(cascade.viewProjection);
+		for (Entity entity = 0; entity < entityCount; entity++)
+		{
+			bool isStatic = m_Caching && scene.IsStatic(entity);
+			if (isStatic && !cascade.refreshStatic)
+				continue;
+
+			const glm::vec4& sphere = m_CasterSpheres[entity];
+			if (!frustum.IntersectsSphere(glm::vec3(sphere), sphere.w))
+			{
+				m_Stats.culledCasters++;
+				continue;
+			}
+
+			ShadowDraw draw = { scene.GetMesh(entity), cascade.viewProjection * scene.GetWorldMatrix(entity) };
+			if (isStatic)
+				cascade.staticDraws.push_back(draw);
+			else
+				cascade.dynamicDraws.push_back(draw);
+		}
+
+		m_Stats.staticDrawCalls += (unsigned int)cascade.staticDraws.size();
+		m_Stats.dynamicDrawCalls += (unsigned int)cascade.dynamicDraws.size();
+	}
+
+	m_Stats.drawCalls = m_Stats.staticDrawCalls + m_Stats.dynamicDrawCalls;
+
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	m_Stats.updateMs = elapsed.count();
+}
+
+void CascadedShadowMaps::CreateTextures()
+{
+	for (unsigned int* texture : { &m_ShadowMap, &m_StaticMap })
+	{
+		glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, texture);
+		glTextureStorage3D(*texture, 1, GL_DEPTH_COMPONENT32F, m_Resolution, m_Resolution, m_CascadeCount);
+		glTextureParameteri(*texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTextureParameteri(*texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTextureParameteri(*texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(*texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	}
+
+	//hardverska usporedba dubine za PCF u shaderu
+	glTextureParameteri(m_ShadowMap, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+	glTextureParameteri(m_ShadowMap, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+	glCreateFramebuffers(1, &m_Framebuffer);
+	glNamedFramebufferDrawBuffer(m_Framebuffer, GL_NONE);
+	glNamedFramebufferReadBuffer(m_Framebuffer, GL_NONE);
+
+	m_DepthShader = std::make_unique<Shader>("res/shaders/vDepth.glsl", "res/shaders/fNull.glsl");
+}
+
+void CascadedShadowMaps::DrawCasters(const std::vector<ShadowDraw>& draws, const Model* const* meshes) const
+{
+	for (const ShadowDraw& draw : draws)
+	{
+		m_DepthShader->SetUniform4x4("mvp", draw.mvp);
+		meshes[draw.mesh]->DrawDepth();
+	}
+}
+
+void CascadedShadowMaps::Render(const Model* const* meshes)
+{
+	if (!m_ShadowMap)
+		CreateTextures();
+
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+	glViewport(0, 0, m_Resolution, m_Resolution);
+	glEnable(GL_DEPTH_TEST);
+	glDepthFunc(GL_LESS);
+	glDepthMask(GL_TRUE);
+	glEnable(GL_POLYGON_OFFSET_FILL);
+	glPolygonOffset(2.0f, 4.0f);
+	m_DepthShader->Bind();
+
+	for (unsigned int c = 0; c < m_CascadeCount; c++)
+	{
+		Cascade& cascade = m_Cascades[c];
+
+		if (m_Caching)
+		{
+			if (cascade.refreshStatic)
+			{
+				glNamedFramebufferTextureLayer(m_Framebuffer, GL_DEPTH_ATTACHMENT, m_StaticMap, 0, c);
+				glClear(GL_DEPTH_BUFFER_BIT);
+				DrawCasters(cascade.staticDraws, meshes);
+			}
+
+			//konacna mapa je kopija cachea s dinamicnim bacacima preko, kopija se preskace dok nema promjene
+			bool dynamic = !cascade.dynamicDraws.empty();
+			if (cascade.refreshStatic || dynamic || cascade.hadDynamic)
+			{
+				glCopyImageSubData(m_StaticMap, GL_TEXTURE_2D_ARRAY, 0, 0, 0, c,
+					m_ShadowMap, GL_TEXTURE_2D_ARRAY, 0, 0, 0, c, m_Resolution, m_Resolution, 1);
+			}
+			cascade.hadDynamic = dynamic;
+
+			if (dynamic)
+			{
+				glNamedFramebufferTextureLayer(m_Framebuffer, GL_DEPTH_ATTACHMENT, m_ShadowMap, 0, c);
+				DrawCasters(cascade.dynamicDraws, meshes);
+			}
+		}
+		else
+		{
+			glNamedFramebufferTextureLayer(m_Framebuffer, GL_DEPTH_ATTACHMENT, m_ShadowMap, 0, c);
+			glClear(GL_DEPTH_BUFFER_BIT);
+			DrawCasters(cascade.dynamicDraws, meshes);
+		}
+	}
+
+	glDisable(GL_POLYGON_OFFSET_FILL);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+void CascadedShadowMaps::SetUniforms(const Shader& shader, unsigned int slot) const
+{
+	glActiveTexture(GL_TEXTURE0 + slot);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, m_ShadowMap);
+	glActiveTexture(GL_TEXTURE0);
+
+	shader.SetUniformInt("shadowMap", slot);
+	shader.SetUniformInt("cascadeCount", m_CascadeCount);
+	shader.SetUniformVec3("sunDirection", m_LightDirection);
+	for (unsigned int c = 0; c < m_CascadeCount; c++)
+	{
+		shader.SetUniform4x4("cascadeMatrices[" + std::to_string(c) + "]", m_Cascades[c].viewProjection);
+		shader.SetUniformFloat("cascadeSplits[" + std::to_string(c) + "]", m_Splits[c]);
+	}
+}
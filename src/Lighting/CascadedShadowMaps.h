@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Scene.h"
+#include "Shader.h"
+
+#include "glm/glm.hpp"
+
+#include <memory>
+#include <vector>
+
+class Model;
+
+struct ShadowStats
+{
+	unsigned int drawCalls = 0;
+	unsigned int staticDrawCalls = 0;
+	unsigned int dynamicDrawCalls = 0;
+	unsigned int refreshedCascades = 0;
+	unsigned int culledCasters = 0;
+	double updateMs = 0.0;
+};
+
+struct ShadowDraw
+{
+	unsigned int mesh;
+	glm::mat4 mvp;
+};
+
+//kaskadne mape sjena za usmjereno svjetlo
+//staticni bacaci sjene se crtaju u zasebnu cache mapu koja se obnavlja samo kad se promijeni svjetlo, staticni skup
+//ili kad kaskada izade iz svog (malo povecanog) podrucja; dinamicni se svaki frame crtaju preko kopije cachea
+class CascadedShadowMaps
+{
+public:
+	static const unsigned int MAX_CASCADES = 4;
+
+	CascadedShadowMaps(unsigned int cascadeCount = 4, unsigned int resolution = 2048);
+	~CascadedShadowMaps();
+
+	CascadedShadowMaps(const CascadedShadowMaps&) = delete;
+	CascadedShadowMaps& operator=(const CascadedShadowMaps&) = delete;
+
+	//lambda mijesa logaritamsku (1) i jednoliku (0) podjelu kaskada
+	void SetCamera(float fovy, float aspect, float nearPlane, float shadowDistance, float splitLambda = 0.75f);
+	void SetCaching(bool enabled);
+	void Invalidate();
+
+	//CPU dio: smjesta kaskade, odbacuje bacace po frustumu svake kaskade i odlucuje sto treba ponovno nacrtati
+	//meshBounds su sfere iz Mesh::GetBoundingSphere() indeksirane kao Scene::GetMesh(); scena je kopija framea (Scene::Snapshot)
+	void Update(const SceneSnapshot& scene, const std::vector<glm::vec4>& meshBounds, const glm::mat4& view, const glm::vec3& lightDirection);
+	void Render(const Model* const* meshes);
+	void SetUniforms(const Shader& shader, unsigned int slot) const;
+
+	inline unsigned int GetCascadeCount() const { return m_CascadeCount; }
+	inline unsigned int GetResolution() const { return m_Resolution; }
+	inline const glm::mat4& GetCascadeMatrix(unsigned int cascade) const { return m_Cascades[cascade].viewProjection; }
+	inline float GetSplitDistance(unsigned int cascade) const { return m_Splits[cascade]; }
+	inline unsigned int GetTexture() const { return m_ShadowMap; }
+	inline bool IsCachingEnabled() const { return m_Caching; }
+	inline const ShadowStats& GetStats() const { return m_Stats; }
+
+private:
+	struct Cascade
+	{
+		glm::mat4 viewProjection = glm::mat4(1.0f);
+
+		//podrucje kaskade u prostoru svjetla, vece od sfere isjecka kako bi cache prezivio male pomake kamere
+		glm::vec3 center = glm::vec3(0.0f);
+		float halfExtent = 0.0f;
+		bool placed = false;
+
+		bool staticValid = false;
+		bool refreshStatic = false;
+		bool hadDynamic = false;
+
+		std::vector<ShadowDraw> staticDraws;
+		std::vector<ShadowDraw> dynamicDraws;
+	};
+
+	void CreateTextures();
+	void DrawCasters(const std::vector<ShadowDraw>& draws, const Model* const* meshes) const;
+
+private:
+	unsigned int m_CascadeCount;
+	unsigned int m_Resolution;
+
+	float m_Fovy, m_Aspect, m_Near;
+	float m_Splits[MAX_CASCADES];
+	Cascade m_Cascades[MAX_CASCADES];
+
+	glm::vec3 m_LightDirection;
+	glm::mat4 m_LightView;
+	std::uint64_t m_StaticVersion;
+	bool m_Caching;
+	bool m_LightValid;
+
+	std::vector<glm::vec4> m_CasterSpheres;
+
+	unsigned int m_ShadowMap;
+	unsigned int m_StaticMap;
+	unsigned int m_Framebuffer;
+	std::unique_ptr<Shader> m_DepthShader;
+
+	ShadowStats m_Stats;
+};
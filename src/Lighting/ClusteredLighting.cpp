@@ -0,0 +1,243 @@
+#include "glad/glad.h"
+
+#include "ClusteredLighting.h"
+
+#include "JobSystem.h"
+#include "RingBuffer.h"
+#include "Shader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+glm::vec3 ShadePointLight(const PointLight& light, const glm::vec3& fragPos, const glm::vec3& normal,
+	const glm::vec3& viewPos, float specularStrength)
+{
+	glm::vec3 toLight = light.position - fragPos;
+	float distance = glm::length(toLight);
+	if (distance >= light.radius || distance <= 0.0f)
+		return glm::vec3(0.0f);
+
+	float falloff = 1.0f - (distance * distance) / (light.radius * light.radius);
+	float attenuation = falloff * falloff;
+
+	//Diffuse
+	glm::vec3 lightDir = toLight / distance;
+	float diff = std::max(glm::dot(normal, lightDir), 0.0f);
+
+	//Specular
+	glm::vec3 viewDir = glm::normalize(viewPos - fragPos);
+	glm::vec3 reflectDir = glm::reflect(-lightDir, normal);
+	float spec = std::pow(std::max(glm::dot(viewDir, reflectDir), 0.0f), 32.0f);
+
+	return (diff + specularStrength * spec) * light.color * light.intensity * attenuation;
+}
+
+ClusteredLighting::ClusteredLighting(unsigned int tilesX, unsigned int tilesY, unsigned int slices)
+	: m_TilesX(tilesX), m_TilesY(tilesY), m_Slices(slices), m_Projection(1.0f), m_ZNear(0.1f), m_ZFar(100.0f)
+{
+	m_ClusterCounts.resize(GetClusterCount());
+	m_ClusterDropped.resize(GetClusterCount());
+	m_ClusterLights.resize(GetClusterCount() * MAX_LIGHTS_PER_CLUSTER);
+	m_Grid.resize(GetClusterCount());
+}
+
+void ClusteredLighting::SetProjection(const glm::mat4& projection, float zNear, float zFar)
+{
+	m_Projection = projection;
+	m_ZNear = zNear;
+	m_ZFar = zFar;
+
+	m_ClusterMin.resize(GetClusterCount());
+	m_ClusterMax.resize(GetClusterCount());
+
+	glm::mat4 inverseProjection = glm::inverse(projection);
+
+	for (unsigned int z = 0; z < m_Slices; z++)
+	{
+		float depthNear = zNear * std::pow(zFar / zNear, (float)z / m_Slices);
+		float depthFar = zNear * std::pow(zFar / zNear, (float)(z + 1) / m_Slices);
+
+		for (unsigned int y = 0; y < m_TilesY; y++)
+		{
+			for (unsigned int x = 0; x < m_TilesX; x++)
+			{
+				glm::vec3 minimum(1e30f), maximum(-1e30f);
+				for (int corner = 0; corner < 4; corner++)
+				{
+					float ndcX = -1.0f + 2.0f * (x + (corner & 1)) / m_TilesX;
+					float ndcY = -1.0f + 2.0f * (y + (corner >> 1)) / m_TilesY;
+
+					//zraka kroz kut tilea, skalirana tako da je na dubini 1
+					glm::vec4 nearPoint = inverseProjection * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+					glm::vec3 ray = glm::vec3(nearPoint) / nearPoint.w;
+					ray /= -ray.z;
+
+					minimum = glm::min(minimum, glm::min(ray * depthNear, ray * depthFar));
+					maximum = glm::max(maximum, glm::max(ray * depthNear, ray * depthFar));
+				}
+
+				unsigned int cluster = (z * m_TilesY + y) * m_TilesX + x;
+				m_ClusterMin[cluster] = minimum;
+				m_ClusterMax[cluster] = maximum;
+			}
+		}
+	}
+}
+
+void ClusteredLighting::Build(const std::vector<PointLight>& lights, const glm::mat4& view, JobSystem* jobs)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	m_Lights = lights;
+
+	std::vector<glm::vec4> viewSpheres(lights.size());
+	for (std::size_t i = 0; i < lights.size(); i++)
+		viewSpheres[i] = glm::vec4(glm::vec3(view * glm::vec4(lights[i].position, 1.0f)), lights[i].radius);
+
+	if (jobs)
+	{
+		jobs->ParallelFor(m_Slices, 1, [this, &viewSpheres](std::uint32_t begin, std::uint32_t end)
+		{
+			for (std::uint32_t slice = begin; slice < end; slice++)
+				BuildSlice(slice, viewSpheres);
+		});
+	}
+	else
+	{
+		for (unsigned int slice = 0; slice < m_Slices; slice++)
+			BuildSlice(slice, viewSpheres);
+	}
+
+	//zbijanje listi u jedan niz indeksa, mreza cuva (offset, broj) za svaki klaster
+	m_Stats = ClusterStats();
+	m_LightIndices.clear();
+	for (unsigned int cluster = 0; cluster < GetClusterCount(); cluster++)
+	{
+		std::uint32_t count = m_ClusterCounts[cluster];
+		m_Grid[cluster] = glm::uvec2((unsigned int)m_LightIndices.size(), count);
+
+		const std::uint32_t* list = &m_ClusterLights[cluster * MAX_LIGHTS_PER_CLUSTER];
+		m_LightIndices.insert(m_LightIndices.end(), list, list + count);
+
+		m_Stats.maxLightsPerCluster = std::max(m_Stats.maxLightsPerCluster, count);
+		if (count)
+			m_Stats.occupiedClusters++;
+		if (m_ClusterDropped[cluster])
+		{
+			m_Stats.droppedLightReferences += m_ClusterDropped[cluster];
+			m_Stats.overflowedClusters++;
+		}
+	}
+
+	m_Stats.lights = (unsigned int)lights.size();
+	m_Stats.lightReferences = (unsigned int)m_LightIndices.size();
+
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	m_Stats.buildMs = elapsed.count();
+}
+
+void ClusteredLighting::BuildSlice(unsigned int slice, const std::vector<glm::vec4>& viewSpheres)
+{
+	float sliceNear = m_ZNear * std::pow(m_ZFar / m_ZNear, (float)slice / m_Slices);
+	float sliceFar = m_ZNear * std::pow(m_ZFar / m_ZNear, (float)(slice + 1) / m_Slices);
+
+	unsigned int first = slice * m_TilesX * m_TilesY;
+	std::fill(m_ClusterCounts.begin() + first, m_ClusterCounts.begin() + first + m_TilesX * m_TilesY, 0);
+	std::fill(m_ClusterDropped.begin() + first, m_ClusterDropped.begin() + first + m_TilesX * m_TilesY, 0);
+
+	for (std::uint32_t light = 0; light < (std::uint32_t)viewSpheres.size(); light++)
+	{
+		glm::vec3 center = glm::vec3(viewSpheres[light]);
+		float radius = viewSpheres[light].w;
+
+		float depthMin = std::max(-center.z - radius, sliceNear);
+		float depthMax = std::min(-center.z + radius, sliceFar);
+		if (depthMin > depthMax)
+			continue;
+
+		//raspon tileova iz projekcije AABB-a sfere odrezanog na dubine ovog reza
+		glm::vec2 ndcMin(1e30f), ndcMax(-1e30f);
+		for (int corner = 0; corner < 8; corner++)
+		{
+			glm::vec4 point(center.x + ((corner & 1) ? radius : -radius),
+				center.y + ((corner & 2) ? radius : -radius),
+				(corner & 4) ? -depthMax : -depthMin, 1.0f);
+			glm::vec4 clip = m_Projection * point;
+			glm::vec2 ndc = glm::vec2(clip) / clip.w;
+			ndcMin = glm::min(ndcMin, ndc);
+			ndcMax = glm::max(ndcMax, ndc);
+		}
+
+		int x0 = std::max(0, (int)std::floor((ndcMin.x * 0.5f + 0.5f) * m_TilesX));
+		int x1 = std::min((int)m_TilesX - 1, (int)std::floor((ndcMax.x * 0.5f + 0.5f) * m_TilesX));
+		int y0 = std::max(0, (int)std::floor((ndcMin.y * 0.5f + 0.5f) * m_TilesY));
+		int y1 = std::min((int)m_TilesY - 1, (int)std::floor((ndcMax.y * 0.5f + 0.5f) * m_TilesY));
+
+		for (int y = y0; y <= y1; y++)
+		{
+			for (int x = x0; x <= x1; x++)
+			{
+				unsigned int cluster = first + y * m_TilesX + x;
+
+				glm::vec3 closest = glm::clamp(center, m_ClusterMin[cluster], m_ClusterMax[cluster]);
+				glm::vec3 delta = closest - center;
+				if (glm::dot(delta, delta) > radius * radius)
+					continue;
+
+				std::uint32_t& count = m_ClusterCounts[cluster];
+				if (count < MAX_LIGHTS_PER_CLUSTER)
+					m_ClusterLights[cluster * MAX_LIGHTS_PER_CLUSTER + count++] = light;
+				else
+					m_ClusterDropped[cluster]++;
+			}
+		}
+	}
+}
+
+bool ClusteredLighting::Upload(RingBuffer& ring) const
+{
+	//prazni nizovi se ne smiju vezati pa svaki dio ima barem jedan element
+	std::size_t lightBytes = std::max<std::size_t>(1, m_Lights.size()) * sizeof(PointLight);
+	std::size_t gridBytes = std::max<std::size_t>(1, m_Grid.size()) * sizeof(glm::uvec2);
+	std::size_t indexBytes = std::max<std::size_t>(1, m_LightIndices.size()) * sizeof(std::uint32_t);
+
+	BufferSlice lights = ring.AllocateStorage(lightBytes);
+	BufferSlice grid = ring.AllocateStorage(gridBytes);
+	BufferSlice indices = ring.AllocateStorage(indexBytes);
+	if (!lights.IsValid() || !grid.IsValid() || !indices.IsValid())
+		return false;
+
+	std::memcpy(lights.data, m_Lights.data(), m_Lights.size() * sizeof(PointLight));
+	std::memcpy(grid.data, m_Grid.data(), m_Grid.size() * sizeof(glm::uvec2));
+	std::memcpy(indices.data, m_LightIndices.data(), m_LightIndices.size() * sizeof(std::uint32_t));
+
+	ring.BindStorage(LIGHTS_BINDING, lights);
+	ring.BindStorage(GRID_BINDING, grid);
+	ring.BindStorage(INDICES_BINDING, indices);
+	return true;
+}
+
+void ClusteredLighting::SetUniforms(const Shader& shader, const glm::mat4& view, float screenWidth, float screenHeight) const
+{
+	shader.SetUniform4x4("view", view);
+	shader.SetUniformInt("tilesX", m_TilesX);
+	shader.SetUniformInt("tilesY", m_TilesY);
+	shader.SetUniformInt("slices", m_Slices);
+	shader.SetUniformFloat("zNear", m_ZNear);
+	shader.SetUniformFloat("zFar", m_ZFar);
+	shader.SetUniformVec2("screenSize", glm::vec2(screenWidth, screenHeight));
+	shader.SetUniformInt("lightCount", (int)m_Lights.size());
+}
+
+unsigned int ClusteredLighting::GetClusterIndex(float pixelX, float pixelY, float viewDepth, float screenWidth, float screenHeight) const
+{
+	unsigned int x = std::min(m_TilesX - 1, (unsigned int)std::max(0.0f, pixelX / screenWidth * m_TilesX));
+	unsigned int y = std::min(m_TilesY - 1, (unsigned int)std::max(0.0f, pixelY / screenHeight * m_TilesY));
+
+	float slice = std::log(std::max(viewDepth, m_ZNear) / m_ZNear) / std::log(m_ZFar / m_ZNear) * m_Slices;
+	unsigned int z = std::min(m_Slices - 1, (unsigned int)std::max(0.0f, slice));
+
+	return (z * m_TilesY + y) * m_TilesX + x;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "glm/glm.hpp"
+
+#include <cstdint>
+#include <vector>
+
+class JobSystem;
+class RingBuffer;
+class Shader;
+
+//raspored odgovara std430 strukturi PointLight u fShaderClustered.glsl
+struct PointLight
+{
+	glm::vec3 position;
+	float radius;
+	glm::vec3 color;
+	float intensity;
+};
+
+//Phong iz fShader.glsl za jedno tockasto svjetlo s glatkim padom do nule na radiusu
+glm::vec3 ShadePointLight(const PointLight& light, const glm::vec3& fragPos, const glm::vec3& normal,
+	const glm::vec3& viewPos, float specularStrength);
+
+struct ClusterStats
+{
+	unsigned int lights = 0;
+	unsigned int lightReferences = 0;
+	unsigned int maxLightsPerCluster = 0;
+	unsigned int occupiedClusters = 0;
+	//reference svjetala odbacene jer je klaster vec imao MAX_LIGHTS_PER_CLUSTER svjetala, tada je osvjetljenje nepotpuno
+	unsigned int droppedLightReferences = 0;
+	unsigned int overflowedClusters = 0;
+	double buildMs = 0.0;
+};
+
+//frustum kamere je podijeljen na tilesX * tilesY * slices klastera (eksponencijalni rez po dubini)
+//svakom klasteru se na CPU-u pridruzuje lista svjetala koja ga dodiruju
+class ClusteredLighting
+{
+public:
+	static const unsigned int MAX_LIGHTS_PER_CLUSTER = 256;
+
+	static const unsigned int LIGHTS_BINDING = 0;
+	static const unsigned int GRID_BINDING = 1;
+	static const unsigned int INDICES_BINDING = 2;
+
+	ClusteredLighting(unsigned int tilesX = 16, unsigned int tilesY = 9, unsigned int slices = 24);
+
+	void SetProjection(const glm::mat4& projection, float zNear, float zFar);
+	void Build(const std::vector<PointLight>& lights, const glm::mat4& view, JobSystem* jobs = nullptr);
+
+	//kopira svjetla, mrezu i indekse u SSBO dijelove ring buffera i veze ih na GRID/INDICES/LIGHTS binding
+	bool Upload(RingBuffer& ring) const;
+	void SetUniforms(const Shader& shader, const glm::mat4& view, float screenWidth, float screenHeight) const;
+
+	unsigned int GetClusterIndex(float pixelX, float pixelY, float viewDepth, float screenWidth, float screenHeight) const;
+
+	inline unsigned int GetClusterCount() const { return m_TilesX * m_TilesY * m_Slices; }
+	inline const std::vector<PointLight>& GetLights() const { return m_Lights; }
+	inline const std::vector<glm::uvec2>& GetGrid() const { return m_Grid; }
+	inline const std::vector<std::uint32_t>& GetLightIndices() const { return m_LightIndices; }
+	inline const ClusterStats& GetStats() const { return m_Stats; }
+
+private:
+	void BuildSlice(unsigned int slice, const std::vector<glm::vec4>& viewSpheres);
+
+private:
+	unsigned int m_TilesX, m_TilesY, m_Slices;
+
+	glm::mat4 m_Projection;
+	float m_ZNear, m_ZFar;
+
+	//AABB klastera u prostoru kamere
+	std::vector<glm::vec3> m_ClusterMin;
+	std::vector<glm::vec3> m_ClusterMax;
+
+	std::vector<PointLight> m_Lights;
+	std::vector<std::uint32_t> m_ClusterCounts;
+	std::vector<std::uint32_t> m_ClusterDropped;
+	std::vector<std::uint32_t> m_ClusterLights;
+
+	std::vector<glm::uvec2> m_Grid;
+	std::vector<std::uint32_t> m_LightIndices;
+
+	ClusterStats m_Stats;
+};
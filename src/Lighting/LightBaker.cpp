@@ -0,0 +1,219 @@
+#include "glad/glad.h"
+#include "LightBaker.h"
+
+#include "JobSystem.h"
+#include "Model.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+
+//broj vrhova u jednom poslu, sve njihove zrake idu u jedan poziv OccludedRays
+static const std::uint32_t BAKE_GRAIN = 64;
+
+static double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	return elapsed.count();
+}
+
+//PCG hash, iz jednog broja daje dobro izmijesan niz bez obzira na redoslijed vrhova
+static inline std::uint32_t Hash(std::uint32_t value)
+{
+	std::uint32_t state = value * 747796405u + 2891336453u;
+	std::uint32_t word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+	return (word >> 22u) ^ word;
+}
+
+static inline float NextFloat(std::uint32_t& state)
+{
+	state = Hash(state);
+	return (state >> 8) * (1.0f / 16777216.0f);
+}
+
+//ortonormirana baza oko normale bez grananja (Duff i dr. 2017)
+static void BuildBasis(const glm::vec3& normal, glm::vec3& tangent, glm::vec3& bitangent)
+{
+	float sign = std::copysign(1.0f, normal.z);
+	float a = -1.0f / (sign + normal.z);
+	float b = normal.x * normal.y * a;
+	tangent = glm::vec3(1.0f + sign * normal.x * normal.x * a, sign * b, -sign * normal.x);
+	bitangent = glm::vec3(b, sign + normal.y * normal.y * a, -normal.y);
+}
+
+LightBaker::~LightBaker()
+{
+	if (m_Buffer)
+		glDeleteBuffers(1, &m_Buffer);
+}
+
+void LightBaker::AddOccluder(const std::vector<Vertex>& vertices, const std::vector<int>& indices, const glm::mat4& world)
+{
+	int base = (int)m_Positions.size();
+	for (const Vertex& vertex : vertices)
+		m_Positions.push_back(glm::vec3(world * glm::vec4(vertex.position, 1.0f)));
+	for (int index : indices)
+		m_Indices.push_back(base + index);
+}
+
+void LightBaker::BuildOccluders()
+{
+	m_Occluders.Build(m_Positions.empty() ? nullptr : m_Positions.data(), sizeof(glm::vec3), m_Indices.data(), m_Indices.size());
+}
+
+void LightBaker::BuildOccluders(const Scene& scene, const Model* const* meshes)
+{
+	m_Positions.clear();
+	m_Indices.clear();
+	for (Entity entity = 0; entity < scene.GetEntityCount(); entity++)
+	{
+		const Mesh& mesh = meshes[scene.GetMesh(entity)]->GetMesh();
+		AddOccluder(mesh.GetVertices(), mesh.GetIndices(), scene.GetWorldMatrix(entity));
+	}
+	BuildOccluders();
+}
+
+void LightBaker::Bake(const std::vector<Vertex>& vertices, const glm::mat4& world, const LightBakeSettings& settings,
+	std::vector<glm::vec4>& out, JobSystem* jobs, std::uint32_t seedOffset)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	std::uint32_t count = (std::uint32_t)vertices.size();
+	out.assign(count, glm::vec4(1.0f));
+	m_Stats = LightBakeStats();
+	m_Stats.vertices = count;
+	m_Stats.threads = jobs ? jobs->GetThreadCount() : 1;
+	if (count == 0 || m_Occluders.IsEmpty())
+		return;
+
+	//stratificirani uzorci: side x side celija, u svakoj jedan nasumican
+	unsigned int side = std::max(1u, (unsigned int)std::lround(std::sqrt((float)settings.samples)));
+	unsigned int samples = side * side;
+	float maxDistance = settings.maxDistance > 0.0f ? settings.maxDistance : glm::length(m_Occluders.GetBounds().Extent()) * 0.25f;
+	glm::vec3 toSun = -glm::normalize(settings.sunDirection);
+	bool bakeSun = settings.sunColor != glm::vec3(0.0f);
+	glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(world)));
+
+	auto worldNormal = [&](std::uint32_t i)
+	{
+		glm::vec3 normal = normalMatrix * vertices[i].normal;
+		float length = glm::length(normal);
+		return length > 0.0f ? normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+	};
+
+	std::atomic<std::uint64_t> rays(0);
+	auto bakeRange = [&](std::uint32_t begin, std::uint32_t end)
+	{
+		std::vector<glm::vec3> origins, directions;
+		std::vector<std::uint8_t> occluded;
+		origins.reserve((end - begin) * (samples + 1));
+		directions.reserve((end - begin) * (samples + 1));
+
+		for (std::uint32_t i = begin; i < end; i++)
+		{
+			glm::vec3 normal = worldNormal(i);
+			glm::vec3 tangent, bitangent;
+			BuildBasis(normal, tangent, bitangent);
+
+			glm::vec3 origin = glm::vec3(world * glm::vec4(vertices[i].position, 1.0f)) + normal * settings.bias;
+			std::uint32_t state = Hash(settings.seed ^ Hash(seedOffset + i));
+			for (unsigned int y = 0; y < side; y++)
+			{
+				for (unsigned int x = 0; x < side; x++)
+				{
+					//kosinusna hemisfera: tocka u jedinicnom krugu podignuta na polusferu
+					float u = (x + NextFloat(state)) / side, v = (y + NextFloat(state)) / side;
+					float radius = std::sqrt(u), phi = 6.28318531f * v;
+					glm::vec3 local(radius * std::cos(phi), radius * std::sin(phi), std::sqrt(std::max(0.0f, 1.0f - u)));
+					origins.push_back(origin);
+					directions.push_back(tangent * local.x + bitangent * local.y + normal * local.z);
+				}
+			}
+
+			if (bakeSun)
+			{
+				origins.push_back(origin);
+				directions.push_back(toSun);
+			}
+		}
+
+		occluded.resize(origins.size());
+		m_Occluders.OccludedRays(origins.data(), directions.data(), origins.size(), occluded.data(), maxDistance);
+		rays += origins.size();
+
+		//estimator s kosinusnom gustocom: prosjek radijancije vidljivih smjerova je vec irradijancija / pi
+		std::size_t ray = 0;
+		for (std::uint32_t i = begin; i < end; i++)
+		{
+			glm::vec3 irradiance(0.0f);
+			unsigned int visible = 0;
+			for (unsigned int s = 0; s < samples; s++, ray++)
+			{
+				if (occluded[ray])
+					continue;
+				irradiance += glm::mix(settings.groundColor, settings.skyColor, directions[ray].y * 0.5f + 0.5f);
+				visible++;
+			}
+			irradiance /= (float)samples;
+
+			if (bakeSun)
+			{
+				float cosine = glm::dot(toSun, worldNormal(i));
+				if (!occluded[ray] && cosine > 0.0f)
+					irradiance += settings.sunColor * cosine;
+				ray++;
+			}
+
+			out[i] = glm::vec4(irradiance, (float)visible / samples);
+		}
+	};
+
+	if (jobs)
+		jobs->ParallelFor(count, BAKE_GRAIN, bakeRange);
+	else
+		bakeRange(0, count);
+
+	m_Stats.rays = rays;
+	m_Stats.bakeMs = ElapsedMs(start);
+}
+
+void LightBaker::BakeScene(const Scene& scene, const Model* const* meshes, const LightBakeSettings& settings, JobSystem* jobs)
+{
+	LightBakeStats total;
+	m_Baked.clear();
+	m_EntityOffsets.assign(scene.GetEntityCount(), 0);
+
+	std::vector<glm::vec4> entityLighting;
+	for (Entity entity = 0; entity < scene.GetEntityCount(); entity++)
+	{
+		m_EntityOffsets[entity] = m_Baked.size();
+		const Mesh& mesh = meshes[scene.GetMesh(entity)]->GetMesh();
+		Bake(mesh.GetVertices(), scene.GetWorldMatrix(entity), settings, entityLighting, jobs, (std::uint32_t)m_Baked.size());
+		m_Baked.insert(m_Baked.end(), entityLighting.begin(), entityLighting.end());
+
+		total.vertices += m_Stats.vertices;
+		total.rays += m_Stats.rays;
+		total.threads = m_Stats.threads;
+		total.bakeMs += m_Stats.bakeMs;
+	}
+	m_Stats = total;
+}
+
+void LightBaker::Upload()
+{
+	if (!m_Buffer)
+		glGenBuffers(1, &m_Buffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_Buffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec4) * m_Baked.size(), m_Baked.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void LightBaker::Record(CommandBuffer& commands, const Mesh& mesh, Entity entity) const
+{
+	if (!m_Buffer || entity >= m_EntityOffsets.size())
+		return;
+
+	commands.BindVertexBuffer(mesh.GetVertexArray(), Mesh::BAKED_LIGHTING_ATTRIBUTE, m_Buffer,
+		m_EntityOffsets[entity] * sizeof(glm::vec4), sizeof(glm::vec4));
+}
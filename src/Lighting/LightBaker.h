@@ -0,0 +1,84 @@
+#pragma once
+
+#include "MeshBVH.h"
+#include "Scene.h"
+
+#include "glm/glm.hpp"
+
+#include <cstdint>
+#include <vector>
+
+class CommandBuffer;
+class JobSystem;
+class Mesh;
+class Model;
+struct Vertex;
+
+struct LightBakeSettings
+{
+	//zrake po vrhu u kosinusno tezinskoj hemisferi, zaokruzuje se na kvadrat zbog stratifikacije
+	unsigned int samples = 64;
+	//0 znaci cetvrtina dijagonale scene
+	float maxDistance = 0.0f;
+	float bias = 1e-3f;
+	std::uint32_t seed = 1;
+
+	glm::vec3 skyColor = glm::vec3(1.0f);
+	glm::vec3 groundColor = glm::vec3(0.3f);
+	//sunColor 0 iskljucuje pecenje sunca i zraku sjene
+	glm::vec3 sunDirection = glm::vec3(0.0f, -1.0f, 0.0f);
+	glm::vec3 sunColor = glm::vec3(0.0f);
+};
+
+struct LightBakeStats
+{
+	std::size_t vertices = 0;
+	std::uint64_t rays = 0;
+	unsigned int threads = 0;
+	double bakeMs = 0.0;
+
+	inline double GetMraysPerSecond() const { return bakeMs > 0.0 ? rays / (bakeMs * 1000.0) : 0.0; }
+};
+
+//peceni ambient po vrhu: rgb irradijancija neba (i sunca) s vidljivoscu, a ambijentalna okluzija
+//zrake idu kroz vlastiti BVH nad trokutima cijele scene u svjetskom prostoru
+//svaki vrh ima svoj generator izveden iz seeda i indeksa vrha pa rezultat ne ovisi o broju dretvi
+class LightBaker
+{
+public:
+	LightBaker() = default;
+	~LightBaker();
+
+	LightBaker(const LightBaker&) = delete;
+	LightBaker& operator=(const LightBaker&) = delete;
+
+	void AddOccluder(const std::vector<Vertex>& vertices, const std::vector<int>& indices, const glm::mat4& world);
+	void BuildOccluders();
+	//svi entiteti scene kao okluderi, meshes indeksirani kao Scene::GetMesh()
+	void BuildOccluders(const Scene& scene, const Model* const* meshes);
+
+	//vrhovi u lokalnom prostoru, out[i] odgovara vertices[i]; seedOffset razdvaja generatore razlicitih instanci
+	void Bake(const std::vector<Vertex>& vertices, const glm::mat4& world, const LightBakeSettings& settings,
+		std::vector<glm::vec4>& out, JobSystem* jobs = nullptr, std::uint32_t seedOffset = 0);
+	//pece sve entitete scene u jedan niz, svaki entitet dobiva svoj odsjecak
+	void BakeScene(const Scene& scene, const Model* const* meshes, const LightBakeSettings& settings, JobSystem* jobs = nullptr);
+
+	//GPU dio: rezultat BakeScene u jedan buffer, Record snima njegovo spajanje na Mesh::BAKED_LIGHTING_ATTRIBUTE VAO-a mesha s pomakom entiteta
+	void Upload();
+	void Record(CommandBuffer& commands, const Mesh& mesh, Entity entity) const;
+
+	inline const MeshBVH& GetOccluders() const { return m_Occluders; }
+	inline const std::vector<glm::vec4>& GetBakedLighting() const { return m_Baked; }
+	inline const LightBakeStats& GetStats() const { return m_Stats; }
+
+private:
+	std::vector<glm::vec3> m_Positions;
+	std::vector<int> m_Indices;
+	MeshBVH m_Occluders;
+
+	std::vector<glm::vec4> m_Baked;
+	std::vector<std::size_t> m_EntityOffsets;
+	unsigned int m_Buffer = 0;
+
+	LightBakeStats m_Stats;
+};
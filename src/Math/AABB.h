@@ -0,0 +1,52 @@
+#pragma once
+
+#include "glm/glm.hpp"
+
+#include <cfloat>
+
+//osno poravnata kutija, prazna kutija ima min > max pa je Expand odmah ispravno postavlja
+struct AABB
+{
+	glm::vec3 minimum = glm::vec3(FLT_MAX);
+	glm::vec3 maximum = glm::vec3(-FLT_MAX);
+
+	AABB() = default;
+	AABB(const glm::vec3& minimum, const glm::vec3& maximum) : minimum(minimum), maximum(maximum) { }
+
+	inline void Expand(const glm::vec3& point) { minimum = glm::min(minimum, point); maximum = glm::max(maximum, point); }
+	inline void Expand(const AABB& box) { minimum = glm::min(minimum, box.minimum); maximum = glm::max(maximum, box.maximum); }
+
+	inline bool IsEmpty() const { return minimum.x > maximum.x; }
+	inline glm::vec3 Center() const { return (minimum + maximum) * 0.5f; }
+	inline glm::vec3 Extent() const { return maximum - minimum; }
+
+	inline float SurfaceArea() const
+	{
+		if (IsEmpty())
+			return 0.0f;
+		glm::vec3 e = Extent();
+		return 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+	}
+
+	inline bool Overlaps(const AABB& box) const
+	{
+		return minimum.x <= box.maximum.x && maximum.x >= box.minimum.x &&
+			minimum.y <= box.maximum.y && maximum.y >= box.minimum.y &&
+			minimum.z <= box.maximum.z && maximum.z >= box.minimum.z;
+	}
+
+	//kutija oko transformirane kutije (Arvo), bez transformiranja svih 8 vrhova
+	inline AABB Transform(const glm::mat4& matrix) const
+	{
+		glm::vec3 translation(matrix[3]);
+		AABB result(translation, translation);
+		for (int column = 0; column < 3; column++)
+		{
+			glm::vec3 a = glm::vec3(matrix[column]) * minimum[column];
+			glm::vec3 b = glm::vec3(matrix[column]) * maximum[column];
+			result.minimum += glm::min(a, b);
+			result.maximum += glm::max(a, b);
+		}
+		return result;
+	}
+};
@@ -0,0 +1,119 @@
+#include "BatchMath.h"
+#include "BatchMathSimd.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__GNUC__)
+#include <cpuid.h>
+#endif
+
+namespace BatchMath
+{
+	static SimdLevel DetectSimdLevel()
+	{
+		int info[4] = { 0, 0, 0, 0 };
+#if defined(_MSC_VER)
+		__cpuid(info, 1);
+#elif defined(__GNUC__)
+		unsigned int a, b, c, d;
+		if (__get_cpuid(1, &a, &b, &c, &d))
+		{
+			info[2] = (int)c;
+			info[3] = (int)d;
+		}
+#endif
+		bool sse = (info[3] & (1 << 25)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+
+		//AVX registri moraju biti ukljuceni i u operacijskom sustavu (XCR0)
+		if (avx && osxsave)
+		{
+#if defined(_MSC_VER)
+			unsigned long long xcr0 = _xgetbv(0);
+#else
+			unsigned int eax, edx;
+			__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+			unsigned long long xcr0 = ((unsigned long long)edx << 32) | eax;
+#endif
+			if ((xcr0 & 0x6) == 0x6)
+				return SimdLevel::AVX;
+		}
+		return sse ? SimdLevel::SSE : SimdLevel::Scalar;
+	}
+
+	SimdLevel GetBestSimdLevel()
+	{
+		static const SimdLevel level = DetectSimdLevel();
+		return level;
+	}
+
+	const char* GetSimdLevelName(SimdLevel level)
+	{
+		switch (level)
+		{
+			case SimdLevel::Scalar: return "scalar";
+			case SimdLevel::SSE: return "sse";
+			case SimdLevel::AVX: return "avx";
+		}
+		return "unknown";
+	}
+
+	void ComposeTRS(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, std::size_t count,
+		void* out, std::size_t outStride, SimdLevel level)
+	{
+		unsigned char* dst = (unsigned char*)out;
+
+		std::size_t done = 0;
+		if (level == SimdLevel::AVX)
+			done = ComposeTRSAvx(positions, rotations, scales, count, dst, outStride);
+		else if (level == SimdLevel::SSE)
+			done = ComposeTRSSse(positions, rotations, scales, count, dst, outStride);
+
+		for (std::size_t i = done; i < count; i++)
+		{
+			glm::mat4 model = glm::mat4_cast(rotations[i]);
+			model[0] *= scales[i].x;
+			model[1] *= scales[i].y;
+			model[2] *= scales[i].z;
+			model[3] = glm::vec4(positions[i], 1.0f);
+			*(glm::mat4*)(dst + i * outStride) = model;
+		}
+	}
+
+	void MultiplyMatrices(const glm::mat4& left, const glm::mat4* matrices, std::size_t count,
+		void* out, std::size_t outStride, SimdLevel level)
+	{
+		unsigned char* dst = (unsigned char*)out;
+
+		std::size_t done = 0;
+		if (level == SimdLevel::AVX)
+			done = MultiplyMatricesAvx(left, matrices, count, dst, outStride);
+		else if (level == SimdLevel::SSE)
+			done = MultiplyMatricesSse(left, matrices, count, dst, outStride);
+
+		for (std::size_t i = done; i < count; i++)
+			*(glm::mat4*)(dst + i * outStride) = left * matrices[i];
+	}
+
+	void ComputeNormalMatrices(const glm::mat4* matrices, std::size_t count,
+		void* out, std::size_t outStride, SimdLevel level)
+	{
+		unsigned char* dst = (unsigned char*)out;
+
+		std::size_t done = 0;
+		if (level == SimdLevel::AVX)
+			done = ComputeNormalMatricesAvx(matrices, count, dst, outStride);
+		else if (level == SimdLevel::SSE)
+			done = ComputeNormalMatricesSse(matrices, count, dst, outStride);
+
+		for (std::size_t i = done; i < count; i++)
+		{
+			glm::mat3 normal = glm::transpose(glm::inverse(glm::mat3(matrices[i])));
+			glm::vec4* columns = (glm::vec4*)(dst + i * outStride);
+			columns[0] = glm::vec4(normal[0], 0.0f);
+			columns[1] = glm::vec4(normal[1], 0.0f);
+			columns[2] = glm::vec4(normal[2], 0.0f);
+		}
+	}
+}
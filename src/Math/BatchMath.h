@@ -0,0 +1,33 @@
+#pragma once
+
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+#include <cstddef>
+
+//obrada transformacija za tisuce objekata u jednom prolazu, 4 (SSE) ili 8 (AVX) objekata odjednom
+//izlaz se pise s korakom outStride bajtova pa moze ici izravno u instance ili UBO buffer
+namespace BatchMath
+{
+	enum class SimdLevel
+	{
+		Scalar,
+		SSE,
+		AVX
+	};
+
+	SimdLevel GetBestSimdLevel();
+	const char* GetSimdLevelName(SimdLevel level);
+
+	//model = T * R * S, izlaz je mat4
+	void ComposeTRS(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, std::size_t count,
+		void* out, std::size_t outStride, SimdLevel level = GetBestSimdLevel());
+
+	//out[i] = left * matrices[i], npr. viewProjection * model
+	void MultiplyMatrices(const glm::mat4& left, const glm::mat4* matrices, std::size_t count,
+		void* out, std::size_t outStride, SimdLevel level = GetBestSimdLevel());
+
+	//transpose(inverse(mat3(model))) zapisan kao tri vec4 stupca (std140 raspored za mat3)
+	void ComputeNormalMatrices(const glm::mat4* matrices, std::size_t count,
+		void* out, std::size_t outStride, SimdLevel level = GetBestSimdLevel());
+}
@@ -0,0 +1,123 @@
+#include "BatchMathSimd.h"
+
+#include <immintrin.h>
+
+//MSVC prevodi AVX intrinsice bez dodatnih opcija, GCC i clang trebaju target za ovu jedinicu prevodenja
+//funkcije iz ove datoteke pozivaju se samo kad GetBestSimdLevel() potvrdi podrsku za AVX
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx")
+#endif
+
+namespace BatchMath
+{
+	struct Avx
+	{
+		typedef __m256 V;
+		static const std::size_t W = 8;
+
+		static inline V Set1(float value) { return _mm256_set1_ps(value); }
+		static inline V Add(V a, V b) { return _mm256_add_ps(a, b); }
+		static inline V Sub(V a, V b) { return _mm256_sub_ps(a, b); }
+		static inline V Mul(V a, V b) { return _mm256_mul_ps(a, b); }
+		static inline V Div(V a, V b) { return _mm256_div_ps(a, b); }
+
+		static inline V Gather(const float* base, std::size_t stride)
+		{
+			const unsigned char* p = (const unsigned char*)base;
+			return _mm256_set_ps(
+				*(const float*)(p + 7 * stride), *(const float*)(p + 6 * stride),
+				*(const float*)(p + 5 * stride), *(const float*)(p + 4 * stride),
+				*(const float*)(p + 3 * stride), *(const float*)(p + 2 * stride),
+				*(const float*)(p + stride), *(const float*)p);
+		}
+
+		//4x4 transpozicija unutar svake 128-bitne polovice; objekti j i j + 4 dijele registar
+		static inline void Transpose(V& r0, V& r1, V& r2, V& r3)
+		{
+			V t0 = _mm256_unpacklo_ps(r0, r1);
+			V t1 = _mm256_unpackhi_ps(r0, r1);
+			V t2 = _mm256_unpacklo_ps(r2, r3);
+			V t3 = _mm256_unpackhi_ps(r2, r3);
+			r0 = _mm256_shuffle_ps(t0, t2, 0x44);
+			r1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+			r2 = _mm256_shuffle_ps(t1, t3, 0x44);
+			r3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+		}
+
+		static inline void LoadColumns(const float* base, std::size_t stride, V out[4])
+		{
+			const unsigned char* p = (const unsigned char*)base;
+			for (int k = 0; k < 4; k++)
+			{
+				__m128 lo = _mm_loadu_ps((const float*)(p + k * stride));
+				__m128 hi = _mm_loadu_ps((const float*)(p + (k + 4) * stride));
+				out[k] = _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+			}
+			Transpose(out[0], out[1], out[2], out[3]);
+		}
+
+		static inline void StoreColumns(float* base, std::size_t stride, const V in[4])
+		{
+			unsigned char* p = (unsigned char*)base;
+			V r[4] = { in[0], in[1], in[2], in[3] };
+			Transpose(r[0], r[1], r[2], r[3]);
+			for (int k = 0; k < 4; k++)
+			{
+				_mm_storeu_ps((float*)(p + k * stride), _mm256_castps256_ps128(r[k]));
+				_mm_storeu_ps((float*)(p + (k + 4) * stride), _mm256_extractf128_ps(r[k], 1));
+			}
+		}
+	};
+}
+
+#include "BatchMathKernels.inl"
+
+namespace BatchMath
+{
+	std::size_t ComposeTRSAvx(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, std::size_t count, unsigned char* out, std::size_t outStride)
+	{
+		return ComposeTRSKernel<Avx>(positions, rotations, scales, count, out, outStride);
+	}
+
+	std::size_t MultiplyMatricesAvx(const glm::mat4& left, const glm::mat4* matrices, std::size_t count, unsigned char* out, std::size_t outStride)
+	{
+		//isti stupac lijeve matrice u obje polovice registra, tako se racunaju dva stupca rezultata odjednom
+		__m256 l[4];
+		for (int c = 0; c < 4; c++)
+			l[c] = _mm256_broadcast_ps((const __m128*)&left[c].x);
+
+		for (std::size_t i = 0; i < count; i++)
+		{
+			const float* m = &matrices[i][0].x;
+			float* dst = (float*)(out + i * outStride);
+			for (int half = 0; half < 2; half++)
+			{
+				__m256 columns = _mm256_loadu_ps(m + 8 * half);
+				__m256 x = _mm256_permute_ps(columns, 0x00);
+				__m256 y = _mm256_permute_ps(columns, 0x55);
+				__m256 z = _mm256_permute_ps(columns, 0xAA);
+				__m256 w = _mm256_permute_ps(columns, 0xFF);
+
+				__m256 result = _mm256_add_ps(
+					_mm256_add_ps(_mm256_mul_ps(l[0], x), _mm256_mul_ps(l[1], y)),
+					_mm256_add_ps(_mm256_mul_ps(l[2], z), _mm256_mul_ps(l[3], w)));
+				_mm256_storeu_ps(dst + 8 * half, result);
+			}
+		}
+		return count;
+	}
+
+	std::size_t ComputeNormalMatricesAvx(const glm::mat4* matrices, std::size_t count, unsigned char* out, std::size_t outStride)
+	{
+		return ComputeNormalMatricesKernel<Avx>(matrices, count, out, outStride);
+	}
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
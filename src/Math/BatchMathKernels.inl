@@ -0,0 +1,107 @@
+//SoA jezgre su pisane jednom i instancirane za svaki skup instrukcija (BatchMathSse.cpp, BatchMathAvx.cpp)
+//Simd tip daje W, V, Set1, Add, Sub, Mul, Div, Gather, LoadColumns i StoreColumns
+//mnozenje matrica ne treba transponiranje pa je napisano posebno u svakoj datoteci
+
+namespace BatchMath
+{
+	template<typename Simd>
+	std::size_t ComposeTRSKernel(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, std::size_t count,
+		unsigned char* out, std::size_t outStride)
+	{
+		typedef typename Simd::V V;
+		const std::size_t W = Simd::W;
+
+		const V one = Simd::Set1(1.0f);
+		const V two = Simd::Set1(2.0f);
+		const V zero = Simd::Set1(0.0f);
+
+		std::size_t i = 0;
+		for (; i + W <= count; i += W)
+		{
+			V q[4];
+			Simd::LoadColumns(&rotations[i].x, sizeof(glm::quat), q);
+
+			V sx = Simd::Gather(&scales[i].x, sizeof(glm::vec3));
+			V sy = Simd::Gather(&scales[i].y, sizeof(glm::vec3));
+			V sz = Simd::Gather(&scales[i].z, sizeof(glm::vec3));
+
+			V xx = Simd::Mul(q[0], q[0]), yy = Simd::Mul(q[1], q[1]), zz = Simd::Mul(q[2], q[2]);
+			V xy = Simd::Mul(q[0], q[1]), xz = Simd::Mul(q[0], q[2]), yz = Simd::Mul(q[1], q[2]);
+			V wx = Simd::Mul(q[3], q[0]), wy = Simd::Mul(q[3], q[1]), wz = Simd::Mul(q[3], q[2]);
+
+			V columns[4][4];
+			columns[0][0] = Simd::Mul(sx, Simd::Sub(one, Simd::Mul(two, Simd::Add(yy, zz))));
+			columns[0][1] = Simd::Mul(sx, Simd::Mul(two, Simd::Add(xy, wz)));
+			columns[0][2] = Simd::Mul(sx, Simd::Mul(two, Simd::Sub(xz, wy)));
+			columns[0][3] = zero;
+
+			columns[1][0] = Simd::Mul(sy, Simd::Mul(two, Simd::Sub(xy, wz)));
+			columns[1][1] = Simd::Mul(sy, Simd::Sub(one, Simd::Mul(two, Simd::Add(xx, zz))));
+			columns[1][2] = Simd::Mul(sy, Simd::Mul(two, Simd::Add(yz, wx)));
+			columns[1][3] = zero;
+
+			columns[2][0] = Simd::Mul(sz, Simd::Mul(two, Simd::Add(xz, wy)));
+			columns[2][1] = Simd::Mul(sz, Simd::Mul(two, Simd::Sub(yz, wx)));
+			columns[2][2] = Simd::Mul(sz, Simd::Sub(one, Simd::Mul(two, Simd::Add(xx, yy))));
+			columns[2][3] = zero;
+
+			columns[3][0] = Simd::Gather(&positions[i].x, sizeof(glm::vec3));
+			columns[3][1] = Simd::Gather(&positions[i].y, sizeof(glm::vec3));
+			columns[3][2] = Simd::Gather(&positions[i].z, sizeof(glm::vec3));
+			columns[3][3] = one;
+
+			unsigned char* dst = out + i * outStride;
+			for (int c = 0; c < 4; c++)
+				Simd::StoreColumns((float*)(dst + c * sizeof(glm::vec4)), outStride, columns[c]);
+		}
+		return i;
+	}
+
+	template<typename Simd>
+	std::size_t ComputeNormalMatricesKernel(const glm::mat4* matrices, std::size_t count, unsigned char* out, std::size_t outStride)
+	{
+		typedef typename Simd::V V;
+		const std::size_t W = Simd::W;
+
+		const V zero = Simd::Set1(0.0f);
+		const V one = Simd::Set1(1.0f);
+
+		std::size_t i = 0;
+		for (; i + W <= count; i += W)
+		{
+			V a[4], b[4], c[4];
+			Simd::LoadColumns(&matrices[i][0].x, sizeof(glm::mat4), a);
+			Simd::LoadColumns(&matrices[i][1].x, sizeof(glm::mat4), b);
+			Simd::LoadColumns(&matrices[i][2].x, sizeof(glm::mat4), c);
+
+			//stupci inverzne transponirane matrice su b x c, c x a i a x b podijeljeni determinantom
+			V bc[4], ca[4], ab[4];
+			bc[0] = Simd::Sub(Simd::Mul(b[1], c[2]), Simd::Mul(b[2], c[1]));
+			bc[1] = Simd::Sub(Simd::Mul(b[2], c[0]), Simd::Mul(b[0], c[2]));
+			bc[2] = Simd::Sub(Simd::Mul(b[0], c[1]), Simd::Mul(b[1], c[0]));
+			ca[0] = Simd::Sub(Simd::Mul(c[1], a[2]), Simd::Mul(c[2], a[1]));
+			ca[1] = Simd::Sub(Simd::Mul(c[2], a[0]), Simd::Mul(c[0], a[2]));
+			ca[2] = Simd::Sub(Simd::Mul(c[0], a[1]), Simd::Mul(c[1], a[0]));
+			ab[0] = Simd::Sub(Simd::Mul(a[1], b[2]), Simd::Mul(a[2], b[1]));
+			ab[1] = Simd::Sub(Simd::Mul(a[2], b[0]), Simd::Mul(a[0], b[2]));
+			ab[2] = Simd::Sub(Simd::Mul(a[0], b[1]), Simd::Mul(a[1], b[0]));
+
+			V det = Simd::Add(Simd::Add(Simd::Mul(a[0], bc[0]), Simd::Mul(a[1], bc[1])), Simd::Mul(a[2], bc[2]));
+			V invDet = Simd::Div(one, det);
+
+			for (int r = 0; r < 3; r++)
+			{
+				bc[r] = Simd::Mul(bc[r], invDet);
+				ca[r] = Simd::Mul(ca[r], invDet);
+				ab[r] = Simd::Mul(ab[r], invDet);
+			}
+			bc[3] = ca[3] = ab[3] = zero;
+
+			unsigned char* dst = out + i * outStride;
+			Simd::StoreColumns((float*)(dst + 0 * sizeof(glm::vec4)), outStride, bc);
+			Simd::StoreColumns((float*)(dst + 1 * sizeof(glm::vec4)), outStride, ca);
+			Simd::StoreColumns((float*)(dst + 2 * sizeof(glm::vec4)), outStride, ab);
+		}
+		return i;
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+#include <cstddef>
+
+//ulazne tocke jezgri za pojedini skup instrukcija, vracaju broj obradenih objekata (visekratnik sirine)
+//ostatak obraduje skalarni kod u BatchMath.cpp
+namespace BatchMath
+{
+	std::size_t ComposeTRSSse(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, std::size_t count, unsigned char* out, std::size_t outStride);
+	std::size_t MultiplyMatricesSse(const glm::mat4& left, const glm::mat4* matrices, std::size_t count, unsigned char* out, std::size_t outStride);
+	std::size_t ComputeNormalMatricesSse(const glm::mat4* matrices, std::size_t count, unsigned char* out, std::size_t outStride);
+
+	std::size_t ComposeTRSAvx(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, std::size_t count, unsigned char* out, std::size_t outStride);
+	std::size_t MultiplyMatricesAvx(const glm::mat4& left, const glm::mat4* matrices, std::size_t count, unsigned char* out, std::size_t outStride);
+	std::size_t ComputeNormalMatricesAvx(const glm::mat4* matrices, std::size_t count, unsigned char* out, std::size_t outStride);
+}
@@ -0,0 +1,85 @@
+#include "BatchMathSimd.h"
+
+#include <immintrin.h>
+
+namespace BatchMath
+{
+	struct Sse
+	{
+		typedef __m128 V;
+		static const std::size_t W = 4;
+
+		static inline V Set1(float value) { return _mm_set1_ps(value); }
+		static inline V Add(V a, V b) { return _mm_add_ps(a, b); }
+		static inline V Sub(V a, V b) { return _mm_sub_ps(a, b); }
+		static inline V Mul(V a, V b) { return _mm_mul_ps(a, b); }
+		static inline V Div(V a, V b) { return _mm_div_ps(a, b); }
+
+		static inline V Gather(const float* base, std::size_t stride)
+		{
+			const unsigned char* p = (const unsigned char*)base;
+			return _mm_set_ps(*(const float*)(p + 3 * stride), *(const float*)(p + 2 * stride),
+				*(const float*)(p + stride), *(const float*)p);
+		}
+
+		//cita vec4 iz svakog od 4 objekta i transponira ih tako da je out[k] k-ta komponenta svih objekata
+		static inline void LoadColumns(const float* base, std::size_t stride, V out[4])
+		{
+			const unsigned char* p = (const unsigned char*)base;
+			V r0 = _mm_loadu_ps((const float*)p);
+			V r1 = _mm_loadu_ps((const float*)(p + stride));
+			V r2 = _mm_loadu_ps((const float*)(p + 2 * stride));
+			V r3 = _mm_loadu_ps((const float*)(p + 3 * stride));
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+			out[0] = r0; out[1] = r1; out[2] = r2; out[3] = r3;
+		}
+
+		static inline void StoreColumns(float* base, std::size_t stride, const V in[4])
+		{
+			unsigned char* p = (unsigned char*)base;
+			V r0 = in[0], r1 = in[1], r2 = in[2], r3 = in[3];
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+			_mm_storeu_ps((float*)p, r0);
+			_mm_storeu_ps((float*)(p + stride), r1);
+			_mm_storeu_ps((float*)(p + 2 * stride), r2);
+			_mm_storeu_ps((float*)(p + 3 * stride), r3);
+		}
+	};
+}
+
+#include "BatchMathKernels.inl"
+
+namespace BatchMath
+{
+	std::size_t ComposeTRSSse(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, std::size_t count, unsigned char* out, std::size_t outStride)
+	{
+		return ComposeTRSKernel<Sse>(positions, rotations, scales, count, out, outStride);
+	}
+
+	std::size_t MultiplyMatricesSse(const glm::mat4& left, const glm::mat4* matrices, std::size_t count, unsigned char* out, std::size_t outStride)
+	{
+		__m128 l[4];
+		for (int c = 0; c < 4; c++)
+			l[c] = _mm_loadu_ps(&left[c].x);
+
+		//stupac rezultata je linearna kombinacija stupaca lijeve matrice
+		for (std::size_t i = 0; i < count; i++)
+		{
+			const float* m = &matrices[i][0].x;
+			float* dst = (float*)(out + i * outStride);
+			for (int c = 0; c < 4; c++)
+			{
+				__m128 result = _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(l[0], _mm_set1_ps(m[4 * c + 0])), _mm_mul_ps(l[1], _mm_set1_ps(m[4 * c + 1]))),
+					_mm_add_ps(_mm_mul_ps(l[2], _mm_set1_ps(m[4 * c + 2])), _mm_mul_ps(l[3], _mm_set1_ps(m[4 * c + 3]))));
+				_mm_storeu_ps(dst + 4 * c, result);
+			}
+		}
+		return count;
+	}
+
+	std::size_t ComputeNormalMatricesSse(const glm::mat4* matrices, std::size_t count, unsigned char* out, std::size_t outStride)
+	{
+		return ComputeNormalMatricesKernel<Sse>(matrices, count, out, outStride);
+	}
+}
@@ -0,0 +1,46 @@
+#include "Frustum.h"
+
+Frustum Frustum::FromMatrix(const glm::mat4& viewProjection)
+{
+	Frustum frustum;
+
+	glm::vec4 row[4];
+	for (int r = 0; r < 4; r++)
+		row[r] = glm::vec4(viewProjection[0][r], viewProjection[1][r], viewProjection[2][r], viewProjection[3][r]);
+
+	frustum.planes[0] = row[3] + row[0];
+	frustum.planes[1] = row[3] - row[0];
+	frustum.planes[2] = row[3] + row[1];
+	frustum.planes[3] = row[3] - row[1];
+	frustum.planes[4] = row[3] + row[2];
+	frustum.planes[5] = row[3] - row[2];
+
+	for (glm::vec4& plane : frustum.planes)
+		plane /= glm::length(glm::vec3(plane));
+
+	return frustum;
+}
+
+bool Frustum::IntersectsSphere(const glm::vec3& center, float radius) const
+{
+	for (const glm::vec4& plane : planes)
+	{
+		if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+			return false;
+	}
+	return true;
+}
+
+bool Frustum::IntersectsAABB(const glm::vec3& minimum, const glm::vec3& maximum) const
+{
+	for (const glm::vec4& plane : planes)
+	{
+		//vrh kutije najdalji u smjeru normale ravnine
+		glm::vec3 positive(plane.x >= 0.0f ? maximum.x : minimum.x,
+			plane.y >= 0.0f ? maximum.y : minimum.y,
+			plane.z >= 0.0f ? maximum.z : minimum.z);
+		if (glm::dot(glm::vec3(plane), positive) + plane.w < 0.0f)
+			return false;
+	}
+	return true;
+}
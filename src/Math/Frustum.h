@@ -0,0 +1,14 @@
+#pragma once
+
+#include "glm/glm.hpp"
+
+//ravnine frustuma izvucene iz matrice projekcije * pogleda, normale gledaju prema unutra
+struct Frustum
+{
+	glm::vec4 planes[6];
+
+	static Frustum FromMatrix(const glm::mat4& viewProjection);
+
+	bool IntersectsSphere(const glm::vec3& center, float radius) const;
+	bool IntersectsAABB(const glm::vec3& minimum, const glm::vec3& maximum) const;
+};
@@ -0,0 +1,346 @@
+#include "MeshBVH.h"
+#include "MeshBVHSimd.h"
+
+#include <algorithm>
+#include <chrono>
+
+//ispod ove dubine SAH, dalje podjela po medijanu pa stog obilaska od 64 cvora uvijek dostaje
+static const unsigned int MAX_SAH_DEPTH = 32;
+static const unsigned int STACK_SIZE = 64;
+
+static double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	return elapsed.count();
+}
+
+static bool IntersectNode(const MeshBVHNode& node, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance)
+{
+	glm::vec3 t1 = (node.minimum - origin) * inverseDirection;
+	glm::vec3 t2 = (node.maximum - origin) * inverseDirection;
+	glm::vec3 tNear = glm::min(t1, t2), tFar = glm::max(t1, t2);
+
+	float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+	float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+	return enter <= exit;
+}
+
+//Moller-Trumbore, vraca udaljenost ili FLT_MAX
+static float IntersectTriangle(const MeshTriangle& triangle, const glm::vec3& origin, const glm::vec3& direction, float& u, float& v)
+{
+	glm::vec3 p = glm::cross(direction, triangle.edge2);
+	float det = glm::dot(triangle.edge1, p);
+	if (det * det <= 1e-16f)
+		return FLT_MAX;
+	float inverse = 1.0f / det;
+
+	glm::vec3 t = origin - triangle.v0;
+	u = glm::dot(t, p) * inverse;
+	if (u < 0.0f || u > 1.0f)
+		return FLT_MAX;
+
+	glm::vec3 q = glm::cross(t, triangle.edge1);
+	v = glm::dot(direction, q) * inverse;
+	if (v < 0.0f || u + v > 1.0f)
+		return FLT_MAX;
+
+	float distance = glm::dot(triangle.edge2, q) * inverse;
+	return distance > 0.0f ? distance : FLT_MAX;
+}
+
+void MeshBVH::Build(const glm::vec3* positions, std::size_t positionStride, const int* indices, std::size_t indexCount)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	m_Nodes.clear();
+	m_Triangles.clear();
+	m_TriangleIds.clear();
+	m_Bounds = AABB();
+	m_Stats = MeshBVHStats();
+
+	std::uint32_t count = (std::uint32_t)(indexCount / 3);
+	if (count == 0)
+		return;
+
+	const unsigned char* base = (const unsigned char*)positions;
+	auto position = [&](int index) { return *(const glm::vec3*)(base + index * positionStride); };
+
+	std::vector<BuildTriangle> triangles(count);
+	for (std::uint32_t i = 0; i < count; i++)
+	{
+		BuildTriangle& triangle = triangles[i];
+		triangle.bounds.Expand(position(indices[3 * i]));
+		triangle.bounds.Expand(position(indices[3 * i + 1]));
+		triangle.bounds.Expand(position(indices[3 * i + 2]));
+		triangle.centroid = triangle.bounds.Center();
+		triangle.index = i;
+	}
+
+	m_Nodes.reserve(2 * count);
+	BuildNode(triangles, 0, count, 0);
+
+	//trokuti u redoslijedu listova da ih obilazak cita uzastopno
+	m_Triangles.resize(count);
+	m_TriangleIds.resize(count);
+	for (std::uint32_t i = 0; i < count; i++)
+	{
+		std::uint32_t index = triangles[i].index;
+		glm::vec3 v0 = position(indices[3 * index]);
+		m_Triangles[i].v0 = v0;
+		m_Triangles[i].edge1 = position(indices[3 * index + 1]) - v0;
+		m_Triangles[i].edge2 = position(indices[3 * index + 2]) - v0;
+		m_TriangleIds[i] = index;
+	}
+
+	m_Bounds = AABB(m_Nodes[0].minimum, m_Nodes[0].maximum);
+	m_Stats.triangles = count;
+	m_Stats.nodes = (unsigned int)m_Nodes.size();
+	m_Stats.buildMs = ElapsedMs(start);
+}
+
+void MeshBVH::BuildNode(std::vector<BuildTriangle>& triangles, std::uint32_t begin, std::uint32_t end, unsigned int depth)
+{
+	struct Bin
+	{
+		AABB bounds;
+		std::uint32_t count = 0;
+	};
+
+	std::uint32_t index = (std::uint32_t)m_Nodes.size();
+	m_Nodes.emplace_back();
+	m_Stats.maxDepth = std::max(m_Stats.maxDepth, depth);
+
+	AABB bounds, centroidBounds;
+	for (std::uint32_t i = begin; i < end; i++)
+	{
+		bounds.Expand(triangles[i].bounds);
+		centroidBounds.Expand(triangles[i].centroid);
+	}
+	m_Nodes[index].minimum = bounds.minimum;
+	m_Nodes[index].maximum = bounds.maximum;
+
+	std::uint32_t count = end - begin;
+	auto makeLeaf = [&]()
+	{
+		m_Nodes[index].rightOrFirst = begin;
+		m_Nodes[index].count = count;
+	};
+	if (count <= MAX_LEAF_SIZE)
+		return makeLeaf();
+
+	glm::vec3 extent = centroidBounds.Extent();
+	int bestAxis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+	std::uint32_t middle = begin + count / 2;
+
+	if (depth < MAX_SAH_DEPTH)
+	{
+		glm::vec3 scale(0.0f);
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (extent[axis] > 0.0f)
+				scale[axis] = BIN_COUNT * 0.9999f / extent[axis];
+		}
+
+		Bin bins[3][BIN_COUNT];
+		for (std::uint32_t i = begin; i < end; i++)
+		{
+			glm::vec3 offset = (triangles[i].centroid - centroidBounds.minimum) * scale;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				Bin& bin = bins[axis][std::min((unsigned int)offset[axis], BIN_COUNT - 1)];
+				bin.bounds.Expand(triangles[i].bounds);
+				bin.count++;
+			}
+		}
+
+		float bestCost = FLT_MAX;
+		int sahAxis = -1;
+		unsigned int bestBin = 0;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (scale[axis] == 0.0f)
+				continue;
+
+			float rightCost[BIN_COUNT];
+			AABB right;
+			std::uint32_t rightCount = 0;
+			for (unsigned int b = BIN_COUNT - 1; b > 0; b--)
+			{
+				right.Expand(bins[axis][b].bounds);
+				rightCount += bins[axis][b].count;
+				rightCost[b] = rightCount * right.SurfaceArea();
+			}
+
+			AABB left;
+			std::uint32_t leftCount = 0;
+			for (unsigned int b = 0; b < BIN_COUNT - 1; b++)
+			{
+				left.Expand(bins[axis][b].bounds);
+				leftCount += bins[axis][b].count;
+				float cost = leftCount * left.SurfaceArea() + rightCost[b + 1];
+				if (leftCount > 0 && leftCount < count && cost < bestCost)
+				{
+					bestCost = cost;
+					sahAxis = axis;
+					bestBin = b;
+				}
+			}
+		}
+
+		//podjela se ne isplati ako je skuplja od testiranja svih trokuta u listu (trosak obilaska ~ 1 trokut)
+		if (count <= 2 * MAX_LEAF_SIZE && bestCost + bounds.SurfaceArea() >= count * bounds.SurfaceArea())
+			return makeLeaf();
+
+		if (sahAxis >= 0)
+		{
+			bestAxis = sahAxis;
+			float axisMinimum = centroidBounds.minimum[bestAxis], axisScale = scale[bestAxis];
+			auto split = std::partition(triangles.begin() + begin, triangles.begin() + end, [&](const BuildTriangle& triangle)
+			{
+				return std::min((unsigned int)((triangle.centroid[bestAxis] - axisMinimum) * axisScale), BIN_COUNT - 1) <= bestBin;
+			});
+			middle = (std::uint32_t)(split - triangles.begin());
+		}
+	}
+
+	//preduboko ili sva sredista u istoj tocki: podjela po medijanu
+	if (depth >= MAX_SAH_DEPTH || middle == begin || middle == end)
+	{
+		middle = begin + count / 2;
+		std::nth_element(triangles.begin() + begin, triangles.begin() + middle, triangles.begin() + end,
+			[&](const BuildTriangle& a, const BuildTriangle& b) { return a.centroid[bestAxis] < b.centroid[bestAxis]; });
+	}
+
+	BuildNode(triangles, begin, middle, depth + 1);
+	std::uint32_t right = (std::uint32_t)m_Nodes.size();
+	BuildNode(triangles, middle, end, depth + 1);
+
+	m_Nodes[index].rightOrFirst = right;
+	m_Nodes[index].count = INTERNAL_NODE | (std::uint32_t)bestAxis;
+}
+
+bool MeshBVH::Intersect(const glm::vec3& origin, const glm::vec3& direction, MeshHit& hit, float maxDistance) const
+{
+	hit = MeshHit();
+	if (m_Nodes.empty())
+		return false;
+
+	glm::vec3 inverseDirection = 1.0f / direction;
+	float best = maxDistance;
+
+	std::uint32_t stack[STACK_SIZE];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0)
+	{
+		std::uint32_t index = stack[--stackSize];
+		const MeshBVHNode& node = m_Nodes[index];
+		if (!IntersectNode(node, origin, inverseDirection, best))
+			continue;
+
+		if (node.count & INTERNAL_NODE)
+		{
+			bool negative = direction[node.count & 3] < 0.0f;
+			stack[stackSize++] = negative ? index + 1 : node.rightOrFirst;
+			stack[stackSize++] = negative ? node.rightOrFirst : index + 1;
+			continue;
+		}
+
+		for (std::uint32_t t = node.rightOrFirst; t < node.rightOrFirst + node.count; t++)
+		{
+			float u, v;
+			float distance = IntersectTriangle(m_Triangles[t], origin, direction, u, v);
+			if (distance < best)
+			{
+				best = distance;
+				hit.triangle = t;
+				hit.distance = distance;
+				hit.u = u;
+				hit.v = v;
+			}
+		}
+	}
+
+	if (!hit.IsHit())
+		return false;
+	hit.triangle = m_TriangleIds[hit.triangle];
+	return true;
+}
+
+bool MeshBVH::Occluded(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const
+{
+	if (m_Nodes.empty())
+		return false;
+
+	glm::vec3 inverseDirection = 1.0f / direction;
+
+	std::uint32_t stack[STACK_SIZE];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0)
+	{
+		std::uint32_t index = stack[--stackSize];
+		const MeshBVHNode& node = m_Nodes[index];
+		if (!IntersectNode(node, origin, inverseDirection, maxDistance))
+			continue;
+
+		if (node.count & INTERNAL_NODE)
+		{
+			bool negative = direction[node.count & 3] < 0.0f;
+			stack[stackSize++] = negative ? index + 1 : node.rightOrFirst;
+			stack[stackSize++] = negative ? node.rightOrFirst : index + 1;
+			continue;
+		}
+
+		for (std::uint32_t t = node.rightOrFirst; t < node.rightOrFirst + node.count; t++)
+		{
+			float u, v;
+			if (IntersectTriangle(m_Triangles[t], origin, direction, u, v) < maxDistance)
+				return true;
+		}
+	}
+	return false;
+}
+
+void MeshBVH::IntersectRays(const glm::vec3* origins, const glm::vec3* directions, std::size_t count, MeshHit* hits,
+	float maxDistance, BatchMath::SimdLevel level) const
+{
+	if (m_Nodes.empty())
+	{
+		std::fill(hits, hits + count, MeshHit());
+		return;
+	}
+
+	std::size_t done = 0;
+	if (level == BatchMath::SimdLevel::AVX)
+		done = MeshBVHKernels::TraceRaysAvx(m_Nodes.data(), m_Triangles.data(), origins, directions, count, maxDistance, hits, nullptr);
+	else if (level == BatchMath::SimdLevel::SSE)
+		done = MeshBVHKernels::TraceRaysSse(m_Nodes.data(), m_Triangles.data(), origins, directions, count, maxDistance, hits, nullptr);
+
+	for (std::size_t i = 0; i < done; i++)
+	{
+		if (hits[i].IsHit())
+			hits[i].triangle = m_TriangleIds[hits[i].triangle];
+	}
+	for (std::size_t i = done; i < count; i++)
+		Intersect(origins[i], directions[i], hits[i], maxDistance);
+}
+
+void MeshBVH::OccludedRays(const glm::vec3* origins, const glm::vec3* directions, std::size_t count, std::uint8_t* occluded,
+	float maxDistance, BatchMath::SimdLevel level) const
+{
+	if (m_Nodes.empty())
+	{
+		std::fill(occluded, occluded + count, (std::uint8_t)0);
+		return;
+	}
+
+	std::size_t done = 0;
+	if (level == BatchMath::SimdLevel::AVX)
+		done = MeshBVHKernels::TraceRaysAvx(m_Nodes.data(), m_Triangles.data(), origins, directions, count, maxDistance, nullptr, occluded);
+	else if (level == BatchMath::SimdLevel::SSE)
+		done = MeshBVHKernels::TraceRaysSse(m_Nodes.data(), m_Triangles.data(), origins, directions, count, maxDistance, nullptr, occluded);
+
+	for (std::size_t i = done; i < count; i++)
+		occluded[i] = Occluded(origins[i], directions[i], maxDistance) ? 1 : 0;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "AABB.h"
+#include "BatchMath.h"
+
+#include "glm/glm.hpp"
+
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct MeshHit
+{
+	std::uint32_t triangle = 0xFFFFFFFF;
+	float distance = FLT_MAX;
+	float u = 0.0f, v = 0.0f;
+
+	inline bool IsHit() const { return triangle != 0xFFFFFFFF; }
+};
+
+//32 bajta, dva cvora u cache liniji; lijevo dijete je odmah iza roditelja (DFS redoslijed)
+struct MeshBVHNode
+{
+	glm::vec3 minimum;
+	//unutarnji cvor: indeks desnog djeteta, list: prvi trokut
+	std::uint32_t rightOrFirst;
+	glm::vec3 maximum;
+	//list: broj trokuta, unutarnji cvor: INTERNAL_NODE | os podjele
+	std::uint32_t count;
+};
+
+//trokut pripremljen za Moller-Trumbore test
+struct MeshTriangle
+{
+	glm::vec3 v0;
+	glm::vec3 edge1;
+	glm::vec3 edge2;
+};
+
+struct MeshBVHStats
+{
+	unsigned int triangles = 0;
+	unsigned int nodes = 0;
+	unsigned int maxDepth = 0;
+	double buildMs = 0.0;
+};
+
+//BVH nad trokutima jednog mesha, gradi se iz CPU kopije vrhova i indeksa
+//zrake se mogu obradivati pojedinacno ili u paketima od 4 (SSE) ili 8 (AVX) zraka
+class MeshBVH
+{
+public:
+	static const std::uint32_t INTERNAL_NODE = 0x80000000;
+	static const unsigned int MAX_LEAF_SIZE = 4;
+	static const unsigned int BIN_COUNT = 16;
+
+	MeshBVH() = default;
+
+	//positions s korakom positionStride bajtova (npr. sizeof(Vertex)), svaka tri indeksa cine trokut
+	void Build(const glm::vec3* positions, std::size_t positionStride, const int* indices, std::size_t indexCount);
+
+	//najblizi pogodak, triangle je indeks trokuta u izvornom redoslijedu indeksa
+	bool Intersect(const glm::vec3& origin, const glm::vec3& direction, MeshHit& hit, float maxDistance = FLT_MAX) const;
+	//bilo koji pogodak, prekida na prvom (sjene, vidljivost)
+	bool Occluded(const glm::vec3& origin, const glm::vec3& direction, float maxDistance = FLT_MAX) const;
+
+	//niz zraka u paketima sirine SIMD razine, ostatak skalarno; uzastopne zrake trebaju biti koherentne
+	void IntersectRays(const glm::vec3* origins, const glm::vec3* directions, std::size_t count, MeshHit* hits,
+		float maxDistance = FLT_MAX, BatchMath::SimdLevel level = BatchMath::GetBestSimdLevel()) const;
+	void OccludedRays(const glm::vec3* origins, const glm::vec3* directions, std::size_t count, std::uint8_t* occluded,
+		float maxDistance = FLT_MAX, BatchMath::SimdLevel level = BatchMath::GetBestSimdLevel()) const;
+
+	inline bool IsEmpty() const { return m_Nodes.empty(); }
+	inline const AABB& GetBounds() const { return m_Bounds; }
+	inline const std::vector<MeshBVHNode>& GetNodes() const { return m_Nodes; }
+	inline const std::vector<MeshTriangle>& GetTriangles() const { return m_Triangles; }
+	inline const MeshBVHStats& GetStats() const { return m_Stats; }
+
+private:
+	struct BuildTriangle
+	{
+		AABB bounds;
+		glm::vec3 centroid;
+		std::uint32_t index;
+	};
+
+	void BuildNode(std::vector<BuildTriangle>& triangles, std::uint32_t begin, std::uint32_t end, unsigned int depth);
+
+private:
+	std::vector<MeshBVHNode> m_Nodes;
+	std::vector<MeshTriangle> m_Triangles;
+	std::vector<std::uint32_t> m_TriangleIds;
+	AABB m_Bounds;
+
+	MeshBVHStats m_Stats;
+};
@@ -0,0 +1,63 @@
+#include "MeshBVHSimd.h"
+
+#include <immintrin.h>
+
+//isto kao BatchMathAvx.cpp: target samo za ovu jedinicu, poziva se tek nakon provjere GetBestSimdLevel()
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx")
+#endif
+
+namespace MeshBVHKernels
+{
+	struct Avx
+	{
+		typedef __m256 V;
+		static const std::size_t W = 8;
+
+		static inline V Set1(float value) { return _mm256_set1_ps(value); }
+		static inline V Add(V a, V b) { return _mm256_add_ps(a, b); }
+		static inline V Sub(V a, V b) { return _mm256_sub_ps(a, b); }
+		static inline V Mul(V a, V b) { return _mm256_mul_ps(a, b); }
+		static inline V Div(V a, V b) { return _mm256_div_ps(a, b); }
+		static inline V Min(V a, V b) { return _mm256_min_ps(a, b); }
+		static inline V Max(V a, V b) { return _mm256_max_ps(a, b); }
+		static inline V And(V a, V b) { return _mm256_and_ps(a, b); }
+		static inline V CmpLE(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+		static inline V CmpLT(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+		static inline V CmpGT(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+		static inline V CmpGE(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+		static inline V Blend(V a, V b, V mask) { return _mm256_blendv_ps(a, b, mask); }
+		static inline int MoveMask(V a) { return _mm256_movemask_ps(a); }
+		static inline void Store(float* out, V a) { _mm256_storeu_ps(out, a); }
+
+		static inline V Gather(const float* base, std::size_t stride)
+		{
+			const unsigned char* p = (const unsigned char*)base;
+			return _mm256_set_ps(
+				*(const float*)(p + 7 * stride), *(const float*)(p + 6 * stride),
+				*(const float*)(p + 5 * stride), *(const float*)(p + 4 * stride),
+				*(const float*)(p + 3 * stride), *(const float*)(p + 2 * stride),
+				*(const float*)(p + stride), *(const float*)p);
+		}
+	};
+}
+
+#include "MeshBVHKernels.inl"
+
+namespace MeshBVHKernels
+{
+	std::size_t TraceRaysAvx(const MeshBVHNode* nodes, const MeshTriangle* triangles, const glm::vec3* origins, const glm::vec3* directions,
+		std::size_t count, float maxDistance, MeshHit* hits, std::uint8_t* occluded)
+	{
+		return TraceRaysKernel<Avx>(nodes, triangles, origins, directions, count, maxDistance, hits, occluded);
+	}
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
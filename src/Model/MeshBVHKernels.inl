@@ -0,0 +1,146 @@
+//paketna jezgra je pisana jednom i instancirana za svaki skup instrukcija (MeshBVHSse.cpp, MeshBVHAvx.cpp)
+//Simd tip daje W, V, Set1, Add, Sub, Mul, Div, Min, Max, And, CmpLE, CmpLT, CmpGT, CmpGE, Blend, MoveMask, Gather i Store
+//svi trakovi paketa obilaze stablo zajedno, cvor se preskace kad ga ne pogada nijedna aktivna zraka
+
+namespace MeshBVHKernels
+{
+	template<typename Simd>
+	std::size_t TraceRaysKernel(const MeshBVHNode* nodes, const MeshTriangle* triangles, const glm::vec3* origins, const glm::vec3* directions,
+		std::size_t count, float maxDistance, MeshHit* hits, std::uint8_t* occluded)
+	{
+		typedef typename Simd::V V;
+		const std::size_t W = Simd::W;
+		const int allLanes = (1 << W) - 1;
+		const bool anyHit = occluded != nullptr;
+
+		const V zero = Simd::Set1(0.0f);
+		const V one = Simd::Set1(1.0f);
+		const V epsilon = Simd::Set1(1e-16f);
+
+		std::size_t i = 0;
+		for (; i + W <= count; i += W)
+		{
+			V ox = Simd::Gather(&origins[i].x, sizeof(glm::vec3));
+			V oy = Simd::Gather(&origins[i].y, sizeof(glm::vec3));
+			V oz = Simd::Gather(&origins[i].z, sizeof(glm::vec3));
+			V dx = Simd::Gather(&directions[i].x, sizeof(glm::vec3));
+			V dy = Simd::Gather(&directions[i].y, sizeof(glm::vec3));
+			V dz = Simd::Gather(&directions[i].z, sizeof(glm::vec3));
+			V ix = Simd::Div(one, dx), iy = Simd::Div(one, dy), iz = Simd::Div(one, dz);
+
+			V best = Simd::Set1(maxDistance), bestU = zero, bestV = zero;
+			std::uint32_t triangle[W];
+			for (std::size_t lane = 0; lane < W; lane++)
+				triangle[lane] = 0xFFFFFFFF;
+			int done = 0;
+
+			std::uint32_t stack[64];
+			unsigned int stackSize = 0;
+			stack[stackSize++] = 0;
+
+			while (stackSize > 0 && done != allLanes)
+			{
+				std::uint32_t index = stack[--stackSize];
+				const MeshBVHNode& node = nodes[index];
+
+				V x1 = Simd::Mul(Simd::Sub(Simd::Set1(node.minimum.x), ox), ix);
+				V x2 = Simd::Mul(Simd::Sub(Simd::Set1(node.maximum.x), ox), ix);
+				V y1 = Simd::Mul(Simd::Sub(Simd::Set1(node.minimum.y), oy), iy);
+				V y2 = Simd::Mul(Simd::Sub(Simd::Set1(node.maximum.y), oy), iy);
+				V z1 = Simd::Mul(Simd::Sub(Simd::Set1(node.minimum.z), oz), iz);
+				V z2 = Simd::Mul(Simd::Sub(Simd::Set1(node.maximum.z), oz), iz);
+				V enter = Simd::Max(Simd::Max(Simd::Min(x1, x2), Simd::Min(y1, y2)), Simd::Max(Simd::Min(z1, z2), zero));
+				V exit = Simd::Min(Simd::Min(Simd::Max(x1, x2), Simd::Max(y1, y2)), Simd::Min(Simd::Max(z1, z2), best));
+
+				int mask = Simd::MoveMask(Simd::CmpLE(enter, exit)) & ~done;
+				if (!mask)
+					continue;
+
+				if (node.count & MeshBVH::INTERNAL_NODE)
+				{
+					//blize dijete po smjeru prve aktivne zrake ide na vrh stoga
+					int lane = 0;
+					while (!(mask & (1 << lane)))
+						lane++;
+					bool negative = directions[i + lane][node.count & 3] < 0.0f;
+
+					std::uint32_t left = index + 1, right = node.rightOrFirst;
+					stack[stackSize++] = negative ? left : right;
+					stack[stackSize++] = negative ? right : left;
+					continue;
+				}
+
+				for (std::uint32_t t = node.rightOrFirst; t < node.rightOrFirst + node.count; t++)
+				{
+					const MeshTriangle& tri = triangles[t];
+					V e1x = Simd::Set1(tri.edge1.x), e1y = Simd::Set1(tri.edge1.y), e1z = Simd::Set1(tri.edge1.z);
+					V e2x = Simd::Set1(tri.edge2.x), e2y = Simd::Set1(tri.edge2.y), e2z = Simd::Set1(tri.edge2.z);
+
+					//Moller-Trumbore za W zraka odjednom
+					V px = Simd::Sub(Simd::Mul(dy, e2z), Simd::Mul(dz, e2y));
+					V py = Simd::Sub(Simd::Mul(dz, e2x), Simd::Mul(dx, e2z));
+					V pz = Simd::Sub(Simd::Mul(dx, e2y), Simd::Mul(dy, e2x));
+					V det = Simd::Add(Simd::Add(Simd::Mul(e1x, px), Simd::Mul(e1y, py)), Simd::Mul(e1z, pz));
+					V inverse = Simd::Div(one, det);
+
+					V tx = Simd::Sub(ox, Simd::Set1(tri.v0.x));
+					V ty = Simd::Sub(oy, Simd::Set1(tri.v0.y));
+					V tz = Simd::Sub(oz, Simd::Set1(tri.v0.z));
+					V u = Simd::Mul(Simd::Add(Simd::Add(Simd::Mul(tx, px), Simd::Mul(ty, py)), Simd::Mul(tz, pz)), inverse);
+
+					V qx = Simd::Sub(Simd::Mul(ty, e1z), Simd::Mul(tz, e1y));
+					V qy = Simd::Sub(Simd::Mul(tz, e1x), Simd::Mul(tx, e1z));
+					V qz = Simd::Sub(Simd::Mul(tx, e1y), Simd::Mul(ty, e1x));
+					V v = Simd::Mul(Simd::Add(Simd::Add(Simd::Mul(dx, qx), Simd::Mul(dy, qy)), Simd::Mul(dz, qz)), inverse);
+					V distance = Simd::Mul(Simd::Add(Simd::Add(Simd::Mul(e2x, qx), Simd::Mul(e2y, qy)), Simd::Mul(e2z, qz)), inverse);
+
+					V hit = Simd::And(Simd::CmpGT(Simd::Mul(det, det), epsilon), Simd::CmpGE(u, zero));
+					hit = Simd::And(hit, Simd::And(Simd::CmpGE(v, zero), Simd::CmpLE(Simd::Add(u, v), one)));
+					hit = Simd::And(hit, Simd::And(Simd::CmpGT(distance, zero), Simd::CmpLT(distance, best)));
+
+					int hitMask = Simd::MoveMask(hit) & ~done;
+					if (!hitMask)
+						continue;
+
+					best = Simd::Blend(best, distance, hit);
+					bestU = Simd::Blend(bestU, u, hit);
+					bestV = Simd::Blend(bestV, v, hit);
+					for (std::size_t lane = 0; lane < W; lane++)
+					{
+						if (hitMask & (1 << lane))
+							triangle[lane] = t;
+					}
+
+					if (anyHit)
+					{
+						done |= hitMask;
+						if (done == allLanes)
+							break;
+					}
+				}
+			}
+
+			if (anyHit)
+			{
+				for (std::size_t lane = 0; lane < W; lane++)
+					occluded[i + lane] = (done & (1 << lane)) ? 1 : 0;
+				continue;
+			}
+
+			float distances[W], us[W], vs[W];
+			Simd::Store(distances, best);
+			Simd::Store(us, bestU);
+			Simd::Store(vs, bestV);
+			for (std::size_t lane = 0; lane < W; lane++)
+			{
+				MeshHit& result = hits[i + lane];
+				result.triangle = triangle[lane];
+				result.distance = triangle[lane] != 0xFFFFFFFF ? distances[lane] : FLT_MAX;
+				result.u = us[lane];
+				result.v = vs[lane];
+			}
+		}
+
+		return i;
+	}
+}
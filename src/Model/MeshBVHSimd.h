@@ -0,0 +1,15 @@
+#pragma once
+
+#include "MeshBVH.h"
+
+//ulazne tocke paketnih jezgri, vracaju broj obradenih zraka (visekratnik sirine paketa)
+//indeksi trokuta u rezultatu su u redoslijedu BVH-a, ostatak i preslikavanje radi MeshBVH.cpp
+//occluded == nullptr znaci najblizi pogodak, inace bilo koji pogodak
+namespace MeshBVHKernels
+{
+	std::size_t TraceRaysSse(const MeshBVHNode* nodes, const MeshTriangle* triangles, const glm::vec3* origins, const glm::vec3* directions,
+		std::size_t count, float maxDistance, MeshHit* hits, std::uint8_t* occluded);
+
+	std::size_t TraceRaysAvx(const MeshBVHNode* nodes, const MeshTriangle* triangles, const glm::vec3* origins, const glm::vec3* directions,
+		std::size_t count, float maxDistance, MeshHit* hits, std::uint8_t* occluded);
+}
@@ -0,0 +1,47 @@
+#include "MeshBVHSimd.h"
+
+#include <immintrin.h>
+
+namespace MeshBVHKernels
+{
+	struct Sse
+	{
+		typedef __m128 V;
+		static const std::size_t W = 4;
+
+		static inline V Set1(float value) { return _mm_set1_ps(value); }
+		static inline V Add(V a, V b) { return _mm_add_ps(a, b); }
+		static inline V Sub(V a, V b) { return _mm_sub_ps(a, b); }
+		static inline V Mul(V a, V b) { return _mm_mul_ps(a, b); }
+		static inline V Div(V a, V b) { return _mm_div_ps(a, b); }
+		static inline V Min(V a, V b) { return _mm_min_ps(a, b); }
+		static inline V Max(V a, V b) { return _mm_max_ps(a, b); }
+		static inline V And(V a, V b) { return _mm_and_ps(a, b); }
+		static inline V CmpLE(V a, V b) { return _mm_cmple_ps(a, b); }
+		static inline V CmpLT(V a, V b) { return _mm_cmplt_ps(a, b); }
+		static inline V CmpGT(V a, V b) { return _mm_cmpgt_ps(a, b); }
+		static inline V CmpGE(V a, V b) { return _mm_cmpge_ps(a, b); }
+		//SSE2 nema blendv, maska je cijela rijec pa je dovoljna bitovna kombinacija
+		static inline V Blend(V a, V b, V mask) { return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a)); }
+		static inline int MoveMask(V a) { return _mm_movemask_ps(a); }
+		static inline void Store(float* out, V a) { _mm_storeu_ps(out, a); }
+
+		static inline V Gather(const float* base, std::size_t stride)
+		{
+			const unsigned char* p = (const unsigned char*)base;
+			return _mm_set_ps(*(const float*)(p + 3 * stride), *(const float*)(p + 2 * stride),
+				*(const float*)(p + stride), *(const float*)p);
+		}
+	};
+}
+
+#include "MeshBVHKernels.inl"
+
+namespace MeshBVHKernels
+{
+	std::size_t TraceRaysSse(const MeshBVHNode* nodes, const MeshTriangle* triangles, const glm::vec3* origins, const glm::vec3* directions,
+		std::size_t count, float maxDistance, MeshHit* hits, std::uint8_t* occluded)
+	{
+		return TraceRaysKernel<Sse>(nodes, triangles, origins, directions, count, maxDistance, hits, occluded);
+	}
+}
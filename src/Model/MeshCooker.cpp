@@ -0,0 +1,482 @@
+#include "MeshCooker.h"
+
+#include "Model.h"
+#include "FileSystem.h"
+
+#include "glm/gtc/packing.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+static const std::uint32_t CMESH_MAGIC = 0x48534D43; //"CMSH"
+static const std::uint32_t CMESH_VERSION = 1;
+
+static const std::uint32_t NO_VERTEX = ~0u;
+
+//tezine bodovanja vrhova iz Forsythovog "Linear-Speed Vertex Cache Optimisation"
+static const unsigned int MAX_CACHE_SIZE = 64;
+static const float CACHE_DECAY_POWER = 1.5f;
+static const float LAST_TRIANGLE_SCORE = 0.75f;
+static const float VALENCE_BOOST_SCALE = 2.0f;
+static const float VALENCE_BOOST_POWER = 0.5f;
+
+static double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	return elapsed.count();
+}
+
+//bitovi komponenti vrha, -0.0 i 0.0 su isti kljuc
+struct WeldKey
+{
+	std::uint32_t bits[8];
+	unsigned int count;
+
+	bool operator==(const WeldKey& other) const { return count == other.count && std::memcmp(bits, other.bits, count * sizeof(std::uint32_t)) == 0; }
+};
+
+struct WeldKeyHash
+{
+	std::size_t operator()(const WeldKey& key) const
+	{
+		std::uint64_t hash = 14695981039346656037ull;
+		for (unsigned int i = 0; i < key.count; i++)
+		{
+			hash ^= key.bits[i];
+			hash *= 1099511628211ull;
+		}
+		return (std::size_t)hash;
+	}
+};
+
+static WeldKey MakeWeldKey(const Vertex& vertex, bool withNormal)
+{
+	float components[8] = { vertex.position.x, vertex.position.y, vertex.position.z, vertex.textureCordinates.x, vertex.textureCordinates.y,
+		vertex.normal.x, vertex.normal.y, vertex.normal.z };
+	WeldKey key;
+	key.count = withNormal ? 8 : 5;
+	for (unsigned int i = 0; i < key.count; i++)
+	{
+		float value = components[i] == 0.0f ? 0.0f : components[i];
+		std::memcpy(&key.bits[i], &value, sizeof(float));
+	}
+	return key;
+}
+
+static float VertexScore(int cachePosition, std::uint32_t remaining, unsigned int cacheSize)
+{
+	if (remaining == 0)
+		return -1.0f;
+
+	float score = 0.0f;
+	if (cachePosition >= 0)
+	{
+		//vrhovi zadnjeg trokuta dobivaju fiksni bod da se ne favorizira trokut koji ih samo ponavlja
+		if (cachePosition < 3)
+			score = LAST_TRIANGLE_SCORE;
+		else
+			score = std::pow(1.0f - (float)(cachePosition - 3) / (float)(cacheSize - 3), CACHE_DECAY_POWER);
+	}
+	//vrhovi s malo preostalih trokuta se zavrsavaju prvi da ne ostanu osamljeni
+	return score + VALENCE_BOOST_SCALE * std::pow((float)remaining, -VALENCE_BOOST_POWER);
+}
+
+static void OctEncode(const glm::vec3& normal, std::int16_t* out)
+{
+	float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+	glm::vec2 p = length > 0.0f ? glm::vec2(normal.x, normal.y) / length : glm::vec2(0.0f);
+	if (normal.z < 0.0f)
+	{
+		glm::vec2 folded = glm::vec2(1.0f) - glm::abs(glm::vec2(p.y, p.x));
+		p = glm::vec2(p.x >= 0.0f ? folded.x : -folded.x, p.y >= 0.0f ? folded.y : -folded.y);
+	}
+	out[0] = (std::int16_t)std::lround(glm::clamp(p.x, -1.0f, 1.0f) * 32767.0f);
+	out[1] = (std::int16_t)std::lround(glm::clamp(p.y, -1.0f, 1.0f) * 32767.0f);
+}
+
+static glm::vec3 OctDecode(const std::int16_t* in)
+{
+	glm::vec2 p = glm::max(glm::vec2(in[0], in[1]) / 32767.0f, glm::vec2(-1.0f));
+	glm::vec3 normal(p.x, p.y, 1.0f - std::abs(p.x) - std::abs(p.y));
+	float t = std::max(-normal.z, 0.0f);
+	normal.x += normal.x >= 0.0f ? -t : t;
+	normal.y += normal.y >= 0.0f ? -t : t;
+	return glm::normalize(normal);
+}
+
+bool MeshCooker::Cook(const std::string& objPath, CookedMesh& out, MeshCookStats& stats, const MeshCookSettings& settings)
+{
+	if (!FileSystem::Exists(objPath))
+	{
+		std::cerr << "MESH NOT FOUND: " << objPath << std::endl;
+		return false;
+	}
+
+	std::vector<Vertex> vertices;
+	std::vector<int> indices;
+	Mesh::LoadMesh(objPath, vertices, indices);
+	if (indices.size() < 3)
+	{
+		std::cerr << "MESH HAS NO TRIANGLES: " << objPath << std::endl;
+		return false;
+	}
+
+	Cook(vertices, indices, out, stats, settings);
+	return true;
+}
+
+void MeshCooker::Cook(const std::vector<Vertex>& vertices, const std::vector<int>& indices, CookedMesh& out, MeshCookStats& stats,
+	const MeshCookSettings& settings)
+{
+	stats = MeshCookStats();
+	stats.inputVertices = (unsigned int)vertices.size();
+	stats.triangles = (unsigned int)(indices.size() / 3);
+
+	auto start = std::chrono::high_resolution_clock::now();
+	std::vector<Vertex> welded;
+	std::vector<std::uint32_t> weldedIndices;
+	Weld(vertices, indices, settings.normalWeldAngle, welded, weldedIndices);
+	stats.vertices = (unsigned int)welded.size();
+	stats.weldMs = ElapsedMs(start);
+
+	start = std::chrono::high_resolution_clock::now();
+	stats.acmrBefore = ComputeACMR(weldedIndices, welded.size(), settings.cacheSize);
+	OptimizeVertexCache(weldedIndices, welded.size(), settings.cacheSize);
+	OptimizeVertexFetch(welded, weldedIndices);
+	stats.acmrAfter = ComputeACMR(weldedIndices, welded.size(), settings.cacheSize);
+	stats.optimizeMs = ElapsedMs(start);
+
+	start = std::chrono::high_resolution_clock::now();
+	Quantize(welded, out);
+	out.indices = std::move(weldedIndices);
+	stats.quantizeMs = ElapsedMs(start);
+
+	std::vector<Vertex> restored;
+	Dequantize(out, restored);
+	for (std::size_t i = 0; i < welded.size(); i++)
+	{
+		glm::vec3 error = glm::abs(restored[i].position - welded[i].position);
+		stats.maxPositionError = std::max(stats.maxPositionError, std::max(error.x, std::max(error.y, error.z)));
+	}
+}
+
+void MeshCooker::Weld(const std::vector<Vertex>& vertices, const std::vector<int>& indices, float normalWeldAngle,
+	std::vector<Vertex>& outVertices, std::vector<std::uint32_t>& outIndices)
+{
+	outVertices.clear();
+	outIndices.clear();
+	outIndices.reserve(indices.size());
+
+	//s kutom se kljuc gradi bez normale, a vrhovi istog kljuca su ulancani preko next
+	bool exact = normalWeldAngle <= 0.0f;
+	float cosAngle = std::cos(glm::radians(std::min(normalWeldAngle, 180.0f)));
+	std::unordered_map<WeldKey, std::uint32_t, WeldKeyHash> heads;
+	heads.reserve(indices.size());
+	std::vector<std::uint32_t> next;
+	std::vector<glm::vec3> normalSums;
+
+	for (int index : indices)
+	{
+		const Vertex& vertex = vertices[index];
+		WeldKey key = MakeWeldKey(vertex, exact);
+		auto found = heads.find(key);
+
+		glm::vec3 normal = glm::dot(vertex.normal, vertex.normal) > 0.0f ? glm::normalize(vertex.normal) : vertex.normal;
+		std::uint32_t match = NO_VERTEX;
+		for (std::uint32_t candidate = found != heads.end() ? found->second : NO_VERTEX; candidate != NO_VERTEX; candidate = next[candidate])
+		{
+			if (exact || glm::dot(glm::normalize(outVertices[candidate].normal), normal) >= cosAngle)
+			{
+				match = candidate;
+				break;
+			}
+		}
+
+		if (match == NO_VERTEX)
+		{
+			match = (std::uint32_t)outVertices.size();
+			outVertices.push_back(vertex);
+			normalSums.push_back(glm::vec3(0.0f));
+			if (found != heads.end())
+			{
+				next.push_back(found->second);
+				found->second = match;
+			}
+			else
+			{
+				next.push_back(NO_VERTEX);
+				heads.emplace(key, match);
+			}
+		}
+		normalSums[match] += normal;
+		outIndices.push_back(match);
+	}
+
+	if (!exact)
+	{
+		for (std::size_t i = 0; i < outVertices.size(); i++)
+		{
+			if (glm::dot(normalSums[i], normalSums[i]) > 0.0f)
+				outVertices[i].normal = glm::normalize(normalSums[i]);
+		}
+	}
+}
+
+void MeshCooker::OptimizeVertexCache(std::vector<std::uint32_t>& indices, std::size_t vertexCount, unsigned int cacheSize)
+{
+	std::size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0 || vertexCount == 0)
+		return;
+	cacheSize = std::max(4u, std::min(cacheSize, MAX_CACHE_SIZE));
+
+	//trokuti svakog vrha, emitirani trokut se uklanja zamjenom sa zadnjim u rasponu vrha
+	std::vector<std::uint32_t> remaining(vertexCount, 0);
+	for (std::uint32_t index : indices)
+		remaining[index]++;
+	std::vector<std::uint32_t> offsets(vertexCount + 1, 0);
+	for (std::size_t v = 0; v < vertexCount; v++)
+		offsets[v + 1] = offsets[v] + remaining[v];
+	std::vector<std::uint32_t> adjacency(indices.size());
+	std::vector<std::uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+	for (std::size_t i = 0; i < indices.size(); i++)
+		adjacency[cursor[indices[i]]++] = (std::uint32_t)(i / 3);
+
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScore(vertexCount);
+	for (std::size_t v = 0; v < vertexCount; v++)
+		vertexScore[v] = VertexScore(-1, remaining[v], cacheSize);
+
+	std::vector<float> triangleScore(triangleCount);
+	std::size_t best = 0;
+	for (std::size_t t = 0; t < triangleCount; t++)
+	{
+		triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+		if (triangleScore[t] > triangleScore[best])
+			best = t;
+	}
+
+	std::vector<bool> emitted(triangleCount, false);
+	std::vector<std::uint32_t> result;
+	result.reserve(triangleCount * 3);
+	std::vector<std::uint32_t> cache, nextCache;
+	cache.reserve(cacheSize + 3);
+	nextCache.reserve(cacheSize + 3);
+	std::size_t scanCursor = 0;
+
+	auto updateScore = [&](std::uint32_t vertex)
+	{
+		float score = VertexScore(cachePosition[vertex], remaining[vertex], cacheSize);
+		float delta = score - vertexScore[vertex];
+		vertexScore[vertex] = score;
+		for (std::uint32_t i = offsets[vertex]; i < offsets[vertex] + remaining[vertex]; i++)
+			triangleScore[adjacency[i]] += delta;
+	};
+
+	while (true)
+	{
+		const std::uint32_t* triangle = &indices[best * 3];
+		emitted[best] = true;
+		nextCache.clear();
+		for (int k = 0; k < 3; k++)
+		{
+			std::uint32_t vertex = triangle[k];
+			result.push_back(vertex);
+
+			std::uint32_t* first = &adjacency[offsets[vertex]];
+			std::uint32_t* last = first + remaining[vertex] - 1;
+			*std::find(first, last + 1, (std::uint32_t)best) = *last;
+			remaining[vertex]--;
+
+			if (std::find(nextCache.begin(), nextCache.end(), vertex) == nextCache.end())
+				nextCache.push_back(vertex);
+		}
+		for (std::uint32_t vertex : cache)
+		{
+			if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+				nextCache.push_back(vertex);
+		}
+
+		//vrhovi koji ispadnu iz cachea gube bodove pozicije
+		for (std::size_t i = cacheSize; i < nextCache.size(); i++)
+		{
+			cachePosition[nextCache[i]] = -1;
+			updateScore(nextCache[i]);
+		}
+		if (nextCache.size() > cacheSize)
+			nextCache.resize(cacheSize);
+		for (std::size_t i = 0; i < nextCache.size(); i++)
+		{
+			cachePosition[nextCache[i]] = (int)i;
+			updateScore(nextCache[i]);
+		}
+		cache.swap(nextCache);
+
+		if (result.size() == triangleCount * 3)
+			break;
+
+		//sljedeci trokut se trazi samo medu trokutima vrhova u cacheu
+		float bestScore = -1.0f;
+		best = triangleCount;
+		for (std::uint32_t vertex : cache)
+		{
+			for (std::uint32_t i = offsets[vertex]; i < offsets[vertex] + remaining[vertex]; i++)
+			{
+				std::uint32_t candidate = adjacency[i];
+				if (triangleScore[candidate] > bestScore)
+				{
+					bestScore = triangleScore[candidate];
+					best = candidate;
+				}
+			}
+		}
+		if (best == triangleCount)
+		{
+			while (emitted[scanCursor])
+				scanCursor++;
+			best = scanCursor;
+		}
+	}
+
+	indices.swap(result);
+}
+
+void MeshCooker::OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<std::uint32_t>& indices)
+{
+	std::vector<std::uint32_t> remap(vertices.size(), NO_VERTEX);
+	std::vector<Vertex> reordered;
+	reordered.reserve(vertices.size());
+	for (std::uint32_t& index : indices)
+	{
+		if (remap[index] == NO_VERTEX)
+		{
+			remap[index] = (std::uint32_t)reordered.size();
+			reordered.push_back(vertices[index]);
+		}
+		index = remap[index];
+	}
+	vertices.swap(reordered);
+}
+
+float MeshCooker::ComputeACMR(const std::vector<std::uint32_t>& indices, std::size_t vertexCount, unsigned int cacheSize)
+{
+	if (indices.size() < 3)
+		return 0.0f;
+
+	//vrh je u FIFO cacheu ako je od njegovog ulaska bilo manje od cacheSize promasaja
+	std::vector<std::uint32_t> entered(vertexCount, 0);
+	std::uint32_t time = cacheSize + 1;
+	std::size_t misses = 0;
+	for (std::uint32_t index : indices)
+	{
+		if (time - entered[index] > cacheSize)
+		{
+			entered[index] = time++;
+			misses++;
+		}
+	}
+	return (float)misses / (float)(indices.size() / 3);
+}
+
+void MeshCooker::Quantize(const std::vector<Vertex>& vertices, CookedMesh& out)
+{
+	out.bounds = AABB();
+	for (const Vertex& vertex : vertices)
+		out.bounds.Expand(vertex.position);
+
+	glm::vec3 extent = out.bounds.Extent();
+	glm::vec3 scale(extent.x > 0.0f ? 65535.0f / extent.x : 0.0f, extent.y > 0.0f ? 65535.0f / extent.y : 0.0f, extent.z > 0.0f ? 65535.0f / extent.z : 0.0f);
+
+	out.vertices.resize(vertices.size());
+	for (std::size_t i = 0; i < vertices.size(); i++)
+	{
+		const Vertex& vertex = vertices[i];
+		QuantizedVertex& quantized = out.vertices[i];
+		glm::vec3 position = glm::clamp((vertex.position - out.bounds.minimum) * scale, glm::vec3(0.0f), glm::vec3(65535.0f));
+		for (int k = 0; k < 3; k++)
+			quantized.position[k] = (std::uint16_t)std::lround(position[k]);
+		quantized.position[3] = 0;
+		OctEncode(vertex.normal, quantized.normal);
+		quantized.texCoord[0] = (std::uint16_t)glm::packHalf1x16(vertex.textureCordinates.x);
+		quantized.texCoord[1] = (std::uint16_t)glm::packHalf1x16(vertex.textureCordinates.y);
+	}
+}
+
+void MeshCooker::Dequantize(const CookedMesh& mesh, std::vector<Vertex>& vertices)
+{
+	glm::vec3 step = mesh.bounds.IsEmpty() ? glm::vec3(0.0f) : mesh.bounds.Extent() / 65535.0f;
+	vertices.clear();
+	vertices.reserve(mesh.vertices.size());
+	for (const QuantizedVertex& quantized : mesh.vertices)
+	{
+		glm::vec3 position = mesh.bounds.minimum + glm::vec3(quantized.position[0], quantized.position[1], quantized.position[2]) * step;
+		glm::vec2 texCoord(glm::unpackHalf1x16(quantized.texCoord[0]), glm::unpackHalf1x16(quantized.texCoord[1]));
+		vertices.push_back(Vertex(position, OctDecode(quantized.normal), texCoord));
+	}
+}
+
+bool MeshCooker::Save(const std::string& path, const CookedMesh& mesh)
+{
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+	{
+		std::cerr << "FILE COULD NOT OPEN: " << path << std::endl;
+		return false;
+	}
+
+	std::uint32_t header[4] = { CMESH_MAGIC, CMESH_VERSION, (std::uint32_t)mesh.vertices.size(), (std::uint32_t)mesh.indices.size() };
+	float bounds[6] = { mesh.bounds.minimum.x, mesh.bounds.minimum.y, mesh.bounds.minimum.z, mesh.bounds.maximum.x, mesh.bounds.maximum.y, mesh.bounds.maximum.z };
+	file.write((const char*)header, sizeof(header));
+	file.write((const char*)bounds, sizeof(bounds));
+	file.write((const char*)mesh.vertices.data(), mesh.vertices.size() * sizeof(QuantizedVertex));
+	file.write((const char*)mesh.indices.data(), mesh.indices.size() * sizeof(std::uint32_t));
+	return (bool)file;
+}
+
+bool MeshCooker::Load(const std::string& path, CookedMesh& mesh)
+{
+	FileData file;
+	if (!FileSystem::Read(path, file))
+		return false;
+
+	std::uint32_t header[4] = {};
+	float bounds[6] = {};
+	const std::size_t headerSize = sizeof(header) + sizeof(bounds);
+	if (file.GetSize() >= headerSize)
+	{
+		std::memcpy(header, file.GetData(), sizeof(header));
+		std::memcpy(bounds, file.GetData() + sizeof(header), sizeof(bounds));
+	}
+	std::size_t vertexBytes = (std::size_t)header[2] * sizeof(QuantizedVertex);
+	std::size_t indexBytes = (std::size_t)header[3] * sizeof(std::uint32_t);
+	if (header[0] != CMESH_MAGIC || header[1] != CMESH_VERSION || file.GetSize() != headerSize + vertexBytes + indexBytes)
+	{
+		std::cerr << "INVALID COOKED MESH: " << path << std::endl;
+		return false;
+	}
+
+	mesh.bounds = AABB(glm::vec3(bounds[0], bounds[1], bounds[2]), glm::vec3(bounds[3], bounds[4], bounds[5]));
+	mesh.vertices.resize(header[2]);
+	mesh.indices.resize(header[3]);
+	std::memcpy(mesh.vertices.data(), file.GetData() + headerSize, vertexBytes);
+	std::memcpy(mesh.indices.data(), file.GetData() + headerSize + vertexBytes, indexBytes);
+	for (std::uint32_t index : mesh.indices)
+	{
+		if (index >= header[2])
+		{
+			std::cerr << "INVALID COOKED MESH: " << path << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+bool MeshCooker::IsCookedPath(const std::string& path)
+{
+	const std::string extension = ".cmesh";
+	return path.size() > extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "AABB.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct Vertex;
+
+//16 bajtova umjesto 32: pozicija unorm16 unutar kutije mesha, normala oktaedarski snorm16, UV half float
+struct QuantizedVertex
+{
+	std::uint16_t position[4];
+	std::int16_t normal[2];
+	std::uint16_t texCoord[2];
+};
+
+struct CookedMesh
+{
+	//kutija u kojoj su kvantizirane pozicije
+	AABB bounds;
+	std::vector<QuantizedVertex> vertices;
+	std::vector<std::uint32_t> indices;
+};
+
+struct MeshCookSettings
+{
+	//velicina simuliranog FIFO cachea vrhova za optimizaciju i ACMR
+	unsigned int cacheSize = 32;
+	//0 spaja samo identicne vrhove; vise od 0 spaja i vrhove iste pozicije i UV-a cije se normale razlikuju najvise toliko stupnjeva
+	//(normala je tada prosjek), npr. za glatko sjencanje meshova bez vn
+	float normalWeldAngle = 0.0f;
+};
+
+struct MeshCookStats
+{
+	unsigned int inputVertices = 0;
+	unsigned int vertices = 0;
+	unsigned int triangles = 0;
+	//promasaji cachea vrhova po trokutu, prije i nakon optimizacije
+	float acmrBefore = 0.0f;
+	float acmrAfter = 0.0f;
+	//najveca greska pozicije nakon kvantizacije, u jedinicama mesha
+	float maxPositionError = 0.0f;
+	double weldMs = 0.0;
+	double optimizeMs = 0.0;
+	double quantizeMs = 0.0;
+};
+
+//offline priprema mesha iz .obj: spajanje vrhova u indeksirani mesh, redoslijed trokuta za cache vrhova (Forsyth),
+//redoslijed vrhova po prvoj upotrebi i kvantizacija; rezultat se sprema u .cmesh koji Mesh::LoadMesh cita izravno
+class MeshCooker
+{
+public:
+	static bool Cook(const std::string& objPath, CookedMesh& out, MeshCookStats& stats, const MeshCookSettings& settings = MeshCookSettings());
+	//vrhovi i indeksi kakve daje Mesh::LoadMesh
+	static void Cook(const std::vector<Vertex>& vertices, const std::vector<int>& indices, CookedMesh& out, MeshCookStats& stats,
+		const MeshCookSettings& settings = MeshCookSettings());
+
+	static void Weld(const std::vector<Vertex>& vertices, const std::vector<int>& indices, float normalWeldAngle,
+		std::vector<Vertex>& outVertices, std::vector<std::uint32_t>& outIndices);
+	//mijenja samo redoslijed trokuta
+	static void OptimizeVertexCache(std::vector<std::uint32_t>& indices, std::size_t vertexCount, unsigned int cacheSize = 32);
+	//preslaguje vrhove redom prve upotrebe u indeksima i prepisuje indekse
+	static void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<std::uint32_t>& indices);
+	//average cache miss ratio uz FIFO cache, 3.0 je najgore, oko 0.5-0.7 dobro za tipicne meshove
+	static float ComputeACMR(const std::vector<std::uint32_t>& indices, std::size_t vertexCount, unsigned int cacheSize = 32);
+
+	static void Quantize(const std::vector<Vertex>& vertices, CookedMesh& out);
+	static void Dequantize(const CookedMesh& mesh, std::vector<Vertex>& vertices);
+
+	//.cmesh: zaglavlje (magic, verzija, broj vrhova i indeksa, kutija) pa vrhovi i indeksi
+	static bool Save(const std::string& path, const CookedMesh& mesh);
+	static bool Load(const std::string& path, CookedMesh& mesh);
+	static bool IsCookedPath(const std::string& path);
+};
@@ -1,26 +1,48 @@
 #include "glad/glad.h"
 #include "Model.h"
+#include "MeshBVH.h"
+#include "MeshCooker.h"
+#include "FileSystem.h"
 
 #include <assert.h>
+#include <algorithm>
+
+//mora odgovarati std140 rasporedu bloka DrawBlock u vShader.glsl
+static_assert(sizeof(DrawData) == 224, "DrawData layout");
 
 Vertex::Vertex(glm::vec3 pos, glm::vec3 norm, glm::vec2 texCor) 
 	: position(pos), normal(norm), textureCordinates(texCor) { }
 
 Mesh::Mesh(const std::string& meshPath)
 {
-	LoadMesh(meshPath);
+	LoadMesh(meshPath, m_Mesh, m_Indices);
 	SetupMesh();
 }
 
 Mesh::~Mesh()
 {
+    glDeleteBuffers(1, &m_BakedVBO);
+    glDeleteBuffers(1, &m_PositionVBO);
+    glDeleteVertexArrays(1, &m_DepthVAO);
     glDeleteBuffers(1, &m_EBO);
     glDeleteBuffers(1, &m_VBO);
     glDeleteVertexArrays(1, &m_RenderID);
 }
 
-void Mesh::LoadMesh(const std::string& meshPath)
+void Mesh::LoadMesh(const std::string& meshPath, std::vector<Vertex>& vertices, std::vector<int>& indices)
 {
+    //.cmesh iz assetcook-a je vec spojen, optimiziran i kvantiziran, ovdje se samo vraca u float vrhove
+    if (MeshCooker::IsCookedPath(meshPath))
+    {
+        CookedMesh cooked;
+        if (MeshCooker::Load(meshPath, cooked))
+        {
+            MeshCooker::Dequantize(cooked, vertices);
+            indices.assign(cooked.indices.begin(), cooked.indices.end());
+        }
+        return;
+    }
+
     std::vector<glm::vec3> positions;
     std::vector<glm::vec3> normals;
     std::vector<glm::vec2> texCord;
@@ -33,9 +55,10 @@ void Mesh::LoadMesh(const std::string& meshPath)
     std::string readLine;
     std::string attribute;
 
-    std::ifstream objFile{ meshPath, std::ios::in };
-    if (!objFile)
-        std::cerr << "FILE COULD NOT OPEN\n";
+    //iz montiranog packa ili s diska (FileSystem), parser cita iz memorije
+    FileData objData;
+    FileSystem::Read(meshPath, objData);
+    std::istringstream objFile(objData.ToString());
 
     float x = 0, y = 0, z = 0;
     std::string temp;
@@ -111,7 +134,7 @@ void Mesh::LoadMesh(const std::string& meshPath)
                     std::cerr << "Formatting not supported!" << std::endl;
 
 
-                m_Indices.push_back(index++);
+                indices.push_back(index++);
 
                 temp_indices.push_back(x - 1);
                 if (y != 0) {
@@ -125,14 +148,13 @@ void Mesh::LoadMesh(const std::string& meshPath)
             }
         }
     }
-    objFile.close();
 
     for (unsigned int f = 0; f < temp_indices.size(); f+=3) {
         x = temp_indices[f];
         y = temp_indices[f + 1];
         z = temp_indices[f + 2];
 
-        m_Mesh.push_back(Vertex(positions[x], normals[y], texCord[z]));
+        vertices.push_back(Vertex(positions[x], normals[y], texCord[z]));
     
     }
 }
@@ -159,29 +181,106 @@ void Mesh::SetupMesh()
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(2 * sizeof(glm::vec3)));
     glEnableVertexAttribArray(2);
 
+    //korak 0 u vezanju buffera znaci da svi vrhovi citaju isti element, LightBaker::Record ga zamjenjuje pecenim podacima
+    const glm::vec4 unbaked(1.0f);
+    glGenBuffers(1, &m_BakedVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_BakedVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec4), &unbaked, GL_STATIC_DRAW);
+    glVertexAttribFormat(BAKED_LIGHTING_ATTRIBUTE, 4, GL_FLOAT, GL_FALSE, 0);
+    glVertexAttribBinding(BAKED_LIGHTING_ATTRIBUTE, BAKED_LIGHTING_ATTRIBUTE);
+    glBindVertexBuffer(BAKED_LIGHTING_ATTRIBUTE, m_BakedVBO, 0, 0);
+    glEnableVertexAttribArray(BAKED_LIGHTING_ATTRIBUTE);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindVertexArray(0);
+
+    //pozicije se izdvajaju u gusti buffer kako depth pre-pass ne bi citao normale i UV koordinate
+    std::vector<glm::vec3> positions;
+    positions.reserve(m_Mesh.size());
+    for (const Vertex& vertex : m_Mesh)
+        positions.push_back(vertex.position);
+
+    m_Bounds = AABB(glm::vec3(0.0f), glm::vec3(0.0f));
+    if (!positions.empty())
+        m_Bounds = AABB(positions[0], positions[0]);
+    for (const glm::vec3& position : positions)
+        m_Bounds.Expand(position);
+
+    glm::vec3 center = m_Bounds.Center();
+    float radius = 0.0f;
+    for (const glm::vec3& position : positions)
+        radius = std::max(radius, glm::length(position - center));
+    m_BoundingSphere = glm::vec4(center, radius);
+
+    glGenVertexArrays(1, &m_DepthVAO);
+    glGenBuffers(1, &m_PositionVBO);
+    glBindVertexArray(m_DepthVAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_PositionVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * positions.size(), positions.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+    glEnableVertexAttribArray(0);
+
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     glBindVertexArray(0);
 }
 
-void Mesh::Draw(const Shader& shader, const Texture& texture) const
+void Mesh::BuildBVH()
 {
-    shader.Bind();
-    texture.Bind();
-    glBindVertexArray(m_RenderID);
+    if (!m_BVH)
+        m_BVH = std::make_unique<MeshBVH>();
+    m_BVH->Build(m_Mesh.empty() ? nullptr : &m_Mesh[0].position, sizeof(Vertex), m_Indices.data(), m_Indices.size());
+}
+
+void Mesh::DrawDepth() const
+{
+    glBindVertexArray(m_DepthVAO);
 
     glDrawElements(GL_TRIANGLES, m_Indices.size(), GL_UNSIGNED_INT, 0);
 
     glBindVertexArray(0);
 }
 
+void Mesh::Record(CommandBuffer& commands, const Shader& shader, const Texture& texture, const BufferSlice& drawData) const
+{
+    commands.BindTexture(0, texture.GetID());
+    Record(commands, shader, drawData);
+}
+
+void Mesh::Record(CommandBuffer& commands, const Shader& shader, const BufferSlice& drawData) const
+{
+    commands.BindProgram(shader.GetID());
+    commands.BindUniformBlock(DRAW_DATA_BINDING, drawData.buffer, drawData.offset, drawData.size);
+    commands.BindVertexArray(m_RenderID);
+    commands.DrawIndexed((unsigned int)m_Indices.size());
+}
+
 
 Model::Model(const std::string& meshPath) 
     : m_Mesh(std::make_unique<Mesh>(meshPath)) { }
 
 Model::~Model() {}
 
-void Model::Draw(const Shader& shader, const Texture& texture) const
+void Model::DrawDepth() const
+{
+    m_Mesh->DrawDepth();
+}
+
+void Model::BuildBVH()
+{
+    m_Mesh->BuildBVH();
+}
+
+void Model::Record(CommandBuffer& commands, const Shader& shader, const Texture& texture, const BufferSlice& drawData) const
+{
+    m_Mesh->Record(commands, shader, texture, drawData);
+}
+
+void Model::Record(CommandBuffer& commands, const Shader& shader, const BufferSlice& drawData) const
 {
-    m_Mesh->Draw(shader, texture);
+    m_Mesh->Record(commands, shader, drawData);
 }
\ No newline at end of file
@@ -12,6 +12,11 @@
 
 #include "Shader.h"
 #include "Texture.h"
+#include "CommandBuffer.h"
+#include "RingBuffer.h"
+#include "AABB.h"
+
+class MeshBVH;
 
 struct Vertex
 {
@@ -22,25 +27,73 @@ struct Vertex
     Vertex(glm::vec3 pos, glm::vec3 norm = glm::vec3(0.0f, 0.0f, 0.0f), glm::vec2 texCor = glm::vec3(0.0f, 0.0f, 0.0f));
 };
 
+//blok DrawBlock iz vShader.glsl (std140), jedan po pozivu crtanja u ring bufferu
+struct DrawData
+{
+    glm::mat4 model;
+    glm::mat4 mvp;
+    //mat3 u std140 su tri vec4 stupca, kao BatchMath::ComputeNormalMatrices
+    glm::mat3x4 normalMatrix;
+    //xyz boja objekta, w spekularna jakost
+    glm::vec4 colorSpecular;
+    //pravokutnik u nizu iz TexturePackera (xy pomak, zw skala), bez pakiranja (0, 0, 1, 1)
+    glm::vec4 uvRect;
+    //x je sloj u nizu
+    glm::vec4 textureLayer;
+};
+
 class Mesh
 {
 public:
+    //ulaz vShader.glsl s pecenim ambientom (LightBaker), bez pecenja svi vrhovi citaju (1, 1, 1, 1)
+    static const unsigned int BAKED_LIGHTING_ATTRIBUTE = 3;
+    //binding bloka DrawBlock u vShader.glsl
+    static const unsigned int DRAW_DATA_BINDING = 0;
+
     Mesh() = delete;
     Mesh(const std::string& meshPath);
     ~Mesh();
 
-    void Draw(const Shader& shader, const Texture& texture) const;
+    //drawData je DrawData ovog poziva u ring bufferu, snima se kao raspon na DRAW_DATA_BINDING
+    void Record(CommandBuffer& commands, const Shader& shader, const Texture& texture, const BufferSlice& drawData) const;
+    //bez vezanja teksture, kad je pass vec vezao niz iz TexturePackera
+    void Record(CommandBuffer& commands, const Shader& shader, const BufferSlice& drawData) const;
+
+    //crta samo pozicije iz zasebnog buffera, za depth pre-pass
+    void DrawDepth() const;
+
+    inline unsigned int GetVertexArray() const { return m_RenderID; }
+    inline unsigned int GetDepthVertexArray() const { return m_DepthVAO; }
+
+    //sfera oko svih vrhova u lokalnom prostoru: xyz sredina, w radijus
+    inline const glm::vec4& GetBoundingSphere() const { return m_BoundingSphere; }
+    inline const AABB& GetBounds() const { return m_Bounds; }
+    inline unsigned int GetIndexCount() const { return (unsigned int)m_Indices.size(); }
+    inline const std::vector<Vertex>& GetVertices() const { return m_Mesh; }
+    inline const std::vector<int>& GetIndices() const { return m_Indices; }
+
+    //BVH nad trokutima za zrake na CPU-u (pick, AO), gradi se na zahtjev iz CPU kopije vrhova
+    void BuildBVH();
+    inline const MeshBVH* GetBVH() const { return m_BVH.get(); }
+
+    //cita .obj bez GL-a, vrhovi su raspakirani pa indeksi idu redom; .cmesh (MeshCooker) daje spojene vrhove
+    static void LoadMesh(const std::string& meshPath, std::vector<Vertex>& vertices, std::vector<int>& indices);
 
 private:
-    void LoadMesh(const std::string& meshPath);
     void SetupMesh();
 
 private:
     unsigned int m_RenderID;
     unsigned int m_VBO, m_EBO;
+    unsigned int m_DepthVAO, m_PositionVBO;
+    unsigned int m_BakedVBO;
 
     std::vector<Vertex> m_Mesh;
     std::vector<int> m_Indices;
+    glm::vec4 m_BoundingSphere;
+    AABB m_Bounds;
+
+    std::unique_ptr<MeshBVH> m_BVH;
 };
 
 class Model
@@ -50,7 +103,12 @@ public:
     Model(const std::string& meshPath);
     ~Model();
 
-    void Draw(const Shader& shader, const Texture& texture) const;
+    void Record(CommandBuffer& commands, const Shader& shader, const Texture& texture, const BufferSlice& drawData) const;
+    void Record(CommandBuffer& commands, const Shader& shader, const BufferSlice& drawData) const;
+    void DrawDepth() const;
+    void BuildBVH();
+
+    inline const Mesh& GetMesh() const { return *m_Mesh; }
 private:
     std::unique_ptr<Mesh> m_Mesh;
 };
\ No newline at end of file
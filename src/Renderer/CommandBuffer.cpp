@@ -0,0 +1,82 @@
+#include "CommandBuffer.h"
+
+#include <cstring>
+
+static_assert(sizeof(RenderCommand) == 32, "RenderCommand layout");
+
+bool operator==(const RenderCommand& a, const RenderCommand& b)
+{
+	return std::memcmp(&a, &b, sizeof(RenderCommand)) == 0;
+}
+
+RenderCommand& CommandBuffer::Push(CommandType type)
+{
+	m_Commands.emplace_back();
+	RenderCommand& command = m_Commands.back();
+	//nuliranje cijelog zapisa da usporedba s memcmp ne ovisi o neiskoristenim poljima unije
+	std::memset(&command, 0, sizeof(RenderCommand));
+	command.type = type;
+	return command;
+}
+
+void CommandBuffer::BindProgram(unsigned int program)
+{
+	Push(CommandType::BindProgram).bindProgram.program = program;
+}
+
+void CommandBuffer::BindVertexArray(unsigned int vertexArray)
+{
+	Push(CommandType::BindVertexArray).bindVertexArray.vertexArray = vertexArray;
+}
+
+void CommandBuffer::BindTexture(unsigned int slot, unsigned int texture)
+{
+	RenderCommand& command = Push(CommandType::BindTexture);
+	command.bindTexture.slot = slot;
+	command.bindTexture.texture = texture;
+}
+
+void CommandBuffer::BindTextureArray(unsigned int slot, unsigned int texture)
+{
+	RenderCommand& command = Push(CommandType::BindTextureArray);
+	command.bindTexture.slot = slot;
+	command.bindTexture.texture = texture;
+}
+
+void CommandBuffer::BindVertexBuffer(unsigned int vertexArray, unsigned int bindingIndex, unsigned int buffer, std::size_t offset, unsigned int stride)
+{
+	RenderCommand& command = Push(CommandType::BindVertexBuffer);
+	command.bindVertexBuffer.vertexArray = vertexArray;
+	command.bindVertexBuffer.bindingIndex = bindingIndex;
+	command.bindVertexBuffer.buffer = buffer;
+	command.bindVertexBuffer.stride = stride;
+	command.bindVertexBuffer.offset = offset;
+}
+
+void CommandBuffer::BindUniformBlock(unsigned int binding, unsigned int buffer, std::size_t offset, std::size_t size)
+{
+	RenderCommand& command = Push(CommandType::BindUniformBlock);
+	command.bindBlock.binding = binding;
+	command.bindBlock.buffer = buffer;
+	command.bindBlock.offset = offset;
+	command.bindBlock.size = size;
+}
+
+void CommandBuffer::BindStorageBlock(unsigned int binding, unsigned int buffer, std::size_t offset, std::size_t size)
+{
+	RenderCommand& command = Push(CommandType::BindStorageBlock);
+	command.bindBlock.binding = binding;
+	command.bindBlock.buffer = buffer;
+	command.bindBlock.offset = offset;
+	command.bindBlock.size = size;
+}
+
+void CommandBuffer::DrawIndexed(unsigned int indexCount, unsigned int firstIndex, int baseVertex, unsigned int instanceCount, unsigned int baseInstance)
+{
+	RenderCommand& command = Push(CommandType::DrawIndexed);
+	command.drawIndexed.indexCount = indexCount;
+	command.drawIndexed.firstIndex = firstIndex;
+	command.drawIndexed.baseVertex = baseVertex;
+	command.drawIndexed.instanceCount = instanceCount;
+	command.drawIndexed.baseInstance = baseInstance;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class CommandType : std::uint32_t
+{
+	BindProgram,
+	BindVertexArray,
+	BindTexture,
+	BindTextureArray,
+	BindVertexBuffer,
+	BindUniformBlock,
+	BindStorageBlock,
+	DrawIndexed
+};
+
+//kompaktni POD zapis jedne naredbe, 32 bajta jer su pomaci u bufferima 64-bitni
+struct RenderCommand
+{
+	CommandType type;
+	union
+	{
+		struct { unsigned int program; } bindProgram;
+		struct { unsigned int vertexArray; } bindVertexArray;
+		struct { unsigned int slot; unsigned int texture; } bindTexture;
+		struct { unsigned int vertexArray; unsigned int bindingIndex; unsigned int buffer; unsigned int stride; std::uint64_t offset; } bindVertexBuffer;
+		struct { unsigned int binding; unsigned int buffer; std::uint64_t offset; std::uint64_t size; } bindBlock;
+		struct { unsigned int indexCount; unsigned int firstIndex; int baseVertex; unsigned int instanceCount; unsigned int baseInstance; } drawIndexed;
+	};
+};
+
+bool operator==(const RenderCommand& a, const RenderCommand& b);
+inline bool operator!=(const RenderCommand& a, const RenderCommand& b) { return !(a == b); }
+
+//naredbe se snimaju bez GL konteksta (na bilo kojoj dretvi), a izvrsava ih Renderer na dretvi konteksta
+class CommandBuffer
+{
+public:
+	CommandBuffer() = default;
+
+	void BindProgram(unsigned int program);
+	void BindVertexArray(unsigned int vertexArray);
+	void BindTexture(unsigned int slot, unsigned int texture);
+	//GL_TEXTURE_2D_ARRAY, npr. niz iz TexturePackera
+	void BindTextureArray(unsigned int slot, unsigned int texture);
+	//buffer na binding index VAO-a (glVertexArrayVertexBuffer), npr. peceno osvjetljenje entiteta iz LightBakera
+	void BindVertexBuffer(unsigned int vertexArray, unsigned int bindingIndex, unsigned int buffer, std::size_t offset, unsigned int stride);
+	void BindUniformBlock(unsigned int binding, unsigned int buffer, std::size_t offset, std::size_t size);
+	void BindStorageBlock(unsigned int binding, unsigned int buffer, std::size_t offset, std::size_t size);
+	void DrawIndexed(unsigned int indexCount, unsigned int firstIndex = 0, int baseVertex = 0, unsigned int instanceCount = 1, unsigned int baseInstance = 0);
+
+	inline void Clear() { m_Commands.clear(); }
+	inline void Reserve(std::size_t count) { m_Commands.reserve(count); }
+	inline std::size_t Size() const { return m_Commands.size(); }
+	inline const std::vector<RenderCommand>& GetCommands() const { return m_Commands; }
+
+private:
+	RenderCommand& Push(CommandType type);
+
+private:
+	std::vector<RenderCommand> m_Commands;
+};
@@ -0,0 +1,261 @@
+#include "glad/glad.h"
+
+#include "DeferredRenderer.h"
+#include "Frustum.h"
+
+#include <cmath>
+
+static std::vector<FramebufferAttachment> GBufferLayout()
+{
+	return {
+		{ GL_RGBA16F, GL_RGBA, GL_FLOAT },
+		{ GL_RGBA16F, GL_RGBA, GL_FLOAT },
+		{ GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE },
+		{ GL_RGBA16F, GL_RGBA, GL_FLOAT }
+	};
+}
+
+DeferredRenderer::DeferredRenderer(unsigned int width, unsigned int height)
+	: m_GBuffer(width, height, GBufferLayout(), true),
+	m_GeometryShader("res/shaders/vShader.glsl", "res/shaders/fGBuffer.glsl"),
+	m_StencilShader("res/shaders/vLightVolume.glsl", "res/shaders/fNull.glsl"),
+	m_LightShader("res/shaders/vLightVolume.glsl", "res/shaders/fDeferredLight.glsl"),
+	m_CompositeShader("res/shaders/vFullscreen.glsl", "res/shaders/fDeferredComposite.glsl"),
+	m_SphereVAO(0), m_SphereVBO(0), m_SphereEBO(0), m_SphereIndexCount(0), m_FullscreenVAO(0),
+	m_PendingQueries(0)
+{
+	CreateSphere(16, 12);
+
+	glGenVertexArrays(1, &m_FullscreenVAO);
+
+	m_LightShader.Bind();
+	m_LightShader.SetUniformInt("gPosition", POSITION);
+	m_LightShader.SetUniformInt("gNormal", NORMAL);
+	m_LightShader.SetUniformInt("gAlbedoSpec", ALBEDO_SPECULAR);
+
+	m_CompositeShader.Bind();
+	m_CompositeShader.SetUniformInt("gPosition", POSITION);
+	m_CompositeShader.SetUniformInt("gAlbedoSpec", ALBEDO_SPECULAR);
+	m_CompositeShader.SetUniformInt("lightAccumulation", LIGHT_ACCUMULATION);
+	m_CompositeShader.UnBind();
+}
+
+DeferredRenderer::~DeferredRenderer()
+{
+	if (!m_SamplesQueries.empty())
+		glDeleteQueries((GLsizei)m_SamplesQueries.size(), m_SamplesQueries.data());
+	glDeleteVertexArrays(1, &m_FullscreenVAO);
+	glDeleteBuffers(1, &m_SphereEBO);
+	glDeleteBuffers(1, &m_SphereVBO);
+	glDeleteVertexArrays(1, &m_SphereVAO);
+}
+
+void DeferredRenderer::CreateSphere(unsigned int segments, unsigned int rings)
+{
+	//poligonalna sfera lezi unutar prave pa se vrhovi povecavaju da volumen sigurno obuhvati svjetlo
+	const float pi = 3.14159265f;
+	float bound = 1.0f / (std::cos(pi / segments) * std::cos(pi / (2 * rings)));
+
+	std::vector<glm::vec3> positions;
+	for (unsigned int r = 0; r <= rings; r++)
+	{
+		float phi = pi * r / rings;
+		for (unsigned int s = 0; s <= segments; s++)
+		{
+			float theta = 2.0f * pi * s / segments;
+			positions.push_back(bound * glm::vec3(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta)));
+		}
+	}
+
+	std::vector<unsigned int> indices;
+	for (unsigned int r = 0; r < rings; r++)
+	{
+		for (unsigned int s = 0; s < segments; s++)
+		{
+			unsigned int a = r * (segments + 1) + s;
+			unsigned int b = a + segments + 1;
+			indices.insert(indices.end(), { a, a + 1, b, b, a + 1, b + 1 });
+		}
+	}
+	m_SphereIndexCount = (unsigned int)indices.size();
+
+	glGenVertexArrays(1, &m_SphereVAO);
+	glGenBuffers(1, &m_SphereVBO);
+	glGenBuffers(1, &m_SphereEBO);
+	glBindVertexArray(m_SphereVAO);
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_SphereVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * positions.size(), positions.data(), GL_STATIC_DRAW);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_SphereEBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * indices.size(), indices.data(), GL_STATIC_DRAW);
+
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+	glEnableVertexAttribArray(0);
+
+	glBindVertexArray(0);
+}
+
+void DeferredRenderer::Resize(unsigned int width, unsigned int height)
+{
+	m_GBuffer.Resize(width, height);
+}
+
+void DeferredRenderer::BeginGeometryPass()
+{
+	m_GBuffer.Bind();
+
+	//akumulacija i G-buffer se brisu zajedno, w = 0 u poziciji oznacava prazan piksel
+	m_GBuffer.SetDrawBuffers({ POSITION, NORMAL, ALBEDO_SPECULAR, LIGHT_ACCUMULATION });
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glDepthMask(GL_TRUE);
+	glStencilMask(0xFF);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+	m_GBuffer.SetDrawBuffers({ POSITION, NORMAL, ALBEDO_SPECULAR });
+	glEnable(GL_DEPTH_TEST);
+	glDisable(GL_BLEND);
+
+	m_GeometryShader.Bind();
+}
+
+void DeferredRenderer::EndGeometryPass()
+{
+	m_GeometryShader.UnBind();
+}
+
+void DeferredRenderer::LightingPass(const std::vector<PointLight>& lights, const glm::mat4& viewProjection, const glm::vec3& viewPos)
+{
+	if (m_PendingQueries > 0)
+	{
+		GLuint available = 1;
+		for (unsigned int i = 0; i < m_PendingQueries && available; i++)
+			glGetQueryObjectuiv(m_SamplesQueries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available)
+		{
+			m_Stats.shadedSamples = 0;
+			for (unsigned int i = 0; i < m_PendingQueries; i++)
+			{
+				GLuint64 samples = 0;
+				glGetQueryObjectui64v(m_SamplesQueries[i], GL_QUERY_RESULT, &samples);
+				m_Stats.shadedSamples += samples;
+			}
+			m_PendingQueries = 0;
+		}
+	}
+
+	m_Stats.lights = (unsigned int)lights.size();
+	m_Stats.culledLights = 0;
+	m_Stats.drawCalls = 0;
+
+	m_GBuffer.Bind();
+	m_GBuffer.BindColorTexture(POSITION, POSITION);
+	m_GBuffer.BindColorTexture(NORMAL, NORMAL);
+	m_GBuffer.BindColorTexture(ALBEDO_SPECULAR, ALBEDO_SPECULAR);
+
+	m_LightShader.Bind();
+	m_LightShader.SetUniform4x4("viewProjection", viewProjection);
+	m_LightShader.SetUniformVec2("screenSize", glm::vec2((float)m_GBuffer.GetWidth(), (float)m_GBuffer.GetHeight()));
+	m_LightShader.SetUniformVec3("viewPos", viewPos);
+	m_StencilShader.Bind();
+	m_StencilShader.SetUniform4x4("viewProjection", viewProjection);
+
+	glEnable(GL_STENCIL_TEST);
+	glDepthMask(GL_FALSE);
+	glBlendFunc(GL_ONE, GL_ONE);
+	glBindVertexArray(m_SphereVAO);
+
+	Frustum frustum = Frustum::FromMatrix(viewProjection);
+
+	//novi upiti krecu tek kad su prethodni procitani; stencil crtezi u njima nisu jer ne sjencaju
+	bool query = m_PendingQueries == 0;
+	unsigned int queries = 0;
+
+	for (const PointLight& light : lights)
+	{
+		//svjetla potpuno izvan frustuma se preskacu
+		if (!frustum.IntersectsSphere(light.position, light.radius))
+		{
+			m_Stats.culledLights++;
+			continue;
+		}
+
+		glm::vec4 positionRadius(light.position, light.radius);
+
+		//stencil prolaz: straznja lica iza geometrije povecavaju, prednja iza geometrije smanjuju vrijednost
+		m_GBuffer.SetDrawBuffers({});
+		glEnable(GL_DEPTH_TEST);
+		glDisable(GL_CULL_FACE);
+		glDisable(GL_BLEND);
+		glStencilFunc(GL_ALWAYS, 0, 0xFF);
+		glStencilOpSeparate(GL_BACK, GL_KEEP, GL_INCR_WRAP, GL_KEEP);
+		glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_DECR_WRAP, GL_KEEP);
+
+		m_StencilShader.Bind();
+		m_StencilShader.SetUniformVec4("lightPositionRadius", positionRadius);
+		glDrawElements(GL_TRIANGLES, m_SphereIndexCount, GL_UNSIGNED_INT, 0);
+
+		//svjetlosni prolaz: samo pikseli s stencilom != 0, koji se ujedno vracaju na 0 za sljedece svjetlo
+		m_GBuffer.SetDrawBuffers({ LIGHT_ACCUMULATION });
+		glDisable(GL_DEPTH_TEST);
+		glEnable(GL_CULL_FACE);
+		glCullFace(GL_FRONT);
+		glEnable(GL_BLEND);
+		glStencilFunc(GL_NOTEQUAL, 0, 0xFF);
+		glStencilOp(GL_KEEP, GL_KEEP, GL_ZERO);
+
+		m_LightShader.Bind();
+		m_LightShader.SetUniformVec4("lightPositionRadius", positionRadius);
+		m_LightShader.SetUniformVec4("lightColorIntensity", glm::vec4(light.color, light.intensity));
+		if (query)
+		{
+			if (queries == m_SamplesQueries.size())
+			{
+				m_SamplesQueries.push_back(0);
+				glGenQueries(1, &m_SamplesQueries.back());
+			}
+			glBeginQuery(GL_SAMPLES_PASSED, m_SamplesQueries[queries++]);
+		}
+		glDrawElements(GL_TRIANGLES, m_SphereIndexCount, GL_UNSIGNED_INT, 0);
+		if (query)
+			glEndQuery(GL_SAMPLES_PASSED);
+
+		m_Stats.drawCalls += 2;
+	}
+
+	if (query)
+	{
+		m_PendingQueries = queries;
+		if (queries == 0)
+			m_Stats.shadedSamples = 0;
+	}
+
+	glBindVertexArray(0);
+	glCullFace(GL_BACK);
+	glDisable(GL_CULL_FACE);
+	glDisable(GL_BLEND);
+	glDisable(GL_STENCIL_TEST);
+	glEnable(GL_DEPTH_TEST);
+	glDepthMask(GL_TRUE);
+}
+
+void DeferredRenderer::Composite(const glm::vec3& ambientColor, const glm::vec3& clearColor)
+{
+	m_GBuffer.UnBind();
+	glViewport(0, 0, m_GBuffer.GetWidth(), m_GBuffer.GetHeight());
+
+	m_GBuffer.BindColorTexture(POSITION, POSITION);
+	m_GBuffer.BindColorTexture(ALBEDO_SPECULAR, ALBEDO_SPECULAR);
+	m_GBuffer.BindColorTexture(LIGHT_ACCUMULATION, LIGHT_ACCUMULATION);
+
+	glDisable(GL_DEPTH_TEST);
+	m_CompositeShader.Bind();
+	m_CompositeShader.SetUniformVec3("ambientColor", ambientColor);
+	m_CompositeShader.SetUniformVec3("clearColor", clearColor);
+
+	glBindVertexArray(m_FullscreenVAO);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glBindVertexArray(0);
+
+	glEnable(GL_DEPTH_TEST);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Framebuffer.h"
+#include "Shader.h"
+#include "ClusteredLighting.h"
+
+#include "glm/glm.hpp"
+
+#include <vector>
+
+struct DeferredStats
+{
+	unsigned int lights = 0;
+	unsigned int culledLights = 0;
+	unsigned int drawCalls = 0;
+
+	//broj uzoraka koje su osjencali crtezi svjetala (bez stencil prolaza), rezultat upita iz prethodnog framea
+	unsigned long long shadedSamples = 0;
+};
+
+//G-buffer: pozicija, normala, albedo + jacina spekulara, akumulacija svjetla
+//svako svjetlo je sfera, stencil ogranicava sjencanje na piksele cija je geometrija unutar sfere
+class DeferredRenderer
+{
+public:
+	enum GBufferAttachment
+	{
+		POSITION = 0,
+		NORMAL = 1,
+		ALBEDO_SPECULAR = 2,
+		LIGHT_ACCUMULATION = 3
+	};
+
+	DeferredRenderer() = delete;
+	DeferredRenderer(unsigned int width, unsigned int height);
+	~DeferredRenderer();
+
+	void Resize(unsigned int width, unsigned int height);
+
+	//izmedu Begin i End crta se geometrija s GetGeometryShader(); matrice, boja i spekularna jakost nisu uniformi
+	//nego DrawData raspon vezan na blok 0 (DrawBlock u vShader.glsl), kao u Model::Record
+	void BeginGeometryPass();
+	void EndGeometryPass();
+	inline const Shader& GetGeometryShader() const { return m_GeometryShader; }
+
+	void LightingPass(const std::vector<PointLight>& lights, const glm::mat4& viewProjection, const glm::vec3& viewPos);
+	void Composite(const glm::vec3& ambientColor, const glm::vec3& clearColor);
+
+	inline const Framebuffer& GetGBuffer() const { return m_GBuffer; }
+	inline const DeferredStats& GetStats() const { return m_Stats; }
+
+private:
+	void CreateSphere(unsigned int segments, unsigned int rings);
+
+private:
+	Framebuffer m_GBuffer;
+
+	Shader m_GeometryShader;
+	Shader m_StencilShader;
+	Shader m_LightShader;
+	Shader m_CompositeShader;
+
+	unsigned int m_SphereVAO, m_SphereVBO, m_SphereEBO;
+	unsigned int m_SphereIndexCount;
+	unsigned int m_FullscreenVAO;
+
+	//jedan upit po osjencanom svjetlu, zbrajaju se kad su svi dostupni
+	std::vector<unsigned int> m_SamplesQueries;
+	unsigned int m_PendingQueries;
+
+	DeferredStats m_Stats;
+};
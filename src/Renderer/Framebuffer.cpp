@@ -0,0 +1,126 @@
+#include "Framebuffer.h"
+
+#include <iostream>
+
+Framebuffer::Framebuffer(unsigned int width, unsigned int height, const std::vector<FramebufferAttachment>& colorAttachments, bool depthStencil)
+	: m_RenderID(0), m_Width(width), m_Height(height), m_Attachments(colorAttachments), m_HasDepthStencil(depthStencil), m_DepthTexture(0)
+{
+	Create();
+}
+
+Framebuffer::~Framebuffer()
+{
+	Destroy();
+}
+
+void Framebuffer::Create()
+{
+	glGenFramebuffers(1, &m_RenderID);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_RenderID);
+
+	m_ColorTextures.resize(m_Attachments.size());
+	if (!m_ColorTextures.empty())
+		glGenTextures((GLsizei)m_ColorTextures.size(), m_ColorTextures.data());
+
+	std::vector<GLenum> drawBuffers;
+	for (unsigned int i = 0; i < m_Attachments.size(); i++)
+	{
+		const FramebufferAttachment& attachment = m_Attachments[i];
+
+		glBindTexture(GL_TEXTURE_2D, m_ColorTextures[i]);
+		glTexImage2D(GL_TEXTURE_2D, 0, attachment.internalFormat, m_Width, m_Height, 0, attachment.format, attachment.type, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, m_ColorTextures[i], 0);
+
+		drawBuffers.push_back(GL_COLOR_ATTACHMENT0 + i);
+	}
+
+	if (m_HasDepthStencil)
+	{
+		glGenTextures(1, &m_DepthTexture);
+		glBindTexture(GL_TEXTURE_2D, m_DepthTexture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, m_Width, m_Height, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, m_DepthTexture, 0);
+	}
+
+	if (drawBuffers.empty())
+	{
+		glDrawBuffer(GL_NONE);
+		glReadBuffer(GL_NONE);
+	}
+	else
+	{
+		glDrawBuffers((GLsizei)drawBuffers.size(), drawBuffers.data());
+	}
+
+	if (!IsComplete())
+		std::cerr << "FRAMEBUFFER NOT COMPLETE" << std::endl;
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Framebuffer::Destroy()
+{
+	if (!m_ColorTextures.empty())
+		glDeleteTextures((GLsizei)m_ColorTextures.size(), m_ColorTextures.data());
+	if (m_DepthTexture)
+		glDeleteTextures(1, &m_DepthTexture);
+	glDeleteFramebuffers(1, &m_RenderID);
+
+	m_ColorTextures.clear();
+	m_DepthTexture = 0;
+	m_RenderID = 0;
+}
+
+void Framebuffer::Bind() const
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, m_RenderID);
+	glViewport(0, 0, m_Width, m_Height);
+}
+
+void Framebuffer::UnBind() const
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Framebuffer::Resize(unsigned int width, unsigned int height)
+{
+	if (width == m_Width && height == m_Height)
+		return;
+
+	m_Width = width;
+	m_Height = height;
+	Destroy();
+	Create();
+}
+
+void Framebuffer::SetDrawBuffers(const std::vector<unsigned int>& attachments) const
+{
+	if (attachments.empty())
+	{
+		glDrawBuffer(GL_NONE);
+		return;
+	}
+
+	std::vector<GLenum> drawBuffers;
+	for (unsigned int attachment : attachments)
+		drawBuffers.push_back(GL_COLOR_ATTACHMENT0 + attachment);
+	glDrawBuffers((GLsizei)drawBuffers.size(), drawBuffers.data());
+}
+
+void Framebuffer::BindColorTexture(unsigned int attachment, unsigned int slot) const
+{
+	glActiveTexture(GL_TEXTURE0 + slot);
+	glBindTexture(GL_TEXTURE_2D, m_ColorTextures[attachment]);
+}
+
+bool Framebuffer::IsComplete() const
+{
+	return glCheckNamedFramebufferStatus(m_RenderID, GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
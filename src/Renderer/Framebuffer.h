@@ -0,0 +1,54 @@
+#pragma once
+#include "glad/glad.h"
+
+#include <vector>
+
+struct FramebufferAttachment
+{
+	GLenum internalFormat;
+	GLenum format;
+	GLenum type;
+};
+
+//FBO s vise color tekstura (MRT) i opcionalnom depth-stencil teksturom
+class Framebuffer
+{
+public:
+	Framebuffer() = delete;
+	Framebuffer(unsigned int width, unsigned int height, const std::vector<FramebufferAttachment>& colorAttachments, bool depthStencil = true);
+	~Framebuffer();
+
+	Framebuffer(const Framebuffer&) = delete;
+	Framebuffer& operator=(const Framebuffer&) = delete;
+
+	void Bind() const;
+	void UnBind() const;
+	void Resize(unsigned int width, unsigned int height);
+
+	//attachments su indeksi color tekstura, prazan popis iskljucuje pisanje boje
+	void SetDrawBuffers(const std::vector<unsigned int>& attachments) const;
+	void BindColorTexture(unsigned int attachment, unsigned int slot) const;
+
+	bool IsComplete() const;
+
+	inline unsigned int GetID() const { return m_RenderID; }
+	inline unsigned int GetColorTexture(unsigned int attachment) const { return m_ColorTextures[attachment]; }
+	inline unsigned int GetDepthTexture() const { return m_DepthTexture; }
+	inline unsigned int GetColorAttachmentCount() const { return (unsigned int)m_ColorTextures.size(); }
+	inline unsigned int GetWidth() const { return m_Width; }
+	inline unsigned int GetHeight() const { return m_Height; }
+
+private:
+	void Create();
+	void Destroy();
+
+private:
+	unsigned int m_RenderID;
+	unsigned int m_Width, m_Height;
+
+	std::vector<FramebufferAttachment> m_Attachments;
+	std::vector<unsigned int> m_ColorTextures;
+
+	bool m_HasDepthStencil;
+	unsigned int m_DepthTexture;
+};
@@ -0,0 +1,430 @@
+#include "RenderGraph.h"
+
+#include <iostream>
+#include <algorithm>
+
+bool RenderTargetDesc::operator==(const RenderTargetDesc& other) const
+{
+	return width == other.width && height == other.height && internalFormat == other.internalFormat;
+}
+
+static unsigned int BytesPerPixel(GLenum internalFormat)
+{
+	switch (internalFormat)
+	{
+	case GL_R8:
+		return 1;
+	case GL_R16F:
+	case GL_RG8:
+	case GL_DEPTH_COMPONENT16:
+		return 2;
+	case GL_RGBA16F:
+	case GL_RG32F:
+	case GL_DEPTH32F_STENCIL8:
+		return 8;
+	case GL_RGBA32F:
+		return 16;
+	case GL_RGB16F:
+		return 6;
+	case GL_RGB32F:
+		return 12;
+	default:
+		//RGBA8, SRGB8_ALPHA8, RG16F, R32F, R11F_G11F_B10F, RGB10_A2, DEPTH24_STENCIL8, DEPTH_COMPONENT24/32F
+		return 4;
+	}
+}
+
+unsigned long long GetRenderTargetBytes(const RenderTargetDesc& desc)
+{
+	return (unsigned long long)desc.width * desc.height * BytesPerPixel(desc.internalFormat);
+}
+
+bool IsDepthFormat(GLenum internalFormat)
+{
+	switch (internalFormat)
+	{
+	case GL_DEPTH_COMPONENT16:
+	case GL_DEPTH_COMPONENT24:
+	case GL_DEPTH_COMPONENT32F:
+	case GL_DEPTH24_STENCIL8:
+	case GL_DEPTH32F_STENCIL8:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static bool HasStencil(GLenum internalFormat)
+{
+	return internalFormat == GL_DEPTH24_STENCIL8 || internalFormat == GL_DEPTH32F_STENCIL8;
+}
+
+RenderTargetPool::RenderTargetPool(unsigned int maxUnusedFrames)
+	: m_Frame(0), m_MaxUnusedFrames(maxUnusedFrames)
+{
+}
+
+RenderTargetPool::~RenderTargetPool()
+{
+	for (const Entry& entry : m_Entries)
+		glDeleteTextures(1, &entry.texture);
+}
+
+unsigned int RenderTargetPool::Acquire(const RenderTargetDesc& desc)
+{
+	for (Entry& entry : m_Entries)
+	{
+		if (!entry.inUse && entry.desc == desc)
+		{
+			entry.inUse = true;
+			entry.lastUsedFrame = m_Frame;
+			return entry.texture;
+		}
+	}
+
+	unsigned int texture = 0;
+	glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+	glTextureStorage2D(texture, 1, desc.internalFormat, desc.width, desc.height);
+	glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	m_Entries.push_back({ desc, texture, m_Frame, true });
+	return texture;
+}
+
+void RenderTargetPool::Release(unsigned int texture)
+{
+	for (Entry& entry : m_Entries)
+	{
+		if (entry.texture == texture)
+		{
+			entry.inUse = false;
+			return;
+		}
+	}
+}
+
+void RenderTargetPool::EndFrame()
+{
+	m_Frame++;
+
+	//teksture koje dugo nisu trebale (npr. nakon promjene rezolucije) se oslobadaju
+	for (std::size_t i = 0; i < m_Entries.size();)
+	{
+		if (!m_Entries[i].inUse && m_Frame - m_Entries[i].lastUsedFrame > m_MaxUnusedFrames)
+		{
+			glDeleteTextures(1, &m_Entries[i].texture);
+			m_Entries[i] = m_Entries.back();
+			m_Entries.pop_back();
+		}
+		else
+		{
+			i++;
+		}
+	}
+}
+
+unsigned long long RenderTargetPool::GetAllocatedBytes() const
+{
+	unsigned long long bytes = 0;
+	for (const Entry& entry : m_Entries)
+		bytes += GetRenderTargetBytes(entry.desc);
+	return bytes;
+}
+
+RenderPassBuilder::RenderPassBuilder(RenderGraph& graph, unsigned int pass)
+	: m_Graph(graph), m_Pass(pass)
+{
+}
+
+RenderResource RenderPassBuilder::Create(const std::string& name, const RenderTargetDesc& desc)
+{
+	RenderResource resource = (RenderResource)m_Graph.m_Resources.size();
+	m_Graph.m_Resources.push_back({ name, desc, false, 0, {}, 0, 0, 0, 0 });
+	return Write(resource);
+}
+
+RenderResource RenderPassBuilder::Read(RenderResource resource)
+{
+	std::vector<RenderResource>& reads = m_Graph.m_Passes[m_Pass].reads;
+	if (std::find(reads.begin(), reads.end(), resource) == reads.end())
+	{
+		reads.push_back(resource);
+		m_Graph.m_Resources[resource].readers++;
+	}
+	return resource;
+}
+
+RenderResource RenderPassBuilder::Write(RenderResource resource)
+{
+	std::vector<RenderResource>& writes = m_Graph.m_Passes[m_Pass].writes;
+	if (std::find(writes.begin(), writes.end(), resource) == writes.end())
+	{
+		writes.push_back(resource);
+		m_Graph.m_Resources[resource].writers.push_back(m_Pass);
+	}
+	return resource;
+}
+
+void RenderPassBuilder::SetSideEffect()
+{
+	m_Graph.m_Passes[m_Pass].sideEffect = true;
+}
+
+RenderGraph::RenderGraph()
+	: m_Compiled(false), m_Framebuffer(0), m_BoundColorAttachments(0)
+{
+}
+
+RenderGraph::~RenderGraph()
+{
+	if (m_Framebuffer)
+		glDeleteFramebuffers(1, &m_Framebuffer);
+}
+
+RenderResource RenderGraph::Import(const std::string& name, unsigned int texture, const RenderTargetDesc& desc)
+{
+	m_Resources.push_back({ name, desc, true, texture, {}, 0, 0, 0, 0 });
+	return (RenderResource)m_Resources.size() - 1;
+}
+
+void RenderGraph::AddPass(const std::string& name, const SetupFunction& setup, const ExecuteFunction& execute)
+{
+	m_Passes.push_back({ name, execute, {}, {}, false, false });
+	m_Compiled = false;
+
+	RenderPassBuilder builder(*this, (unsigned int)m_Passes.size() - 1);
+	setup(builder);
+}
+
+bool RenderGraph::Compile()
+{
+	m_ExecutionOrder.clear();
+	m_Physical.clear();
+	m_Stats = RenderGraphStats();
+	m_Stats.passes = (unsigned int)m_Passes.size();
+
+	for (const Resource& resource : m_Resources)
+	{
+		if (!resource.imported && resource.writers.empty())
+		{
+			std::cerr << "RENDER GRAPH: RESOURCE READ BUT NEVER WRITTEN: " << resource.name << std::endl;
+			return false;
+		}
+	}
+
+	//brojanje referenci: prolaz zivi dok netko cita nesto sto pise, uvezeni resursi se uvijek citaju
+	std::vector<unsigned int> passRefs(m_Passes.size());
+	std::vector<unsigned int> resourceRefs(m_Resources.size());
+	std::vector<RenderResource> unreferenced;
+
+	for (std::size_t r = 0; r < m_Resources.size(); r++)
+	{
+		resourceRefs[r] = m_Resources[r].readers + (m_Resources[r].imported ? 1 : 0);
+		if (resourceRefs[r] == 0)
+			unreferenced.push_back((RenderResource)r);
+	}
+
+	auto cull = [&](unsigned int p)
+	{
+		m_Passes[p].culled = true;
+		m_Stats.culledPasses++;
+		for (RenderResource read : m_Passes[p].reads)
+		{
+			if (--resourceRefs[read] == 0)
+				unreferenced.push_back(read);
+		}
+	};
+
+	for (std::size_t p = 0; p < m_Passes.size(); p++)
+	{
+		m_Passes[p].culled = false;
+		passRefs[p] = (unsigned int)m_Passes[p].writes.size();
+		if (passRefs[p] == 0 && !m_Passes[p].sideEffect)
+			cull((unsigned int)p);
+	}
+
+	while (!unreferenced.empty())
+	{
+		RenderResource resource = unreferenced.back();
+		unreferenced.pop_back();
+
+		for (unsigned int writer : m_Resources[resource].writers)
+		{
+			if (!m_Passes[writer].culled && --passRefs[writer] == 0 && !m_Passes[writer].sideEffect)
+				cull(writer);
+		}
+	}
+
+	//redoslijed dodavanja je vec topoloski jer prolaz moze citati samo ono sto je prije dodano
+	for (unsigned int p = 0; p < (unsigned int)m_Passes.size(); p++)
+	{
+		if (!m_Passes[p].culled)
+			m_ExecutionOrder.push_back(p);
+	}
+
+	const unsigned int unused = ~0u;
+	for (Resource& resource : m_Resources)
+	{
+		resource.firstUse = unused;
+		resource.lastUse = 0;
+		resource.physical = unused;
+	}
+
+	for (unsigned int i = 0; i < (unsigned int)m_ExecutionOrder.size(); i++)
+	{
+		const Pass& pass = m_Passes[m_ExecutionOrder[i]];
+		for (const std::vector<RenderResource>* list : { &pass.reads, &pass.writes })
+		{
+			for (RenderResource r : *list)
+			{
+				m_Resources[r].firstUse = std::min(m_Resources[r].firstUse, i);
+				m_Resources[r].lastUse = std::max(m_Resources[r].lastUse, i);
+			}
+		}
+	}
+
+	//GL teksture imaju nepromjenjiv format pa se dijele samo targeti s istim opisom
+	std::vector<bool> physicalFree;
+	unsigned long long liveBytes = 0;
+	for (unsigned int i = 0; i < (unsigned int)m_ExecutionOrder.size(); i++)
+	{
+		for (Resource& resource : m_Resources)
+		{
+			if (resource.imported || resource.firstUse != i)
+				continue;
+
+			m_Stats.transientTargets++;
+			m_Stats.bytesWithoutAliasing += GetRenderTargetBytes(resource.desc);
+			liveBytes += GetRenderTargetBytes(resource.desc);
+
+			for (unsigned int t = 0; t < (unsigned int)m_Physical.size(); t++)
+			{
+				if (physicalFree[t] && m_Physical[t].desc == resource.desc)
+				{
+					resource.physical = t;
+					physicalFree[t] = false;
+					break;
+				}
+			}
+
+			if (resource.physical == unused)
+			{
+				resource.physical = (unsigned int)m_Physical.size();
+				m_Physical.push_back({ resource.desc, 0 });
+				physicalFree.push_back(false);
+				m_Stats.bytesWithAliasing += GetRenderTargetBytes(resource.desc);
+			}
+		}
+
+		m_Stats.peakLiveBytes = std::max(m_Stats.peakLiveBytes, liveBytes);
+
+		for (Resource& resource : m_Resources)
+		{
+			if (resource.imported || resource.firstUse == unused || resource.lastUse != i)
+				continue;
+
+			physicalFree[resource.physical] = true;
+			liveBytes -= GetRenderTargetBytes(resource.desc);
+		}
+	}
+	m_Stats.physicalTargets = (unsigned int)m_Physical.size();
+
+	m_Compiled = true;
+	return true;
+}
+
+void RenderGraph::BindTargets(const Pass& pass)
+{
+	if (pass.writes.empty())
+		return;
+
+	const RenderTargetDesc& size = m_Resources[pass.writes[0]].desc;
+
+	for (RenderResource r : pass.writes)
+	{
+		if (m_Resources[r].imported && m_Resources[r].texture == 0)
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			glViewport(0, 0, size.width, size.height);
+			return;
+		}
+	}
+
+	std::vector<GLenum> drawBuffers;
+	bool depthAttached = false;
+	for (RenderResource r : pass.writes)
+	{
+		unsigned int texture = GetTexture(r);
+		GLenum format = m_Resources[r].desc.internalFormat;
+
+		if (IsDepthFormat(format))
+		{
+			glNamedFramebufferTexture(m_Framebuffer, HasStencil(format) ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT, texture, 0);
+			depthAttached = true;
+		}
+		else
+		{
+			GLenum attachment = GL_COLOR_ATTACHMENT0 + (GLenum)drawBuffers.size();
+			glNamedFramebufferTexture(m_Framebuffer, attachment, texture, 0);
+			drawBuffers.push_back(attachment);
+		}
+	}
+
+	//ostaci prethodnog prolaza se odvajaju
+	for (unsigned int i = (unsigned int)drawBuffers.size(); i < m_BoundColorAttachments; i++)
+		glNamedFramebufferTexture(m_Framebuffer, GL_COLOR_ATTACHMENT0 + i, 0, 0);
+	m_BoundColorAttachments = (unsigned int)drawBuffers.size();
+	if (!depthAttached)
+		glNamedFramebufferTexture(m_Framebuffer, GL_DEPTH_STENCIL_ATTACHMENT, 0, 0);
+
+	if (drawBuffers.empty())
+		glNamedFramebufferDrawBuffer(m_Framebuffer, GL_NONE);
+	else
+		glNamedFramebufferDrawBuffers(m_Framebuffer, (GLsizei)drawBuffers.size(), drawBuffers.data());
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+	glViewport(0, 0, size.width, size.height);
+}
+
+void RenderGraph::Execute()
+{
+	if (!m_Compiled && !Compile())
+		return;
+
+	if (!m_Framebuffer)
+		glCreateFramebuffers(1, &m_Framebuffer);
+
+	for (PhysicalTarget& target : m_Physical)
+		target.texture = m_Pool.Acquire(target.desc);
+
+	for (unsigned int p : m_ExecutionOrder)
+	{
+		BindTargets(m_Passes[p]);
+		m_Passes[p].execute(*this);
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	for (PhysicalTarget& target : m_Physical)
+		m_Pool.Release(target.texture);
+	m_Pool.EndFrame();
+}
+
+void RenderGraph::Reset()
+{
+	m_Resources.clear();
+	m_Passes.clear();
+	m_ExecutionOrder.clear();
+	m_Physical.clear();
+	m_Compiled = false;
+}
+
+unsigned int RenderGraph::GetTexture(RenderResource resource) const
+{
+	const Resource& r = m_Resources[resource];
+	if (r.imported)
+		return r.texture;
+	return r.physical < m_Physical.size() ? m_Physical[r.physical].texture : 0;
+}
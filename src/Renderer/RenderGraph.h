@@ -0,0 +1,165 @@
+#pragma once
+#include "glad/glad.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+struct RenderTargetDesc
+{
+	unsigned int width;
+	unsigned int height;
+	GLenum internalFormat;
+
+	bool operator==(const RenderTargetDesc& other) const;
+};
+
+unsigned long long GetRenderTargetBytes(const RenderTargetDesc& desc);
+bool IsDepthFormat(GLenum internalFormat);
+
+typedef unsigned int RenderResource;
+const RenderResource INVALID_RESOURCE = ~0u;
+
+struct RenderGraphStats
+{
+	unsigned int passes = 0;
+	unsigned int culledPasses = 0;
+	unsigned int transientTargets = 0;
+	unsigned int physicalTargets = 0;
+
+	//memorija prijelaznih targeta kad svaki ima svoju teksturu, kad se teksture dijele i
+	//najveca kolicina istovremeno zivih targeta (donja granica za dijeljenje)
+	unsigned long long bytesWithoutAliasing = 0;
+	unsigned long long bytesWithAliasing = 0;
+	unsigned long long peakLiveBytes = 0;
+};
+
+//teksture koje prezive izmedu frameova, neiskoristene se brisu nakon maxUnusedFrames
+class RenderTargetPool
+{
+public:
+	RenderTargetPool(unsigned int maxUnusedFrames = 3);
+	~RenderTargetPool();
+
+	RenderTargetPool(const RenderTargetPool&) = delete;
+	RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+	unsigned int Acquire(const RenderTargetDesc& desc);
+	void Release(unsigned int texture);
+	void EndFrame();
+
+	unsigned long long GetAllocatedBytes() const;
+	inline unsigned int GetTextureCount() const { return (unsigned int)m_Entries.size(); }
+
+private:
+	struct Entry
+	{
+		RenderTargetDesc desc;
+		unsigned int texture;
+		unsigned long long lastUsedFrame;
+		bool inUse;
+	};
+
+	std::vector<Entry> m_Entries;
+	unsigned long long m_Frame;
+	unsigned int m_MaxUnusedFrames;
+};
+
+class RenderGraph;
+
+//u setup funkciji prolaz navodi sto cita i pise, redoslijed Write poziva odreduje color attachmente
+class RenderPassBuilder
+{
+public:
+	RenderResource Create(const std::string& name, const RenderTargetDesc& desc);
+	RenderResource Read(RenderResource resource);
+	RenderResource Write(RenderResource resource);
+
+	//prolaz se nikad ne odbacuje (npr. citanje na CPU, upiti)
+	void SetSideEffect();
+
+private:
+	friend class RenderGraph;
+	RenderPassBuilder(RenderGraph& graph, unsigned int pass);
+
+	RenderGraph& m_Graph;
+	unsigned int m_Pass;
+};
+
+//graf se gradi svaki frame: AddPass..., Compile(), Execute(), Reset()
+//prijelazne teksture s istim opisom i nepreklapajucim zivotom dijele istu fizicku teksturu
+class RenderGraph
+{
+public:
+	typedef std::function<void(RenderPassBuilder&)> SetupFunction;
+	typedef std::function<void(const RenderGraph&)> ExecuteFunction;
+
+	RenderGraph();
+	~RenderGraph();
+
+	RenderGraph(const RenderGraph&) = delete;
+	RenderGraph& operator=(const RenderGraph&) = delete;
+
+	//vanjska tekstura (0 = zadani framebuffer), prolazi koji pisu u nju se ne odbacuju
+	RenderResource Import(const std::string& name, unsigned int texture, const RenderTargetDesc& desc);
+	void AddPass(const std::string& name, const SetupFunction& setup, const ExecuteFunction& execute);
+
+	//odbacuje nepotrebne prolaze, racuna zivot resursa i dodjeljuje fizicke teksture, ne poziva GL
+	bool Compile();
+	void Execute();
+	void Reset();
+
+	unsigned int GetTexture(RenderResource resource) const;
+	inline const RenderTargetDesc& GetDesc(RenderResource resource) const { return m_Resources[resource].desc; }
+	inline const std::vector<unsigned int>& GetExecutionOrder() const { return m_ExecutionOrder; }
+	inline const std::string& GetPassName(unsigned int pass) const { return m_Passes[pass].name; }
+	inline const RenderGraphStats& GetStats() const { return m_Stats; }
+	inline const RenderTargetPool& GetPool() const { return m_Pool; }
+
+private:
+	friend class RenderPassBuilder;
+
+	struct Resource
+	{
+		std::string name;
+		RenderTargetDesc desc;
+		bool imported;
+		unsigned int texture;
+
+		std::vector<unsigned int> writers;
+		unsigned int readers;
+		unsigned int firstUse, lastUse;
+		unsigned int physical;
+	};
+
+	struct Pass
+	{
+		std::string name;
+		ExecuteFunction execute;
+		std::vector<RenderResource> reads;
+		std::vector<RenderResource> writes;
+		bool sideEffect;
+		bool culled;
+	};
+
+	struct PhysicalTarget
+	{
+		RenderTargetDesc desc;
+		unsigned int texture;
+	};
+
+	void BindTargets(const Pass& pass);
+
+private:
+	std::vector<Resource> m_Resources;
+	std::vector<Pass> m_Passes;
+	std::vector<unsigned int> m_ExecutionOrder;
+	std::vector<PhysicalTarget> m_Physical;
+	bool m_Compiled;
+
+	RenderTargetPool m_Pool;
+	unsigned int m_Framebuffer;
+	unsigned int m_BoundColorAttachments;
+
+	RenderGraphStats m_Stats;
+};
@@ -0,0 +1,108 @@
+#include "RenderThread.h"
+
+#include <algorithm>
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double ElapsedMs(Clock::time_point from, Clock::time_point to)
+{
+	std::chrono::duration<double, std::milli> elapsed = to - from;
+	return elapsed.count();
+}
+
+RenderThread::RenderThread(const Window& window, unsigned int pipelineDepth)
+	: m_Window(window), m_PipelineDepth(std::max(1u, pipelineDepth)), m_InFlight(0), m_Running(true)
+{
+	m_Start = Clock::now();
+
+	//kontekst moze biti aktivan na samo jednoj dretvi
+	m_Window.ReleaseContext();
+	m_Thread = std::thread(&RenderThread::Loop, this);
+}
+
+RenderThread::~RenderThread()
+{
+	Flush();
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Running = false;
+	}
+	m_QueueChanged.notify_all();
+	m_Thread.join();
+
+	m_Window.MakeContextCurrent();
+}
+
+void RenderThread::Submit(FramePacket packet)
+{
+	auto start = Clock::now();
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	//frameovi u redu i frame koji se trenutno crta zajedno cine dubinu pipelinea
+	m_QueueChanged.wait(lock, [this]() { return m_InFlight < m_PipelineDepth; });
+	m_Stats.producerWaitMs += ElapsedMs(start, Clock::now());
+
+	m_Queue.push_back(std::move(packet));
+	m_InFlight++;
+	lock.unlock();
+
+	m_QueueChanged.notify_all();
+}
+
+void RenderThread::Flush()
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_QueueChanged.wait(lock, [this]() { return m_InFlight == 0; });
+}
+
+RenderThreadStats RenderThread::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	RenderThreadStats stats = m_Stats;
+	stats.elapsedMs = ElapsedMs(m_Start, Clock::now());
+	return stats;
+}
+
+void RenderThread::Loop()
+{
+	m_Window.MakeContextCurrent();
+
+	while (true)
+	{
+		FramePacket packet;
+		{
+			auto idleStart = Clock::now();
+
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_QueueChanged.wait(lock, [this]() { return !m_Running || !m_Queue.empty(); });
+			if (m_Queue.empty())
+				break;
+
+			m_Stats.consumerIdleMs += ElapsedMs(idleStart, Clock::now());
+			packet = std::move(m_Queue.front());
+			m_Queue.pop_front();
+		}
+
+		int width, height;
+		if (TakePendingViewport(width, height))
+			glViewport(0, 0, width, height);
+
+		if (packet.render)
+			packet.render();
+		m_Window.Swap();
+
+		double latency = ElapsedMs(packet.simulateStart, Clock::now());
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Stats.frames++;
+			m_Stats.lastLatencyMs = latency;
+			m_Stats.totalLatencyMs += latency;
+			m_Stats.maxLatencyMs = std::max(m_Stats.maxLatencyMs, latency);
+			m_InFlight--;
+		}
+		m_QueueChanged.notify_all();
+	}
+
+	m_Window.ReleaseContext();
+}
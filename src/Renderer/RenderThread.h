@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Window.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+struct FramePacket
+{
+	unsigned long long frame = 0;
+	std::chrono::high_resolution_clock::time_point simulateStart;
+	std::function<void()> render;
+};
+
+struct RenderThreadStats
+{
+	unsigned long long frames = 0;
+
+	//latencija od pocetka simulacije framea do zavrsetka njegovog swapa
+	double lastLatencyMs = 0.0;
+	double maxLatencyMs = 0.0;
+	double totalLatencyMs = 0.0;
+
+	//vrijeme koje je glavna dretva cekala na mjesto u redu, odnosno render dretva na paket
+	double producerWaitMs = 0.0;
+	double consumerIdleMs = 0.0;
+
+	double elapsedMs = 0.0;
+
+	inline double AverageLatencyMs() const { return frames ? totalLatencyMs / frames : 0.0; }
+	inline double FramesPerSecond() const { return elapsedMs > 0.0 ? frames * 1000.0 / elapsedMs : 0.0; }
+};
+
+//GL kontekst prelazi na zasebnu dretvu, glavna dretva simulira frame N+1 dok se frame N predaje GPU-u
+//GLFW dogadaji se i dalje obraduju na glavnoj dretvi (Window::PollEvents)
+class RenderThread
+{
+public:
+	RenderThread() = delete;
+	RenderThread(const Window& window, unsigned int pipelineDepth = 2);
+	~RenderThread();
+
+	RenderThread(const RenderThread&) = delete;
+	RenderThread& operator=(const RenderThread&) = delete;
+
+	void Submit(FramePacket packet);
+	void Flush();
+
+	RenderThreadStats GetStats() const;
+	inline unsigned int GetPipelineDepth() const { return m_PipelineDepth; }
+
+private:
+	void Loop();
+
+private:
+	const Window& m_Window;
+	unsigned int m_PipelineDepth;
+
+	std::deque<FramePacket> m_Queue;
+	unsigned int m_InFlight;
+	bool m_Running;
+
+	mutable std::mutex m_Mutex;
+	std::condition_variable m_QueueChanged;
+
+	RenderThreadStats m_Stats;
+	std::chrono::high_resolution_clock::time_point m_Start;
+
+	std::thread m_Thread;
+};
@@ -1,8 +1,277 @@
 #include "Renderer.h"
 
+#include "Model.h"
+
+#include <iostream>
+
+Renderer::Renderer()
+	: Renderer(RenderBackend::OpenGL) { }
+
+Renderer::Renderer(RenderBackend backend, unsigned int width, unsigned int height, JobSystem* jobs)
+	: m_Backend(backend), m_PassCount(0), m_ThreadCount(0), m_DepthPrePass(false), m_Queries(), m_QueryFrame(0)
+{
+	if (backend == RenderBackend::Software)
+		m_Software = std::make_unique<SoftwareRasterizer>(width, height, jobs);
+}
+
+Renderer::~Renderer()
+{
+	if (m_Queries[0][0])
+		glDeleteQueries(4, &m_Queries[0][0]);
+}
+
 void Renderer::Clear()
 {
+	if (m_Software)
+	{
+		//statistika software backenda vrijedi za jedan frame, kao za jedan Execute
+		m_Stats = RendererStats();
+		m_Software->Clear(glm::vec3(0.2f, 0.3f, 0.3f));
+		return;
+	}
+
 	glEnable(GL_DEPTH_TEST);
 	glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
+
+void Renderer::SetLight(const glm::vec3& lightPos, const glm::vec3& lightColor, const glm::vec3& viewPos)
+{
+	if (m_Software)
+		m_Software->SetLight(lightPos, lightColor, viewPos);
+}
+
+void Renderer::Draw(const std::vector<Vertex>& vertices, const std::vector<int>& indices, const SoftwareDrawUniforms& uniforms)
+{
+	//GL backend crta iz command buffera (Submit), uniformi su u UBO-u
+	if (!m_Software)
+	{
+		std::cerr << "RENDERER DRAW NEEDS SOFTWARE BACKEND" << std::endl;
+		return;
+	}
+
+	m_Software->Draw(vertices, indices, uniforms);
+	m_Stats.drawCalls++;
+}
+
+void Renderer::Draw(const Mesh& mesh, const SoftwareDrawUniforms& uniforms)
+{
+	Draw(mesh.GetVertices(), mesh.GetIndices(), uniforms);
+}
+
+void Renderer::SetDepthPrePass(bool enabled)
+{
+	//software backend vec sjenca samo vidljive piksele (buffer vidljivosti po plocici)
+	if (m_Software)
+		return;
+
+	m_DepthPrePass = enabled;
+	if (enabled && !m_DepthShader)
+		m_DepthShader = std::make_unique<Shader>("res/shaders/vDepth.glsl", "res/shaders/fNull.glsl");
+}
+
+const Shader* Renderer::BeginDepthPrePass()
+{
+	if (m_Software)
+		return nullptr;
+
+	if (!m_Queries[0][0])
+		glGenQueries(4, &m_Queries[0][0]);
+
+	//vrijeme se mjeri od pocetka pre-passa do kraja glavnog prolaza
+	glBeginQuery(GL_TIME_ELAPSED, m_Queries[m_QueryFrame & 1][1]);
+
+	if (!m_DepthPrePass)
+		return nullptr;
+
+	glEnable(GL_DEPTH_TEST);
+	glDepthFunc(GL_LESS);
+	glDepthMask(GL_TRUE);
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+	m_DepthShader->Bind();
+	return m_DepthShader.get();
+}
+
+void Renderer::BeginMainPass()
+{
+	if (m_Software)
+		return;
+
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	if (m_DepthPrePass)
+	{
+		glDepthFunc(GL_EQUAL);
+		glDepthMask(GL_FALSE);
+	}
+
+	glBeginQuery(GL_SAMPLES_PASSED, m_Queries[m_QueryFrame & 1][0]);
+}
+
+void Renderer::EndMainPass()
+{
+	if (m_Software)
+	{
+		m_Software->Flush();
+		return;
+	}
+
+	glEndQuery(GL_SAMPLES_PASSED);
+	glEndQuery(GL_TIME_ELAPSED);
+
+	glDepthFunc(GL_LESS);
+	glDepthMask(GL_TRUE);
+
+	//upiti prethodnog framea su gotovo sigurno dostupni pa citanje ne zaustavlja CPU
+	if (m_QueryFrame > 0)
+	{
+		unsigned int* previous = m_Queries[(m_QueryFrame - 1) & 1];
+		GLuint64 samples = 0, elapsed = 0;
+		glGetQueryObjectui64v(previous[0], GL_QUERY_RESULT, &samples);
+		glGetQueryObjectui64v(previous[1], GL_QUERY_RESULT, &elapsed);
+		m_PassStats.shadedFragments = samples;
+		m_PassStats.gpuMs = elapsed / 1000000.0;
+	}
+	m_QueryFrame++;
+}
+
+void Renderer::BeginCommands(unsigned int passCount, unsigned int threadCount)
+{
+	m_PassCount = passCount;
+	m_ThreadCount = threadCount;
+
+	//bufferi se ne oslobadaju izmedu frameova kako bi se zadrzala alocirana memorija
+	if (m_CommandBuffers.size() < passCount * threadCount)
+		m_CommandBuffers.resize(passCount * threadCount);
+
+	for (auto& commands : m_CommandBuffers)
+		commands.Clear();
+}
+
+CommandBuffer& Renderer::GetCommandBuffer(unsigned int pass, unsigned int thread)
+{
+	return m_CommandBuffers[pass * m_ThreadCount + thread];
+}
+
+const std::vector<RenderCommand>& Renderer::MergeCommands()
+{
+	std::size_t total = 0;
+	for (unsigned int i = 0; i < m_PassCount * m_ThreadCount; i++)
+		total += m_CommandBuffers[i].Size();
+
+	m_Merged.clear();
+	m_Merged.reserve(total);
+	for (unsigned int i = 0; i < m_PassCount * m_ThreadCount; i++)
+	{
+		const auto& commands = m_CommandBuffers[i].GetCommands();
+		m_Merged.insert(m_Merged.end(), commands.begin(), commands.end());
+	}
+
+	return m_Merged;
+}
+
+void Renderer::Submit()
+{
+	Execute(MergeCommands());
+}
+
+void Renderer::Execute(const std::vector<RenderCommand>& commands)
+{
+	m_Stats = RendererStats();
+
+	//stanje se prati samo unutar jednog Execute poziva jer ostatak koda mijenja GL stanje izravno
+	const unsigned int unknown = ~0u;
+	unsigned int program = unknown, vertexArray = unknown;
+	unsigned int textures[MAX_TEXTURE_SLOTS], arrays[MAX_TEXTURE_SLOTS];
+	for (unsigned int i = 0; i < MAX_TEXTURE_SLOTS; i++)
+		textures[i] = arrays[i] = unknown;
+
+	for (const RenderCommand& command : commands)
+	{
+		m_Stats.commands++;
+
+		switch (command.type)
+		{
+			case CommandType::BindProgram:
+			{
+				if (program == command.bindProgram.program)
+				{
+					m_Stats.skippedBinds++;
+					break;
+				}
+				program = command.bindProgram.program;
+				glUseProgram(program);
+				break;
+			}
+			case CommandType::BindVertexArray:
+			{
+				if (vertexArray == command.bindVertexArray.vertexArray)
+				{
+					m_Stats.skippedBinds++;
+					break;
+				}
+				vertexArray = command.bindVertexArray.vertexArray;
+				glBindVertexArray(vertexArray);
+				break;
+			}
+			case CommandType::BindTexture:
+			{
+				unsigned int slot = command.bindTexture.slot;
+				if (slot < MAX_TEXTURE_SLOTS && textures[slot] == command.bindTexture.texture)
+				{
+					m_Stats.skippedBinds++;
+					break;
+				}
+				if (slot < MAX_TEXTURE_SLOTS)
+					textures[slot] = command.bindTexture.texture;
+				glActiveTexture(GL_TEXTURE0 + slot);
+				glBindTexture(GL_TEXTURE_2D, command.bindTexture.texture);
+				m_Stats.textureBinds++;
+				break;
+			}
+			case CommandType::BindTextureArray:
+			{
+				unsigned int slot = command.bindTexture.slot;
+				if (slot < MAX_TEXTURE_SLOTS && arrays[slot] == command.bindTexture.texture)
+				{
+					m_Stats.skippedBinds++;
+					break;
+				}
+				if (slot < MAX_TEXTURE_SLOTS)
+					arrays[slot] = command.bindTexture.texture;
+				glActiveTexture(GL_TEXTURE0 + slot);
+				glBindTexture(GL_TEXTURE_2D_ARRAY, command.bindTexture.texture);
+				m_Stats.textureBinds++;
+				break;
+			}
+			case CommandType::BindVertexBuffer:
+			{
+				const auto& binding = command.bindVertexBuffer;
+				glVertexArrayVertexBuffer(binding.vertexArray, binding.bindingIndex, binding.buffer, (GLintptr)binding.offset, binding.stride);
+				break;
+			}
+			case CommandType::BindUniformBlock:
+			{
+				glBindBufferRange(GL_UNIFORM_BUFFER, command.bindBlock.binding, command.bindBlock.buffer,
+					(GLintptr)command.bindBlock.offset, (GLsizeiptr)command.bindBlock.size);
+				break;
+			}
+			case CommandType::BindStorageBlock:
+			{
+				glBindBufferRange(GL_SHADER_STORAGE_BUFFER, command.bindBlock.binding, command.bindBlock.buffer,
+					(GLintptr)command.bindBlock.offset, (GLsizeiptr)command.bindBlock.size);
+				break;
+			}
+			case CommandType::DrawIndexed:
+			{
+				const auto& draw = command.drawIndexed;
+				glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, draw.indexCount, GL_UNSIGNED_INT,
+					(void*)(draw.firstIndex * sizeof(unsigned int)), draw.instanceCount, draw.baseVertex, draw.baseInstance);
+				m_Stats.drawCalls++;
+				break;
+			}
+		}
+	}
+
+	glBindVertexArray(0);
+}
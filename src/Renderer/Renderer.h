@@ -1,8 +1,93 @@
 #pragma once
 #include "glad/glad.h"
 
+#include "CommandBuffer.h"
+#include "Shader.h"
+#include "SoftwareRasterizer.h"
+
+#include <memory>
+#include <vector>
+
+struct RendererStats
+{
+	unsigned int commands = 0;
+	unsigned int drawCalls = 0;
+	unsigned int skippedBinds = 0;
+	//teksture i nizovi koji su stvarno vezani, bez preskocenih
+	unsigned int textureBinds = 0;
+};
+
+//rezultati GPU upita iz prethodnog framea, za usporedbu s i bez depth pre-passa
+struct PassStats
+{
+	unsigned long long shadedFragments = 0;
+	double gpuMs = 0.0;
+};
+
+//Software crta SoftwareRasterizerom u memoriju, bez GL konteksta (CI i strojevi bez GPU-a)
+enum class RenderBackend
+{
+	OpenGL,
+	Software
+};
+
 class Renderer
 {
 public:
+	static const unsigned int MAX_TEXTURE_SLOTS = 16;
+
+	Renderer();
+	//width, height i jobs vrijede samo za Software backend
+	Renderer(RenderBackend backend, unsigned int width = 0, unsigned int height = 0, JobSystem* jobs = nullptr);
+	~Renderer();
+
 	void Clear();
-};
\ No newline at end of file
+
+	inline RenderBackend GetBackend() const { return m_Backend; }
+	inline SoftwareRasterizer* GetSoftwareRasterizer() const { return m_Software.get(); }
+
+	//Software backend: crtanje ide kroz Renderer kao i kod GL-a, rasterizira se u EndMainPass
+	void SetLight(const glm::vec3& lightPos, const glm::vec3& lightColor, const glm::vec3& viewPos);
+	void Draw(const std::vector<Vertex>& vertices, const std::vector<int>& indices, const SoftwareDrawUniforms& uniforms);
+	void Draw(const Mesh& mesh, const SoftwareDrawUniforms& uniforms);
+
+	//pre-pass crta samo dubinu, glavni prolaz zatim sjenca samo vidljive fragmente (GL_EQUAL, bez pisanja dubine)
+	void SetDepthPrePass(bool enabled);
+	inline bool IsDepthPrePassEnabled() const { return m_DepthPrePass; }
+
+	//vraca program za pre-pass (uniform mvp) ili nullptr kad je pre-pass iskljucen, geometrija se crta s DrawDepth()
+	const Shader* BeginDepthPrePass();
+	void BeginMainPass();
+	void EndMainPass();
+
+	//jedan CommandBuffer po (prolazu, dretvi), dretve snimaju paralelno bez zakljucavanja
+	void BeginCommands(unsigned int passCount, unsigned int threadCount);
+	CommandBuffer& GetCommandBuffer(unsigned int pass, unsigned int thread);
+
+	//spaja buffere redom po prolazu pa po dretvi, rezultat ne ovisi o rasporedu dretvi
+	const std::vector<RenderCommand>& MergeCommands();
+	void Submit();
+	void Execute(const std::vector<RenderCommand>& commands);
+
+	inline const RendererStats& GetStats() const { return m_Stats; }
+	inline const PassStats& GetPassStats() const { return m_PassStats; }
+
+private:
+	RenderBackend m_Backend;
+	std::unique_ptr<SoftwareRasterizer> m_Software;
+
+	unsigned int m_PassCount;
+	unsigned int m_ThreadCount;
+	std::vector<CommandBuffer> m_CommandBuffers;
+	std::vector<RenderCommand> m_Merged;
+
+	RendererStats m_Stats;
+
+	bool m_DepthPrePass;
+	std::unique_ptr<Shader> m_DepthShader;
+
+	//dva seta upita (uzorci, vrijeme) kako se rezultat ne bi cekao u istom frameu
+	unsigned int m_Queries[2][2];
+	unsigned int m_QueryFrame;
+	PassStats m_PassStats;
+};
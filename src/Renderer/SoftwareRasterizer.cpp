@@ -0,0 +1,540 @@
+#include "SoftwareRasterizer.h"
+
+#include "JobSystem.h"
+#include "Model.h"
+
+#include <emmintrin.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+//rezanje samo o ravnine izvan ovog pojasa (u NDC), unutar njega rubne funkcije u floatu ostaju tocne
+static const float GUARD_BAND = 4.0f;
+static const std::uint32_t VERTEX_GRAIN = 4096;
+//margina za zlatne slike, s istim buildom razlika je nula
+static const double GOLDEN_MIN_PSNR = 50.0;
+static const double GOLDEN_MAX_DIFFERENT_SHARE = 0.0002;
+
+static double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	return elapsed.count();
+}
+
+static inline std::uint32_t PackColor(const glm::vec3& color)
+{
+	glm::vec3 c = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+	return (std::uint32_t)c.r | ((std::uint32_t)c.g << 8) | ((std::uint32_t)c.b << 16) | 0xFF000000u;
+}
+
+SoftwareRasterizer::SoftwareRasterizer(unsigned int width, unsigned int height, JobSystem* jobs)
+	: m_Width(0), m_Height(0), m_TilesX(0), m_TilesY(0), m_Jobs(jobs),
+	m_LightPos(0.0f), m_LightColor(1.0f), m_ViewPos(0.0f)
+{
+	Resize(width, height);
+}
+
+void SoftwareRasterizer::Resize(unsigned int width, unsigned int height)
+{
+	m_Width = width;
+	m_Height = height;
+	m_TilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+	m_TilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+	m_Color.assign((std::size_t)width * height, 0);
+	m_Depth.assign((std::size_t)width * height, 1.0f);
+	m_Bins.assign(m_TilesX * m_TilesY, std::vector<std::uint32_t>());
+}
+
+void SoftwareRasterizer::Clear(const glm::vec3& color)
+{
+	std::fill(m_Color.begin(), m_Color.end(), PackColor(color));
+	std::fill(m_Depth.begin(), m_Depth.end(), 1.0f);
+}
+
+void SoftwareRasterizer::SetLight(const glm::vec3& lightPos, const glm::vec3& lightColor, const glm::vec3& viewPos)
+{
+	m_LightPos = lightPos;
+	m_LightColor = lightColor;
+	m_ViewPos = viewPos;
+}
+
+void SoftwareRasterizer::Draw(const Mesh& mesh, const SoftwareDrawUniforms& uniforms)
+{
+	Draw(mesh.GetVertices(), mesh.GetIndices(), uniforms);
+}
+
+void SoftwareRasterizer::Draw(const std::vector<Vertex>& vertices, const std::vector<int>& indices, const SoftwareDrawUniforms& uniforms)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	std::uint32_t draw = (std::uint32_t)m_Draws.size();
+	m_Draws.push_back(uniforms);
+	m_Stats.drawCalls++;
+
+	//vShader.glsl: pozicija odmah za sve vrhove, FragPos i Normal tek za trokute koji prezive odbacivanje
+	std::uint32_t count = (std::uint32_t)vertices.size();
+	m_Clip.resize(count);
+	auto transform = [&](std::uint32_t begin, std::uint32_t end)
+	{
+		for (std::uint32_t i = begin; i < end; i++)
+			m_Clip[i] = uniforms.mvp * glm::vec4(vertices[i].position, 1.0f);
+	};
+	if (m_Jobs && count >= 2 * VERTEX_GRAIN)
+		m_Jobs->ParallelFor(count, VERTEX_GRAIN, transform);
+	else
+		transform(0, count);
+
+	auto shadeVertex = [&](int index)
+	{
+		ClipVertex vertex;
+		vertex.clip = m_Clip[index];
+		vertex.worldPos = glm::vec3(uniforms.model * glm::vec4(vertices[index].position, 1.0f));
+		vertex.normal = uniforms.normalMatrix * vertices[index].normal;
+		return vertex;
+	};
+
+	//ravnine kao (koeficijent za x, y, z, w): tocka je unutra kad je dot(plane, clip) >= 0
+	const glm::vec4 planes[] = {
+		glm::vec4(0.0f, 0.0f, 1.0f, 1.0f),
+		glm::vec4(0.0f, 0.0f, -1.0f, 1.0f),
+		glm::vec4(1.0f, 0.0f, 0.0f, GUARD_BAND),
+		glm::vec4(-1.0f, 0.0f, 0.0f, GUARD_BAND),
+		glm::vec4(0.0f, 1.0f, 0.0f, GUARD_BAND),
+		glm::vec4(0.0f, -1.0f, 0.0f, GUARD_BAND)
+	};
+
+	//bitovi 0-5: izvan ravnine pogleda, bitovi 6-11: izvan ravnine pojasa (redoslijed kao planes)
+	auto outcode = [](const glm::vec4& clip)
+	{
+		float guard = clip.w * GUARD_BAND;
+		return (clip.z < -clip.w ? 1u : 0u) | (clip.z > clip.w ? 2u : 0u) |
+			(clip.x < -clip.w ? 4u : 0u) | (clip.x > clip.w ? 8u : 0u) | (clip.y < -clip.w ? 16u : 0u) | (clip.y > clip.w ? 32u : 0u) |
+			(clip.z < -clip.w ? 64u : 0u) | (clip.z > clip.w ? 128u : 0u) |
+			(clip.x < -guard ? 256u : 0u) | (clip.x > guard ? 512u : 0u) | (clip.y < -guard ? 1024u : 0u) | (clip.y > guard ? 2048u : 0u);
+	};
+
+	for (std::size_t t = 0; t + 2 < indices.size(); t += 3)
+	{
+		m_Stats.triangles++;
+		int i0 = indices[t], i1 = indices[t + 1], i2 = indices[t + 2];
+
+		//cijeli trokut izvan jedne ravnine pogleda se odbacuje, izvan pojasa se reze
+		std::uint32_t code0 = outcode(m_Clip[i0]), code1 = outcode(m_Clip[i1]), code2 = outcode(m_Clip[i2]);
+		if (code0 & code1 & code2 & 63u)
+		{
+			m_Stats.culledTriangles++;
+			continue;
+		}
+
+		if (!((code0 | code1 | code2) >> 6))
+		{
+			if (RasterTriangle* triangle = SetupTriangle(m_Clip[i0], m_Clip[i1], m_Clip[i2], draw))
+				SetAttributes(*triangle, shadeVertex(i0), shadeVertex(i1), shadeVertex(i2));
+			continue;
+		}
+
+		//Sutherland-Hodgman, trokut nakon 6 ravnina ima najvise 9 vrhova
+		m_Stats.clippedTriangles++;
+		ClipVertex polygon[2][12];
+		int size = 3;
+		polygon[0][0] = shadeVertex(i0);
+		polygon[0][1] = shadeVertex(i1);
+		polygon[0][2] = shadeVertex(i2);
+
+		int current = 0;
+		for (int p = 0; p < 6 && size > 0; p++)
+		{
+			const ClipVertex* in = polygon[current];
+			ClipVertex* out = polygon[current ^ 1];
+			int outSize = 0;
+			for (int v = 0; v < size; v++)
+			{
+				const ClipVertex& a = in[v];
+				const ClipVertex& b = in[(v + 1) % size];
+				float da = glm::dot(planes[p], a.clip), db = glm::dot(planes[p], b.clip);
+				if (da >= 0.0f)
+					out[outSize++] = a;
+				if ((da >= 0.0f) != (db >= 0.0f))
+				{
+					float s = da / (da - db);
+					ClipVertex& result = out[outSize++];
+					result.clip = glm::mix(a.clip, b.clip, s);
+					result.worldPos = glm::mix(a.worldPos, b.worldPos, s);
+					result.normal = glm::mix(a.normal, b.normal, s);
+				}
+			}
+			size = outSize;
+			current ^= 1;
+		}
+
+		const ClipVertex* result = polygon[current];
+		for (int v = 1; v + 1 < size; v++)
+		{
+			if (RasterTriangle* triangle = SetupTriangle(result[0].clip, result[v].clip, result[v + 1].clip, draw))
+				SetAttributes(*triangle, result[0], result[v], result[v + 1]);
+		}
+	}
+
+	m_Stats.geometryMs += ElapsedMs(start);
+}
+
+SoftwareRasterizer::RasterTriangle* SoftwareRasterizer::SetupTriangle(const glm::vec4& c0, const glm::vec4& c1, const glm::vec4& c2, std::uint32_t draw)
+{
+	const glm::vec4* vertices[3] = { &c0, &c1, &c2 };
+
+	RasterTriangle triangle;
+	float x[3], y[3];
+	for (int v = 0; v < 3; v++)
+	{
+		const glm::vec4& clip = *vertices[v];
+		float inverseW = 1.0f / clip.w;
+		//y raste prema dolje kako bi redovi buffera isli odozgo kao na ekranu
+		x[v] = (clip.x * inverseW * 0.5f + 0.5f) * m_Width;
+		y[v] = (0.5f - clip.y * inverseW * 0.5f) * m_Height;
+		triangle.z[v] = clip.z * inverseW * 0.5f + 0.5f;
+		triangle.inverseW[v] = inverseW;
+	}
+
+	float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+	if (area == 0.0f || !std::isfinite(area))
+	{
+		m_Stats.culledTriangles++;
+		return nullptr;
+	}
+
+	//bez odbacivanja straznjih strana (kao GL bez GL_CULL_FACE), obje orijentacije se svode na pozitivnu povrsinu
+	triangle.swapped = area < 0.0f;
+	if (triangle.swapped)
+	{
+		std::swap(x[1], x[2]);
+		std::swap(y[1], y[2]);
+		std::swap(triangle.z[1], triangle.z[2]);
+		std::swap(triangle.inverseW[1], triangle.inverseW[2]);
+		area = -area;
+	}
+	triangle.inverseArea = 1.0f / area;
+
+	//rub i nasuprot vrha i, raste prema unutrasnjosti
+	//racuna se od vrha ruba, a ne od ishodista ekrana: konstanta c = -(a * x0 + b * y0) bi se gotovo ponistila s a * x + b * y
+	//pa bi tezine mogle odstupiti vise od razmaka dubina dviju ploha; vrh je onaj prvi po (y, x) pa dva trokuta sa zajednickim
+	//rubom dobiju bitovno suprotne vrijednosti i piksel na rubu uzima tocno jedan od njih
+	for (int e = 0; e < 3; e++)
+	{
+		int a = (e + 1) % 3, b = (e + 2) % 3;
+		bool forward = y[a] < y[b] || (y[a] == y[b] && x[a] < x[b]);
+		int first = forward ? a : b, second = forward ? b : a;
+		float edgeA = y[first] - y[second];
+		float edgeB = x[second] - x[first];
+		triangle.edgeA[e] = forward ? edgeA : -edgeA;
+		triangle.edgeB[e] = forward ? edgeB : -edgeB;
+		triangle.edgeX[e] = x[first];
+		triangle.edgeY[e] = y[first];
+		triangle.topLeft[e] = triangle.edgeA[e] > 0.0f || (triangle.edgeA[e] == 0.0f && triangle.edgeB[e] > 0.0f);
+	}
+
+	//pravokutnik sredista piksela koja trokut moze pokriti; sitni trokuti izmedu sredista tu nestaju
+	triangle.minX = std::max(0, (int)std::ceil(std::min(std::min(x[0], x[1]), x[2]) - 0.5f));
+	triangle.minY = std::max(0, (int)std::ceil(std::min(std::min(y[0], y[1]), y[2]) - 0.5f));
+	triangle.maxX = std::min((int)m_Width - 1, (int)std::floor(std::max(std::max(x[0], x[1]), x[2]) - 0.5f));
+	triangle.maxY = std::min((int)m_Height - 1, (int)std::floor(std::max(std::max(y[0], y[1]), y[2]) - 0.5f));
+	if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+	{
+		m_Stats.culledTriangles++;
+		return nullptr;
+	}
+	triangle.draw = draw;
+
+	std::uint32_t index = (std::uint32_t)m_Triangles.size();
+	m_Triangles.push_back(triangle);
+
+	for (int tileY = triangle.minY / TILE_SIZE; tileY <= triangle.maxY / (int)TILE_SIZE; tileY++)
+	{
+		for (int tileX = triangle.minX / TILE_SIZE; tileX <= triangle.maxX / (int)TILE_SIZE; tileX++)
+		{
+			m_Bins[tileY * m_TilesX + tileX].push_back(index);
+			m_Stats.binnedTriangles++;
+		}
+	}
+	return &m_Triangles.back();
+}
+
+void SoftwareRasterizer::SetAttributes(RasterTriangle& triangle, const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2)
+{
+	const ClipVertex* vertices[3] = { &v0, triangle.swapped ? &v2 : &v1, triangle.swapped ? &v1 : &v2 };
+	for (int v = 0; v < 3; v++)
+	{
+		triangle.worldPos[v] = vertices[v]->worldPos;
+		triangle.normal[v] = vertices[v]->normal;
+	}
+}
+
+void SoftwareRasterizer::Flush()
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	std::atomic<unsigned long long> shaded(0);
+	auto rasterize = [&](std::uint32_t begin, std::uint32_t end)
+	{
+		std::vector<std::uint32_t> visibility(TILE_SIZE * TILE_SIZE);
+		std::vector<glm::vec2> barycentrics(TILE_SIZE * TILE_SIZE);
+		std::vector<float> depth(TILE_SIZE * TILE_SIZE);
+		unsigned long long pixels = 0;
+		for (std::uint32_t tile = begin; tile < end; tile++)
+		{
+			if (m_Bins[tile].empty())
+				continue;
+			RasterizeTile(tile, visibility, barycentrics, depth);
+
+			//svaki vidljivi piksel se sjenca jednom (fShader.glsl), bez obzira na preklapanje
+			unsigned int originX = (tile % m_TilesX) * TILE_SIZE, originY = (tile / m_TilesX) * TILE_SIZE;
+			unsigned int width = std::min(TILE_SIZE, m_Width - originX), height = std::min(TILE_SIZE, m_Height - originY);
+			for (unsigned int y = 0; y < height; y++)
+			{
+				for (unsigned int x = 0; x < width; x++)
+				{
+					std::uint32_t local = y * TILE_SIZE + x;
+					std::size_t pixel = (std::size_t)(originY + y) * m_Width + originX + x;
+					m_Depth[pixel] = depth[local];
+					if (!visibility[local])
+						continue;
+
+					const glm::vec2& l = barycentrics[local];
+					m_Color[pixel] = PackColor(Shade(m_Triangles[visibility[local] - 1], l.x, l.y));
+					pixels++;
+				}
+			}
+		}
+		shaded += pixels;
+	};
+
+	std::uint32_t tiles = m_TilesX * m_TilesY;
+	if (m_Jobs)
+		m_Jobs->ParallelFor(tiles, 1, rasterize);
+	else
+		rasterize(0, tiles);
+
+	m_Stats.shadedPixels += shaded;
+	m_Stats.rasterMs += ElapsedMs(start);
+
+	m_Triangles.clear();
+	m_Draws.clear();
+	for (std::vector<std::uint32_t>& bin : m_Bins)
+		bin.clear();
+}
+
+void SoftwareRasterizer::RasterizeTile(unsigned int tile, std::vector<std::uint32_t>& visibility, std::vector<glm::vec2>& barycentrics, std::vector<float>& depth)
+{
+	int originX = (tile % m_TilesX) * TILE_SIZE, originY = (tile / m_TilesX) * TILE_SIZE;
+	int endX = std::min(originX + (int)TILE_SIZE, (int)m_Width), endY = std::min(originY + (int)TILE_SIZE, (int)m_Height);
+
+	std::fill(visibility.begin(), visibility.end(), 0);
+	for (int y = originY; y < endY; y++)
+	{
+		std::copy(m_Depth.begin() + (std::size_t)y * m_Width + originX, m_Depth.begin() + (std::size_t)y * m_Width + endX,
+			depth.begin() + (y - originY) * TILE_SIZE);
+	}
+
+	const __m128 laneOffsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 four = _mm_set1_ps(4.0f);
+
+	for (std::uint32_t index : m_Bins[tile])
+	{
+		const RasterTriangle& triangle = m_Triangles[index];
+		int minY = std::max(triangle.minY, originY), maxY = std::min(triangle.maxY, endY - 1);
+		//pocetak reda poravnat na 4 piksela plocice kako bi SSE citanja i pisanja bila cijela
+		int minX = originX + ((std::max(triangle.minX, originX) - originX) & ~3), maxX = std::min(triangle.maxX, endX - 1);
+
+		__m128 a[3], edgeX[3], edgeMask[3];
+		for (int e = 0; e < 3; e++)
+		{
+			a[e] = _mm_set1_ps(triangle.edgeA[e]);
+			edgeX[e] = _mm_set1_ps(triangle.edgeX[e]);
+			//gornji i lijevi rubovi uzimaju i piksele s w == 0
+			edgeMask[e] = triangle.topLeft[e] ? _mm_castsi128_ps(_mm_set1_epi32(-1)) : _mm_setzero_ps();
+		}
+		__m128 inverseArea = _mm_set1_ps(triangle.inverseArea);
+		//dubina od z0 kako bi se greska tezina mnozila samo razlikama dubina vrhova, a ne cijelom dubinom
+		__m128 z0 = _mm_set1_ps(triangle.z[0]);
+		__m128 z10 = _mm_set1_ps(triangle.z[1] - triangle.z[0]), z20 = _mm_set1_ps(triangle.z[2] - triangle.z[0]);
+		__m128i id = _mm_set1_epi32((int)index + 1);
+
+		for (int y = minY; y <= maxY; y++)
+		{
+			float py = y + 0.5f;
+			__m128 px = _mm_add_ps(_mm_set1_ps((float)minX), laneOffsets);
+			__m128 row[3];
+			for (int e = 0; e < 3; e++)
+				row[e] = _mm_set1_ps(triangle.edgeB[e] * (py - triangle.edgeY[e]));
+
+			int rowOffset = (y - originY) * TILE_SIZE - originX;
+			for (int x = minX; x <= maxX; x += 4)
+			{
+				//svaki piksel racuna w izravno, zbrajanje koraka bi ovisilo o pocetku reda pa rubovi ne bi bili vodonepropusni
+				__m128 w[3];
+				for (int e = 0; e < 3; e++)
+					w[e] = _mm_add_ps(_mm_mul_ps(a[e], _mm_sub_ps(px, edgeX[e])), row[e]);
+
+				__m128 inside = _mm_and_ps(
+					_mm_and_ps(_mm_or_ps(_mm_cmpgt_ps(w[0], zero), _mm_and_ps(edgeMask[0], _mm_cmpeq_ps(w[0], zero))),
+						_mm_or_ps(_mm_cmpgt_ps(w[1], zero), _mm_and_ps(edgeMask[1], _mm_cmpeq_ps(w[1], zero)))),
+					_mm_or_ps(_mm_cmpgt_ps(w[2], zero), _mm_and_ps(edgeMask[2], _mm_cmpeq_ps(w[2], zero))));
+
+				if (_mm_movemask_ps(inside))
+				{
+					//dubina je linearna u prostoru ekrana
+					__m128 l1 = _mm_mul_ps(w[1], inverseArea), l2 = _mm_mul_ps(w[2], inverseArea);
+					__m128 z = _mm_add_ps(z0, _mm_add_ps(_mm_mul_ps(l1, z10), _mm_mul_ps(l2, z20)));
+
+					int local = rowOffset + x;
+					__m128 stored = _mm_loadu_ps(&depth[local]);
+					__m128 pass = _mm_and_ps(inside, _mm_cmplt_ps(z, stored));
+					int passMask = _mm_movemask_ps(pass);
+					if (passMask)
+					{
+						_mm_storeu_ps(&depth[local], _mm_or_ps(_mm_and_ps(pass, z), _mm_andnot_ps(pass, stored)));
+
+						__m128i passInt = _mm_castps_si128(pass);
+						__m128i ids = _mm_loadu_si128((const __m128i*)&visibility[local]);
+						_mm_storeu_si128((__m128i*)&visibility[local], _mm_or_si128(_mm_and_si128(passInt, id), _mm_andnot_si128(passInt, ids)));
+
+						float l1s[4], l2s[4];
+						_mm_storeu_ps(l1s, l1);
+						_mm_storeu_ps(l2s, l2);
+						for (int lane = 0; lane < 4; lane++)
+						{
+							if (passMask & (1 << lane))
+								barycentrics[local + lane] = glm::vec2(l1s[lane], l2s[lane]);
+						}
+					}
+				}
+
+				px = _mm_add_ps(px, four);
+			}
+		}
+	}
+}
+
+glm::vec3 SoftwareRasterizer::Shade(const RasterTriangle& triangle, float l1, float l2) const
+{
+	//perspektivno ispravne tezine iz tezina u prostoru ekrana
+	float l0 = 1.0f - l1 - l2;
+	float p0 = l0 * triangle.inverseW[0], p1 = l1 * triangle.inverseW[1], p2 = l2 * triangle.inverseW[2];
+	float inverseSum = 1.0f / (p0 + p1 + p2);
+	p0 *= inverseSum;
+	p1 *= inverseSum;
+	p2 *= inverseSum;
+
+	glm::vec3 fragPos = triangle.worldPos[0] * p0 + triangle.worldPos[1] * p1 + triangle.worldPos[2] * p2;
+	glm::vec3 normal = triangle.normal[0] * p0 + triangle.normal[1] * p1 + triangle.normal[2] * p2;
+	const SoftwareDrawUniforms& uniforms = m_Draws[triangle.draw];
+
+	//fShader.glsl
+	glm::vec3 ambient = 0.1f * m_LightColor;
+
+	glm::vec3 norm = glm::normalize(normal);
+	glm::vec3 lightDir = glm::normalize(m_LightPos - fragPos);
+	float diff = std::max(glm::dot(norm, lightDir), 0.0f);
+	glm::vec3 diffuse = diff * m_LightColor;
+
+	glm::vec3 viewDir = glm::normalize(m_ViewPos - fragPos);
+	glm::vec3 reflectDir = glm::reflect(-lightDir, norm);
+	float spec = std::max(glm::dot(viewDir, reflectDir), 0.0f);
+	//pow(spec, 32) kvadriranjem
+	spec *= spec; spec *= spec; spec *= spec; spec *= spec; spec *= spec;
+	glm::vec3 specular = uniforms.specularStrength * spec * m_LightColor;
+
+	return (ambient + diffuse + specular) * uniforms.objectColor;
+}
+
+bool SoftwareRasterizer::SaveImage(const std::string& path) const
+{
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+	{
+		std::cerr << "FILE COULD NOT OPEN: " << path << std::endl;
+		return false;
+	}
+
+	file << "P6\n" << m_Width << " " << m_Height << "\n255\n";
+	std::vector<unsigned char> row(m_Width * 3);
+	for (unsigned int y = 0; y < m_Height; y++)
+	{
+		for (unsigned int x = 0; x < m_Width; x++)
+		{
+			std::uint32_t pixel = m_Color[(std::size_t)y * m_Width + x];
+			row[3 * x] = pixel & 0xFF;
+			row[3 * x + 1] = (pixel >> 8) & 0xFF;
+			row[3 * x + 2] = (pixel >> 16) & 0xFF;
+		}
+		file.write((const char*)row.data(), row.size());
+	}
+	return true;
+}
+
+bool SoftwareRasterizer::LoadImage(const std::string& path, unsigned int& width, unsigned int& height, std::vector<std::uint32_t>& pixels)
+{
+	std::ifstream file(path, std::ios::binary);
+	std::string magic;
+	unsigned int maxValue = 0;
+	if (!(file >> magic >> width >> height >> maxValue) || magic != "P6" || maxValue != 255)
+	{
+		std::cerr << "NOT A BINARY PPM IMAGE: " << path << std::endl;
+		return false;
+	}
+	file.get();
+
+	std::vector<unsigned char> data((std::size_t)width * height * 3);
+	file.read((char*)data.data(), data.size());
+	if (!file)
+	{
+		std::cerr << "PPM IMAGE TRUNCATED: " << path << std::endl;
+		return false;
+	}
+
+	pixels.resize((std::size_t)width * height);
+	for (std::size_t i = 0; i < pixels.size(); i++)
+		pixels[i] = data[3 * i] | (data[3 * i + 1] << 8) | (data[3 * i + 2] << 16) | 0xFF000000u;
+	return true;
+}
+
+ImageDifference SoftwareRasterizer::CompareImages(const std::vector<std::uint32_t>& a, const std::vector<std::uint32_t>& b, unsigned int tolerance)
+{
+	ImageDifference result;
+	result.pixels = a.size();
+	if (a.size() != b.size() || a.empty())
+	{
+		result.maxDifference = 255;
+		result.differentPixels = result.pixels;
+		return result;
+	}
+
+	double squared = 0.0;
+	for (std::size_t i = 0; i < a.size(); i++)
+	{
+		unsigned int pixelDifference = 0;
+		for (int channel = 0; channel < 3; channel++)
+		{
+			int difference = std::abs((int)((a[i] >> (8 * channel)) & 0xFF) - (int)((b[i] >> (8 * channel)) & 0xFF));
+			pixelDifference = std::max(pixelDifference, (unsigned int)difference);
+			squared += difference * difference;
+		}
+		result.maxDifference = std::max(result.maxDifference, pixelDifference);
+		result.differentPixels += pixelDifference > tolerance ? 1 : 0;
+	}
+
+	double mse = squared / (a.size() * 3.0);
+	result.psnr = mse == 0.0 ? std::numeric_limits<double>::infinity() : 10.0 * std::log10(255.0 * 255.0 / mse);
+	return result;
+}
+
+bool SoftwareRasterizer::MatchesGolden(const ImageDifference& difference)
+{
+	return difference.psnr >= GOLDEN_MIN_PSNR && difference.GetDifferentShare() <= GOLDEN_MAX_DIFFERENT_SHARE;
+}
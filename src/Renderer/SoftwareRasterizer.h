@@ -0,0 +1,135 @@
+#pragma once
+
+#include "glm/glm.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class JobSystem;
+class Mesh;
+struct Vertex;
+
+//uniformi jednog poziva crtanja, isti kao u vShader.glsl / fShader.glsl
+struct SoftwareDrawUniforms
+{
+	glm::mat4 model = glm::mat4(1.0f);
+	glm::mat4 mvp = glm::mat4(1.0f);
+	glm::mat3 normalMatrix = glm::mat3(1.0f);
+	glm::vec3 objectColor = glm::vec3(1.0f);
+	float specularStrength = 0.5f;
+};
+
+//usporedba dviju slika po RGB kanalima
+struct ImageDifference
+{
+	//beskonacno za iste slike
+	double psnr = 0.0;
+	unsigned int maxDifference = 0;
+	//pikseli kojima se barem jedan kanal razlikuje vise od tolerancije
+	std::size_t differentPixels = 0;
+	std::size_t pixels = 0;
+
+	inline double GetDifferentShare() const { return pixels ? (double)differentPixels / pixels : 1.0; }
+};
+
+struct SoftwareRasterStats
+{
+	unsigned int drawCalls = 0;
+	unsigned int triangles = 0;
+	unsigned int culledTriangles = 0;
+	unsigned int clippedTriangles = 0;
+	unsigned int binnedTriangles = 0;
+	unsigned long long shadedPixels = 0;
+	double geometryMs = 0.0;
+	double rasterMs = 0.0;
+};
+
+//CPU rasterizer koji ponavlja forward Phong prolaz (vShader.glsl + fShader.glsl) bez GPU-a
+//Draw transformira vrhove, reze trokute o blisku ravninu i razvrstava ih po plocicama ekrana,
+//Flush rasterizira plocice paralelno: SSE rubne funkcije i test dubine za 4 piksela odjednom u
+//buffer vidljivosti plocice, zatim se svaki vidljivi piksel sjenca tocno jednom s perspektivno
+//ispravnom interpolacijom; trokuti unutar plocice idu redom slanja pa je slika ista za bilo koji broj dretvi
+class SoftwareRasterizer
+{
+public:
+	static const unsigned int TILE_SIZE = 64;
+	//razlika kanala do koje se piksel smatra istim kao u zlatnoj slici
+	static const unsigned int GOLDEN_TOLERANCE = 8;
+
+	SoftwareRasterizer() = delete;
+	SoftwareRasterizer(unsigned int width, unsigned int height, JobSystem* jobs = nullptr);
+
+	void Resize(unsigned int width, unsigned int height);
+	void Clear(const glm::vec3& color);
+	void SetLight(const glm::vec3& lightPos, const glm::vec3& lightColor, const glm::vec3& viewPos);
+
+	void Draw(const std::vector<Vertex>& vertices, const std::vector<int>& indices, const SoftwareDrawUniforms& uniforms);
+	void Draw(const Mesh& mesh, const SoftwareDrawUniforms& uniforms);
+	void Flush();
+
+	//RGBA8 po redovima odozgo prema dolje, dubina u [0, 1] kao GL_LESS s glDepthRange(0, 1)
+	inline const std::vector<std::uint32_t>& GetColorBuffer() const { return m_Color; }
+	inline const std::vector<float>& GetDepthBuffer() const { return m_Depth; }
+	inline unsigned int GetWidth() const { return m_Width; }
+	inline unsigned int GetHeight() const { return m_Height; }
+	inline const SoftwareRasterStats& GetStats() const { return m_Stats; }
+	inline void ResetStats() { m_Stats = SoftwareRasterStats(); }
+
+	//binarni PPM (P6), za referentne slike i usporedbu u CI-u
+	bool SaveImage(const std::string& path) const;
+	static bool LoadImage(const std::string& path, unsigned int& width, unsigned int& height, std::vector<std::uint32_t>& pixels);
+	static ImageDifference CompareImages(const std::vector<std::uint32_t>& a, const std::vector<std::uint32_t>& b, unsigned int tolerance = GOLDEN_TOLERANCE);
+	//zlatne slike u res/reference: drugi kompajler ili CPU smije pomaknuti rub trokuta za piksel (velika razlika jednog piksela)
+	//i zaokruzivanje sjencanja za nekoliko razina, ali ne smije promijeniti sliku
+	static bool MatchesGolden(const ImageDifference& difference);
+
+private:
+	struct ClipVertex
+	{
+		glm::vec4 clip;
+		glm::vec3 worldPos;
+		glm::vec3 normal;
+	};
+
+	//trokut spreman za rasterizaciju, rubne funkcije w = a * (x - x0) + b * (y - y0) u sredistu piksela, (x0, y0) je vrh ruba
+	struct RasterTriangle
+	{
+		float edgeA[3], edgeB[3], edgeX[3], edgeY[3];
+		float inverseArea;
+		float z[3];
+		float inverseW[3];
+		glm::vec3 worldPos[3];
+		glm::vec3 normal[3];
+		int minX, minY, maxX, maxY;
+		std::uint32_t draw;
+		//vrhovi 1 i 2 zamijenjeni kako bi povrsina bila pozitivna
+		bool swapped;
+		//rubovi koji ne pripadaju gornjem ili lijevom rubu ne uzimaju piksele tocno na rubu
+		std::uint8_t topLeft[3];
+	};
+
+	//racuna rubne funkcije i razvrstava trokut po plocicama, nullptr ako ne pokriva nijedan piksel
+	RasterTriangle* SetupTriangle(const glm::vec4& c0, const glm::vec4& c1, const glm::vec4& c2, std::uint32_t draw);
+	void SetAttributes(RasterTriangle& triangle, const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2);
+	void RasterizeTile(unsigned int tile, std::vector<std::uint32_t>& visibility, std::vector<glm::vec2>& barycentrics, std::vector<float>& depth);
+	glm::vec3 Shade(const RasterTriangle& triangle, float l1, float l2) const;
+
+private:
+	unsigned int m_Width, m_Height;
+	unsigned int m_TilesX, m_TilesY;
+	JobSystem* m_Jobs;
+
+	std::vector<std::uint32_t> m_Color;
+	std::vector<float> m_Depth;
+
+	glm::vec3 m_LightPos, m_LightColor, m_ViewPos;
+
+	std::vector<glm::vec4> m_Clip;
+	std::vector<RasterTriangle> m_Triangles;
+	std::vector<SoftwareDrawUniforms> m_Draws;
+	std::vector<std::vector<std::uint32_t>> m_Bins;
+
+	SoftwareRasterStats m_Stats;
+};
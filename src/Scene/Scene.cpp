@@ -0,0 +1,176 @@
+#include "Scene.h"
+
+#include "JobSystem.h"
+
+Scene::Scene()
+	: m_StaticVersion(0) { }
+
+Entity Scene::CreateEntity(const glm::vec3& position, Entity parent)
+{
+	Entity entity = (Entity)m_Positions.size();
+
+	m_Positions.push_back(position);
+	m_Rotations.push_back(glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+	m_Scales.push_back(glm::vec3(1.0f));
+	m_WorldMatrices.push_back(glm::mat4(1.0f));
+
+	m_Parents.push_back(parent);
+	m_FirstChild.push_back(INVALID_ENTITY);
+	m_NextSibling.push_back(INVALID_ENTITY);
+	m_Depths.push_back(0);
+	if (parent != INVALID_ENTITY)
+	{
+		m_Depths[entity] = m_Depths[parent] + 1;
+		m_NextSibling[entity] = m_FirstChild[parent];
+		m_FirstChild[parent] = entity;
+	}
+
+	m_Colors.push_back(glm::vec3(1.0f));
+	m_SpecularStrengths.push_back(0.5f);
+	m_Meshes.push_back(0);
+	m_Static.push_back(0);
+
+	m_Dirty.push_back(0);
+	MarkDirty(entity);
+
+	return entity;
+}
+
+void Scene::Reserve(std::size_t count)
+{
+	m_Positions.reserve(count);
+	m_Rotations.reserve(count);
+	m_Scales.reserve(count);
+	m_WorldMatrices.reserve(count);
+	m_Parents.reserve(count);
+	m_FirstChild.reserve(count);
+	m_NextSibling.reserve(count);
+	m_Depths.reserve(count);
+	m_Colors.reserve(count);
+	m_SpecularStrengths.reserve(count);
+	m_Meshes.reserve(count);
+	m_Static.reserve(count);
+	m_Dirty.reserve(count);
+}
+
+void Scene::SetPosition(Entity entity, const glm::vec3& position)
+{
+	m_Positions[entity] = position;
+	MarkDirty(entity);
+}
+
+void Scene::SetRotation(Entity entity, const glm::quat& rotation)
+{
+	m_Rotations[entity] = rotation;
+	MarkDirty(entity);
+}
+
+void Scene::SetScale(Entity entity, const glm::vec3& scale)
+{
+	m_Scales[entity] = scale;
+	MarkDirty(entity);
+}
+
+void Scene::SetMaterial(Entity entity, const glm::vec3& color, float specularStrength)
+{
+	m_Colors[entity] = color;
+	m_SpecularStrengths[entity] = specularStrength;
+}
+
+void Scene::SetMesh(Entity entity, unsigned int mesh)
+{
+	m_Meshes[entity] = mesh;
+	if (m_Static[entity])
+		m_StaticVersion++;
+}
+
+void Scene::SetStatic(Entity entity, bool isStatic)
+{
+	if (m_Static[entity] == (std::uint8_t)isStatic)
+		return;
+
+	m_Static[entity] = isStatic ? 1 : 0;
+	m_StaticVersion++;
+}
+
+void Scene::MarkDirty(Entity entity)
+{
+	if (m_Static[entity])
+		m_StaticVersion++;
+
+	if (m_Dirty[entity])
+		return;
+
+	m_Dirty[entity] = 1;
+
+	std::uint32_t depth = m_Depths[entity];
+	if (m_DirtyByDepth.size() <= depth)
+		m_DirtyByDepth.resize(depth + 1);
+	m_DirtyByDepth[depth].push_back(entity);
+}
+
+void Scene::UpdateEntity(Entity entity)
+{
+	//T * R * S bez posrednih mnozenja matrica
+	glm::mat4 local = glm::mat4_cast(m_Rotations[entity]);
+	local[0] *= m_Scales[entity].x;
+	local[1] *= m_Scales[entity].y;
+	local[2] *= m_Scales[entity].z;
+	local[3] = glm::vec4(m_Positions[entity], 1.0f);
+
+	Entity parent = m_Parents[entity];
+	m_WorldMatrices[entity] = parent == INVALID_ENTITY ? local : m_WorldMatrices[parent] * local;
+	m_Dirty[entity] = 0;
+}
+
+void Scene::UpdateTransforms(JobSystem* jobs)
+{
+	m_Stats = SceneStats();
+
+	//roditelji su na nizoj razini pa su gotovi prije nego sto se racunaju djeca
+	for (std::size_t depth = 0; depth < m_DirtyByDepth.size(); depth++)
+	{
+		if (m_DirtyByDepth[depth].empty())
+			continue;
+
+		//sljedeca razina mora postojati prije uzimanja reference jer MarkDirty inace moze realocirati niz
+		if (m_DirtyByDepth.size() <= depth + 1)
+			m_DirtyByDepth.resize(depth + 2);
+		std::vector<Entity>& dirty = m_DirtyByDepth[depth];
+
+		if (jobs)
+		{
+			jobs->ParallelFor((std::uint32_t)dirty.size(), 1024, [this, &dirty](std::uint32_t begin, std::uint32_t end)
+			{
+				for (std::uint32_t i = begin; i < end; i++)
+					UpdateEntity(dirty[i]);
+			});
+		}
+		else
+		{
+			for (Entity entity : dirty)
+				UpdateEntity(entity);
+		}
+
+		//djeca promijenjenih entiteta dolaze na red na sljedecoj razini
+		for (Entity entity : dirty)
+		{
+			for (Entity child = m_FirstChild[entity]; child != INVALID_ENTITY; child = m_NextSibling[child])
+				MarkDirty(child);
+		}
+
+		m_Stats.updatedEntities += (unsigned int)dirty.size();
+		m_Stats.levels++;
+		dirty.clear();
+	}
+}
+
+void Scene::Snapshot(SceneSnapshot& snapshot) const
+{
+	snapshot.worldMatrices.assign(m_WorldMatrices.begin(), m_WorldMatrices.end());
+	snapshot.colors.assign(m_Colors.begin(), m_Colors.end());
+	snapshot.specularStrengths.assign(m_SpecularStrengths.begin(), m_SpecularStrengths.end());
+	snapshot.meshes.assign(m_Meshes.begin(), m_Meshes.end());
+	snapshot.statics.assign(m_Static.begin(), m_Static.end());
+	snapshot.staticVersion = m_StaticVersion;
+}
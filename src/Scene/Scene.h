@@ -0,0 +1,112 @@
+#pragma once
+
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+#include <cstdint>
+#include <vector>
+
+class JobSystem;
+
+typedef std::uint32_t Entity;
+const Entity INVALID_ENTITY = 0xFFFFFFFF;
+
+struct SceneStats
+{
+	unsigned int updatedEntities = 0;
+	unsigned int levels = 0;
+};
+
+//kopija onoga sto renderer cita iz scene u jednom frameu; s render dretvom frame N crta iz svoje kopije
+//dok glavna dretva vec mijenja scenu za frame N+1
+struct SceneSnapshot
+{
+	std::vector<glm::mat4> worldMatrices;
+	std::vector<glm::vec3> colors;
+	std::vector<float> specularStrengths;
+	std::vector<unsigned int> meshes;
+	std::vector<std::uint8_t> statics;
+	std::uint64_t staticVersion = 0;
+
+	inline std::size_t GetEntityCount() const { return worldMatrices.size(); }
+	inline const glm::mat4& GetWorldMatrix(Entity entity) const { return worldMatrices[entity]; }
+	inline const glm::vec3& GetColor(Entity entity) const { return colors[entity]; }
+	inline float GetSpecularStrength(Entity entity) const { return specularStrengths[entity]; }
+	inline unsigned int GetMesh(Entity entity) const { return meshes[entity]; }
+	inline bool IsStatic(Entity entity) const { return statics[entity] != 0; }
+	inline std::uint64_t GetStaticVersion() const { return staticVersion; }
+};
+
+//entiteti su indeksi u paralelne nizove komponenti (SoA)
+//roditelj mora biti stvoren prije djeteta pa je dubina u hijerarhiji poznata pri stvaranju
+class Scene
+{
+public:
+	Scene();
+
+	Entity CreateEntity(const glm::vec3& position, Entity parent = INVALID_ENTITY);
+	void Reserve(std::size_t count);
+
+	void SetPosition(Entity entity, const glm::vec3& position);
+	void SetRotation(Entity entity, const glm::quat& rotation);
+	void SetScale(Entity entity, const glm::vec3& scale);
+	void SetMaterial(Entity entity, const glm::vec3& color, float specularStrength);
+	void SetMesh(Entity entity, unsigned int mesh);
+
+	//staticni entiteti se smiju cacheirati (npr. u mapama sjena), svaka njihova promjena povecava verziju
+	void SetStatic(Entity entity, bool isStatic);
+
+	//ponovno racuna samo matrice oznacenih entiteta i njihove djece, razinu po razinu
+	void UpdateTransforms(JobSystem* jobs = nullptr);
+	//kopira matrice, materijale, meshove i staticnost nakon UpdateTransforms, postojeci kapacitet se ponovno koristi
+	void Snapshot(SceneSnapshot& snapshot) const;
+
+	inline std::size_t GetEntityCount() const { return m_Positions.size(); }
+	inline Entity GetParent(Entity entity) const { return m_Parents[entity]; }
+
+	inline const glm::vec3& GetPosition(Entity entity) const { return m_Positions[entity]; }
+	inline const glm::quat& GetRotation(Entity entity) const { return m_Rotations[entity]; }
+	inline const glm::vec3& GetScale(Entity entity) const { return m_Scales[entity]; }
+	inline const glm::mat4& GetWorldMatrix(Entity entity) const { return m_WorldMatrices[entity]; }
+	inline const glm::vec3& GetColor(Entity entity) const { return m_Colors[entity]; }
+	inline float GetSpecularStrength(Entity entity) const { return m_SpecularStrengths[entity]; }
+	inline unsigned int GetMesh(Entity entity) const { return m_Meshes[entity]; }
+	inline bool IsStatic(Entity entity) const { return m_Static[entity] != 0; }
+	inline std::uint64_t GetStaticVersion() const { return m_StaticVersion; }
+
+	inline const std::vector<glm::mat4>& GetWorldMatrices() const { return m_WorldMatrices; }
+	inline const std::vector<glm::vec3>& GetColors() const { return m_Colors; }
+	inline const std::vector<float>& GetSpecularStrengths() const { return m_SpecularStrengths; }
+	inline const std::vector<unsigned int>& GetMeshes() const { return m_Meshes; }
+
+	inline const SceneStats& GetStats() const { return m_Stats; }
+
+private:
+	void MarkDirty(Entity entity);
+	void UpdateEntity(Entity entity);
+
+private:
+	//transformacija
+	std::vector<glm::vec3> m_Positions;
+	std::vector<glm::quat> m_Rotations;
+	std::vector<glm::vec3> m_Scales;
+	std::vector<glm::mat4> m_WorldMatrices;
+
+	//hijerarhija
+	std::vector<Entity> m_Parents;
+	std::vector<Entity> m_FirstChild;
+	std::vector<Entity> m_NextSibling;
+	std::vector<std::uint32_t> m_Depths;
+
+	//materijal i mesh
+	std::vector<glm::vec3> m_Colors;
+	std::vector<float> m_SpecularStrengths;
+	std::vector<unsigned int> m_Meshes;
+	std::vector<std::uint8_t> m_Static;
+	std::uint64_t m_StaticVersion;
+
+	std::vector<std::uint8_t> m_Dirty;
+	std::vector<std::vector<Entity>> m_DirtyByDepth;
+
+	SceneStats m_Stats;
+};
@@ -0,0 +1,599 @@
+#include "SceneBVH.h"
+
+#include "JobSystem.h"
+#include "Scene.h"
+
+#include <xmmintrin.h>
+
+#include <algorithm>
+#include <chrono>
+
+static const std::uint32_t LEAF_FLAG = 0x80000000;
+static const std::uint32_t EMPTY_CHILD = 0xFFFFFFFF;
+static const std::uint32_t NO_PARENT = 0xFFFFFFFF;
+
+//ispod ovih velicina posao se ne dijeli jer bi rasporedivanje kostalo vise od samog rada
+static const std::uint32_t PARALLEL_BINNING_SIZE = 64 * 1024;
+static const std::uint32_t PARALLEL_SUBTREE_SIZE = 4 * 1024;
+static const std::uint32_t BINNING_GRAIN = 16 * 1024;
+
+static const unsigned int STACK_SIZE = 256;
+
+static inline bool IsLeaf(std::uint32_t child) { return child != EMPTY_CHILD && (child & LEAF_FLAG) != 0; }
+static inline std::uint32_t LeafFirst(std::uint32_t child) { return (child & ~LEAF_FLAG) >> 3; }
+static inline std::uint32_t LeafCount(std::uint32_t child) { return child & 7; }
+
+static double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	return elapsed.count();
+}
+
+//ulazna udaljenost zrake u kutiju ili FLT_MAX ako je promasuje
+static float IntersectRay(const AABB& box, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance)
+{
+	glm::vec3 t1 = (box.minimum - origin) * inverseDirection;
+	glm::vec3 t2 = (box.maximum - origin) * inverseDirection;
+	glm::vec3 tNear = glm::min(t1, t2), tFar = glm::max(t1, t2);
+
+	float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+	float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+	return enter <= exit ? enter : FLT_MAX;
+}
+
+SceneBVH::SceneBVH()
+	: m_BuildNodeCount(0) { }
+
+void SceneBVH::Build(const Scene& scene, const std::vector<AABB>& meshBounds, JobSystem* jobs)
+{
+	std::vector<AABB> bounds(scene.GetEntityCount());
+	for (Entity entity = 0; entity < bounds.size(); entity++)
+		bounds[entity] = meshBounds[scene.GetMesh(entity)].Transform(scene.GetWorldMatrix(entity));
+
+	Build(bounds, jobs);
+}
+
+void SceneBVH::Build(const std::vector<AABB>& bounds, JobSystem* jobs)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	std::uint32_t count = (std::uint32_t)bounds.size();
+	m_Bounds = bounds;
+	m_Nodes.clear();
+	m_DirtyList.clear();
+	m_Stats = BVHStats();
+	if (count == 0)
+		return;
+
+	m_Objects.resize(count);
+	m_Centroids.resize(count);
+	for (std::uint32_t i = 0; i < count; i++)
+	{
+		m_Objects[i] = i;
+		m_Centroids[i] = bounds[i].Center();
+	}
+
+	m_BuildNodes.resize(2 * count);
+	m_BuildNodeCount = 1;
+	BuildRange(0, 0, count, jobs);
+
+	m_ObjectSlots.resize(count);
+	m_Nodes.reserve(m_BuildNodeCount / 2 + 1);
+	Collapse(0, NO_PARENT, 0, 1);
+	m_DirtyNodes.assign(m_Nodes.size(), 0);
+
+	m_Stats.nodes = (unsigned int)m_Nodes.size();
+
+	std::vector<glm::vec3>().swap(m_Centroids);
+	std::vector<BuildNode>().swap(m_BuildNodes);
+
+	m_Stats.buildMs = ElapsedMs(start);
+}
+
+void SceneBVH::BuildRange(std::uint32_t node, std::uint32_t begin, std::uint32_t end, JobSystem* jobs)
+{
+	struct Bin
+	{
+		AABB bounds;
+		std::uint32_t count = 0;
+	};
+
+	std::uint32_t count = end - begin;
+	bool parallel = jobs && count >= PARALLEL_BINNING_SIZE;
+
+	//kutija cvora i kutija sredista, na velikim cvorovima po komadima na dretvama
+	AABB bounds, centroidBounds;
+	{
+		std::uint32_t chunks = parallel ? (count + BINNING_GRAIN - 1) / BINNING_GRAIN : 1;
+		std::vector<AABB> partialBounds(chunks), partialCentroids(chunks);
+		auto gather = [&](std::uint32_t first, std::uint32_t last)
+		{
+			std::uint32_t chunk = parallel ? first / BINNING_GRAIN : 0;
+			for (std::uint32_t i = begin + first; i < begin + last; i++)
+			{
+				partialBounds[chunk].Expand(m_Bounds[m_Objects[i]]);
+				partialCentroids[chunk].Expand(m_Centroids[m_Objects[i]]);
+			}
+		};
+		if (parallel)
+			jobs->ParallelFor(count, BINNING_GRAIN, gather);
+		else
+			gather(0, count);
+
+		for (std::uint32_t c = 0; c < chunks; c++)
+		{
+			bounds.Expand(partialBounds[c]);
+			centroidBounds.Expand(partialCentroids[c]);
+		}
+	}
+
+	BuildNode& buildNode = m_BuildNodes[node];
+	buildNode.bounds = bounds;
+	buildNode.first = begin;
+	buildNode.count = count;
+	if (count <= MAX_LEAF_SIZE)
+		return;
+
+	glm::vec3 extent = centroidBounds.Extent();
+	glm::vec3 scale(0.0f);
+	for (int axis = 0; axis < 3; axis++)
+	{
+		if (extent[axis] > 0.0f)
+			scale[axis] = BIN_COUNT * 0.9999f / extent[axis];
+	}
+
+	//binning po sve tri osi odjednom
+	Bin bins[3][BIN_COUNT];
+	{
+		std::uint32_t chunks = parallel ? (count + BINNING_GRAIN - 1) / BINNING_GRAIN : 1;
+		std::vector<Bin> partial(chunks * 3 * BIN_COUNT);
+		auto binning = [&](std::uint32_t first, std::uint32_t last)
+		{
+			Bin* local = &partial[(parallel ? first / BINNING_GRAIN : 0) * 3 * BIN_COUNT];
+			for (std::uint32_t i = begin + first; i < begin + last; i++)
+			{
+				std::uint32_t object = m_Objects[i];
+				glm::vec3 offset = (m_Centroids[object] - centroidBounds.minimum) * scale;
+				for (int axis = 0; axis < 3; axis++)
+				{
+					Bin& bin = local[axis * BIN_COUNT + std::min((unsigned int)offset[axis], BIN_COUNT - 1)];
+					bin.bounds.Expand(m_Bounds[object]);
+					bin.count++;
+				}
+			}
+		};
+		if (parallel)
+			jobs->ParallelFor(count, BINNING_GRAIN, binning);
+		else
+			binning(0, count);
+
+		for (std::uint32_t c = 0; c < chunks; c++)
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				for (unsigned int b = 0; b < BIN_COUNT; b++)
+				{
+					const Bin& bin = partial[(c * 3 + axis) * BIN_COUNT + b];
+					bins[axis][b].bounds.Expand(bin.bounds);
+					bins[axis][b].count += bin.count;
+				}
+			}
+		}
+	}
+
+	//SAH: trosak podjele iza svakog bina, lijeva strana prefiksom, desna sufiksom
+	float bestCost = FLT_MAX;
+	int bestAxis = -1;
+	unsigned int bestBin = 0;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		if (scale[axis] == 0.0f)
+			continue;
+
+		float rightCost[BIN_COUNT];
+		AABB right;
+		std::uint32_t rightCount = 0;
+		for (unsigned int b = BIN_COUNT - 1; b > 0; b--)
+		{
+			right.Expand(bins[axis][b].bounds);
+			rightCount += bins[axis][b].count;
+			rightCost[b] = rightCount * right.SurfaceArea();
+		}
+
+		AABB left;
+		std::uint32_t leftCount = 0;
+		for (unsigned int b = 0; b < BIN_COUNT - 1; b++)
+		{
+			left.Expand(bins[axis][b].bounds);
+			leftCount += bins[axis][b].count;
+			float cost = leftCount * left.SurfaceArea() + rightCost[b + 1];
+			if (leftCount > 0 && leftCount < count && cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestBin = b;
+			}
+		}
+	}
+
+	std::uint32_t middle = begin + count / 2;
+	if (bestAxis >= 0)
+	{
+		float axisMinimum = centroidBounds.minimum[bestAxis], axisScale = scale[bestAxis];
+		auto split = std::partition(m_Objects.begin() + begin, m_Objects.begin() + end, [&](std::uint32_t object)
+		{
+			return std::min((unsigned int)((m_Centroids[object][bestAxis] - axisMinimum) * axisScale), BIN_COUNT - 1) <= bestBin;
+		});
+		middle = (std::uint32_t)(split - m_Objects.begin());
+	}
+	//sva sredista u istoj tocki: podjela po pola
+	if (middle == begin || middle == end)
+		middle = begin + count / 2;
+
+	std::uint32_t left = m_BuildNodeCount.fetch_add(2);
+	buildNode.left = left;
+	buildNode.right = left + 1;
+	buildNode.count = 0;
+
+	if (jobs && count >= PARALLEL_SUBTREE_SIZE)
+	{
+		JobCounter counter;
+		jobs->Run([this, left, begin, middle, jobs]() { BuildRange(left, begin, middle, jobs); }, &counter);
+		BuildRange(left + 1, middle, end, jobs);
+		jobs->Wait(counter);
+	}
+	else
+	{
+		BuildRange(left, begin, middle, jobs);
+		BuildRange(left + 1, middle, end, jobs);
+	}
+}
+
+std::uint32_t SceneBVH::Collapse(std::uint32_t buildNode, std::uint32_t parent, std::uint32_t parentSlot, unsigned int depth)
+{
+	std::uint32_t index = (std::uint32_t)m_Nodes.size();
+	m_Nodes.emplace_back();
+	for (unsigned int slot = 0; slot < 4; slot++)
+	{
+		SetChildBounds(m_Nodes[index], slot, AABB());
+		m_Nodes[index].children[slot] = EMPTY_CHILD;
+	}
+	m_Nodes[index].parent = parent;
+	m_Nodes[index].parentSlot = parentSlot;
+	m_Stats.maxDepth = std::max(m_Stats.maxDepth, depth);
+
+	//djeca binarnog cvora se otvaraju (najveca povrsina prva) dok ih nema 4
+	std::uint32_t children[4];
+	unsigned int childCount = 0;
+	const BuildNode& root = m_BuildNodes[buildNode];
+	if (root.count > 0)
+	{
+		children[childCount++] = buildNode;
+	}
+	else
+	{
+		children[childCount++] = root.left;
+		children[childCount++] = root.right;
+	}
+
+	while (childCount < 4)
+	{
+		int best = -1;
+		float bestArea = -1.0f;
+		for (unsigned int i = 0; i < childCount; i++)
+		{
+			const BuildNode& child = m_BuildNodes[children[i]];
+			if (child.count == 0 && child.bounds.SurfaceArea() > bestArea)
+			{
+				bestArea = child.bounds.SurfaceArea();
+				best = (int)i;
+			}
+		}
+		if (best < 0)
+			break;
+
+		const BuildNode& opened = m_BuildNodes[children[best]];
+		children[best] = opened.left;
+		children[childCount++] = opened.right;
+	}
+
+	for (unsigned int slot = 0; slot < childCount; slot++)
+	{
+		const BuildNode& child = m_BuildNodes[children[slot]];
+		SetChildBounds(m_Nodes[index], slot, child.bounds);
+
+		if (child.count > 0)
+		{
+			m_Nodes[index].children[slot] = LEAF_FLAG | (child.first << 3) | child.count;
+			for (std::uint32_t i = child.first; i < child.first + child.count; i++)
+				m_ObjectSlots[m_Objects[i]] = index * 4 + slot;
+			m_Stats.leaves++;
+		}
+		else
+		{
+			//push_back u rekurziji moze realocirati niz pa se referenca ne drzi
+			std::uint32_t childIndex = Collapse(children[slot], index, slot, depth + 1);
+			m_Nodes[index].children[slot] = childIndex;
+		}
+	}
+
+	return index;
+}
+
+void SceneBVH::SetChildBounds(Node& node, unsigned int slot, const AABB& bounds)
+{
+	node.minX[slot] = bounds.minimum.x;
+	node.minY[slot] = bounds.minimum.y;
+	node.minZ[slot] = bounds.minimum.z;
+	node.maxX[slot] = bounds.maximum.x;
+	node.maxY[slot] = bounds.maximum.y;
+	node.maxZ[slot] = bounds.maximum.z;
+}
+
+AABB SceneBVH::GetNodeBounds(const Node& node) const
+{
+	AABB bounds;
+	for (unsigned int slot = 0; slot < 4; slot++)
+	{
+		if (node.children[slot] != EMPTY_CHILD)
+			bounds.Expand(AABB(glm::vec3(node.minX[slot], node.minY[slot], node.minZ[slot]), glm::vec3(node.maxX[slot], node.maxY[slot], node.maxZ[slot])));
+	}
+	return bounds;
+}
+
+AABB SceneBVH::GetLeafBounds(std::uint32_t child) const
+{
+	AABB bounds;
+	for (std::uint32_t i = LeafFirst(child); i < LeafFirst(child) + LeafCount(child); i++)
+		bounds.Expand(m_Bounds[m_Objects[i]]);
+	return bounds;
+}
+
+void SceneBVH::UpdateObject(std::uint32_t object, const AABB& bounds)
+{
+	m_Bounds[object] = bounds;
+
+	std::uint32_t node = m_ObjectSlots[object] / 4;
+	if (!m_DirtyNodes[node])
+	{
+		m_DirtyNodes[node] = 1;
+		m_DirtyList.push_back(node);
+	}
+}
+
+void SceneBVH::Refit()
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	m_Stats.refitNodes = 0;
+
+	//roditelj ima manji indeks od djece pa obrada od najveceg indeksa vidi vec osvjezenu djecu
+	std::make_heap(m_DirtyList.begin(), m_DirtyList.end());
+	while (!m_DirtyList.empty())
+	{
+		std::pop_heap(m_DirtyList.begin(), m_DirtyList.end());
+		std::uint32_t index = m_DirtyList.back();
+		m_DirtyList.pop_back();
+		m_DirtyNodes[index] = 0;
+		m_Stats.refitNodes++;
+
+		Node& node = m_Nodes[index];
+		AABB previous = GetNodeBounds(node);
+		for (unsigned int slot = 0; slot < 4; slot++)
+		{
+			std::uint32_t child = node.children[slot];
+			if (child == EMPTY_CHILD)
+				continue;
+			SetChildBounds(node, slot, IsLeaf(child) ? GetLeafBounds(child) : GetNodeBounds(m_Nodes[child]));
+		}
+
+		//roditelj se osvjezava samo ako se kutija cvora stvarno promijenila
+		AABB current = GetNodeBounds(node);
+		if (node.parent != NO_PARENT && !m_DirtyNodes[node.parent] &&
+			(current.minimum != previous.minimum || current.maximum != previous.maximum))
+		{
+			m_DirtyNodes[node.parent] = 1;
+			m_DirtyList.push_back(node.parent);
+			std::push_heap(m_DirtyList.begin(), m_DirtyList.end());
+		}
+	}
+
+	m_Stats.refitMs = ElapsedMs(start);
+}
+
+void SceneBVH::QueryFrustum(const Frustum& frustum, std::vector<std::uint32_t>& result) const
+{
+	if (m_Nodes.empty())
+		return;
+
+	//za svaku ravninu unaprijed se bira koja strana kutije je najdalja u smjeru normale
+	__m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+	bool positiveX[6], positiveY[6], positiveZ[6];
+	for (int p = 0; p < 6; p++)
+	{
+		const glm::vec4& plane = frustum.planes[p];
+		planeX[p] = _mm_set1_ps(plane.x);
+		planeY[p] = _mm_set1_ps(plane.y);
+		planeZ[p] = _mm_set1_ps(plane.z);
+		planeW[p] = _mm_set1_ps(plane.w);
+		positiveX[p] = plane.x >= 0.0f;
+		positiveY[p] = plane.y >= 0.0f;
+		positiveZ[p] = plane.z >= 0.0f;
+	}
+	const __m128 zero = _mm_setzero_ps();
+
+	std::uint32_t stack[STACK_SIZE];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const Node& node = m_Nodes[stack[--stackSize]];
+
+		__m128 inside = _mm_cmpeq_ps(zero, zero);
+		for (int p = 0; p < 6; p++)
+		{
+			__m128 x = _mm_load_ps(positiveX[p] ? node.maxX : node.minX);
+			__m128 y = _mm_load_ps(positiveY[p] ? node.maxY : node.minY);
+			__m128 z = _mm_load_ps(positiveZ[p] ? node.maxZ : node.minZ);
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], x), _mm_mul_ps(planeY[p], y)),
+				_mm_add_ps(_mm_mul_ps(planeZ[p], z), planeW[p]));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, zero));
+		}
+
+		int mask = _mm_movemask_ps(inside);
+		for (unsigned int slot = 0; slot < 4; slot++)
+		{
+			std::uint32_t child = node.children[slot];
+			if (!(mask & (1 << slot)) || child == EMPTY_CHILD)
+				continue;
+
+			if (IsLeaf(child))
+			{
+				for (std::uint32_t i = LeafFirst(child); i < LeafFirst(child) + LeafCount(child); i++)
+				{
+					const AABB& box = m_Bounds[m_Objects[i]];
+					if (frustum.IntersectsAABB(box.minimum, box.maximum))
+						result.push_back(m_Objects[i]);
+				}
+			}
+			else
+			{
+				stack[stackSize++] = child;
+			}
+		}
+	}
+}
+
+void SceneBVH::QueryAABB(const AABB& box, std::vector<std::uint32_t>& result) const
+{
+	if (m_Nodes.empty())
+		return;
+
+	const __m128 boxMinX = _mm_set1_ps(box.minimum.x), boxMinY = _mm_set1_ps(box.minimum.y), boxMinZ = _mm_set1_ps(box.minimum.z);
+	const __m128 boxMaxX = _mm_set1_ps(box.maximum.x), boxMaxY = _mm_set1_ps(box.maximum.y), boxMaxZ = _mm_set1_ps(box.maximum.z);
+
+	std::uint32_t stack[STACK_SIZE];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const Node& node = m_Nodes[stack[--stackSize]];
+
+		__m128 overlapX = _mm_and_ps(_mm_cmple_ps(_mm_load_ps(node.minX), boxMaxX), _mm_cmpge_ps(_mm_load_ps(node.maxX), boxMinX));
+		__m128 overlapY = _mm_and_ps(_mm_cmple_ps(_mm_load_ps(node.minY), boxMaxY), _mm_cmpge_ps(_mm_load_ps(node.maxY), boxMinY));
+		__m128 overlapZ = _mm_and_ps(_mm_cmple_ps(_mm_load_ps(node.minZ), boxMaxZ), _mm_cmpge_ps(_mm_load_ps(node.maxZ), boxMinZ));
+		int mask = _mm_movemask_ps(_mm_and_ps(overlapX, _mm_and_ps(overlapY, overlapZ)));
+
+		for (unsigned int slot = 0; slot < 4; slot++)
+		{
+			std::uint32_t child = node.children[slot];
+			if (!(mask & (1 << slot)) || child == EMPTY_CHILD)
+				continue;
+
+			if (IsLeaf(child))
+			{
+				for (std::uint32_t i = LeafFirst(child); i < LeafFirst(child) + LeafCount(child); i++)
+				{
+					if (m_Bounds[m_Objects[i]].Overlaps(box))
+						result.push_back(m_Objects[i]);
+				}
+			}
+			else
+			{
+				stack[stackSize++] = child;
+			}
+		}
+	}
+}
+
+BVHRayHit SceneBVH::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance) const
+{
+	BVHRayHit hit;
+	hit.distance = maxDistance;
+	if (m_Nodes.empty())
+		return hit;
+
+	glm::vec3 inverseDirection = 1.0f / direction;
+	const __m128 originX = _mm_set1_ps(origin.x), originY = _mm_set1_ps(origin.y), originZ = _mm_set1_ps(origin.z);
+	const __m128 inverseX = _mm_set1_ps(inverseDirection.x), inverseY = _mm_set1_ps(inverseDirection.y), inverseZ = _mm_set1_ps(inverseDirection.z);
+
+	struct Entry
+	{
+		std::uint32_t node;
+		float distance;
+	};
+	Entry stack[STACK_SIZE];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = { 0, 0.0f };
+
+	while (stackSize > 0)
+	{
+		Entry entry = stack[--stackSize];
+		if (entry.distance > hit.distance)
+			continue;
+		const Node& node = m_Nodes[entry.node];
+
+		//slab test za 4 kutije odjednom
+		__m128 x1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minX), originX), inverseX);
+		__m128 x2 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxX), originX), inverseX);
+		__m128 y1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minY), originY), inverseY);
+		__m128 y2 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxY), originY), inverseY);
+		__m128 z1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minZ), originZ), inverseZ);
+		__m128 z2 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxZ), originZ), inverseZ);
+
+		__m128 enter = _mm_max_ps(_mm_max_ps(_mm_min_ps(x1, x2), _mm_min_ps(y1, y2)), _mm_max_ps(_mm_min_ps(z1, z2), _mm_setzero_ps()));
+		__m128 exit = _mm_min_ps(_mm_min_ps(_mm_max_ps(x1, x2), _mm_max_ps(y1, y2)), _mm_min_ps(_mm_max_ps(z1, z2), _mm_set1_ps(hit.distance)));
+		int mask = _mm_movemask_ps(_mm_cmple_ps(enter, exit));
+		if (!mask)
+			continue;
+
+		alignas(16) float distances[4];
+		_mm_store_ps(distances, enter);
+
+		//pogodena djeca se sortiraju po udaljenosti, bliza se obilaze prva
+		Entry hits[4];
+		unsigned int hitCount = 0;
+		for (unsigned int slot = 0; slot < 4; slot++)
+		{
+			std::uint32_t child = node.children[slot];
+			if (!(mask & (1 << slot)) || child == EMPTY_CHILD)
+				continue;
+
+			Entry childEntry = { child, distances[slot] };
+			unsigned int i = hitCount++;
+			while (i > 0 && hits[i - 1].distance > childEntry.distance)
+			{
+				hits[i] = hits[i - 1];
+				i--;
+			}
+			hits[i] = childEntry;
+		}
+
+		for (unsigned int i = 0; i < hitCount; i++)
+		{
+			if (!IsLeaf(hits[i].node))
+				continue;
+
+			for (std::uint32_t o = LeafFirst(hits[i].node); o < LeafFirst(hits[i].node) + LeafCount(hits[i].node); o++)
+			{
+				float distance = IntersectRay(m_Bounds[m_Objects[o]], origin, inverseDirection, hit.distance);
+				if (distance == FLT_MAX)
+					continue;
+				if (distance < hit.distance || (distance == hit.distance && m_Objects[o] < hit.object))
+				{
+					hit.distance = distance;
+					hit.object = m_Objects[o];
+				}
+			}
+		}
+
+		for (unsigned int i = hitCount; i > 0; i--)
+		{
+			if (!IsLeaf(hits[i - 1].node))
+				stack[stackSize++] = hits[i - 1];
+		}
+	}
+
+	return hit;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "AABB.h"
+#include "Frustum.h"
+
+#include "glm/glm.hpp"
+
+#include <atomic>
+#include <cfloat>
+#include <cstdint>
+#include <vector>
+
+class JobSystem;
+class Scene;
+
+struct BVHRayHit
+{
+	std::uint32_t object = 0xFFFFFFFF;
+	float distance = FLT_MAX;
+
+	inline bool IsHit() const { return object != 0xFFFFFFFF; }
+};
+
+struct BVHStats
+{
+	unsigned int nodes = 0;
+	unsigned int leaves = 0;
+	unsigned int maxDepth = 0;
+	unsigned int refitNodes = 0;
+	double buildMs = 0.0;
+	double refitMs = 0.0;
+};
+
+//BVH nad kutijama objekata (instanci Modela), gradi se binarnim SAH-om pa sazima u 4-struka stabla
+//cvor drzi kutije sve 4 djece (SoA) pa se jednom SSE usporedbom testiraju sva djeca
+class SceneBVH
+{
+public:
+	static const unsigned int MAX_LEAF_SIZE = 4;
+	static const unsigned int BIN_COUNT = 16;
+	static const std::uint32_t INVALID_OBJECT = 0xFFFFFFFF;
+
+	SceneBVH();
+
+	//gradnja na dretvama posla: gornje razine dijele binning, podstabla se grade kao zasebni poslovi
+	void Build(const std::vector<AABB>& bounds, JobSystem* jobs = nullptr);
+	//kutije entiteta iz svjetskih matrica i lokalnih kutija mesheva (Mesh::GetBounds() po indeksu Scene::GetMesh())
+	void Build(const Scene& scene, const std::vector<AABB>& meshBounds, JobSystem* jobs = nullptr);
+
+	//mijenja kutiju objekta i oznacava put do korijena, Refit() osvjezava samo oznacene cvorove
+	void UpdateObject(std::uint32_t object, const AABB& bounds);
+	void Refit();
+
+	void QueryFrustum(const Frustum& frustum, std::vector<std::uint32_t>& result) const;
+	void QueryAABB(const AABB& box, std::vector<std::uint32_t>& result) const;
+	BVHRayHit Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance = FLT_MAX) const;
+
+	inline std::size_t GetObjectCount() const { return m_Bounds.size(); }
+	inline std::size_t GetNodeCount() const { return m_Nodes.size(); }
+	inline const AABB& GetBounds(std::uint32_t object) const { return m_Bounds[object]; }
+	inline const BVHStats& GetStats() const { return m_Stats; }
+
+private:
+	struct alignas(16) Node
+	{
+		float minX[4], minY[4], minZ[4];
+		float maxX[4], maxY[4], maxZ[4];
+		//unutarnji cvor: indeks, list: LEAF_FLAG | (prvi << 3) | broj, prazno: EMPTY_CHILD
+		std::uint32_t children[4];
+		std::uint32_t parent;
+		std::uint32_t parentSlot;
+	};
+
+	struct BuildNode
+	{
+		AABB bounds;
+		std::uint32_t left, right;
+		std::uint32_t first, count;
+	};
+
+	void BuildRange(std::uint32_t node, std::uint32_t begin, std::uint32_t end, JobSystem* jobs);
+	std::uint32_t Collapse(std::uint32_t buildNode, std::uint32_t parent, std::uint32_t parentSlot, unsigned int depth);
+	void SetChildBounds(Node& node, unsigned int slot, const AABB& bounds);
+	AABB GetNodeBounds(const Node& node) const;
+	AABB GetLeafBounds(std::uint32_t child) const;
+
+private:
+	std::vector<AABB> m_Bounds;
+	std::vector<std::uint32_t> m_Objects;
+	std::vector<Node> m_Nodes;
+
+	//lokacija lista svakog objekta (cvor * 4 + utor) i cvorovi koje treba osvjeziti
+	std::vector<std::uint32_t> m_ObjectSlots;
+	std::vector<std::uint8_t> m_DirtyNodes;
+	std::vector<std::uint32_t> m_DirtyList;
+
+	//privremeno tijekom gradnje
+	std::vector<glm::vec3> m_Centroids;
+	std::vector<BuildNode> m_BuildNodes;
+	std::atomic<std::uint32_t> m_BuildNodeCount;
+
+	BVHStats m_Stats;
+};
@@ -1,6 +1,7 @@
 #include "glad/glad.h"
 
 #include "Shader.h"
+#include "FileSystem.h"
 
 Shader::Shader(const std::string& vertexShader, const std::string& fragmentShader) 
 {
@@ -28,6 +29,16 @@ void Shader::SetUniform4x4(const std::string& name, const glm::mat4& value) cons
 	glUniformMatrix4fv(glGetUniformLocation(m_RenderID, name.c_str()), 1, GL_FALSE, &value[0][0]);
 }
 
+void Shader::SetUniform3x3(const std::string& name, const glm::mat3& value) const
+{
+	glUniformMatrix3fv(glGetUniformLocation(m_RenderID, name.c_str()), 1, GL_FALSE, &value[0][0]);
+}
+
+void Shader::SetUniformVec2(const std::string& name, const glm::vec2& value) const
+{
+	glUniform2fv(glGetUniformLocation(m_RenderID, name.c_str()), 1, &value[0]);
+}
+
 void Shader::SetUniformVec3(const std::string& name, const float& x, const float& y, const float& z) const
 {
 	glUniform3f(glGetUniformLocation(m_RenderID, name.c_str()), x, y, z);
@@ -38,6 +49,11 @@ void Shader::SetUniformVec3(const std::string& name, const glm::vec3& value) con
 	glUniform3fv(glGetUniformLocation(m_RenderID, name.c_str()), 1, &value[0]);
 }
 
+void Shader::SetUniformVec4(const std::string& name, const glm::vec4& value) const
+{
+	glUniform4fv(glGetUniformLocation(m_RenderID, name.c_str()), 1, &value[0]);
+}
+
 void Shader::SetUniformFloat(const std::string& name, const float& value) const
 {
 	glUniform1f(glGetUniformLocation(m_RenderID, name.c_str()), value);
@@ -50,32 +66,18 @@ void Shader::SetUniformInt(const std::string& name, const int& value) const
 
 void Shader::LoadShaders(const std::string& vertexPath, const std::string& fragmentPath)
 {
-	std::ifstream vertexShaderFile(vertexPath);
-	assert(vertexShaderFile);
-	std::ifstream fragmentShaderFile(fragmentPath);
-	assert(fragmentShaderFile);
-	
-	std::stringstream vertexStream;
-	std::stringstream fragmentStream;
-
-	std::string readVertex;
-	std::string readFragment;
-
-	while (std::getline(vertexShaderFile, readVertex))
-	{
-		vertexStream << readVertex << "\n";
-	}
-
-	while (std::getline(fragmentShaderFile, readFragment))
-	{
-		fragmentStream << readFragment << "\n";
-	}
-
-	vertexShaderFile.close();
-	fragmentShaderFile.close();
-
-	m_VertexSource = vertexStream.str();
-	m_FragmentSource = fragmentStream.str();
+	//iz montiranog packa ili s diska (FileSystem)
+	FileData vertexFile;
+	bool vertexLoaded = FileSystem::Read(vertexPath, vertexFile);
+	assert(vertexLoaded);
+	FileData fragmentFile;
+	bool fragmentLoaded = FileSystem::Read(fragmentPath, fragmentFile);
+	assert(fragmentLoaded);
+	(void)vertexLoaded;
+	(void)fragmentLoaded;
+
+	m_VertexSource = vertexFile.ToString();
+	m_FragmentSource = fragmentFile.ToString();
 }
 
 
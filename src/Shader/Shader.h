@@ -18,8 +18,11 @@ public:
 	void UnBind() const;
 
 	void SetUniform4x4(const std::string& name, const glm::mat4& value) const;
+	void SetUniform3x3(const std::string& name, const glm::mat3& value) const;
+	void SetUniformVec2(const std::string& name, const glm::vec2& value) const;
 	void SetUniformVec3(const std::string& name, const float& x, const float& y, const float& z) const;
 	void SetUniformVec3(const std::string& name, const glm::vec3& value) const;
+	void SetUniformVec4(const std::string& name, const glm::vec4& value) const;
 	void SetUniformFloat(const std::string& name, const float& value) const;
 	void SetUniformInt(const std::string& name, const int& value) const;
 
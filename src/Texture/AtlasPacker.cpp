@@ -0,0 +1,109 @@
+#include "AtlasPacker.h"
+
+#include <algorithm>
+
+static unsigned int AlignUp(unsigned int value, unsigned int alignment)
+{
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+AtlasPacker::AtlasPacker(unsigned int width, unsigned int height, unsigned int alignment)
+	: m_Width(width), m_Height(height), m_Alignment(std::max(1u, alignment)), m_UsedArea(0)
+{
+	Clear();
+}
+
+void AtlasPacker::Clear()
+{
+	m_UsedArea = 0;
+	m_Skyline.clear();
+	m_Skyline.push_back({ 0, 0, m_Width });
+}
+
+bool AtlasPacker::Fit(std::size_t index, unsigned int width, unsigned int height, unsigned int& y) const
+{
+	unsigned int x = m_Skyline[index].x;
+	if (x + width > m_Width)
+		return false;
+
+	y = 0;
+	unsigned int remaining = width;
+	for (std::size_t i = index; remaining > 0; i++)
+	{
+		y = std::max(y, m_Skyline[i].y);
+		if (y + height > m_Height)
+			return false;
+		remaining -= std::min(remaining, m_Skyline[i].width);
+	}
+	return true;
+}
+
+bool AtlasPacker::Insert(unsigned int width, unsigned int height, AtlasRect& out)
+{
+	width = AlignUp(width, m_Alignment);
+	height = AlignUp(height, m_Alignment);
+	if (width == 0 || height == 0)
+		return false;
+
+	//najnize mjesto, kod iste visine ono koje ostavlja uzi segment (manje rupa ispod obrisa)
+	std::size_t bestIndex = m_Skyline.size();
+	unsigned int bestY = 0, bestWidth = 0;
+	for (std::size_t i = 0; i < m_Skyline.size(); i++)
+	{
+		unsigned int y;
+		if (!Fit(i, width, height, y))
+			continue;
+		if (bestIndex == m_Skyline.size() || y + height < bestY + height || (y == bestY && m_Skyline[i].width < bestWidth))
+		{
+			bestIndex = i;
+			bestY = y;
+			bestWidth = m_Skyline[i].width;
+		}
+	}
+	if (bestIndex == m_Skyline.size())
+		return false;
+
+	out.x = m_Skyline[bestIndex].x;
+	out.y = bestY;
+	out.width = width;
+	out.height = height;
+
+	//novi segment zamjenjuje sve koje pravokutnik prekriva, zadnji prekriveni se skracuje
+	SkylineNode node = { out.x, bestY + height, width };
+	m_Skyline.insert(m_Skyline.begin() + bestIndex, node);
+	std::size_t i = bestIndex + 1;
+	while (i < m_Skyline.size() && m_Skyline[i].x < node.x + node.width)
+	{
+		unsigned int end = m_Skyline[i].x + m_Skyline[i].width;
+		if (end <= node.x + node.width)
+		{
+			m_Skyline.erase(m_Skyline.begin() + i);
+			continue;
+		}
+		m_Skyline[i].width = end - (node.x + node.width);
+		m_Skyline[i].x = node.x + node.width;
+		break;
+	}
+
+	//susjedni segmenti iste visine se spajaju
+	for (std::size_t j = 0; j + 1 < m_Skyline.size(); )
+	{
+		if (m_Skyline[j].y == m_Skyline[j + 1].y)
+		{
+			m_Skyline[j].width += m_Skyline[j + 1].width;
+			m_Skyline.erase(m_Skyline.begin() + j + 1);
+		}
+		else
+		{
+			j++;
+		}
+	}
+
+	m_UsedArea += (unsigned long long)width * height;
+	return true;
+}
+
+float AtlasPacker::GetOccupancy() const
+{
+	return (float)((double)m_UsedArea / ((double)m_Width * m_Height));
+}
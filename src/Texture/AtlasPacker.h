@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+
+struct AtlasRect
+{
+	unsigned int x = 0;
+	unsigned int y = 0;
+	unsigned int width = 0;
+	unsigned int height = 0;
+};
+
+//skyline bottom-left pakiranje pravokutnika u jednu stranicu atlasa
+//dimenzije se zaokruzuju na alignment pa svi pravokutnici pocinju na visekratniku alignmenta;
+//uz alignment 2^k mip nivoi do k ne mijesaju texele susjednih pravokutnika
+class AtlasPacker
+{
+public:
+	AtlasPacker() = delete;
+	AtlasPacker(unsigned int width, unsigned int height, unsigned int alignment = 1);
+
+	//false ako pravokutnik ne stane; out je zaokruzeni pravokutnik
+	bool Insert(unsigned int width, unsigned int height, AtlasRect& out);
+	void Clear();
+
+	//udio povrsine pokriven zaokruzenim pravokutnicima
+	float GetOccupancy() const;
+	inline unsigned int GetWidth() const { return m_Width; }
+	inline unsigned int GetHeight() const { return m_Height; }
+
+private:
+	//vodoravni segment obrisa: od x do x + width je sve ispod y zauzeto
+	struct SkylineNode
+	{
+		unsigned int x, y, width;
+	};
+
+	//najniza visina na kojoj pravokutnik sirine width stane pocevsi od cvora index, false ako izlazi iz stranice
+	bool Fit(std::size_t index, unsigned int width, unsigned int height, unsigned int& y) const;
+
+private:
+	unsigned int m_Width, m_Height;
+	unsigned int m_Alignment;
+	unsigned long long m_UsedArea;
+	std::vector<SkylineNode> m_Skyline;
+};
@@ -0,0 +1,284 @@
+#include "ImageDecoder.h"
+
+#include "JobSystem.h"
+#include "FileSystem.h"
+#include "AsyncIO.h"
+
+#include "stb_image/stb_image.h"
+
+#include <emmintrin.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+static double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	return elapsed.count();
+}
+
+//round(c * a / 255) bez dijeljenja, isto kao SSE put
+static inline std::uint8_t MultiplyAlpha(std::uint32_t color, std::uint32_t alpha)
+{
+	std::uint32_t t = color * alpha + 128;
+	return (std::uint8_t)((t + (t >> 8)) >> 8);
+}
+
+static void ExpandRowScalar(const std::uint8_t* source, unsigned int channels, unsigned int width, std::uint8_t* target)
+{
+	for (unsigned int x = 0; x < width; x++, source += channels, target += 4)
+	{
+		switch (channels)
+		{
+		case 1: target[0] = target[1] = target[2] = source[0]; target[3] = 255; break;
+		case 2: target[0] = target[1] = target[2] = source[0]; target[3] = source[1]; break;
+		case 3: target[0] = source[0]; target[1] = source[1]; target[2] = source[2]; target[3] = 255; break;
+		default: std::memcpy(target, source, 4); break;
+		}
+	}
+}
+
+static void PremultiplyRowScalar(std::uint8_t* pixels, unsigned int width)
+{
+	for (unsigned int x = 0; x < width; x++, pixels += 4)
+	{
+		pixels[0] = MultiplyAlpha(pixels[0], pixels[3]);
+		pixels[1] = MultiplyAlpha(pixels[1], pixels[3]);
+		pixels[2] = MultiplyAlpha(pixels[2], pixels[3]);
+	}
+}
+
+//sivi: 16 piksela po iteraciji, bajt se dvaput udvostruci u 32-bitnu traku
+//RGB: 4 piksela iz 12 bajtova pomacima za 0, 3, 6 i 9 bajtova; ucitava se 16 bajtova pa zadnja 2 piksela retka idu skalarno
+static void ExpandRowSse(const std::uint8_t* source, unsigned int channels, unsigned int width, std::uint8_t* target)
+{
+	const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+	const __m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+	unsigned int x = 0;
+	if (channels == 1)
+	{
+		for (; x + 16 <= width; x += 16)
+		{
+			__m128i gray = _mm_loadu_si128((const __m128i*)(source + x));
+			__m128i lo = _mm_unpacklo_epi8(gray, gray);
+			__m128i hi = _mm_unpackhi_epi8(gray, gray);
+			__m128i* out = (__m128i*)(target + x * 4);
+			_mm_storeu_si128(out + 0, _mm_or_si128(_mm_unpacklo_epi16(lo, lo), alpha));
+			_mm_storeu_si128(out + 1, _mm_or_si128(_mm_unpackhi_epi16(lo, lo), alpha));
+			_mm_storeu_si128(out + 2, _mm_or_si128(_mm_unpacklo_epi16(hi, hi), alpha));
+			_mm_storeu_si128(out + 3, _mm_or_si128(_mm_unpackhi_epi16(hi, hi), alpha));
+		}
+	}
+	else if (channels == 3)
+	{
+		for (; x + 6 <= width; x += 4)
+		{
+			__m128i rgb = _mm_loadu_si128((const __m128i*)(source + x * 3));
+			__m128i p01 = _mm_unpacklo_epi32(rgb, _mm_srli_si128(rgb, 3));
+			__m128i p23 = _mm_unpacklo_epi32(_mm_srli_si128(rgb, 6), _mm_srli_si128(rgb, 9));
+			__m128i pixels = _mm_unpacklo_epi64(p01, p23);
+			_mm_storeu_si128((__m128i*)(target + x * 4), _mm_or_si128(_mm_and_si128(pixels, rgbMask), alpha));
+		}
+	}
+	else if (channels == 4)
+	{
+		std::memcpy(target, source, (std::size_t)width * 4);
+		return;
+	}
+
+	ExpandRowScalar(source + x * channels, channels, width - x, target + x * 4);
+}
+
+//2 piksela po 16-bitnom registru, alfa se prosiri na sve trake osim vlastite koja se mnozi s 255
+static void PremultiplyRowSse(std::uint8_t* pixels, unsigned int width)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i rgbLanes = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+	const __m128i alphaLane = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+	const __m128i bias = _mm_set1_epi16(128);
+	unsigned int x = 0;
+	for (; x + 4 <= width; x += 4)
+	{
+		__m128i* address = (__m128i*)(pixels + x * 4);
+		__m128i value = _mm_loadu_si128(address);
+		__m128i halves[2] = { _mm_unpacklo_epi8(value, zero), _mm_unpackhi_epi8(value, zero) };
+		for (__m128i& half : halves)
+		{
+			__m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(half, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+			alpha = _mm_or_si128(_mm_and_si128(alpha, rgbLanes), alphaLane);
+			__m128i t = _mm_add_epi16(_mm_mullo_epi16(half, alpha), bias);
+			half = _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+		}
+		_mm_storeu_si128(address, _mm_packus_epi16(halves[0], halves[1]));
+	}
+	PremultiplyRowScalar(pixels + x * 4, width - x);
+}
+
+void ImageDecoder::ConvertToRGBA8(const std::uint8_t* source, unsigned int channels, unsigned int width, unsigned int height,
+	std::uint8_t* target, bool flip, bool premultiplyAlpha, BatchMath::SimdLevel level)
+{
+	bool simd = level != BatchMath::SimdLevel::Scalar;
+	bool hasAlpha = channels == 2 || channels == 4;
+	std::size_t sourcePitch = (std::size_t)width * channels;
+	for (unsigned int y = 0; y < height; y++)
+	{
+		const std::uint8_t* sourceRow = source + (flip ? height - 1 - y : y) * sourcePitch;
+		std::uint8_t* targetRow = target + (std::size_t)y * width * 4;
+		if (simd)
+			ExpandRowSse(sourceRow, channels, width, targetRow);
+		else
+			ExpandRowScalar(sourceRow, channels, width, targetRow);
+
+		//red se premnozava dok je jos u cacheu; bez alfe nema sto mnoziti
+		if (premultiplyAlpha && hasAlpha)
+		{
+			if (simd)
+				PremultiplyRowSse(targetRow, width);
+			else
+				PremultiplyRowScalar(targetRow, width);
+		}
+	}
+}
+
+ImageDecoder::ImageDecoder(JobSystem* jobs, AsyncIO* io)
+	: m_Jobs(jobs), m_IO(io)
+{
+}
+
+bool ImageDecoder::DecodeFile(const std::string& path, DecodedImage& out, const ImageDecodeOptions& options)
+{
+	double decodeMs, convertMs;
+	return DecodeFile(path, out, options, decodeMs, convertMs);
+}
+
+bool ImageDecoder::DecodeMemory(const std::uint8_t* data, std::size_t size, const std::string& path, DecodedImage& out, const ImageDecodeOptions& options)
+{
+	double decodeMs, convertMs;
+	return DecodeMemory(data, size, path, out, options, decodeMs, convertMs);
+}
+
+bool ImageDecoder::DecodeFile(const std::string& path, DecodedImage& out, const ImageDecodeOptions& options, double& decodeMs, double& convertMs)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	FileData file;
+	bool read = FileSystem::Read(path, file);
+	double readMs = ElapsedMs(start);
+	if (!read)
+	{
+		out = DecodedImage();
+		out.path = path;
+		decodeMs = readMs;
+		convertMs = 0.0;
+		std::cerr << "TEXTURE COULD NOT LOAD: " << path << std::endl;
+		return false;
+	}
+
+	bool decoded = DecodeMemory(file.GetData(), file.GetSize(), path, out, options, decodeMs, convertMs);
+	decodeMs += readMs;
+	return decoded;
+}
+
+bool ImageDecoder::DecodeMemory(const std::uint8_t* data, std::size_t size, const std::string& path, DecodedImage& out,
+	const ImageDecodeOptions& options, double& decodeMs, double& convertMs)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	int width = 0, height = 0, channels = 0;
+	unsigned char* pixels = stbi_load_from_memory(data, (int)size, &width, &height, &channels, 0);
+	decodeMs = ElapsedMs(start);
+	convertMs = 0.0;
+
+	out = DecodedImage();
+	out.path = path;
+	if (!pixels)
+	{
+		std::cerr << "TEXTURE COULD NOT LOAD: " << path << std::endl;
+		return false;
+	}
+
+	start = std::chrono::high_resolution_clock::now();
+	out.width = (unsigned int)width;
+	out.height = (unsigned int)height;
+	out.channels = (unsigned int)channels;
+	out.srgb = options.srgb;
+	out.premultiplied = options.premultiplyAlpha;
+	out.pixels.resize((std::size_t)width * height * 4);
+	ConvertToRGBA8(pixels, out.channels, out.width, out.height, out.pixels.data(), options.flip, options.premultiplyAlpha);
+	stbi_image_free(pixels);
+	convertMs = ElapsedMs(start);
+	return true;
+}
+
+bool ImageDecoder::Decode(const std::vector<std::string>& paths, std::vector<DecodedImage>& out, const ImageDecodeOptions& options)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	m_Stats = ImageDecodeStats();
+	m_Stats.images = (unsigned int)paths.size();
+	m_Stats.threads = m_Jobs ? m_Jobs->GetThreadCount() : 1;
+
+	out.clear();
+	out.resize(paths.size());
+	std::vector<double> decodeMs(paths.size(), 0.0), convertMs(paths.size(), 0.0);
+	std::vector<char> decoded(paths.size(), 0);
+	//pakirane slike su vec mapirane pa idu ravno u dekodiranje, ostale se uz AsyncIO citaju skupno
+	std::vector<std::uint32_t> direct;
+	std::vector<AsyncReadRequest> reads;
+	std::vector<std::uint32_t> readImages;
+	for (std::uint32_t i = 0; i < (std::uint32_t)paths.size(); i++)
+	{
+		out[i].path = paths[i];
+		if (m_IO && !FileSystem::IsPacked(paths[i]))
+		{
+			reads.emplace_back();
+			reads.back().path = paths[i];
+			readImages.push_back(i);
+		}
+		else
+		{
+			direct.push_back(i);
+		}
+	}
+
+	JobCounter counter;
+	std::vector<std::vector<std::uint8_t>> contents(reads.size());
+	if (!reads.empty())
+	{
+		m_IO->Read(reads, [&](std::size_t read, std::vector<std::uint8_t>& data)
+		{
+			contents[read].swap(data);
+			auto decodeImage = [&, read]()
+			{
+				std::uint32_t i = readImages[read];
+				decoded[i] = DecodeMemory(contents[read].data(), contents[read].size(), paths[i], out[i], options, decodeMs[i], convertMs[i]) ? 1 : 0;
+				std::vector<std::uint8_t>().swap(contents[read]);
+			};
+			if (m_Jobs)
+				m_Jobs->Run(decodeImage, &counter);
+			else
+				decodeImage();
+		});
+	}
+
+	auto decodeImages = [&](std::uint32_t begin, std::uint32_t end)
+	{
+		for (std::uint32_t i = begin; i < end; i++)
+			decoded[direct[i]] = DecodeFile(paths[direct[i]], out[direct[i]], options, decodeMs[direct[i]], convertMs[direct[i]]) ? 1 : 0;
+	};
+	if (m_Jobs)
+		m_Jobs->ParallelFor((std::uint32_t)direct.size(), 1, decodeImages);
+	else
+		decodeImages(0, (std::uint32_t)direct.size());
+	if (m_Jobs)
+		m_Jobs->Wait(counter);
+
+	for (std::size_t i = 0; i < paths.size(); i++)
+	{
+		m_Stats.failed += decoded[i] ? 0 : 1;
+		m_Stats.pixels += (std::uint64_t)out[i].width * out[i].height;
+		m_Stats.decodeMs += decodeMs[i];
+		m_Stats.convertMs += convertMs[i];
+	}
+	m_Stats.wallMs = ElapsedMs(start);
+	return m_Stats.failed == 0;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "BatchMath.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class JobSystem;
+class AsyncIO;
+
+struct ImageDecodeOptions
+{
+	//redovi odozdo prema gore kao sto GL ocekuje
+	bool flip = true;
+	//boja je u sRGB prostoru (MipGenerator filtrira linearno), false za normale i maske
+	bool srgb = true;
+	bool premultiplyAlpha = false;
+};
+
+//uvijek RGBA8 bez razmaka izmedu redova, channels je broj kanala u izvornoj datoteci
+struct DecodedImage
+{
+	std::string path;
+	unsigned int width = 0;
+	unsigned int height = 0;
+	unsigned int channels = 0;
+	bool srgb = true;
+	bool premultiplied = false;
+	std::vector<std::uint8_t> pixels;
+
+	inline bool IsValid() const { return !pixels.empty(); }
+};
+
+struct ImageDecodeStats
+{
+	unsigned int images = 0;
+	unsigned int failed = 0;
+	unsigned int threads = 0;
+	std::uint64_t pixels = 0;
+	double wallMs = 0.0;
+	//zbroj po slikama preko svih dretvi
+	double decodeMs = 0.0;
+	double convertMs = 0.0;
+
+	inline double GetMpixPerSecond() const { return wallMs > 0.0 ? pixels / (wallMs * 1000.0) : 0.0; }
+	inline double GetMpixPerSecondPerCore() const { return threads > 0 ? GetMpixPerSecond() / threads : 0.0; }
+};
+
+//dekodiranje vise slika odjednom, svaka slika je jedan posao na JobSystemu
+//uz AsyncIO se datoteke s diska citaju skupno, a posao dekodiranja krece cim stigne cijela datoteka
+//stb_image dekodira u izvornom broju kanala bez globalnog stbi_set_flip_vertically_on_load,
+//a pretvorba u RGBA8 (prosirenje sivih i RGB slika, okretanje redova, premnozena alfa) ide SSE2 kernelima u istom prolazu
+class ImageDecoder
+{
+public:
+	ImageDecoder(JobSystem* jobs = nullptr, AsyncIO* io = nullptr);
+
+	//out ima jednu sliku po putanji, neuspjele su prazne (IsValid); false ako ijedna nije uspjela
+	bool Decode(const std::vector<std::string>& paths, std::vector<DecodedImage>& out, const ImageDecodeOptions& options = ImageDecodeOptions());
+
+	inline const ImageDecodeStats& GetStats() const { return m_Stats; }
+
+	//jedna slika na pozivajucoj dretvi
+	static bool DecodeFile(const std::string& path, DecodedImage& out, const ImageDecodeOptions& options = ImageDecodeOptions());
+	//vec procitana datoteka (PNG, JPEG...), path sluzi samo za poruke
+	static bool DecodeMemory(const std::uint8_t* data, std::size_t size, const std::string& path, DecodedImage& out,
+		const ImageDecodeOptions& options = ImageDecodeOptions());
+	//source ima channels (1-4) kanala po pikselu bez razmaka izmedu redova, target width * height * 4 bajtova
+	static void ConvertToRGBA8(const std::uint8_t* source, unsigned int channels, unsigned int width, unsigned int height,
+		std::uint8_t* target, bool flip, bool premultiplyAlpha, BatchMath::SimdLevel level = BatchMath::GetBestSimdLevel());
+
+private:
+	static bool DecodeFile(const std::string& path, DecodedImage& out, const ImageDecodeOptions& options, double& decodeMs, double& convertMs);
+	static bool DecodeMemory(const std::uint8_t* data, std::size_t size, const std::string& path, DecodedImage& out,
+		const ImageDecodeOptions& options, double& decodeMs, double& convertMs);
+
+private:
+	JobSystem* m_Jobs;
+	AsyncIO* m_IO;
+	ImageDecodeStats m_Stats;
+};
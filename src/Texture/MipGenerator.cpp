@@ -0,0 +1,205 @@
+#include "MipGenerator.h"
+
+#include "JobSystem.h"
+
+#include "glm/glm.hpp"
+
+#include <emmintrin.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+//otprilike toliko izlaznih piksela po poslu
+static const std::uint32_t PIXEL_GRAIN = 16384;
+//linearna vrijednost -> sRGB bajt; uz 16K unosa greska ostaje ispod cetvrtine koraka i u strmom dijelu krivulje blizu nule
+static const unsigned int SRGB_TABLE_SIZE = 16384;
+
+struct ColorTables
+{
+	float srgbToLinear[256];
+	float unormToLinear[256];
+	std::uint8_t linearToSrgb[SRGB_TABLE_SIZE];
+};
+
+static ColorTables BuildTables()
+{
+	ColorTables tables;
+	for (unsigned int i = 0; i < 256; i++)
+	{
+		float value = i / 255.0f;
+		tables.srgbToLinear[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+		tables.unormToLinear[i] = value;
+	}
+	for (unsigned int i = 0; i < SRGB_TABLE_SIZE; i++)
+	{
+		float linear = (float)i / (SRGB_TABLE_SIZE - 1);
+		float value = linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f;
+		tables.linearToSrgb[i] = (std::uint8_t)std::min(255.0f, value * 255.0f + 0.5f);
+	}
+	return tables;
+}
+
+static const ColorTables& GetTables()
+{
+	static const ColorTables tables = BuildTables();
+	return tables;
+}
+
+template<bool UseSse>
+static inline glm::vec4 Average(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c, const glm::vec4& d)
+{
+	if (UseSse)
+	{
+		__m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(&a.x), _mm_loadu_ps(&b.x)), _mm_add_ps(_mm_loadu_ps(&c.x), _mm_loadu_ps(&d.x)));
+		glm::vec4 result;
+		_mm_storeu_ps(&result.x, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+		return result;
+	}
+	return ((a + b) + (c + d)) * 0.25f;
+}
+
+//redovi [rowBegin, rowEnd) sljedeceg nivoa, fetch(x, y) vraca linearni piksel prethodnog nivoa
+template<bool UseSse, typename Fetch>
+static void DownsampleRows(const Fetch& fetch, unsigned int width, unsigned int height, glm::vec4* out, unsigned int outWidth,
+	std::uint32_t rowBegin, std::uint32_t rowEnd)
+{
+	for (std::uint32_t y = rowBegin; y < rowEnd; y++)
+	{
+		unsigned int y0 = std::min(2 * y, height - 1), y1 = std::min(2 * y + 1, height - 1);
+		glm::vec4* row = out + (std::size_t)y * outWidth;
+		for (unsigned int x = 0; x < outWidth; x++)
+		{
+			unsigned int x0 = std::min(2 * x, width - 1), x1 = std::min(2 * x + 1, width - 1);
+			row[x] = Average<UseSse>(fetch(x0, y0), fetch(x1, y0), fetch(x0, y1), fetch(x1, y1));
+		}
+	}
+}
+
+template<bool UseSse>
+static void EncodeRow(const glm::vec4* pixels, unsigned int count, bool srgb, std::uint8_t* out)
+{
+	const ColorTables& tables = GetTables();
+	const float colorScale = srgb ? (float)(SRGB_TABLE_SIZE - 1) : 255.0f;
+	const __m128 scale = _mm_set_ps(255.0f, colorScale, colorScale, colorScale);
+
+	for (unsigned int x = 0; x < count; x++)
+	{
+		alignas(16) std::int32_t values[4];
+		if (UseSse)
+		{
+			__m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(&pixels[x].x), _mm_setzero_ps()), _mm_set1_ps(1.0f));
+			_mm_store_si128((__m128i*)values, _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, scale), _mm_set1_ps(0.5f))));
+		}
+		else
+		{
+			glm::vec4 v = glm::clamp(pixels[x], 0.0f, 1.0f) * glm::vec4(colorScale, colorScale, colorScale, 255.0f) + 0.5f;
+			for (int c = 0; c < 4; c++)
+				values[c] = (std::int32_t)v[c];
+		}
+
+		for (int c = 0; c < 3; c++)
+			out[x * 4 + c] = srgb ? tables.linearToSrgb[values[c]] : (std::uint8_t)values[c];
+		out[x * 4 + 3] = (std::uint8_t)values[3];
+	}
+}
+
+namespace MipGenerator
+{
+	unsigned int GetLevelCount(unsigned int width, unsigned int height)
+	{
+		unsigned int count = 1;
+		while (width > 1 || height > 1)
+		{
+			width = std::max(1u, width / 2);
+			height = std::max(1u, height / 2);
+			count++;
+		}
+		return count;
+	}
+
+	template<bool UseSse>
+	static void GenerateLevels(const std::uint8_t* pixels, bool srgb, std::vector<TextureLevel>& levels, JobSystem* jobs)
+	{
+		const ColorTables& tables = GetTables();
+		const float* colorToLinear = srgb ? tables.srgbToLinear : tables.unormToLinear;
+
+		auto parallelFor = [jobs](std::uint32_t count, std::uint32_t grain, const std::function<void(std::uint32_t, std::uint32_t)>& function)
+		{
+			if (jobs)
+				jobs->ParallelFor(count, grain, function);
+			else
+				function(0, count);
+		};
+
+		//linearni float nivoi od 1 nadalje, nivo 0 se cita izravno iz bajtova
+		std::vector<std::vector<glm::vec4>> linear(levels.size());
+		for (std::size_t i = 1; i < levels.size(); i++)
+		{
+			unsigned int sourceWidth = levels[i - 1].width, sourceHeight = levels[i - 1].height;
+			unsigned int outWidth = levels[i].width, outHeight = levels[i].height;
+			linear[i].resize((std::size_t)outWidth * outHeight);
+			glm::vec4* out = linear[i].data();
+			std::uint32_t grain = std::max(1u, PIXEL_GRAIN / outWidth);
+
+			if (i == 1)
+			{
+				auto fetch = [&](unsigned int x, unsigned int y)
+				{
+					const std::uint8_t* pixel = pixels + ((std::size_t)y * sourceWidth + x) * 4;
+					return glm::vec4(colorToLinear[pixel[0]], colorToLinear[pixel[1]], colorToLinear[pixel[2]], tables.unormToLinear[pixel[3]]);
+				};
+				parallelFor(outHeight, grain, [&](std::uint32_t begin, std::uint32_t end)
+				{
+					DownsampleRows<UseSse>(fetch, sourceWidth, sourceHeight, out, outWidth, begin, end);
+				});
+			}
+			else
+			{
+				const glm::vec4* source = linear[i - 1].data();
+				auto fetch = [&](unsigned int x, unsigned int y) -> const glm::vec4& { return source[(std::size_t)y * sourceWidth + x]; };
+				parallelFor(outHeight, grain, [&](std::uint32_t begin, std::uint32_t end)
+				{
+					DownsampleRows<UseSse>(fetch, sourceWidth, sourceHeight, out, outWidth, begin, end);
+				});
+			}
+		}
+
+		//svi redovi svih nivoa u jednom ParallelFor-u, mali nivoi se tako ne izvode svaki za sebe
+		std::vector<std::uint32_t> firstRow(levels.size() + 1, 0);
+		for (std::size_t i = 1; i < levels.size(); i++)
+			firstRow[i + 1] = firstRow[i] + levels[i].height;
+
+		parallelFor(firstRow.back(), 16, [&](std::uint32_t begin, std::uint32_t end)
+		{
+			for (std::uint32_t row = begin; row < end; row++)
+			{
+				std::size_t i = std::upper_bound(firstRow.begin() + 1, firstRow.end(), row) - firstRow.begin() - 1;
+				unsigned int y = row - firstRow[i];
+				unsigned int levelWidth = levels[i].width;
+				EncodeRow<UseSse>(linear[i].data() + (std::size_t)y * levelWidth, levelWidth, srgb, levels[i].data.data() + (std::size_t)y * levelWidth * 4);
+			}
+		});
+	}
+
+	void Generate(const std::uint8_t* pixels, unsigned int width, unsigned int height, bool srgb, std::vector<TextureLevel>& levels,
+		JobSystem* jobs, BatchMath::SimdLevel level)
+	{
+		levels.resize(GetLevelCount(width, height));
+		for (TextureLevel& mip : levels)
+		{
+			mip.width = width;
+			mip.height = height;
+			mip.data.resize((std::size_t)width * height * 4);
+			width = std::max(1u, width / 2);
+			height = std::max(1u, height / 2);
+		}
+		std::memcpy(levels[0].data.data(), pixels, levels[0].data.size());
+
+		if (level == BatchMath::SimdLevel::Scalar)
+			GenerateLevels<false>(pixels, srgb, levels, jobs);
+		else
+			GenerateLevels<true>(pixels, srgb, levels, jobs);
+	}
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "BatchMath.h"
+#include "TextureCooker.h"
+
+#include <cstdint>
+#include <vector>
+
+class JobSystem;
+
+//mip lanac na CPU-u umjesto glGenerateMipmap: 2x2 box filter nad RGBA u floatu, jedan piksel je jedan SSE registar
+//uz srgb se RGB dekodira u linearni prostor prije filtriranja i kodira natrag nakon njega, alfa je uvijek linearna
+//svaki nivo se racuna paralelno po trakama redaka, a pretvorba svih nivoa natrag u RGBA8 ide u jednom prolazu preko svih nivoa
+namespace MipGenerator
+{
+	unsigned int GetLevelCount(unsigned int width, unsigned int height);
+
+	//levels[0] je kopija izvora, ostali nivoi do 1x1; kod neparnih dimenzija zadnji stupac ili redak se ponavlja
+	void Generate(const std::uint8_t* pixels, unsigned int width, unsigned int height, bool srgb, std::vector<TextureLevel>& levels,
+		JobSystem* jobs = nullptr, BatchMath::SimdLevel level = BatchMath::GetBestSimdLevel());
+}
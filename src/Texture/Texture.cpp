@@ -1,58 +1,169 @@
 #include "glad/glad.h"
 
 #include "Texture.h"
+#include "ImageDecoder.h"
+#include "MipGenerator.h"
+#include "TextureStreamer.h"
+#include "TextureResidency.h"
+#include "FileSystem.h"
 
-Texture::Texture() 
-	: m_RenderID(0), m_FilePath(""), m_Width(0), m_Height(0), m_BPP(0), m_LocalBuffer(nullptr)
+#include <algorithm>
+#include <iostream>
+
+//S3TC je ekstenzija pa ga glad ne mora imati, BPTC je u jezgri od 4.2
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+Texture::Texture(const std::string& texturePath, JobSystem* jobs)
+	: m_RenderID(0), m_FilePath(texturePath), m_Width(0), m_Height(0), m_BPP(0),
+	m_Format(TextureFormat::RGBA8), m_MemorySize(0), m_Streamer(nullptr), m_Residency(nullptr), m_ResidencyKey(0)
 {
+	CookedTexture cooked;
+	if (!LoadLevels(jobs, cooked))
+		return;
+
 	glGenTextures(1, &m_RenderID);
 	glBindTexture(GL_TEXTURE_2D, m_RenderID);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 800, 600, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)cooked.levels.size() - 1);
+
+	GLenum internalFormat = GetInternalFormat(cooked.format);
+	for (std::size_t i = 0; i < cooked.levels.size(); i++)
+	{
+		const TextureLevel& level = cooked.levels[i];
+		if (cooked.format == TextureFormat::RGBA8)
+			glTexImage2D(GL_TEXTURE_2D, (GLint)i, internalFormat, level.width, level.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, level.data.data());
+		else
+			glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)i, internalFormat, level.width, level.height, 0, (GLsizei)level.data.size(), level.data.data());
+	}
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_RenderID, 0);
 }
 
-Texture::Texture(const std::string& texturePath)
-	: m_RenderID(0), m_FilePath(texturePath), m_Width(0), m_Height(0), m_BPP(0), m_LocalBuffer(nullptr)
+Texture::Texture(const std::string& texturePath, TextureStreamer& streamer, JobSystem* jobs)
+	: m_RenderID(0), m_FilePath(texturePath), m_Width(0), m_Height(0), m_BPP(0),
+	m_Format(TextureFormat::RGBA8), m_MemorySize(0), m_Streamer(&streamer), m_Residency(nullptr), m_ResidencyKey(0)
 {
-	stbi_set_flip_vertically_on_load(true);
-	m_LocalBuffer = stbi_load(m_FilePath.c_str(), &m_Width, &m_Height, &m_BPP, 0);
+	CookedTexture cooked;
+	if (!LoadLevels(jobs, cooked))
+		return;
 
 	glGenTextures(1, &m_RenderID);
-	glBindTexture(GL_TEXTURE_2D, m_RenderID);
+	streamer.Enqueue(m_RenderID, std::move(cooked));
+}
 
-	GLenum format;
-	if (m_BPP == 1)
-		format = GL_RED;
-	else if (m_BPP == 3)
-		format = GL_RGB;
-	else if (m_BPP == 4)
-		format = GL_RGBA;
+Texture::Texture(const std::string& texturePath, TextureResidency& residency, JobSystem* jobs)
+	: m_RenderID(0), m_FilePath(texturePath), m_Width(0), m_Height(0), m_BPP(0),
+	m_Format(TextureFormat::RGBA8), m_MemorySize(0), m_Streamer(nullptr), m_Residency(&residency), m_ResidencyKey(0)
+{
+	CookedTexture cooked;
+	if (!LoadLevels(jobs, cooked))
+		return;
 
-	glTexImage2D(GL_TEXTURE_2D, 0, format, m_Width, m_Height, 0, format, GL_UNSIGNED_BYTE, m_LocalBuffer);
-	glGenerateMipmap(GL_TEXTURE_2D);
+	m_ResidencyKey = residency.Register(std::move(cooked));
+}
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+bool Texture::LoadLevels(JobSystem* jobs, CookedTexture& cooked)
+{
+	const std::string cookedExtension = ".ctex";
+	bool isCooked = m_FilePath.size() > cookedExtension.size() &&
+		m_FilePath.compare(m_FilePath.size() - cookedExtension.size(), cookedExtension.size(), cookedExtension) == 0;
+
+	bool loaded = false;
+	if (isCooked)
+		loaded = TextureCooker::Load(m_FilePath, cooked);
+	else if (TextureCooker::IsCookedUpToDate(m_FilePath))
+		loaded = TextureCooker::Load(TextureCooker::GetCookedPath(m_FilePath), cooked);
 
-	if (m_LocalBuffer)
+	if (!loaded && !isCooked)
 	{
-		stbi_image_free(m_LocalBuffer);
+		DecodedImage image;
+		if (!ImageDecoder::DecodeFile(m_FilePath, image))
+			return false;
+
+		//mipovi na CPU-u umjesto glGenerateMipmap, rezultat ide u cache pa sljedece ucitavanje ne dekodira sliku
+		cooked.format = TextureFormat::RGBA8;
+		cooked.width = image.width;
+		cooked.height = image.height;
+		MipGenerator::Generate(image.pixels.data(), cooked.width, cooked.height, image.srgb, cooked.levels, jobs);
+
+		//slika iz packa nema direktorij na disku u koji bi cache isao
+		if (!FileSystem::IsPacked(m_FilePath))
+			TextureCooker::Save(TextureCooker::GetCookedPath(m_FilePath), cooked);
+		loaded = true;
+	}
+	if (!loaded)
+		return false;
+
+	//bez podrske za format blokovi se dekodiraju na CPU-u i salju kao RGBA8
+	if (!IsFormatSupported(cooked.format))
+	{
+		std::cerr << "COMPRESSED FORMAT " << TextureCooker::GetFormatName(cooked.format) << " NOT SUPPORTED, DECODING: " << m_FilePath << std::endl;
+		std::vector<std::uint8_t> decoded;
+		for (TextureLevel& level : cooked.levels)
+		{
+			TextureCooker::DecodeLevel(level, cooked.format, decoded);
+			level.data.swap(decoded);
+		}
+		cooked.format = TextureFormat::RGBA8;
 	}
+
+	m_Width = (int)cooked.width;
+	m_Height = (int)cooked.height;
+	m_BPP = 4;
+	m_Format = cooked.format;
+	m_MemorySize = cooked.GetSize();
+	return true;
+}
+
+unsigned int Texture::GetInternalFormat(TextureFormat format)
+{
+	switch (format)
+	{
+	case TextureFormat::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	case TextureFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	case TextureFormat::BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+	default: return GL_RGBA8;
+	}
+}
+
+bool Texture::IsFormatSupported(TextureFormat format)
+{
+	if (format == TextureFormat::RGBA8)
+		return true;
+
+	GLint count = 0;
+	glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count);
+	std::vector<GLint> formats(count);
+	if (count > 0)
+		glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, formats.data());
+	return std::find(formats.begin(), formats.end(), (GLint)GetInternalFormat(format)) != formats.end();
 }
 
 Texture::~Texture()
 {
+	if (m_Streamer)
+		m_Streamer->Cancel(m_RenderID);
+	if (m_Residency)
+		m_Residency->Unregister(m_ResidencyKey);
 	glDeleteTextures(1, &m_RenderID);
 }
 
 void Texture::Bind(unsigned int slot) const
 {
 	glActiveTexture(GL_TEXTURE0 + slot);
-	glBindTexture(GL_TEXTURE_2D, m_RenderID);
+	glBindTexture(GL_TEXTURE_2D, GetID());
+}
+
+unsigned int Texture::GetID() const
+{
+	return m_Residency ? m_Residency->GetTexture(m_ResidencyKey) : m_RenderID;
 }
 
 void Texture::UnBind() const
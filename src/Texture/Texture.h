@@ -1,21 +1,49 @@
 #pragma once
 
-#include "stb_image/stb_image.h"
+#include "TextureCooker.h"
 
 #include <string>
 #include <vector>
 
+class JobSystem;
+class TextureStreamer;
+class TextureResidency;
+
+//.ctex putanja ili kuhana verzija uz izvor (TextureCooker::GetCookedPath) ide izravno u glCompressedTexImage2D sa svim mip nivoima,
+//inace se slika dekodira (ImageDecoder), mipovi se racunaju na CPU-u (MipGenerator) i RGBA8 rezultat sprema kao .ctex cache
+//uz TextureStreamer se odmah alocira samo storage, a nivoi stizu kroz PBO-ove tijekom sljedecih frameova
+//uz TextureResidency stize samo grubi rep, a finije nivoe dosipava i izbacuje TextureResidency prema budzetu; ona i drzi GL objekt
 class Texture
 {
 public:
-	Texture();
-	Texture(const std::string& texturePath);
+	Texture() = delete;
+	Texture(const std::string& texturePath, JobSystem* jobs = nullptr);
+	Texture(const std::string& texturePath, TextureStreamer& streamer, JobSystem* jobs = nullptr);
+	Texture(const std::string& texturePath, TextureResidency& residency, JobSystem* jobs = nullptr);
 	
 	~Texture();
 
 	void Bind(unsigned int slot=0) const;
 	void UnBind() const;
 
+	//uz TextureResidency objekt se mijenja kad se nivoi dosipaju ili izbace pa ga treba uzeti pri svakom bindu
+	unsigned int GetID() const;
+	//kljuc za TextureResidency::Request, 0 bez rezidencije
+	inline unsigned int GetResidencyKey() const { return m_ResidencyKey; }
+	inline int GetWidth() const { return m_Width; }
+	inline int GetHeight() const { return m_Height; }
+	inline TextureFormat GetFormat() const { return m_Format; }
+	//procjena zauzeca VRAM-a sa svim mip nivoima
+	inline std::size_t GetMemorySize() const { return m_MemorySize; }
+
+	//GL interni format, GL_RGBA8 ili kompresirani
+	static unsigned int GetInternalFormat(TextureFormat format);
+	static bool IsFormatSupported(TextureFormat format);
+
+private:
+	//svi nivoi iz .ctex datoteke ili cachea, inace dekodiranje i MipGenerator; nepodrzani BC format se dekodira u RGBA8
+	bool LoadLevels(JobSystem* jobs, CookedTexture& cooked);
+
 private:
 	unsigned int m_RenderID;
 	std::string m_FilePath;
@@ -23,5 +51,10 @@ private:
 	int m_Width;
 	int m_Height;
 	int m_BPP;
-	unsigned char* m_LocalBuffer;
+
+	TextureFormat m_Format;
+	std::size_t m_MemorySize;
+	TextureStreamer* m_Streamer;
+	TextureResidency* m_Residency;
+	unsigned int m_ResidencyKey;
 };
\ No newline at end of file
@@ -0,0 +1,815 @@
+#include "TextureCooker.h"
+
+#include "JobSystem.h"
+#include "ImageDecoder.h"
+#include "MipGenerator.h"
+#include "FileSystem.h"
+
+#include "glm/glm.hpp"
+
+#include <emmintrin.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+//blokova 4x4 u jednom poslu
+static const std::uint32_t BLOCK_GRAIN = 64;
+
+static const std::uint32_t CTEX_MAGIC = 0x58455443; //"CTEX"
+static const std::uint32_t CTEX_VERSION = 1;
+
+//tezine interpolacije BC7 za 4-bitne indekse, u 64-inama
+static const int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+static double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	return elapsed.count();
+}
+
+//blok 4x4 po kanalima, redom piksela kao u BC formatima (redak po redak)
+struct BlockPixels
+{
+	alignas(16) float r[16];
+	alignas(16) float g[16];
+	alignas(16) float b[16];
+	alignas(16) float a[16];
+
+	inline glm::vec4 Get(unsigned int i) const { return glm::vec4(r[i], g[i], b[i], a[i]); }
+};
+
+//pikseli izvan slike ponavljaju rubni stupac ili redak
+static void LoadBlock(const std::uint8_t* pixels, unsigned int width, unsigned int height, unsigned int blockX, unsigned int blockY, BlockPixels& block)
+{
+	for (unsigned int y = 0; y < 4; y++)
+	{
+		unsigned int sourceY = std::min(blockY * 4 + y, height - 1);
+		for (unsigned int x = 0; x < 4; x++)
+		{
+			unsigned int sourceX = std::min(blockX * 4 + x, width - 1);
+			const std::uint8_t* pixel = pixels + ((std::size_t)sourceY * width + sourceX) * 4;
+			unsigned int i = y * 4 + x;
+			block.r[i] = pixel[0];
+			block.g[i] = pixel[1];
+			block.b[i] = pixel[2];
+			block.a[i] = pixel[3];
+		}
+	}
+}
+
+//za svaki piksel najblizi unos palete, 4 piksela odjednom; vraca ukupnu kvadratnu gresku
+static float SelectIndices(const BlockPixels& block, const glm::vec4* palette, unsigned int paletteSize, bool useAlpha, std::uint8_t* indices)
+{
+	__m128 total = _mm_setzero_ps();
+	for (unsigned int p = 0; p < 16; p += 4)
+	{
+		__m128 r = _mm_load_ps(block.r + p), g = _mm_load_ps(block.g + p);
+		__m128 b = _mm_load_ps(block.b + p), a = _mm_load_ps(block.a + p);
+		__m128 best = _mm_set1_ps(FLT_MAX);
+		__m128i bestIndex = _mm_setzero_si128();
+
+		for (unsigned int i = 0; i < paletteSize; i++)
+		{
+			__m128 dr = _mm_sub_ps(r, _mm_set1_ps(palette[i].r));
+			__m128 dg = _mm_sub_ps(g, _mm_set1_ps(palette[i].g));
+			__m128 db = _mm_sub_ps(b, _mm_set1_ps(palette[i].b));
+			__m128 error = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+			if (useAlpha)
+			{
+				__m128 da = _mm_sub_ps(a, _mm_set1_ps(palette[i].a));
+				error = _mm_add_ps(error, _mm_mul_ps(da, da));
+			}
+
+			__m128i closer = _mm_castps_si128(_mm_cmplt_ps(error, best));
+			best = _mm_min_ps(error, best);
+			bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32((int)i)), _mm_andnot_si128(closer, bestIndex));
+		}
+
+		alignas(16) std::int32_t lanes[4];
+		_mm_store_si128((__m128i*)lanes, bestIndex);
+		for (unsigned int lane = 0; lane < 4; lane++)
+			indices[p + lane] = (std::uint8_t)lanes[lane];
+		total = _mm_add_ps(total, best);
+	}
+
+	alignas(16) float sums[4];
+	_mm_store_ps(sums, total);
+	return sums[0] + sums[1] + sums[2] + sums[3];
+}
+
+//isto za jedan kanal (BC4 alfa)
+static float SelectAlphaIndices(const BlockPixels& block, const float* palette, unsigned int paletteSize, std::uint8_t* indices)
+{
+	__m128 total = _mm_setzero_ps();
+	for (unsigned int p = 0; p < 16; p += 4)
+	{
+		__m128 a = _mm_load_ps(block.a + p);
+		__m128 best = _mm_set1_ps(FLT_MAX);
+		__m128i bestIndex = _mm_setzero_si128();
+		for (unsigned int i = 0; i < paletteSize; i++)
+		{
+			__m128 da = _mm_sub_ps(a, _mm_set1_ps(palette[i]));
+			__m128 error = _mm_mul_ps(da, da);
+			__m128i closer = _mm_castps_si128(_mm_cmplt_ps(error, best));
+			best = _mm_min_ps(error, best);
+			bestIndex = _mm_or_si128(_mm_and_si128(closer, _mm_set1_epi32((int)i)), _mm_andnot_si128(closer, bestIndex));
+		}
+
+		alignas(16) std::int32_t lanes[4];
+		_mm_store_si128((__m128i*)lanes, bestIndex);
+		for (unsigned int lane = 0; lane < 4; lane++)
+			indices[p + lane] = (std::uint8_t)lanes[lane];
+		total = _mm_add_ps(total, best);
+	}
+
+	alignas(16) float sums[4];
+	_mm_store_ps(sums, total);
+	return sums[0] + sums[1] + sums[2] + sums[3];
+}
+
+//krajnje tocke na glavnoj osi boja bloka: kovarijanca, nekoliko koraka iteracije potencija pa projekcija piksela
+static void FindEndpoints(const BlockPixels& block, bool useAlpha, glm::vec4& low, glm::vec4& high)
+{
+	glm::vec4 mask = useAlpha ? glm::vec4(1.0f) : glm::vec4(1.0f, 1.0f, 1.0f, 0.0f);
+	glm::vec4 mean(0.0f), minimum(FLT_MAX), maximum(-FLT_MAX);
+	for (unsigned int i = 0; i < 16; i++)
+	{
+		glm::vec4 pixel = block.Get(i) * mask;
+		mean += pixel;
+		minimum = glm::min(minimum, pixel);
+		maximum = glm::max(maximum, pixel);
+	}
+	mean /= 16.0f;
+
+	glm::mat4 covariance(0.0f);
+	for (unsigned int i = 0; i < 16; i++)
+	{
+		glm::vec4 d = block.Get(i) * mask - mean;
+		covariance += glm::outerProduct(d, d);
+	}
+
+	glm::vec4 axis = maximum - minimum;
+	for (unsigned int iteration = 0; iteration < 4; iteration++)
+	{
+		axis = covariance * axis;
+		float largest = std::max(std::max(std::abs(axis.x), std::abs(axis.y)), std::max(std::abs(axis.z), std::abs(axis.w)));
+		if (largest < 1e-6f)
+			break;
+		axis /= largest;
+	}
+
+	float length2 = glm::dot(axis, axis);
+	if (length2 < 1e-6f)
+	{
+		low = high = mean;
+	}
+	else
+	{
+		float minT = FLT_MAX, maxT = -FLT_MAX;
+		for (unsigned int i = 0; i < 16; i++)
+		{
+			float t = glm::dot(block.Get(i) * mask - mean, axis);
+			minT = std::min(minT, t);
+			maxT = std::max(maxT, t);
+		}
+		low = mean + axis * (minT / length2);
+		high = mean + axis * (maxT / length2);
+	}
+
+	if (!useAlpha)
+		low.a = high.a = 255.0f;
+	low = glm::clamp(low, 0.0f, 255.0f);
+	high = glm::clamp(high, 0.0f, 255.0f);
+}
+
+//krajnje tocke koje uz zadane indekse minimiziraju kvadratnu gresku; weights[i] je udio druge tocke u unosu i
+static bool RefineEndpoints(const BlockPixels& block, const std::uint8_t* indices, const float* weights, glm::vec4& first, glm::vec4& second)
+{
+	float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+	glm::vec4 x(0.0f), y(0.0f);
+	for (unsigned int i = 0; i < 16; i++)
+	{
+		float w = weights[indices[i]];
+		float v = 1.0f - w;
+		glm::vec4 pixel = block.Get(i);
+		aa += v * v;
+		ab += v * w;
+		bb += w * w;
+		x += pixel * v;
+		y += pixel * w;
+	}
+
+	float determinant = aa * bb - ab * ab;
+	if (std::abs(determinant) < 1e-6f)
+		return false;
+
+	first = glm::clamp((x * bb - y * ab) / determinant, 0.0f, 255.0f);
+	second = glm::clamp((y * aa - x * ab) / determinant, 0.0f, 255.0f);
+	return true;
+}
+
+static inline std::uint16_t Pack565(const glm::vec4& color)
+{
+	int r = (int)(color.r * (31.0f / 255.0f) + 0.5f);
+	int g = (int)(color.g * (63.0f / 255.0f) + 0.5f);
+	int b = (int)(color.b * (31.0f / 255.0f) + 0.5f);
+	return (std::uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static inline glm::ivec3 Unpack565(std::uint16_t color)
+{
+	int r = (color >> 11) & 31, g = (color >> 5) & 63, b = color & 31;
+	return glm::ivec3((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2));
+}
+
+//BC1 boja u 4-bojnom nacinu (c0 > c1), pa vrijedi i kao bojni dio BC3
+static void EncodeColorBlock(const BlockPixels& block, std::uint8_t* out)
+{
+	static const float weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+	glm::vec4 low, high;
+	FindEndpoints(block, false, low, high);
+
+	std::uint16_t bestColors[2] = { 0, 0 };
+	std::uint8_t bestIndices[16] = {};
+	float bestError = FLT_MAX;
+
+	for (unsigned int iteration = 0; iteration < 2; iteration++)
+	{
+		std::uint16_t c0 = Pack565(high), c1 = Pack565(low);
+		if (c0 < c1)
+			std::swap(c0, c1);
+
+		std::uint8_t indices[16];
+		float error;
+		if (c0 == c1)
+		{
+			//jedna boja: c0 <= c1 je 3-bojni nacin, indeks 0 je i tada c0
+			glm::vec4 color(glm::vec3(Unpack565(c0)), 255.0f);
+			std::memset(indices, 0, sizeof(indices));
+			error = SelectIndices(block, &color, 1, false, indices);
+		}
+		else
+		{
+			glm::vec4 e0(glm::vec3(Unpack565(c0)), 255.0f), e1(glm::vec3(Unpack565(c1)), 255.0f);
+			glm::vec4 palette[4] = { e0, e1, (e0 * 2.0f + e1) / 3.0f, (e0 + e1 * 2.0f) / 3.0f };
+			error = SelectIndices(block, palette, 4, false, indices);
+		}
+
+		if (error < bestError)
+		{
+			bestError = error;
+			bestColors[0] = c0;
+			bestColors[1] = c1;
+			std::memcpy(bestIndices, indices, sizeof(indices));
+		}
+
+		if (c0 == c1 || !RefineEndpoints(block, indices, weights, high, low))
+			break;
+	}
+
+	std::uint32_t bits = 0;
+	for (unsigned int i = 0; i < 16; i++)
+		bits |= (std::uint32_t)bestIndices[i] << (2 * i);
+
+	out[0] = bestColors[0] & 0xFF;
+	out[1] = bestColors[0] >> 8;
+	out[2] = bestColors[1] & 0xFF;
+	out[3] = bestColors[1] >> 8;
+	std::memcpy(out + 4, &bits, 4);
+}
+
+//BC4 alfa u 8-vrijednosnom nacinu (a0 > a1) izmedu najvece i najmanje alfe bloka
+static void EncodeAlphaBlock(const BlockPixels& block, std::uint8_t* out)
+{
+	float minimum = 255.0f, maximum = 0.0f;
+	for (unsigned int i = 0; i < 16; i++)
+	{
+		minimum = std::min(minimum, block.a[i]);
+		maximum = std::max(maximum, block.a[i]);
+	}
+
+	int a0 = (int)maximum, a1 = (int)minimum;
+	std::uint8_t indices[16] = {};
+	if (a0 > a1)
+	{
+		float palette[8] = { (float)a0, (float)a1 };
+		for (int i = 2; i < 8; i++)
+			palette[i] = (float)(((8 - i) * a0 + (i - 1) * a1 + 3) / 7);
+		SelectAlphaIndices(block, palette, 8, indices);
+	}
+
+	std::uint64_t bits = 0;
+	for (unsigned int i = 0; i < 16; i++)
+		bits |= (std::uint64_t)indices[i] << (3 * i);
+
+	out[0] = (std::uint8_t)a0;
+	out[1] = (std::uint8_t)a1;
+	for (unsigned int i = 0; i < 6; i++)
+		out[2 + i] = (std::uint8_t)(bits >> (8 * i));
+}
+
+//7-bitna vrijednost i p bit po krajnjoj tocki, p bit se bira prema manjoj gresci sva cetiri kanala
+static glm::ivec4 QuantizeBC7(const glm::vec4& endpoint, int& pBit)
+{
+	glm::ivec4 best(0);
+	float bestError = FLT_MAX;
+	for (int p = 0; p < 2; p++)
+	{
+		glm::ivec4 quantized = glm::clamp(glm::ivec4((endpoint - (float)p) * 0.5f + 0.5f), 0, 127);
+		glm::vec4 d = glm::vec4(quantized * 2 + p) - endpoint;
+		float error = glm::dot(d, d);
+		if (error < bestError)
+		{
+			bestError = error;
+			best = quantized;
+			pBit = p;
+		}
+	}
+	return best;
+}
+
+static void BuildBC7Palette(const glm::ivec4& q0, int p0, const glm::ivec4& q1, int p1, glm::vec4* palette)
+{
+	glm::ivec4 e0 = q0 * 2 + p0, e1 = q1 * 2 + p1;
+	for (unsigned int i = 0; i < 16; i++)
+		palette[i] = glm::vec4((e0 * (64 - BC7_WEIGHTS[i]) + e1 * BC7_WEIGHTS[i] + 32) >> 6);
+}
+
+struct BitWriter
+{
+	std::uint8_t* out;
+	unsigned int position;
+
+	void Write(std::uint32_t value, unsigned int bits)
+	{
+		for (unsigned int i = 0; i < bits; i++, position++)
+			out[position >> 3] |= ((value >> i) & 1) << (position & 7);
+	}
+};
+
+struct BitReader
+{
+	const std::uint8_t* in;
+	unsigned int position;
+
+	std::uint32_t Read(unsigned int bits)
+	{
+		std::uint32_t value = 0;
+		for (unsigned int i = 0; i < bits; i++, position++)
+			value |= (std::uint32_t)((in[position >> 3] >> (position & 7)) & 1) << i;
+		return value;
+	}
+};
+
+//BC7 mod 6: jedan skup, RGBA krajnje tocke 7 + p bit, 4-bitni indeksi; najvisi bit indeksa prvog piksela mora biti 0
+static void EncodeBC7Block(const BlockPixels& block, std::uint8_t* out)
+{
+	float weights[16];
+	for (unsigned int i = 0; i < 16; i++)
+		weights[i] = BC7_WEIGHTS[i] / 64.0f;
+
+	glm::vec4 low, high;
+	FindEndpoints(block, true, low, high);
+
+	glm::ivec4 bestQ[2] = { glm::ivec4(0), glm::ivec4(0) };
+	int bestP[2] = { 0, 0 };
+	std::uint8_t bestIndices[16] = {};
+	float bestError = FLT_MAX;
+
+	for (unsigned int iteration = 0; iteration < 2; iteration++)
+	{
+		int p0 = 0, p1 = 0;
+		glm::ivec4 q0 = QuantizeBC7(low, p0), q1 = QuantizeBC7(high, p1);
+		glm::vec4 palette[16];
+		BuildBC7Palette(q0, p0, q1, p1, palette);
+
+		std::uint8_t indices[16];
+		float error = SelectIndices(block, palette, 16, true, indices);
+		if (error < bestError)
+		{
+			bestError = error;
+			bestQ[0] = q0;
+			bestQ[1] = q1;
+			bestP[0] = p0;
+			bestP[1] = p1;
+			std::memcpy(bestIndices, indices, sizeof(indices));
+		}
+
+		if (error == 0.0f || !RefineEndpoints(block, indices, weights, low, high))
+			break;
+	}
+
+	if (bestIndices[0] & 8)
+	{
+		std::swap(bestQ[0], bestQ[1]);
+		std::swap(bestP[0], bestP[1]);
+		for (unsigned int i = 0; i < 16; i++)
+			bestIndices[i] = 15 - bestIndices[i];
+	}
+
+	std::memset(out, 0, 16);
+	BitWriter writer = { out, 0 };
+	writer.Write(1 << 6, 7);
+	for (int channel = 0; channel < 4; channel++)
+	{
+		writer.Write(bestQ[0][channel], 7);
+		writer.Write(bestQ[1][channel], 7);
+	}
+	writer.Write(bestP[0], 1);
+	writer.Write(bestP[1], 1);
+	writer.Write(bestIndices[0], 3);
+	for (unsigned int i = 1; i < 16; i++)
+		writer.Write(bestIndices[i], 4);
+}
+
+static void DecodeColorBlock(const std::uint8_t* in, bool alwaysFourColor, std::uint8_t* pixels)
+{
+	std::uint16_t c0 = (std::uint16_t)(in[0] | (in[1] << 8)), c1 = (std::uint16_t)(in[2] | (in[3] << 8));
+	std::uint32_t bits;
+	std::memcpy(&bits, in + 4, 4);
+
+	glm::ivec3 e0 = Unpack565(c0), e1 = Unpack565(c1);
+	glm::ivec4 palette[4] = { glm::ivec4(e0, 255), glm::ivec4(e1, 255) };
+	if (c0 > c1 || alwaysFourColor)
+	{
+		palette[2] = glm::ivec4((e0 * 2 + e1 + 1) / 3, 255);
+		palette[3] = glm::ivec4((e0 + e1 * 2 + 1) / 3, 255);
+	}
+	else
+	{
+		palette[2] = glm::ivec4((e0 + e1) / 2, 255);
+		palette[3] = glm::ivec4(0, 0, 0, 0);
+	}
+
+	for (unsigned int i = 0; i < 16; i++)
+	{
+		const glm::ivec4& color = palette[(bits >> (2 * i)) & 3];
+		for (int c = 0; c < 4; c++)
+			pixels[i * 4 + c] = (std::uint8_t)color[c];
+	}
+}
+
+static void DecodeAlphaBlock(const std::uint8_t* in, std::uint8_t* pixels)
+{
+	int a0 = in[0], a1 = in[1];
+	int palette[8] = { a0, a1 };
+	if (a0 > a1)
+	{
+		for (int i = 2; i < 8; i++)
+			palette[i] = ((8 - i) * a0 + (i - 1) * a1 + 3) / 7;
+	}
+	else
+	{
+		for (int i = 2; i < 6; i++)
+			palette[i] = ((6 - i) * a0 + (i - 1) * a1 + 2) / 5;
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+
+	std::uint64_t bits = 0;
+	for (unsigned int i = 0; i < 6; i++)
+		bits |= (std::uint64_t)in[2 + i] << (8 * i);
+	for (unsigned int i = 0; i < 16; i++)
+		pixels[i * 4 + 3] = (std::uint8_t)palette[(bits >> (3 * i)) & 7];
+}
+
+//dekodira samo mod 6 koji TextureCooker zapisuje, ostali modovi daju magentu
+static void DecodeBC7Block(const std::uint8_t* in, std::uint8_t* pixels)
+{
+	BitReader reader = { in, 0 };
+	if (reader.Read(7) != (1 << 6))
+	{
+		for (unsigned int i = 0; i < 16; i++)
+		{
+			pixels[i * 4] = 255;
+			pixels[i * 4 + 1] = 0;
+			pixels[i * 4 + 2] = 255;
+			pixels[i * 4 + 3] = 255;
+		}
+		return;
+	}
+
+	glm::ivec4 q0, q1;
+	for (int channel = 0; channel < 4; channel++)
+	{
+		q0[channel] = (int)reader.Read(7);
+		q1[channel] = (int)reader.Read(7);
+	}
+	int p0 = (int)reader.Read(1), p1 = (int)reader.Read(1);
+
+	glm::vec4 palette[16];
+	BuildBC7Palette(q0, p0, q1, p1, palette);
+	for (unsigned int i = 0; i < 16; i++)
+	{
+		const glm::vec4& color = palette[reader.Read(i == 0 ? 3 : 4)];
+		for (int c = 0; c < 4; c++)
+			pixels[i * 4 + c] = (std::uint8_t)color[c];
+	}
+}
+
+static unsigned int GetBlockBytes(TextureFormat format)
+{
+	return format == TextureFormat::BC1 ? 8 : 16;
+}
+
+std::size_t CookedTexture::GetSize() const
+{
+	std::size_t size = 0;
+	for (const TextureLevel& level : levels)
+		size += level.data.size();
+	return size;
+}
+
+TextureCooker::TextureCooker(JobSystem* jobs)
+	: m_Jobs(jobs)
+{
+}
+
+bool TextureCooker::Cook(const std::uint8_t* pixels, unsigned int width, unsigned int height, TextureFormat format, CookedTexture& out, bool srgb)
+{
+	m_Stats = TextureCookStats();
+	m_Stats.width = width;
+	m_Stats.height = height;
+	m_Stats.threads = m_Jobs ? m_Jobs->GetThreadCount() : 1;
+	if (!pixels || width == 0 || height == 0)
+		return false;
+
+	out.format = format;
+	out.width = width;
+	out.height = height;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	std::vector<TextureLevel> mips;
+	MipGenerator::Generate(pixels, width, height, srgb, mips, m_Jobs);
+	m_Stats.mipMs = ElapsedMs(start);
+
+	out.levels.resize(mips.size());
+	start = std::chrono::high_resolution_clock::now();
+	for (std::size_t i = 0; i < mips.size(); i++)
+	{
+		const TextureLevel& mip = mips[i];
+		EncodeLevel(mip.data.data(), mip.width, mip.height, format, out.levels[i]);
+
+		m_Stats.pixels += (std::uint64_t)mip.width * mip.height;
+		m_Stats.uncompressedBytes += mip.data.size();
+		m_Stats.compressedBytes += out.levels[i].data.size();
+	}
+	m_Stats.encodeMs = ElapsedMs(start);
+	m_Stats.levels = (unsigned int)out.levels.size();
+
+	std::vector<std::uint8_t> decoded;
+	DecodeLevel(out.levels[0], format, decoded);
+	m_Stats.psnr = ComputePSNR(pixels, decoded.data(), (std::size_t)width * height, format == TextureFormat::BC1 ? 3 : 4);
+	return true;
+}
+
+bool TextureCooker::CookFile(const std::string& sourcePath, const std::string& cookedPath, TextureFormat format, bool srgb)
+{
+	ImageDecodeOptions options;
+	options.srgb = srgb;
+	DecodedImage image;
+	if (!ImageDecoder::DecodeFile(sourcePath, image, options))
+		return false;
+
+	CookedTexture cooked;
+	return Cook(image.pixels.data(), image.width, image.height, format, cooked, srgb) && Save(cookedPath, cooked);
+}
+
+void TextureCooker::EncodeLevel(const std::uint8_t* pixels, unsigned int width, unsigned int height, TextureFormat format, TextureLevel& out)
+{
+	out.width = width;
+	out.height = height;
+	out.data.resize(GetLevelSize(format, width, height));
+
+	if (format == TextureFormat::RGBA8)
+	{
+		std::memcpy(out.data.data(), pixels, out.data.size());
+		return;
+	}
+
+	unsigned int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+	unsigned int blockBytes = GetBlockBytes(format);
+	auto encodeRange = [&](std::uint32_t begin, std::uint32_t end)
+	{
+		BlockPixels block;
+		for (std::uint32_t i = begin; i < end; i++)
+		{
+			LoadBlock(pixels, width, height, i % blocksX, i / blocksX, block);
+			std::uint8_t* destination = out.data.data() + (std::size_t)i * blockBytes;
+			if (format == TextureFormat::BC1)
+			{
+				EncodeColorBlock(block, destination);
+			}
+			else if (format == TextureFormat::BC3)
+			{
+				EncodeAlphaBlock(block, destination);
+				EncodeColorBlock(block, destination + 8);
+			}
+			else
+			{
+				EncodeBC7Block(block, destination);
+			}
+		}
+	};
+
+	if (m_Jobs)
+		m_Jobs->ParallelFor(blocksX * blocksY, BLOCK_GRAIN, encodeRange);
+	else
+		encodeRange(0, blocksX * blocksY);
+}
+
+bool TextureCooker::Save(const std::string& path, const CookedTexture& texture)
+{
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+	{
+		std::cerr << "FILE COULD NOT OPEN: " << path << std::endl;
+		return false;
+	}
+
+	std::uint32_t header[6] = { CTEX_MAGIC, CTEX_VERSION, (std::uint32_t)texture.format, texture.width, texture.height, (std::uint32_t)texture.levels.size() };
+	file.write((const char*)header, sizeof(header));
+	for (const TextureLevel& level : texture.levels)
+	{
+		std::uint32_t levelHeader[3] = { level.width, level.height, (std::uint32_t)level.data.size() };
+		file.write((const char*)levelHeader, sizeof(levelHeader));
+		file.write((const char*)level.data.data(), level.data.size());
+	}
+	return (bool)file;
+}
+
+bool TextureCooker::Load(const std::string& path, CookedTexture& texture)
+{
+	FileData file;
+	if (!FileSystem::Read(path, file))
+		return false;
+
+	//iz packa se cita ravno iz mapirane memorije
+	const std::uint8_t* cursor = file.GetData();
+	const std::uint8_t* end = cursor + file.GetSize();
+	auto read = [&](void* target, std::size_t size)
+	{
+		if ((std::size_t)(end - cursor) < size)
+			return false;
+		std::memcpy(target, cursor, size);
+		cursor += size;
+		return true;
+	};
+
+	std::uint32_t header[6] = {};
+	if (!read(header, sizeof(header)) || header[0] != CTEX_MAGIC || header[1] != CTEX_VERSION || header[2] > (std::uint32_t)TextureFormat::BC7)
+	{
+		std::cerr << "NOT A COOKED TEXTURE: " << path << std::endl;
+		return false;
+	}
+
+	texture.format = (TextureFormat)header[2];
+	texture.width = header[3];
+	texture.height = header[4];
+	texture.levels.resize(header[5]);
+	for (TextureLevel& level : texture.levels)
+	{
+		std::uint32_t levelHeader[3] = {};
+		bool valid = read(levelHeader, sizeof(levelHeader));
+		level.width = levelHeader[0];
+		level.height = levelHeader[1];
+		if (!valid || levelHeader[2] != GetLevelSize(texture.format, level.width, level.height))
+		{
+			std::cerr << "COOKED TEXTURE TRUNCATED: " << path << std::endl;
+			return false;
+		}
+		level.data.resize(levelHeader[2]);
+		if (!read(level.data.data(), level.data.size()))
+		{
+			std::cerr << "COOKED TEXTURE TRUNCATED: " << path << std::endl;
+			return false;
+		}
+	}
+
+	if (texture.levels.empty())
+	{
+		std::cerr << "COOKED TEXTURE TRUNCATED: " << path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+std::string TextureCooker::GetCookedPath(const std::string& sourcePath)
+{
+	return sourcePath + ".ctex";
+}
+
+bool TextureCooker::IsCookedUpToDate(const std::string& sourcePath)
+{
+	//pack se gradi samo sa svjezim kuhanim verzijama
+	if (FileSystem::IsPacked(GetCookedPath(sourcePath)))
+		return true;
+
+	std::error_code error;
+	std::filesystem::file_time_type cooked = std::filesystem::last_write_time(GetCookedPath(sourcePath), error);
+	if (error)
+		return false;
+	std::filesystem::file_time_type source = std::filesystem::last_write_time(sourcePath, error);
+	return error || cooked >= source;
+}
+
+void TextureCooker::DecodeLevel(const TextureLevel& level, TextureFormat format, std::vector<std::uint8_t>& rgba)
+{
+	rgba.resize((std::size_t)level.width * level.height * 4);
+	if (format == TextureFormat::RGBA8)
+	{
+		std::memcpy(rgba.data(), level.data.data(), rgba.size());
+		return;
+	}
+
+	unsigned int blocksX = (level.width + 3) / 4, blocksY = (level.height + 3) / 4;
+	unsigned int blockBytes = GetBlockBytes(format);
+	std::uint8_t pixels[64];
+	for (unsigned int blockY = 0; blockY < blocksY; blockY++)
+	{
+		for (unsigned int blockX = 0; blockX < blocksX; blockX++)
+		{
+			const std::uint8_t* block = level.data.data() + ((std::size_t)blockY * blocksX + blockX) * blockBytes;
+			if (format == TextureFormat::BC1)
+			{
+				DecodeColorBlock(block, false, pixels);
+			}
+			else if (format == TextureFormat::BC3)
+			{
+				DecodeColorBlock(block + 8, true, pixels);
+				DecodeAlphaBlock(block, pixels);
+			}
+			else
+			{
+				DecodeBC7Block(block, pixels);
+			}
+
+			for (unsigned int y = 0; y < 4 && blockY * 4 + y < level.height; y++)
+			{
+				for (unsigned int x = 0; x < 4 && blockX * 4 + x < level.width; x++)
+				{
+					std::size_t destination = ((std::size_t)(blockY * 4 + y) * level.width + blockX * 4 + x) * 4;
+					std::memcpy(rgba.data() + destination, pixels + (y * 4 + x) * 4, 4);
+				}
+			}
+		}
+	}
+}
+
+double TextureCooker::ComputePSNR(const std::uint8_t* a, const std::uint8_t* b, std::size_t pixels, unsigned int channels)
+{
+	double sum = 0.0;
+	for (std::size_t i = 0; i < pixels; i++)
+	{
+		for (unsigned int c = 0; c < channels; c++)
+		{
+			double d = (double)a[i * 4 + c] - b[i * 4 + c];
+			sum += d * d;
+		}
+	}
+
+	double mse = sum / ((double)pixels * channels);
+	return mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : INFINITY;
+}
+
+std::size_t TextureCooker::GetLevelSize(TextureFormat format, unsigned int width, unsigned int height)
+{
+	if (format == TextureFormat::RGBA8)
+		return (std::size_t)width * height * 4;
+	return (std::size_t)((width + 3) / 4) * ((height + 3) / 4) * GetBlockBytes(format);
+}
+
+const char* TextureCooker::GetFormatName(TextureFormat format)
+{
+	switch (format)
+	{
+	case TextureFormat::BC1: return "BC1";
+	case TextureFormat::BC3: return "BC3";
+	case TextureFormat::BC7: return "BC7";
+	default: return "RGBA8";
+	}
+}
+
+bool TextureCooker::ParseFormat(const std::string& name, TextureFormat& format)
+{
+	const TextureFormat formats[] = { TextureFormat::RGBA8, TextureFormat::BC1, TextureFormat::BC3, TextureFormat::BC7 };
+	for (TextureFormat candidate : formats)
+	{
+		std::string candidateName = GetFormatName(candidate);
+		if (name.size() == candidateName.size() && std::equal(name.begin(), name.end(), candidateName.begin(),
+			[](char a, char b) { return std::toupper((unsigned char)a) == b; }))
+		{
+			format = candidate;
+			return true;
+		}
+	}
+	return false;
+}
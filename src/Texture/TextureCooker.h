@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class JobSystem;
+
+enum class TextureFormat : std::uint32_t
+{
+	RGBA8,
+	//RGB 5:6:5 s dva bita po pikselu, 8 bajtova po bloku 4x4, alfa se odbacuje
+	BC1,
+	//BC1 boja + BC4 alfa, 16 bajtova po bloku
+	BC3,
+	//samo mod 6: jedan RGBA pravac s 7 + p bitova po kanalu i 4 bita po pikselu, 16 bajtova po bloku
+	BC7
+};
+
+struct TextureLevel
+{
+	unsigned int width = 0;
+	unsigned int height = 0;
+	std::vector<std::uint8_t> data;
+};
+
+//svi mip nivoi jedne teksture u istom formatu, redovi odozdo prema gore (ImageDecoder ih okrece pri pretvorbi)
+struct CookedTexture
+{
+	TextureFormat format = TextureFormat::RGBA8;
+	unsigned int width = 0;
+	unsigned int height = 0;
+	std::vector<TextureLevel> levels;
+
+	std::size_t GetSize() const;
+};
+
+struct TextureCookStats
+{
+	unsigned int width = 0;
+	unsigned int height = 0;
+	unsigned int levels = 0;
+	unsigned int threads = 0;
+	std::uint64_t pixels = 0;
+	double mipMs = 0.0;
+	double encodeMs = 0.0;
+	//RGBA8 s istim mip lancem, tj. koliko bi zauzela nekomprimirana tekstura
+	std::size_t uncompressedBytes = 0;
+	std::size_t compressedBytes = 0;
+	//prvi nivo nakon dekodiranja prema izvoru, RGB za BC1 i RGBA za ostale
+	double psnr = 0.0;
+
+	inline double GetMpixPerSecond() const { return encodeMs > 0.0 ? pixels / (encodeMs * 1000.0) : 0.0; }
+	inline std::size_t GetSavedBytes() const { return uncompressedBytes > compressedBytes ? uncompressedBytes - compressedBytes : 0; }
+};
+
+//kuhanje tekstura u blok kompresirane formate: mip lanac, paralelno kodiranje blokova 4x4 i spremanje u .ctex
+//krajnje tocke bloka dolaze iz glavne osi boja (PCA) i jednog koraka najmanjih kvadrata,
+//a najblizi unos palete za 4 piksela odjednom bira se SSE-om; rezultat ne ovisi o broju dretvi
+class TextureCooker
+{
+public:
+	TextureCooker(JobSystem* jobs = nullptr);
+
+	//pixels je RGBA8 bez razmaka izmedu redova; srgb filtrira mipove u linearnom prostoru (MipGenerator)
+	bool Cook(const std::uint8_t* pixels, unsigned int width, unsigned int height, TextureFormat format, CookedTexture& out, bool srgb = true);
+	//ucitava sliku preko ImageDecodera i sprema kuhanu verziju u cookedPath
+	bool CookFile(const std::string& sourcePath, const std::string& cookedPath, TextureFormat format, bool srgb = true);
+
+	inline const TextureCookStats& GetStats() const { return m_Stats; }
+
+	//.ctex: zaglavlje (magic, verzija, format, dimenzije, broj nivoa) pa za svaki nivo dimenzije, velicina i blokovi
+	static bool Save(const std::string& path, const CookedTexture& texture);
+	static bool Load(const std::string& path, CookedTexture& texture);
+	//kuhana verzija se drzi uz izvor, Texture je koristi ako nije starija od izvora
+	static std::string GetCookedPath(const std::string& sourcePath);
+	static bool IsCookedUpToDate(const std::string& sourcePath);
+
+	static void DecodeLevel(const TextureLevel& level, TextureFormat format, std::vector<std::uint8_t>& rgba);
+	//PSNR dvaju RGBA8 nizova u dB, channels 3 zanemaruje alfu
+	static double ComputePSNR(const std::uint8_t* a, const std::uint8_t* b, std::size_t pixels, unsigned int channels);
+
+	static std::size_t GetLevelSize(TextureFormat format, unsigned int width, unsigned int height);
+	static const char* GetFormatName(TextureFormat format);
+	static bool ParseFormat(const std::string& name, TextureFormat& format);
+
+private:
+	void EncodeLevel(const std::uint8_t* pixels, unsigned int width, unsigned int height, TextureFormat format, TextureLevel& out);
+
+private:
+	JobSystem* m_Jobs;
+	TextureCookStats m_Stats;
+};
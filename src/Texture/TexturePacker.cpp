@@ -0,0 +1,240 @@
+#include "glad/glad.h"
+
+#include "TexturePacker.h"
+#include "ImageDecoder.h"
+#include "MipGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <utility>
+
+static double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	return elapsed.count();
+}
+
+//padding je ujedno poravnanje u atlasu pa mora biti potencija od 2
+static unsigned int RoundUpPowerOfTwo(unsigned int value)
+{
+	unsigned int result = 1;
+	while (result < value)
+		result <<= 1;
+	return result;
+}
+
+TexturePacker::TexturePacker(unsigned int atlasSize, unsigned int padding, JobSystem* jobs)
+	: m_AtlasSize(atlasSize), m_Padding(padding > 0 ? RoundUpPowerOfTwo(padding) : 0), m_Jobs(jobs)
+{
+}
+
+TexturePacker::~TexturePacker()
+{
+	for (const ArrayData& array : m_Arrays)
+	{
+		if (array.renderID)
+			glDeleteTextures(1, &array.renderID);
+	}
+}
+
+int TexturePacker::Add(const std::string& path)
+{
+	DecodedImage image;
+	if (!ImageDecoder::DecodeFile(path, image))
+		return -1;
+	return Add(image.pixels.data(), image.width, image.height);
+}
+
+int TexturePacker::Add(const std::uint8_t* pixels, unsigned int width, unsigned int height)
+{
+	if (width == 0 || height == 0)
+		return -1;
+
+	SourceImage image;
+	image.width = width;
+	image.height = height;
+	image.pixels.assign(pixels, pixels + (std::size_t)width * height * 4);
+	m_Images.push_back(std::move(image));
+	m_Regions.push_back(TextureRegion());
+	return (int)m_Images.size() - 1;
+}
+
+void TexturePacker::CopyWithGutter(const SourceImage& image, std::vector<std::uint8_t>& page, unsigned int x, unsigned int y) const
+{
+	const unsigned int P = m_Padding;
+	for (unsigned int row = 0; row < image.height + 2 * P; row++)
+	{
+		unsigned int sourceRow = std::min(row > P ? row - P : 0, image.height - 1);
+		const std::uint8_t* source = image.pixels.data() + (std::size_t)sourceRow * image.width * 4;
+		std::uint8_t* target = page.data() + ((std::size_t)(y + row) * m_AtlasSize + x) * 4;
+
+		for (unsigned int i = 0; i < P; i++)
+			std::memcpy(target + i * 4, source, 4);
+		std::memcpy(target + P * 4, source, (std::size_t)image.width * 4);
+		for (unsigned int i = 0; i < P; i++)
+			std::memcpy(target + (P + image.width + i) * 4, source + (image.width - 1) * 4, 4);
+	}
+}
+
+bool TexturePacker::Pack()
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	m_Arrays.clear();
+	m_Stats = TexturePackStats();
+	m_Stats.textures = (unsigned int)m_Images.size();
+	if (m_Images.empty())
+		return false;
+
+	std::map<std::pair<unsigned int, unsigned int>, std::vector<int>> sizeGroups;
+	for (std::size_t i = 0; i < m_Images.size(); i++)
+		sizeGroups[{ m_Images[i].width, m_Images[i].height }].push_back((int)i);
+
+	//dovoljno velike grupe iste velicine i slike koje ne stanu u stranicu dobiju vlastiti niz, ostale idu u atlas
+	std::vector<int> atlasImages;
+	for (const auto& group : sizeGroups)
+	{
+		unsigned int width = group.first.first, height = group.first.second;
+		bool fitsAtlas = width + 2 * m_Padding <= m_AtlasSize && height + 2 * m_Padding <= m_AtlasSize;
+		if (group.second.size() < minArrayLayers && fitsAtlas)
+		{
+			atlasImages.insert(atlasImages.end(), group.second.begin(), group.second.end());
+			continue;
+		}
+
+		ArrayData array;
+		array.width = width;
+		array.height = height;
+		array.levelCount = MipGenerator::GetLevelCount(width, height);
+		array.atlas = false;
+		array.renderID = 0;
+		for (int handle : group.second)
+		{
+			array.layers.emplace_back();
+			MipGenerator::Generate(m_Images[handle].pixels.data(), width, height, true, array.layers.back(), m_Jobs);
+
+			TextureRegion& region = m_Regions[handle];
+			region.array = (unsigned int)m_Arrays.size();
+			region.layer = (unsigned int)array.layers.size() - 1;
+			region.uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+		}
+		m_Arrays.push_back(std::move(array));
+	}
+
+	if (!atlasImages.empty())
+	{
+		//visi prvi, skyline tada ostavlja manje rupa
+		std::sort(atlasImages.begin(), atlasImages.end(), [this](int a, int b)
+		{
+			if (m_Images[a].height != m_Images[b].height)
+				return m_Images[a].height > m_Images[b].height;
+			return m_Images[a].width > m_Images[b].width;
+		});
+
+		std::vector<AtlasPacker> pages;
+		std::vector<std::vector<std::pair<int, AtlasRect>>> placements;
+		for (int handle : atlasImages)
+		{
+			const SourceImage& image = m_Images[handle];
+			AtlasRect rect;
+			std::size_t page = 0;
+			while (page < pages.size() && !pages[page].Insert(image.width + 2 * m_Padding, image.height + 2 * m_Padding, rect))
+				page++;
+			if (page == pages.size())
+			{
+				pages.emplace_back(m_AtlasSize, m_AtlasSize, std::max(1u, m_Padding));
+				placements.emplace_back();
+				pages.back().Insert(image.width + 2 * m_Padding, image.height + 2 * m_Padding, rect);
+			}
+			placements[page].push_back({ handle, rect });
+
+			TextureRegion& region = m_Regions[handle];
+			region.array = (unsigned int)m_Arrays.size();
+			region.layer = (unsigned int)page;
+			region.uvRect = glm::vec4((float)(rect.x + m_Padding), (float)(rect.y + m_Padding), (float)image.width, (float)image.height) / (float)m_AtlasSize;
+		}
+
+		//nivoi ispod 2^k = padding bi mijesali texele susjednih tekstura
+		unsigned int safeLevels = 1;
+		while ((1u << (safeLevels - 1)) < m_Padding)
+			safeLevels++;
+
+		ArrayData array;
+		array.width = m_AtlasSize;
+		array.height = m_AtlasSize;
+		array.levelCount = std::min(safeLevels, MipGenerator::GetLevelCount(m_AtlasSize, m_AtlasSize));
+		array.atlas = true;
+		array.renderID = 0;
+		std::vector<std::uint8_t> page((std::size_t)m_AtlasSize * m_AtlasSize * 4);
+		for (std::size_t i = 0; i < pages.size(); i++)
+		{
+			std::fill(page.begin(), page.end(), (std::uint8_t)0);
+			for (const auto& placement : placements[i])
+				CopyWithGutter(m_Images[placement.first], page, placement.second.x, placement.second.y);
+
+			array.layers.emplace_back();
+			MipGenerator::Generate(page.data(), m_AtlasSize, m_AtlasSize, true, array.layers.back(), m_Jobs);
+			array.layers.back().resize(array.levelCount);
+
+			m_Stats.atlasOccupancy += pages[i].GetOccupancy();
+		}
+		m_Stats.atlasPages = (unsigned int)pages.size();
+		m_Stats.atlasOccupancy /= (float)pages.size();
+		m_Arrays.push_back(std::move(array));
+	}
+
+	m_Stats.arrays = (unsigned int)m_Arrays.size();
+	for (const ArrayData& array : m_Arrays)
+	{
+		m_Stats.layers += (unsigned int)array.layers.size();
+		for (const std::vector<TextureLevel>& levels : array.layers)
+			for (const TextureLevel& level : levels)
+				m_Stats.bytes += level.data.size();
+	}
+
+	m_Images.clear();
+	m_Images.shrink_to_fit();
+	m_Stats.packMs = ElapsedMs(start);
+	return true;
+}
+
+void TexturePacker::Upload()
+{
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	for (ArrayData& array : m_Arrays)
+	{
+		if (array.renderID)
+			continue;
+
+		glGenTextures(1, &array.renderID);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, array.renderID);
+		glTexStorage3D(GL_TEXTURE_2D_ARRAY, array.levelCount, GL_RGBA8, array.width, array.height, (GLsizei)array.layers.size());
+		for (std::size_t layer = 0; layer < array.layers.size(); layer++)
+		{
+			for (std::size_t i = 0; i < array.layers[layer].size(); i++)
+			{
+				const TextureLevel& level = array.layers[layer][i];
+				glTexSubImage3D(GL_TEXTURE_2D_ARRAY, (GLint)i, 0, 0, (GLint)layer, level.width, level.height, 1, GL_RGBA, GL_UNSIGNED_BYTE, level.data.data());
+			}
+		}
+
+		//u atlasu bi REPEAT uzorkovao susjednu teksturu, uv izvan [0, 1] tamo nije podrzan
+		GLint wrap = array.atlas ? GL_CLAMP_TO_EDGE : GL_REPEAT;
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, (GLint)array.levelCount - 1);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, wrap);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, wrap);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		array.layers.clear();
+		array.layers.shrink_to_fit();
+	}
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+void TexturePacker::Bind(unsigned int array, unsigned int slot) const
+{
+	glActiveTexture(GL_TEXTURE0 + slot);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, m_Arrays[array].renderID);
+}
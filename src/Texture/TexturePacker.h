@@ -0,0 +1,101 @@
+#pragma once
+
+#include "AtlasPacker.h"
+#include "TextureCooker.h"
+
+#include "glm/glm.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class JobSystem;
+
+//gdje se tekstura nalazi nakon pakiranja: sloj GL_TEXTURE_2D_ARRAY-a i pravokutnik u njemu
+//shader racuna uv = uvRect.xy + aTexCord * uvRect.zw
+struct TextureRegion
+{
+	unsigned int array = 0;
+	unsigned int layer = 0;
+	glm::vec4 uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+};
+
+struct TexturePackStats
+{
+	unsigned int textures = 0;
+	unsigned int arrays = 0;
+	unsigned int layers = 0;
+	//od toga stranice atlasa i prosjecna popunjenost stranica
+	unsigned int atlasPages = 0;
+	float atlasOccupancy = 0.0f;
+	std::size_t bytes = 0;
+	double packMs = 0.0;
+};
+
+//grupiranje tekstura u sto manje GL_TEXTURE_2D_ARRAY objekata da bi pass vezao teksture jednom umjesto po drawu:
+//teksture iste velicine (barem minArrayLayers) dobiju vlastiti niz s punim mip lancem,
+//ostale se skyline pakerom slazu u stranice atlasa koje su slojevi jednog niza
+//u atlasu je svaka tekstura okruzena s padding texela ponovljenog ruba, a pozicije su poravnate na padding (potencija od 2)
+//pa mip nivoi do log2(padding) ne mijesaju susjede; dublji nivoi se ne alociraju (GL_TEXTURE_MAX_LEVEL)
+class TexturePacker
+{
+public:
+	TexturePacker() = delete;
+	TexturePacker(unsigned int atlasSize = 2048, unsigned int padding = 8, JobSystem* jobs = nullptr);
+	~TexturePacker();
+
+	TexturePacker(const TexturePacker&) = delete;
+	TexturePacker& operator=(const TexturePacker&) = delete;
+
+	//vraca handle za GetRegion ili -1; slike se drze na CPU-u do Pack
+	int Add(const std::string& path);
+	int Add(const std::uint8_t* pixels, unsigned int width, unsigned int height);
+
+	//CPU dio: grupiranje, pakiranje, slaganje slojeva s rubovima i mipovi
+	bool Pack();
+	//GL dio: glTexStorage3D + glTexSubImage3D za sve nizove, CPU kopije se oslobadaju
+	void Upload();
+
+	void Bind(unsigned int array, unsigned int slot = 0) const;
+	//GL objekt niza, za CommandBuffer::BindTextureArray
+	inline unsigned int GetTexture(unsigned int array) const { return m_Arrays[array].renderID; }
+
+	inline const TextureRegion& GetRegion(int handle) const { return m_Regions[handle]; }
+	inline std::size_t GetTextureCount() const { return m_Images.size(); }
+	inline std::size_t GetArrayCount() const { return m_Arrays.size(); }
+	inline const TexturePackStats& GetStats() const { return m_Stats; }
+
+	//teksture iste velicine manje od ovoga idu u atlas
+	static const unsigned int minArrayLayers = 2;
+
+private:
+	struct SourceImage
+	{
+		unsigned int width, height;
+		std::vector<std::uint8_t> pixels;
+	};
+
+	struct ArrayData
+	{
+		unsigned int width, height;
+		unsigned int levelCount;
+		bool atlas;
+		//layers[sloj][nivo]
+		std::vector<std::vector<TextureLevel>> layers;
+		unsigned int renderID;
+	};
+
+	//kopira sliku u stranicu na (x, y) i ispunjava okvir od padding texela ponavljanjem rubnih texela
+	void CopyWithGutter(const SourceImage& image, std::vector<std::uint8_t>& page, unsigned int x, unsigned int y) const;
+
+private:
+	unsigned int m_AtlasSize;
+	unsigned int m_Padding;
+	JobSystem* m_Jobs;
+
+	std::vector<SourceImage> m_Images;
+	std::vector<TextureRegion> m_Regions;
+	std::vector<ArrayData> m_Arrays;
+	TexturePackStats m_Stats;
+};
@@ -0,0 +1,291 @@
+#include "glad/glad.h"
+
+#include "TextureResidency.h"
+#include "TextureStreamer.h"
+#include "MipGenerator.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+TextureResidency::TextureResidency(std::size_t budgetBytes, TextureStreamer* streamer, unsigned int tailSize)
+	: m_Streamer(streamer), m_TailSize(std::max(1u, tailSize)), m_Frame(0), m_NextKey(1)
+{
+	m_Stats.budgetBytes = budgetBytes;
+}
+
+std::size_t TextureResidency::GetLevelBytes(const Entry& entry, unsigned int finest, unsigned int coarsest) const
+{
+	std::size_t bytes = 0;
+	for (unsigned int level = finest; level <= coarsest && level < entry.cooked->levels.size(); level++)
+		bytes += entry.cooked->levels[level].data.size();
+	return bytes;
+}
+
+unsigned int TextureResidency::Register(CookedTexture&& cooked)
+{
+	if (cooked.levels.empty())
+		return 0;
+	unsigned int texture = m_NextKey++;
+
+	Entry entry;
+	entry.cooked = std::make_shared<const CookedTexture>(std::move(cooked));
+	unsigned int lastLevel = (unsigned int)entry.cooked->levels.size() - 1;
+	entry.tailLevel = 0;
+	while (entry.tailLevel < lastLevel &&
+		std::max(entry.cooked->levels[entry.tailLevel].width, entry.cooked->levels[entry.tailLevel].height) > m_TailSize)
+		entry.tailLevel++;
+	entry.targetLevel = entry.tailLevel;
+	entry.requestedLevel = entry.tailLevel;
+	entry.lastUsedFrame = m_Frame;
+
+	//rep lanca ide odmah, neovisno o budzetu, i storage se alocira samo za njega
+	entry.object = 0;
+	if (m_Streamer)
+	{
+		glGenTextures(1, &entry.object);
+		TextureStreamer::AllocateStorage(entry.object, *entry.cooked, entry.tailLevel);
+		m_Streamer->EnqueueLevels(entry.object, entry.cooked, lastLevel, entry.tailLevel, entry.tailLevel);
+		entry.residentLevel = lastLevel + 1;
+		entry.streaming = true;
+	}
+	else
+	{
+		entry.residentLevel = entry.tailLevel;
+		entry.streaming = false;
+	}
+
+	m_Stats.residentBytes += GetLevelBytes(entry, entry.tailLevel, lastLevel);
+	m_Stats.fullBytes += entry.cooked->GetSize();
+	m_Stats.peakResidentBytes = std::max(m_Stats.peakResidentBytes, m_Stats.residentBytes);
+	m_Stats.textures++;
+	m_Entries.emplace(texture, std::move(entry));
+	return texture;
+}
+
+void TextureResidency::Unregister(unsigned int texture)
+{
+	auto it = m_Entries.find(texture);
+	if (it == m_Entries.end())
+		return;
+
+	const Entry& entry = it->second;
+	if (entry.object != 0)
+	{
+		m_Streamer->Cancel(entry.object);
+		glDeleteTextures(1, &entry.object);
+	}
+	m_Stats.residentBytes -= GetLevelBytes(entry, std::min(entry.residentLevel, entry.targetLevel), (unsigned int)entry.cooked->levels.size() - 1);
+	m_Stats.fullBytes -= entry.cooked->GetSize();
+	m_Stats.textures--;
+	m_Entries.erase(it);
+}
+
+void TextureResidency::Request(unsigned int texture, unsigned int level)
+{
+	auto it = m_Entries.find(texture);
+	if (it == m_Entries.end())
+		return;
+
+	Entry& entry = it->second;
+	level = std::min(level, entry.tailLevel);
+	if (entry.lastUsedFrame != m_Frame)
+		entry.requestedLevel = level;
+	else
+		entry.requestedLevel = std::min(entry.requestedLevel, level);
+	entry.lastUsedFrame = m_Frame;
+}
+
+void TextureResidency::Reallocate(Entry& entry, unsigned int finest)
+{
+	if (entry.object == 0)
+		return;
+
+	unsigned int lastLevel = (unsigned int)entry.cooked->levels.size() - 1;
+	unsigned int object = 0;
+	glGenTextures(1, &object);
+	TextureStreamer::AllocateStorage(object, *entry.cooked, finest);
+
+	//nivoi se kopiraju cijeli pa BC nivoi manji od bloka ne smetaju
+	unsigned int copied = std::max(finest, entry.residentLevel);
+	for (unsigned int level = copied; level <= lastLevel; level++)
+	{
+		const TextureLevel& source = entry.cooked->levels[level];
+		glCopyImageSubData(entry.object, GL_TEXTURE_2D, (GLint)(level - entry.targetLevel), 0, 0, 0,
+			object, GL_TEXTURE_2D, (GLint)(level - finest), 0, 0, 0, source.width, source.height, 1);
+		m_Stats.copiedBytes += source.data.size();
+	}
+	if (copied <= lastLevel)
+	{
+		glBindTexture(GL_TEXTURE_2D, object);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, (GLint)(copied - finest));
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	glDeleteTextures(1, &entry.object);
+	entry.object = object;
+	m_Stats.reallocations++;
+}
+
+bool TextureResidency::MakeRoom(std::size_t needed, unsigned int except)
+{
+	if (m_Stats.residentBytes + needed <= m_Stats.budgetBytes)
+		return true;
+
+	//tekstura koristena u ovom frameu cuva nivo koji je trazila, ostale samo rep; nivoi na putu se ne diraju
+	struct Candidate
+	{
+		Entry* entry;
+		unsigned int floor;
+	};
+	std::vector<Candidate> candidates;
+	std::size_t evictable = 0;
+	for (auto& pair : m_Entries)
+	{
+		Entry& entry = pair.second;
+		if (pair.first == except || entry.streaming)
+			continue;
+
+		unsigned int floor = entry.lastUsedFrame == m_Frame ? entry.requestedLevel : entry.tailLevel;
+		if (entry.residentLevel >= floor)
+			continue;
+		candidates.push_back({ &entry, floor });
+		evictable += GetLevelBytes(entry, entry.residentLevel, floor - 1);
+	}
+	if (m_Stats.residentBytes + needed > m_Stats.budgetBytes + evictable)
+		return false;
+
+	std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b)
+	{
+		return a.entry->lastUsedFrame < b.entry->lastUsedFrame;
+	});
+
+	for (const Candidate& candidate : candidates)
+	{
+		Entry& entry = *candidate.entry;
+		unsigned int before = entry.residentLevel;
+		while (entry.residentLevel < candidate.floor && m_Stats.residentBytes + needed > m_Stats.budgetBytes)
+		{
+			m_Stats.residentBytes -= entry.cooked->levels[entry.residentLevel].data.size();
+			entry.residentLevel++;
+			m_Stats.frameEvictions++;
+		}
+		if (entry.residentLevel != before)
+		{
+			//targetLevel je jos baza starog storagea, kopija pocinje od novog residentLevel
+			Reallocate(entry, entry.residentLevel);
+			entry.targetLevel = entry.residentLevel;
+		}
+		if (m_Stats.residentBytes + needed <= m_Stats.budgetBytes)
+			return true;
+	}
+	return false;
+}
+
+void TextureResidency::Update()
+{
+	m_Stats.frameMipRequests = 0;
+	m_Stats.frameEvictions = 0;
+
+	std::vector<std::pair<unsigned int, Entry*>> wanting;
+	for (auto& pair : m_Entries)
+	{
+		Entry& entry = pair.second;
+		if (entry.streaming && m_Streamer->IsResident(entry.object))
+		{
+			entry.residentLevel = entry.targetLevel;
+			entry.streaming = false;
+		}
+
+		if (!entry.streaming && entry.lastUsedFrame == m_Frame && entry.requestedLevel < entry.residentLevel)
+			wanting.push_back({ pair.first, &entry });
+	}
+
+	//najveci manjak prvi, kod jednakog manjka najmanje tekstura pa jeftiniji zahtjevi ne cekaju skupe
+	std::sort(wanting.begin(), wanting.end(), [](const auto& a, const auto& b)
+	{
+		unsigned int missingA = a.second->residentLevel - a.second->requestedLevel;
+		unsigned int missingB = b.second->residentLevel - b.second->requestedLevel;
+		if (missingA != missingB)
+			return missingA > missingB;
+		return a.second->cooked->GetSize() < b.second->cooked->GetSize();
+	});
+
+	for (auto& pair : wanting)
+	{
+		Entry& entry = *pair.second;
+		//ako cijeli zahtjev ne stane ni nakon izbacivanja, trazi se prvi grublji nivo koji stane
+		unsigned int wanted = entry.requestedLevel;
+		std::size_t needed = 0;
+		for (; wanted < entry.residentLevel; wanted++)
+		{
+			needed = GetLevelBytes(entry, wanted, entry.residentLevel - 1);
+			if (MakeRoom(needed, pair.first))
+				break;
+		}
+		if (wanted >= entry.residentLevel)
+			continue;
+
+		m_Stats.frameMipRequests += entry.residentLevel - wanted;
+		m_Stats.residentBytes += needed;
+		if (m_Streamer)
+		{
+			//novi storage s mjestom za finije nivoe, dosadasnji nivoi se uzorkuju iz kopije dok finiji ne stignu
+			Reallocate(entry, wanted);
+			m_Streamer->EnqueueLevels(entry.object, entry.cooked, entry.residentLevel - 1, wanted, wanted);
+			entry.streaming = true;
+		}
+		else
+		{
+			entry.residentLevel = wanted;
+		}
+		entry.targetLevel = wanted;
+	}
+
+	m_Stats.mipRequests += m_Stats.frameMipRequests;
+	m_Stats.evictions += m_Stats.frameEvictions;
+	m_Stats.peakResidentBytes = std::max(m_Stats.peakResidentBytes, m_Stats.residentBytes);
+	m_Stats.frames++;
+	m_Frame++;
+}
+
+unsigned int TextureResidency::GetTexture(unsigned int texture) const
+{
+	auto it = m_Entries.find(texture);
+	return it == m_Entries.end() ? 0 : it->second.object;
+}
+
+int TextureResidency::GetResidentLevel(unsigned int texture) const
+{
+	auto it = m_Entries.find(texture);
+	if (it == m_Entries.end())
+		return -1;
+	return (int)it->second.residentLevel;
+}
+
+unsigned int TextureResidency::GetLevelCount(unsigned int texture) const
+{
+	auto it = m_Entries.find(texture);
+	return it == m_Entries.end() ? 0 : (unsigned int)it->second.cooked->levels.size();
+}
+
+float TextureResidency::GetProjectedSize(const glm::vec3& center, float radius, const glm::vec3& cameraPosition, float fovY, float screenHeight)
+{
+	float distance = glm::length(center - cameraPosition);
+	if (distance <= radius)
+		return FLT_MAX;
+	return radius * screenHeight / (distance * std::tan(fovY * 0.5f));
+}
+
+unsigned int TextureResidency::GetRequiredLevel(unsigned int width, unsigned int height, float screenPixels)
+{
+	unsigned int lastLevel = MipGenerator::GetLevelCount(width, height) - 1;
+	if (screenPixels <= 1.0f)
+		return lastLevel;
+
+	float ratio = (float)std::max(width, height) / screenPixels;
+	if (ratio <= 1.0f)
+		return 0;
+	return std::min(lastLevel, (unsigned int)std::floor(std::log2(ratio)));
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "TextureCooker.h"
+
+#include "glm/glm.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+
+class TextureStreamer;
+
+struct TextureResidencyStats
+{
+	unsigned int textures = 0;
+	std::size_t budgetBytes = 0;
+	//alocirani GL storage: nivoi koji se mogu uzorkovati plus oni koji su na putu
+	std::size_t residentBytes = 0;
+	std::size_t peakResidentBytes = 0;
+	//bajtovi kad bi svi nivoi svih tekstura bili ucitani odmah, ujedno CPU kopija koja ostaje u RAM-u kao izvor za ponovno ucitavanje
+	std::size_t fullBytes = 0;
+
+	//zadnji frame i ukupno, u broju mip nivoa
+	unsigned int frameMipRequests = 0;
+	unsigned int frameEvictions = 0;
+	unsigned long long mipRequests = 0;
+	unsigned long long evictions = 0;
+	//novi storage s drugim brojem nivoa i bajtovi koje je GPU kopirao iz starog
+	unsigned long long reallocations = 0;
+	std::size_t copiedBytes = 0;
+	unsigned long long frames = 0;
+};
+
+//rezidencija mip nivoa prema potrebi i budzetu VRAM-a:
+//crtanje svaki frame javlja najfiniji nivo koji objekt treba (iz projicirane velicine na ekranu), Update dosipava finije nivoe
+//kroz TextureStreamer, a kad bi budzet bio prekoracen izbacuje najfinije nivoe najdulje nekoristenih tekstura
+//grubi rep lanca (do tailSize texela) je uvijek rezidentan pa tekstura uvijek ima sto uzorkovati
+//immutable storage se ne moze smanjiti ni prosiriti pa svaka promjena raspona alocira novi GL objekt samo za nivoe od najfinijeg
+//potrebnog do zadnjeg, kopira zadrzane nivoe iz starog (glCopyImageSubData) i brise stari; budzet zato broji stvarno alocirani
+//storage (bez starog objekta dok traje kopija), a CPU kopija cijelog lanca ostaje u RAM-u i ne ulazi u budzet (fullBytes)
+//kljuc teksture daje Register, a objekt za bind GetTexture jer se mijenja pri svakoj realokaciji
+//bez streamera (nullptr) nivoi postaju rezidentni odmah i nema GL poziva, za mjerenje politike na CPU-u
+class TextureResidency
+{
+public:
+	TextureResidency() = delete;
+	TextureResidency(std::size_t budgetBytes, TextureStreamer* streamer, unsigned int tailSize = 64);
+
+	TextureResidency(const TextureResidency&) = delete;
+	TextureResidency& operator=(const TextureResidency&) = delete;
+
+	//vraca kljuc teksture (0 ako nema nivoa), CPU kopija nivoa ostaje kao izvor za ponovno ucitavanje
+	unsigned int Register(CookedTexture&& cooked);
+	void Unregister(unsigned int texture);
+
+	//tijekom framea, prije Update; vise zahtjeva za istu teksturu uzima najfiniji
+	void Request(unsigned int texture, unsigned int level);
+	//jednom po frameu na dretvi s GL kontekstom, prije TextureStreamer::Update
+	void Update();
+
+	//GL objekt za bind, vrijedi do sljedeceg Update; 0 bez streamera ili ako tekstura nije registrirana
+	unsigned int GetTexture(unsigned int texture) const;
+	//-1 ako tekstura nije registrirana
+	int GetResidentLevel(unsigned int texture) const;
+	unsigned int GetLevelCount(unsigned int texture) const;
+	inline std::size_t GetBudget() const { return m_Stats.budgetBytes; }
+	inline const TextureResidencyStats& GetStats() const { return m_Stats; }
+
+	//promjer sfere u pikselima za perspektivnu kameru s vertikalnim kutom fovY
+	static float GetProjectedSize(const glm::vec3& center, float radius, const glm::vec3& cameraPosition, float fovY, float screenHeight);
+	//nivo ciji texeli odgovaraju pikselima kad tekstura jednom prekriva objekt velicine screenPixels
+	static unsigned int GetRequiredLevel(unsigned int width, unsigned int height, float screenPixels);
+
+private:
+	struct Entry
+	{
+		std::shared_ptr<const CookedTexture> cooked;
+		//GL objekt sa storageom za nivoe od targetLevel do zadnjeg, 0 bez streamera
+		unsigned int object;
+		//najfiniji nivo koji se uzorkuje (levels.size() dok nista nije stiglo) i nivo do kojeg se trenutno streama
+		unsigned int residentLevel;
+		unsigned int targetLevel;
+		unsigned int tailLevel;
+		unsigned int requestedLevel;
+		unsigned long long lastUsedFrame;
+		bool streaming;
+	};
+
+	std::size_t GetLevelBytes(const Entry& entry, unsigned int finest, unsigned int coarsest) const;
+	//izbacuje nivoe ostalih tekstura od najdulje nekoristene dok ne stane needed bajtova, false ako ne moze
+	bool MakeRoom(std::size_t needed, unsigned int except);
+	//zamjenjuje storage novim za nivoe od finest do zadnjeg i kopira u njega rezidentne nivoe koji stanu
+	void Reallocate(Entry& entry, unsigned int finest);
+
+private:
+	TextureStreamer* m_Streamer;
+	unsigned int m_TailSize;
+	unsigned long long m_Frame;
+	unsigned int m_NextKey;
+
+	std::unordered_map<unsigned int, Entry> m_Entries;
+	TextureResidencyStats m_Stats;
+};
@@ -0,0 +1,235 @@
+#include "TextureStreamer.h"
+
+#include "JobSystem.h"
+#include "Texture.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+//kopije manje od ovoga ne vrijedi dijeliti po dretvama
+static const std::size_t COPY_GRAIN = 64 * 1024;
+//budzet mora primiti barem jedan redak najsireg nivoa (16K RGBA8 piksela ili BC blokova)
+static const std::size_t MIN_BYTES_PER_FRAME = 64 * 1024;
+
+static double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	return elapsed.count();
+}
+
+//redak za prijenos: jedan redak piksela za RGBA8, redak blokova 4x4 za BC formate
+static void GetRowLayout(TextureFormat format, const TextureLevel& level, std::size_t& rowBytes, unsigned int& rowCount, unsigned int& rowPixels)
+{
+	bool blocks = format != TextureFormat::RGBA8;
+	rowPixels = blocks ? 4 : 1;
+	rowCount = (level.height + rowPixels - 1) / rowPixels;
+	rowBytes = TextureCooker::GetLevelSize(format, level.width, rowPixels);
+}
+
+TextureStreamer::TextureStreamer(std::size_t bytesPerFrame, JobSystem* jobs)
+	: m_Ring(std::max(bytesPerFrame, MIN_BYTES_PER_FRAME)), m_BytesPerFrame(std::max(bytesPerFrame, MIN_BYTES_PER_FRAME)), m_Jobs(jobs)
+{
+}
+
+void TextureStreamer::Enqueue(unsigned int texture, CookedTexture&& cooked)
+{
+	if (cooked.levels.empty())
+		return;
+
+	AllocateStorage(texture, cooked);
+	std::size_t lastLevel = cooked.levels.size() - 1;
+	EnqueueLevels(texture, std::make_shared<const CookedTexture>(std::move(cooked)), lastLevel, 0);
+}
+
+void TextureStreamer::EnqueueLevels(unsigned int texture, std::shared_ptr<const CookedTexture> cooked, std::size_t coarsest, std::size_t finest, std::size_t baseLevel)
+{
+	if (!cooked || coarsest >= cooked->levels.size() || finest > coarsest || baseLevel > finest)
+		return;
+
+	StreamRequest request;
+	request.texture = texture;
+	request.cooked = std::move(cooked);
+	request.level = coarsest;
+	request.finest = finest;
+	request.baseLevel = baseLevel;
+	request.row = 0;
+	request.done = false;
+	m_Queue.push_back(std::move(request));
+}
+
+void TextureStreamer::AllocateStorage(unsigned int texture, const CookedTexture& cooked, std::size_t finest)
+{
+	const TextureLevel& first = cooked.levels[finest];
+	GLint lastLevel = (GLint)(cooked.levels.size() - 1 - finest);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexStorage2D(GL_TEXTURE_2D, lastLevel + 1, Texture::GetInternalFormat(cooked.format), first.width, first.height);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, lastLevel);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, lastLevel);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void TextureStreamer::Cancel(unsigned int texture)
+{
+	m_Queue.erase(std::remove_if(m_Queue.begin(), m_Queue.end(),
+		[texture](const StreamRequest& request) { return request.texture == texture; }), m_Queue.end());
+}
+
+bool TextureStreamer::IsResident(unsigned int texture) const
+{
+	return std::none_of(m_Queue.begin(), m_Queue.end(), [texture](const StreamRequest& request) { return request.texture == texture; });
+}
+
+std::size_t TextureStreamer::GetPendingBytes() const
+{
+	std::size_t bytes = 0;
+	for (const StreamRequest& request : m_Queue)
+	{
+		for (std::size_t level = request.finest; level <= request.level; level++)
+			bytes += request.cooked->levels[level].data.size();
+
+		std::size_t rowBytes;
+		unsigned int rowCount, rowPixels;
+		GetRowLayout(request.cooked->format, request.cooked->levels[request.level], rowBytes, rowCount, rowPixels);
+		bytes -= request.row * rowBytes;
+	}
+	return bytes;
+}
+
+void TextureStreamer::Update()
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	m_Stats.frames++;
+	m_Stats.lastFrameBytes = 0;
+	if (m_Queue.empty())
+	{
+		m_Stats.lastUpdateMs = 0.0;
+		return;
+	}
+
+	struct Upload
+	{
+		unsigned int texture;
+		TextureFormat format;
+		GLint level;
+		unsigned int y, width, height;
+		const std::uint8_t* source;
+		BufferSlice slice;
+		bool completesLevel;
+	};
+
+	//prvo se rasporedi budzet framea, tako da se sve kopije mogu napraviti jednim ParallelFor-om
+	m_Ring.BeginFrame();
+	std::vector<Upload> uploads;
+	std::size_t budget = m_BytesPerFrame;
+	for (StreamRequest& request : m_Queue)
+	{
+		while (budget > 0 && !request.done)
+		{
+			const TextureLevel& level = request.cooked->levels[request.level];
+			std::size_t rowBytes;
+			unsigned int rowCount, rowPixels;
+			GetRowLayout(request.cooked->format, level, rowBytes, rowCount, rowPixels);
+
+			unsigned int rows = (unsigned int)std::min<std::size_t>(rowCount - request.row, budget / rowBytes);
+			if (rows == 0)
+				break;
+
+			Upload upload;
+			upload.texture = request.texture;
+			upload.format = request.cooked->format;
+			upload.level = (GLint)(request.level - request.baseLevel);
+			upload.y = request.row * rowPixels;
+			upload.width = level.width;
+			upload.height = std::min(rows * rowPixels, level.height - upload.y);
+			upload.source = level.data.data() + request.row * rowBytes;
+			upload.slice = m_Ring.Allocate(rows * rowBytes, 4);
+			if (!upload.slice.IsValid())
+			{
+				budget = 0;
+				break;
+			}
+
+			request.row += rows;
+			budget -= rows * rowBytes;
+			upload.completesLevel = request.row == rowCount;
+			uploads.push_back(upload);
+
+			if (!upload.completesLevel)
+				break;
+			if (request.level == request.finest)
+			{
+				request.done = true;
+				break;
+			}
+			request.level--;
+			request.row = 0;
+		}
+
+		if (budget == 0)
+			break;
+	}
+
+	//kopiranje u mapirani PBO po komadima od COPY_GRAIN bajtova na radnim dretvama
+	std::vector<std::size_t> firstChunk(uploads.size() + 1, 0);
+	for (std::size_t i = 0; i < uploads.size(); i++)
+		firstChunk[i + 1] = firstChunk[i] + (uploads[i].slice.size + COPY_GRAIN - 1) / COPY_GRAIN;
+
+	auto copyChunks = [&](std::uint32_t begin, std::uint32_t end)
+	{
+		for (std::uint32_t chunk = begin; chunk < end; chunk++)
+		{
+			std::size_t i = std::upper_bound(firstChunk.begin(), firstChunk.end(), (std::size_t)chunk) - firstChunk.begin() - 1;
+			const Upload& upload = uploads[i];
+			std::size_t offset = (chunk - firstChunk[i]) * COPY_GRAIN;
+			std::memcpy((std::uint8_t*)upload.slice.data + offset, upload.source + offset, std::min(COPY_GRAIN, upload.slice.size - offset));
+		}
+	};
+	if (m_Jobs)
+		m_Jobs->ParallelFor((std::uint32_t)firstChunk.back(), 1, copyChunks);
+	else
+		copyChunks(0, (std::uint32_t)firstChunk.back());
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_Ring.GetID());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	for (const Upload& upload : uploads)
+	{
+		glBindTexture(GL_TEXTURE_2D, upload.texture);
+		const void* offset = (const void*)upload.slice.offset;
+		if (upload.format == TextureFormat::RGBA8)
+		{
+			glTexSubImage2D(GL_TEXTURE_2D, upload.level, 0, upload.y, upload.width, upload.height, GL_RGBA, GL_UNSIGNED_BYTE, offset);
+		}
+		else
+		{
+			glCompressedTexSubImage2D(GL_TEXTURE_2D, upload.level, 0, upload.y, upload.width, upload.height,
+				Texture::GetInternalFormat(upload.format), (GLsizei)upload.slice.size, offset);
+		}
+
+		//tek dovrseni nivo postaje najfiniji koji se uzorkuje
+		if (upload.completesLevel)
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, upload.level);
+
+		m_Stats.lastFrameBytes += upload.slice.size;
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	m_Ring.EndFrame();
+
+	std::size_t before = m_Queue.size();
+	m_Queue.erase(std::remove_if(m_Queue.begin(), m_Queue.end(),
+		[](const StreamRequest& request) { return request.done; }), m_Queue.end());
+	m_Stats.completedTextures += (unsigned int)(before - m_Queue.size());
+
+	m_Stats.uploadedBytes += m_Stats.lastFrameBytes;
+	m_Stats.peakFrameBytes = std::max(m_Stats.peakFrameBytes, m_Stats.lastFrameBytes);
+	if (m_Stats.lastFrameBytes > 0)
+		m_Stats.uploadFrames++;
+	m_Stats.lastUpdateMs = ElapsedMs(start);
+	m_Stats.maxUpdateMs = std::max(m_Stats.maxUpdateMs, m_Stats.lastUpdateMs);
+}
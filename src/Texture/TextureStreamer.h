@@ -0,0 +1,78 @@
+#pragma once
+
+#include "RingBuffer.h"
+#include "TextureCooker.h"
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+
+class JobSystem;
+
+struct TextureStreamStats
+{
+	unsigned long long frames = 0;
+	unsigned long long uploadFrames = 0;
+	unsigned int completedTextures = 0;
+
+	std::size_t uploadedBytes = 0;
+	std::size_t lastFrameBytes = 0;
+	std::size_t peakFrameBytes = 0;
+
+	//CPU vrijeme Update-a (kopiranje u PBO i izdavanje glTexSubImage2D)
+	double lastUpdateMs = 0.0;
+	double maxUpdateMs = 0.0;
+};
+
+//postupno punjenje tekstura kroz prsten PBO regija (RingBuffer kao GL_PIXEL_UNPACK_BUFFER)
+//Enqueue odmah alocira immutable storage (glTexStorage2D), a Update svaki frame prenese najvise bytesPerFrame bajtova:
+//radne dretve kopiraju retke u mapiranu memoriju, zatim glTexSubImage2D cita iz PBO-a bez sinkronog kopiranja u driveru
+//nivoi idu od najmanjeg prema najvecem i GL_TEXTURE_BASE_LEVEL prati zadnji dovrseni pa tekstura nikad ne uzorkuje prazne nivoe
+class TextureStreamer
+{
+public:
+	TextureStreamer() = delete;
+	TextureStreamer(std::size_t bytesPerFrame, JobSystem* jobs = nullptr);
+
+	TextureStreamer(const TextureStreamer&) = delete;
+	TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+	//texture je postojeci GL objekt bez storagea, format mora biti podrzan (Texture::IsFormatSupported)
+	void Enqueue(unsigned int texture, CookedTexture&& cooked);
+	//nivoi od coarsest do finest u teksturu s vec alociranim storageom, podaci ostaju dijeljeni s pozivateljem
+	//baseLevel je nivo iz cooked koji je u storageu GL nivo 0 (AllocateStorage s istim finest)
+	void EnqueueLevels(unsigned int texture, std::shared_ptr<const CookedTexture> cooked, std::size_t coarsest, std::size_t finest, std::size_t baseLevel = 0);
+	void Cancel(unsigned int texture);
+	//jednom po frameu na dretvi s GL kontekstom, prije crtanja
+	void Update();
+
+	bool IsResident(unsigned int texture) const;
+	std::size_t GetPendingBytes() const;
+	inline bool IsIdle() const { return m_Queue.empty(); }
+	inline std::size_t GetBytesPerFrame() const { return m_BytesPerFrame; }
+	inline const TextureStreamStats& GetStats() const { return m_Stats; }
+
+	//immutable storage za nivoe od finest do zadnjeg (finest je GL nivo 0), BASE_LEVEL = MAX_LEVEL = zadnji nivo dok nista nije stiglo
+	static void AllocateStorage(unsigned int texture, const CookedTexture& cooked, std::size_t finest = 0);
+
+private:
+	struct StreamRequest
+	{
+		unsigned int texture;
+		std::shared_ptr<const CookedTexture> cooked;
+		//nivo koji se trenutno puni (od coarsest prema finest) i prvi neposlani redak, kod BC formata redak blokova
+		std::size_t level;
+		std::size_t finest;
+		std::size_t baseLevel;
+		unsigned int row;
+		bool done;
+	};
+
+private:
+	RingBuffer m_Ring;
+	std::size_t m_BytesPerFrame;
+	JobSystem* m_Jobs;
+
+	std::deque<StreamRequest> m_Queue;
+	TextureStreamStats m_Stats;
+};
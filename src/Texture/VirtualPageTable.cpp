@@ -0,0 +1,229 @@
+#include "VirtualPageTable.h"
+
+#include <chrono>
+
+static double ElapsedMs(std::chrono::high_resolution_clock::time_point start)
+{
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+	return elapsed.count();
+}
+
+static unsigned int RoundUpPowerOfTwo(unsigned int value)
+{
+	unsigned int result = 1;
+	while (result < value)
+		result <<= 1;
+	return result;
+}
+
+VirtualPageTable::VirtualPageTable(unsigned int width, unsigned int height, unsigned int pageSize, unsigned int cacheSize, unsigned int uploadsPerFrame)
+	: m_PageSize(std::max(1u, pageSize)), m_LevelCount(1), m_CacheSize(std::min(std::max(1u, cacheSize), 256u)),
+	m_UploadsPerFrame(std::max(1u, uploadsPerFrame)), m_Frame(0), m_IndirectionDirty(true)
+{
+	//12 bitova po koordinati stranice u feedbacku
+	m_PagesX = std::min(RoundUpPowerOfTwo((width + m_PageSize - 1) / m_PageSize), 4096u);
+	m_PagesY = std::min(RoundUpPowerOfTwo((height + m_PageSize - 1) / m_PageSize), 4096u);
+	while ((std::max(m_PagesX, m_PagesY) >> (m_LevelCount - 1)) > 1)
+		m_LevelCount++;
+
+	m_Slots.resize((std::size_t)m_CacheSize * m_CacheSize);
+	for (unsigned int i = (unsigned int)m_Slots.size(); i > 0; i--)
+	{
+		m_Slots[i - 1].page = VirtualPage::INVALID;
+		m_Slots[i - 1].lastUsedFrame = 0;
+		m_Slots[i - 1].lru = m_LRU.end();
+		m_FreeSlots.push_back(i - 1);
+	}
+
+	m_Indirection.resize(m_LevelCount);
+	for (unsigned int level = 0; level < m_LevelCount; level++)
+		m_Indirection[level].assign((std::size_t)GetPagesX(level) * GetPagesY(level), 0);
+}
+
+int VirtualPageTable::GetSlot(const VirtualPage& page) const
+{
+	auto it = m_Resident.find(page.Encode());
+	return it == m_Resident.end() ? -1 : (int)it->second;
+}
+
+bool VirtualPageTable::IsResident(const VirtualPage& page) const
+{
+	return m_Resident.find(page.Encode()) != m_Resident.end();
+}
+
+void VirtualPageTable::Touch(unsigned int slot)
+{
+	Slot& entry = m_Slots[slot];
+	entry.lastUsedFrame = m_Frame;
+	if (VirtualPage::Decode(entry.page).level == m_LevelCount - 1)
+		return;
+
+	if (entry.lru == m_LRU.end())
+	{
+		m_LRU.push_front(slot);
+		entry.lru = m_LRU.begin();
+	}
+	else
+	{
+		m_LRU.splice(m_LRU.begin(), m_LRU, entry.lru);
+	}
+}
+
+int VirtualPageTable::AllocateSlot()
+{
+	if (!m_FreeSlots.empty())
+	{
+		unsigned int slot = m_FreeSlots.back();
+		m_FreeSlots.pop_back();
+		return (int)slot;
+	}
+
+	//sve sto je trazeno u ovom frameu ostaje, inace bi se stranice izbacivale jedna drugoj u istom frameu
+	if (m_LRU.empty() || m_Slots[m_LRU.back()].lastUsedFrame == m_Frame)
+		return -1;
+
+	unsigned int slot = m_LRU.back();
+	m_LRU.pop_back();
+	m_Resident.erase(m_Slots[slot].page);
+	m_Slots[slot].page = VirtualPage::INVALID;
+	m_Slots[slot].lru = m_LRU.end();
+	m_Stats.evictions++;
+	return (int)slot;
+}
+
+void VirtualPageTable::ProcessFeedback(const std::uint32_t* texels, std::size_t count)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	m_Loads.clear();
+	m_Stats.feedbackTexels = (unsigned int)count;
+	m_Stats.requestedPages = 0;
+	m_Stats.missingPages = 0;
+	m_Stats.uploads = 0;
+	m_Stats.evictions = 0;
+
+	//susjedni texeli vecinom traze istu stranicu pa se ponavljanja izbace prije sortiranja
+	m_Requests.clear();
+	std::uint32_t last = VirtualPage::INVALID;
+	for (std::size_t i = 0; i < count; i++)
+	{
+		if (texels[i] != VirtualPage::INVALID && texels[i] != last)
+			m_Requests.push_back(texels[i]);
+		last = texels[i];
+	}
+	std::sort(m_Requests.begin(), m_Requests.end());
+	m_Requests.erase(std::unique(m_Requests.begin(), m_Requests.end()), m_Requests.end());
+
+	//za svaku trazenu stranicu: svi rezidentni preci su koristeni, a ucitava se najgrublji nerezidentni
+	const unsigned int topLevel = m_LevelCount - 1;
+	std::vector<std::uint32_t> candidates;
+	if (!IsResident({ topLevel, 0, 0 }))
+		candidates.push_back(VirtualPage{ topLevel, 0, 0 }.Encode());
+	for (std::uint32_t key : m_Requests)
+	{
+		VirtualPage page = VirtualPage::Decode(key);
+		if (page.level >= m_LevelCount || page.x >= GetPagesX(page.level) || page.y >= GetPagesY(page.level))
+			continue;
+
+		m_Stats.requestedPages++;
+		if (!IsResident(page))
+			m_Stats.missingPages++;
+
+		std::uint32_t coarsestMissing = VirtualPage::INVALID;
+		for (;;)
+		{
+			auto it = m_Resident.find(page.Encode());
+			if (it != m_Resident.end())
+				Touch(it->second);
+			else
+				coarsestMissing = page.Encode();
+
+			if (page.level == topLevel)
+				break;
+			page = { page.level + 1, page.x / 2, page.y / 2 };
+		}
+
+		if (coarsestMissing != VirtualPage::INVALID)
+			candidates.push_back(coarsestMissing);
+	}
+
+	//grublji nivoi prvi jer o njima ovisi vise texela
+	std::sort(candidates.begin(), candidates.end(), [](std::uint32_t a, std::uint32_t b)
+	{
+		if ((a >> 24) != (b >> 24))
+			return (a >> 24) > (b >> 24);
+		return a < b;
+	});
+	candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+	for (std::uint32_t key : candidates)
+	{
+		if (m_Loads.size() >= m_UploadsPerFrame)
+			break;
+
+		int slot = AllocateSlot();
+		if (slot < 0)
+			break;
+
+		m_Slots[slot].page = key;
+		m_Resident[key] = (unsigned int)slot;
+		Touch((unsigned int)slot);
+		m_Loads.push_back({ VirtualPage::Decode(key), (unsigned int)slot });
+	}
+
+	if (!m_Loads.empty() || m_Stats.evictions > 0)
+		m_IndirectionDirty = true;
+
+	m_Stats.uploads = (unsigned int)m_Loads.size();
+	m_Stats.totalUploads += m_Stats.uploads;
+	m_Stats.totalEvictions += m_Stats.evictions;
+	m_Stats.residentPages = (unsigned int)m_Resident.size();
+	m_Stats.frames++;
+	m_Stats.lastProcessMs = ElapsedMs(start);
+	m_Frame++;
+}
+
+bool VirtualPageTable::UpdateIndirection()
+{
+	if (!m_IndirectionDirty)
+		return false;
+
+	//od najgrubljeg nivoa: svaki unos naslijedi unos roditelja, zatim rezidentne stranice nivoa upisu svoj slot
+	//bez trazenja u mapi po unosu, rezidentne stranice se prvo razvrstaju po nivou
+	std::vector<std::vector<unsigned int>> residentSlots(m_LevelCount);
+	for (unsigned int slot = 0; slot < (unsigned int)m_Slots.size(); slot++)
+	{
+		if (m_Slots[slot].page != VirtualPage::INVALID)
+			residentSlots[VirtualPage::Decode(m_Slots[slot].page).level].push_back(slot);
+	}
+
+	for (unsigned int level = m_LevelCount; level > 0; level--)
+	{
+		unsigned int l = level - 1;
+		unsigned int pagesX = GetPagesX(l), pagesY = GetPagesY(l);
+		std::vector<std::uint32_t>& table = m_Indirection[l];
+		if (l + 1 < m_LevelCount)
+		{
+			const std::vector<std::uint32_t>& parent = m_Indirection[l + 1];
+			unsigned int parentX = GetPagesX(l + 1), parentY = GetPagesY(l + 1);
+			for (unsigned int y = 0; y < pagesY; y++)
+			{
+				const std::uint32_t* parentRow = parent.data() + (std::size_t)std::min(y / 2, parentY - 1) * parentX;
+				for (unsigned int x = 0; x < pagesX; x++)
+					table[(std::size_t)y * pagesX + x] = parentRow[std::min(x / 2, parentX - 1)];
+			}
+		}
+		else
+		{
+			std::fill(table.begin(), table.end(), 0u);
+		}
+
+		for (unsigned int slot : residentSlots[l])
+		{
+			VirtualPage page = VirtualPage::Decode(m_Slots[slot].page);
+			table[(std::size_t)page.y * pagesX + page.x] = (slot % m_CacheSize) | ((slot / m_CacheSize) << 8) | (l << 16) | 0xFF000000u;
+		}
+	}
+
+	m_IndirectionDirty = false;
+	return true;
+}
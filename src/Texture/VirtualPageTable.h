@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+//stranica virtualne teksture u jednom uint32 kao sto ga pise feedback shader: nivo u gornjih 8 bitova, zatim y i x po 12 bitova
+struct VirtualPage
+{
+	unsigned int level = 0;
+	unsigned int x = 0;
+	unsigned int y = 0;
+
+	static const std::uint32_t INVALID = 0xFFFFFFFF;
+
+	inline std::uint32_t Encode() const { return (level << 24) | (y << 12) | x; }
+	static inline VirtualPage Decode(std::uint32_t key) { return { key >> 24, key & 0xFFF, (key >> 12) & 0xFFF }; }
+};
+
+//stranica koju treba ucitati u slot fizickog cachea u ovom frameu
+struct VirtualPageLoad
+{
+	VirtualPage page;
+	unsigned int slot;
+};
+
+struct VirtualTextureStats
+{
+	unsigned long long frames = 0;
+	//zadnji frame: texeli feedbacka, razlicite trazene stranice, trazene stranice koje nisu bile rezidentne, ucitavanja i izbacivanja
+	unsigned int feedbackTexels = 0;
+	unsigned int requestedPages = 0;
+	unsigned int missingPages = 0;
+	unsigned int uploads = 0;
+	unsigned int evictions = 0;
+	unsigned int residentPages = 0;
+
+	unsigned long long totalUploads = 0;
+	unsigned long long totalEvictions = 0;
+	double lastProcessMs = 0.0;
+};
+
+//CPU strana virtualne teksture bez GL-a: tablica rezidentnih stranica, deduplikacija zahtjeva iz feedbacka,
+//LRU izbacivanje slotova fizickog cachea i indirekcijska tablica po nivou
+//virtualna tekstura je zaokruzena na potenciju od 2 stranica po osi pa nivo l ima (stranice >> l) stranica kao GL mip lanac,
+//a najgrublji nivo je uvijek rezidentan kako bi svaki texel imao pretka koji se moze uzorkovati
+//nerezidentna stranica trazi najgrubljeg nerezidentnog pretka pa se detalj puni od grubog prema finom bez rupa
+class VirtualPageTable
+{
+public:
+	VirtualPageTable() = delete;
+	//width i height su dimenzije izvora u texelima, cacheSize je broj slotova po stranici fizickog cachea
+	VirtualPageTable(unsigned int width, unsigned int height, unsigned int pageSize, unsigned int cacheSize, unsigned int uploadsPerFrame);
+
+	//jednom po frameu: texeli s VirtualPage::Encode ili INVALID; rezultat su stranice za ucitavanje (GetLoads)
+	void ProcessFeedback(const std::uint32_t* texels, std::size_t count);
+	//nakon ProcessFeedback prepisuje promijenjene nivoe indirekcije, vraca false ako se nista nije promijenilo
+	bool UpdateIndirection();
+
+	inline const std::vector<VirtualPageLoad>& GetLoads() const { return m_Loads; }
+	//RGBA8 po stranici nivoa: x i y slota, nivo stranice koja se stvarno uzorkuje, 255
+	inline const std::vector<std::uint32_t>& GetIndirection(unsigned int level) const { return m_Indirection[level]; }
+	//-1 ako stranica nije u cacheu
+	int GetSlot(const VirtualPage& page) const;
+	bool IsResident(const VirtualPage& page) const;
+
+	inline unsigned int GetLevelCount() const { return m_LevelCount; }
+	inline unsigned int GetPagesX(unsigned int level) const { return std::max(1u, m_PagesX >> level); }
+	inline unsigned int GetPagesY(unsigned int level) const { return std::max(1u, m_PagesY >> level); }
+	inline unsigned int GetPageSize() const { return m_PageSize; }
+	inline unsigned int GetCacheSize() const { return m_CacheSize; }
+	//dimenzije virtualnog prostora (potencija od 2 stranica), izvor zauzima gornji lijevi dio
+	inline unsigned int GetVirtualWidth() const { return m_PagesX * m_PageSize; }
+	inline unsigned int GetVirtualHeight() const { return m_PagesY * m_PageSize; }
+	inline const VirtualTextureStats& GetStats() const { return m_Stats; }
+
+private:
+	struct Slot
+	{
+		std::uint32_t page;
+		unsigned long long lastUsedFrame;
+		std::list<unsigned int>::iterator lru;
+	};
+
+	void Touch(unsigned int slot);
+	//slobodan slot ili najdulje nekoristeni koji nije trazen u ovom frameu, -1 ako takvog nema
+	int AllocateSlot();
+
+private:
+	unsigned int m_PageSize;
+	unsigned int m_PagesX, m_PagesY;
+	unsigned int m_LevelCount;
+	unsigned int m_CacheSize;
+	unsigned int m_UploadsPerFrame;
+	unsigned long long m_Frame;
+
+	std::unordered_map<std::uint32_t, unsigned int> m_Resident;
+	std::vector<Slot> m_Slots;
+	std::vector<unsigned int> m_FreeSlots;
+	//najnedavnije koristeni na pocetku; stranice najgrubljeg nivoa nisu u popisu pa se nikad ne izbacuju
+	std::list<unsigned int> m_LRU;
+
+	std::vector<std::uint32_t> m_Requests;
+	std::vector<VirtualPageLoad> m_Loads;
+	std::vector<std::vector<std::uint32_t>> m_Indirection;
+	bool m_IndirectionDirty;
+	VirtualTextureStats m_Stats;
+};
@@ -0,0 +1,206 @@
+#include "VirtualTexture.h"
+
+#include "ImageDecoder.h"
+#include "JobSystem.h"
+#include "MipGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static std::vector<TextureLevel> LoadSourceLevels(const std::string& path, JobSystem* jobs)
+{
+	std::vector<TextureLevel> levels;
+	DecodedImage image;
+	if (ImageDecoder::DecodeFile(path, image))
+		MipGenerator::Generate(image.pixels.data(), image.width, image.height, image.srgb, levels, jobs);
+	return levels;
+}
+
+VirtualTexture::VirtualTexture(const std::string& path, unsigned int screenWidth, unsigned int screenHeight,
+	const VirtualTextureSettings& settings, JobSystem* jobs)
+	: m_Settings(settings), m_Jobs(jobs), m_ScreenWidth(screenWidth), m_ScreenHeight(screenHeight),
+	m_Levels(LoadSourceLevels(path, jobs)),
+	m_ImageWidth(m_Levels.empty() ? 1 : m_Levels[0].width), m_ImageHeight(m_Levels.empty() ? 1 : m_Levels[0].height),
+	m_Table(m_ImageWidth, m_ImageHeight, settings.pageSize, settings.cacheSize, settings.uploadsPerFrame),
+	m_Cache(0), m_Indirection(0),
+	m_FeedbackShader("res/shaders/vShader.glsl", "res/shaders/fVirtualFeedback.glsl"),
+	m_Feedback(std::max(1u, screenWidth / std::max(1u, settings.feedbackDivisor)), std::max(1u, screenHeight / std::max(1u, settings.feedbackDivisor)),
+		{ { GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT } }),
+	m_FeedbackFrame(0)
+{
+	m_Settings.pageSize = m_Table.GetPageSize();
+	m_Settings.cacheSize = m_Table.GetCacheSize();
+	if (m_Levels.empty())
+		return;
+
+	unsigned int slotSize = m_Settings.pageSize + 2 * m_Settings.pageBorder;
+	unsigned int cacheTexels = m_Settings.cacheSize * slotSize;
+	glGenTextures(1, &m_Cache);
+	glBindTexture(GL_TEXTURE_2D, m_Cache);
+	glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, cacheTexels, cacheTexels);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	//jedan texel po stranici, mip nivo po nivou virtualne teksture
+	glGenTextures(1, &m_Indirection);
+	glBindTexture(GL_TEXTURE_2D, m_Indirection);
+	glTexStorage2D(GL_TEXTURE_2D, m_Table.GetLevelCount(), GL_RGBA8, m_Table.GetPagesX(0), m_Table.GetPagesY(0));
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)m_Table.GetLevelCount() - 1);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	std::size_t feedbackBytes = (std::size_t)m_Feedback.GetWidth() * m_Feedback.GetHeight() * sizeof(std::uint32_t);
+	glGenBuffers(2, m_ReadbackBuffers);
+	for (unsigned int buffer : m_ReadbackBuffers)
+	{
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+		glBufferData(GL_PIXEL_PACK_BUFFER, feedbackBytes, nullptr, GL_STREAM_READ);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+VirtualTexture::~VirtualTexture()
+{
+	if (!m_Cache)
+		return;
+
+	glDeleteTextures(1, &m_Cache);
+	glDeleteTextures(1, &m_Indirection);
+	glDeleteBuffers(2, m_ReadbackBuffers);
+}
+
+void VirtualTexture::SetUniforms(const Shader& shader) const
+{
+	shader.SetUniformVec2("virtualSize", glm::vec2((float)m_Table.GetVirtualWidth(), (float)m_Table.GetVirtualHeight()));
+	shader.SetUniformVec2("virtualScale", glm::vec2((float)m_ImageWidth / m_Table.GetVirtualWidth(), (float)m_ImageHeight / m_Table.GetVirtualHeight()));
+	shader.SetUniformFloat("pageSize", (float)m_Settings.pageSize);
+	shader.SetUniformInt("virtualLevels", (int)m_Table.GetLevelCount());
+}
+
+const Shader& VirtualTexture::BeginFeedback()
+{
+	m_Feedback.Bind();
+	glViewport(0, 0, m_Feedback.GetWidth(), m_Feedback.GetHeight());
+	const GLuint invalid[4] = { VirtualPage::INVALID, 0, 0, 0 };
+	glClearBufferuiv(GL_COLOR, 0, invalid);
+	glClear(GL_DEPTH_BUFFER_BIT);
+
+	m_FeedbackShader.Bind();
+	SetUniforms(m_FeedbackShader);
+	m_FeedbackShader.SetUniformFloat("feedbackBias", -std::log2((float)std::max(1u, m_Settings.feedbackDivisor)));
+	return m_FeedbackShader;
+}
+
+void VirtualTexture::EndFeedback()
+{
+	if (!m_Cache)
+	{
+		m_Feedback.UnBind();
+		glViewport(0, 0, m_ScreenWidth, m_ScreenHeight);
+		return;
+	}
+
+	//ovaj frame se kopira u jedan PBO, a obraduje se prethodni iz drugog
+	unsigned int write = m_ReadbackBuffers[m_FeedbackFrame % 2];
+	unsigned int read = m_ReadbackBuffers[(m_FeedbackFrame + 1) % 2];
+	std::size_t texelCount = (std::size_t)m_Feedback.GetWidth() * m_Feedback.GetHeight();
+
+	glReadBuffer(GL_COLOR_ATTACHMENT0);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, write);
+	glReadPixels(0, 0, m_Feedback.GetWidth(), m_Feedback.GetHeight(), GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+	m_Feedback.UnBind();
+	glViewport(0, 0, m_ScreenWidth, m_ScreenHeight);
+
+	if (m_FeedbackFrame > 0)
+	{
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, read);
+		const std::uint32_t* texels = (const std::uint32_t*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, texelCount * sizeof(std::uint32_t), GL_MAP_READ_BIT);
+		if (texels)
+		{
+			m_Table.ProcessFeedback(texels, texelCount);
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		}
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	m_FeedbackFrame++;
+
+	const std::vector<VirtualPageLoad>& loads = m_Table.GetLoads();
+	if (loads.empty())
+		return;
+
+	//rezanje stranica paralelno, slanje u cache na GL dretvi
+	unsigned int slotSize = m_Settings.pageSize + 2 * m_Settings.pageBorder;
+	std::size_t pageBytes = (std::size_t)slotSize * slotSize * 4;
+	m_PageData.resize(loads.size() * pageBytes);
+	auto extractPages = [&](std::uint32_t begin, std::uint32_t end)
+	{
+		for (std::uint32_t i = begin; i < end; i++)
+			ExtractPage(loads[i].page, m_PageData.data() + i * pageBytes);
+	};
+	if (m_Jobs)
+		m_Jobs->ParallelFor((std::uint32_t)loads.size(), 1, extractPages);
+	else
+		extractPages(0, (std::uint32_t)loads.size());
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindTexture(GL_TEXTURE_2D, m_Cache);
+	for (std::size_t i = 0; i < loads.size(); i++)
+	{
+		unsigned int slotX = loads[i].slot % m_Settings.cacheSize, slotY = loads[i].slot / m_Settings.cacheSize;
+		glTexSubImage2D(GL_TEXTURE_2D, 0, slotX * slotSize, slotY * slotSize, slotSize, slotSize, GL_RGBA, GL_UNSIGNED_BYTE, m_PageData.data() + i * pageBytes);
+	}
+
+	if (m_Table.UpdateIndirection())
+	{
+		glBindTexture(GL_TEXTURE_2D, m_Indirection);
+		for (unsigned int level = 0; level < m_Table.GetLevelCount(); level++)
+		{
+			glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, m_Table.GetPagesX(level), m_Table.GetPagesY(level),
+				GL_RGBA, GL_UNSIGNED_BYTE, m_Table.GetIndirection(level).data());
+		}
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void VirtualTexture::ExtractPage(const VirtualPage& page, std::uint8_t* target) const
+{
+	const TextureLevel& level = m_Levels[std::min<std::size_t>(page.level, m_Levels.size() - 1)];
+	int slotSize = (int)(m_Settings.pageSize + 2 * m_Settings.pageBorder);
+	int originX = (int)(page.x * m_Settings.pageSize) - (int)m_Settings.pageBorder;
+	int originY = (int)(page.y * m_Settings.pageSize) - (int)m_Settings.pageBorder;
+	for (int y = 0; y < slotSize; y++)
+	{
+		int sourceY = std::min(std::max(originY + y, 0), (int)level.height - 1);
+		const std::uint8_t* row = level.data.data() + (std::size_t)sourceY * level.width * 4;
+		std::uint8_t* out = target + (std::size_t)y * slotSize * 4;
+
+		//unutarnji dio retka je jedan memcpy, rubovi izvan slike ponavljaju zadnji texel
+		int first = std::min(std::max(-originX, 0), slotSize);
+		int last = std::max(std::min((int)level.width - originX, slotSize), first);
+		for (int x = 0; x < first; x++)
+			std::memcpy(out + x * 4, row, 4);
+		if (last > first)
+			std::memcpy(out + first * 4, row + (std::size_t)(originX + first) * 4, (std::size_t)(last - first) * 4);
+		for (int x = last; x < slotSize; x++)
+			std::memcpy(out + x * 4, row + (std::size_t)(level.width - 1) * 4, 4);
+	}
+}
+
+void VirtualTexture::Bind(const Shader& shader, unsigned int cacheSlot, unsigned int indirectionSlot) const
+{
+	glActiveTexture(GL_TEXTURE0 + cacheSlot);
+	glBindTexture(GL_TEXTURE_2D, m_Cache);
+	glActiveTexture(GL_TEXTURE0 + indirectionSlot);
+	glBindTexture(GL_TEXTURE_2D, m_Indirection);
+	glActiveTexture(GL_TEXTURE0);
+
+	SetUniforms(shader);
+	shader.SetUniformInt("virtualCache", (int)cacheSlot);
+	shader.SetUniformInt("virtualIndirection", (int)indirectionSlot);
+	shader.SetUniformFloat("pageBorder", (float)m_Settings.pageBorder);
+	shader.SetUniformFloat("cacheTexels", (float)(m_Settings.cacheSize * (m_Settings.pageSize + 2 * m_Settings.pageBorder)));
+}
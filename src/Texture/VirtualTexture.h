@@ -0,0 +1,74 @@
+#pragma once
+
+#include "VirtualPageTable.h"
+#include "TextureCooker.h"
+#include "Framebuffer.h"
+#include "Shader.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class JobSystem;
+
+struct VirtualTextureSettings
+{
+	unsigned int pageSize = 128;
+	//texeli susjednih stranica oko svake stranice u cacheu, za bilinearno filtriranje na rubu
+	unsigned int pageBorder = 4;
+	//slotova po stranici fizickog cachea
+	unsigned int cacheSize = 8;
+	unsigned int uploadsPerFrame = 8;
+	//feedback se crta u (ekran / feedbackDivisor)
+	unsigned int feedbackDivisor = 8;
+};
+
+//GL strana virtualne teksture: fizicki cache (jedna RGBA8 tekstura sa slotovima), indirekcijska tekstura s mipom po nivou
+//i feedback prolaz koji u R32UI upisuje stranicu koju bi svaki piksel uzorkovao
+//feedback se cita kroz dva PBO-a s jednim frameom kasnjenja pa glReadPixels ne ceka GPU; logika stranica je u VirtualPageTable
+//izvor je mip lanac slike u memoriji (ImageDecoder + MipGenerator), stranice se iz njega rezu s rubom na radnim dretvama
+class VirtualTexture
+{
+public:
+	VirtualTexture() = delete;
+	VirtualTexture(const std::string& path, unsigned int screenWidth, unsigned int screenHeight,
+		const VirtualTextureSettings& settings = VirtualTextureSettings(), JobSystem* jobs = nullptr);
+	~VirtualTexture();
+
+	VirtualTexture(const VirtualTexture&) = delete;
+	VirtualTexture& operator=(const VirtualTexture&) = delete;
+
+	//veze feedback FBO i shader (vShader + fVirtualFeedback), pozivatelj postavlja matrice i crta
+	const Shader& BeginFeedback();
+	//cita feedback prethodnog framea, ucitava trazene stranice i osvjezava indirekciju; vraca default FBO i viewport ekrana
+	void EndFeedback();
+
+	//uniformi za SampleVirtual u fShaderVirtual.glsl, shader mora biti vezan
+	void Bind(const Shader& shader, unsigned int cacheSlot, unsigned int indirectionSlot) const;
+
+	inline bool IsValid() const { return m_Cache != 0; }
+	inline const VirtualPageTable& GetPageTable() const { return m_Table; }
+	inline const VirtualTextureStats& GetStats() const { return m_Table.GetStats(); }
+
+private:
+	//stranica s rubom iz nivoa izvora, texeli izvan slike ponavljaju rub
+	void ExtractPage(const VirtualPage& page, std::uint8_t* target) const;
+	void SetUniforms(const Shader& shader) const;
+
+private:
+	VirtualTextureSettings m_Settings;
+	JobSystem* m_Jobs;
+	unsigned int m_ScreenWidth, m_ScreenHeight;
+	std::vector<TextureLevel> m_Levels;
+	unsigned int m_ImageWidth, m_ImageHeight;
+
+	VirtualPageTable m_Table;
+	unsigned int m_Cache;
+	unsigned int m_Indirection;
+
+	Shader m_FeedbackShader;
+	Framebuffer m_Feedback;
+	unsigned int m_ReadbackBuffers[2];
+	unsigned long long m_FeedbackFrame;
+	std::vector<std::uint8_t> m_PageData;
+};
@@ -1,13 +1,18 @@
 #include "Window.h"
 
 #include <iostream>
+#include <atomic>
 #include <assert.h>
 
+static std::atomic<bool> s_ViewportPending(false);
+static std::atomic<int> s_PendingWidth(0);
+static std::atomic<int> s_PendingHeight(0);
+
 Window::Window(const std::string& name, const unsigned int& scr_width, const unsigned int& scr_height)
 {
     glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_SAMPLES, 4);
 
@@ -44,6 +49,26 @@ void Window::SwapAndPoll() const
     glfwPollEvents();
 }
 
+void Window::Swap() const
+{
+    glfwSwapBuffers(m_Window);
+}
+
+void Window::PollEvents() const
+{
+    glfwPollEvents();
+}
+
+void Window::MakeContextCurrent() const
+{
+    glfwMakeContextCurrent(m_Window);
+}
+
+void Window::ReleaseContext() const
+{
+    glfwMakeContextCurrent(NULL);
+}
+
 void Window::CloseWindow() const
 {
     glfwTerminate();
@@ -62,5 +87,24 @@ void processInput(GLFWwindow* window)
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
-    glViewport(0, 0, width, height);
+    //callback se poziva iz glfwPollEvents na glavnoj dretvi, a kontekst moze biti na render dretvi
+    if (glfwGetCurrentContext() == window)
+    {
+        glViewport(0, 0, width, height);
+        return;
+    }
+
+    s_PendingWidth = width;
+    s_PendingHeight = height;
+    s_ViewportPending = true;
+}
+
+bool TakePendingViewport(int& width, int& height)
+{
+    if (!s_ViewportPending.exchange(false))
+        return false;
+
+    width = s_PendingWidth;
+    height = s_PendingHeight;
+    return true;
 }
\ No newline at end of file
@@ -7,6 +7,9 @@
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void processInput(GLFWwindow* window);
 
+//velicina prozora promijenjena dok kontekst nije bio aktivan na glavnoj dretvi
+bool TakePendingViewport(int& width, int& height);
+
 class Window
 {
 public:
@@ -15,6 +18,10 @@ public:
 
 	void CallBack() const;
 	void SwapAndPoll() const;
+	void Swap() const;
+	void PollEvents() const;
+	void MakeContextCurrent() const;
+	void ReleaseContext() const;
 	void CloseWindow() const;
 	void ProcessInput() const;
 
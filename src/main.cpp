@@ -1,11 +1,39 @@
 ﻿#include <iostream>
 #include <string>
+#include <memory>
+#include <chrono>
+#include <cctype>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <filesystem>
+#include <cstring>
 
 #include "Window.h"
 #include "Renderer.h"
 #include "Model.h"
 #include "Shader.h"
 #include "Texture.h"
+#include "Benchmark.h"
+#include "RenderThread.h"
+#include "JobSystem.h"
+#include "Scene.h"
+#include "BatchMath.h"
+#include "ClusteredLighting.h"
+#include "RingBuffer.h"
+#include "DeferredRenderer.h"
+#include "CascadedShadowMaps.h"
+#include "LightBaker.h"
+#include "TextureCooker.h"
+#include "TextureStreamer.h"
+#include "TexturePacker.h"
+#include "TextureResidency.h"
+#include "ImageDecoder.h"
+#include "VirtualTexture.h"
+#include "AssetPack.h"
+#include "FileSystem.h"
+#include "AssetCooker.h"
+#include "AsyncIO.h"
 
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
@@ -17,108 +45,863 @@ const unsigned int SCR_HEIGHT = 1000;
 
 glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
 
-glm::vec3 cubePositions[] = {
-    glm::vec3(-2.0f, 0.0f, 0.0f),
-    glm::vec3(-1.0f, 0.0f, 0.0f),
-    glm::vec3(0.0f, 1.6f, 0.0f),
-    glm::vec3(0.0f, 1.0f, 0.0f),
-    glm::vec3(0.0f, -1.0f, 0.0f),
-    glm::vec3(0.0f, -1.6f, 0.0f),
-    glm::vec3(1.0f, 0.0f, 0.0f),
-    glm::vec3(2.0f, 0.0f, 0.0f)
-};
-
 //polozaj kamere
 const float radius = 6.0f;
-glm::vec3 cameraTarget(cubePositions[3]);
+glm::vec3 cameraTarget(0.0f, 1.0f, 0.0f);
 glm::vec3 cameraPosition(0.0f, 2.0f, 8.0f);
 glm::mat4 view = glm::lookAt(cameraPosition, cameraTarget, glm::vec3(0.0, 1.0, 0.0));
+glm::mat4 viewProjection = projection * view;
+
+const unsigned int CUBE_MESH = 0;
+
+//kocke s bojom i sjajnosti
+void BuildScene(Scene& scene)
+{
+    struct CubeDesc
+    {
+        glm::vec3 position;
+        glm::vec3 color;
+        float specularStrength;
+    };
+
+    const CubeDesc cubes[] = {
+        { glm::vec3(-2.0f, 0.0f, 0.0f), glm::vec3(0.5f, 0.5f, 0.5f), 0.5f },
+        { glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.5f, 0.31f), 1.0f },
+        { glm::vec3(0.0f, 1.6f, 0.0f), glm::vec3(0.5f, 0.5f, 0.5f), 0.3f },
+        { glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), 0.9f },
+        { glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.5f, 0.5f, 0.5f), 0.3f },
+        { glm::vec3(0.0f, -1.6f, 0.0f), glm::vec3(0.5f, 0.5f, 0.1f), 0.3f },
+        { glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.5f, 0.5f, 0.5f), 0.3f },
+        { glm::vec3(2.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), 0.3f }
+    };
+
+    for (const CubeDesc& cube : cubes)
+    {
+        Entity entity = scene.CreateEntity(cube.position);
+        scene.SetScale(entity, glm::vec3(0.5f));
+        scene.SetMaterial(entity, cube.color, cube.specularStrength);
+        scene.SetMesh(entity, CUBE_MESH);
+    }
+}
+
+
+//nasumicna tockasta svjetla oko kocki za klasterirano osvjetljenje
+std::vector<PointLight> MakeLights(unsigned int count)
+{
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    std::vector<PointLight> lights(count);
+    for (PointLight& light : lights)
+    {
+        light.position = glm::vec3(unit(random) * 8.0f - 4.0f, unit(random) * 5.0f - 2.0f, unit(random) * 8.0f - 4.0f);
+        light.radius = 1.5f + unit(random) * 1.5f;
+        light.color = glm::vec3(unit(random), unit(random), unit(random));
+        light.intensity = 1.0f;
+    }
+    return lights;
+}
+
+
+//crta scenu software backendom bez prozora i GL-a; vrijeme ide u koracima od 1/60 s pa je slika ponovljiva
+//zadnji frame se sprema u outputPath, a uz zlatnu sliku se usporeduje i vraca 1 ako je izvan margine (MatchesGolden)
+int RenderSoftware(unsigned int frames, const std::string& outputPath, const std::string& referencePath)
+{
+    JobSystem jobs;
+    Renderer render(RenderBackend::Software, SCR_WIDTH, SCR_HEIGHT, &jobs);
+    const SoftwareRasterizer& raster = *render.GetSoftwareRasterizer();
+
+    std::vector<Vertex> vertices;
+    std::vector<int> indices;
+    Mesh::LoadMesh("res/models/kocka.obj", vertices, indices);
+    if (indices.empty())
+    {
+        std::cerr << "SOFTWARE BACKEND NEEDS res/models/kocka.obj" << std::endl;
+        return 1;
+    }
+
+    Scene scene;
+    BuildScene(scene);
+    scene.UpdateTransforms(&jobs);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (unsigned int frame = 0; frame < frames; frame++)
+    {
+        float t = frame / 60.0f;
+        glm::vec3 lightPos(sin(t) * radius, 5.0f, cos(t) * radius);
+        glm::vec3 lightColor = glm::mix(glm::vec3(0.9f, 0.1f, 0.1f), glm::vec3(0.1f, 0.9f, 0.1f), (sin(t) + 1.0f) / 2.0f);
+
+        render.Clear();
+        render.SetLight(lightPos, lightColor, cameraPosition);
+        render.BeginMainPass();
+        for (Entity entity = 0; entity < scene.GetEntityCount(); entity++)
+        {
+            SoftwareDrawUniforms uniforms;
+            uniforms.model = scene.GetWorldMatrix(entity);
+            uniforms.mvp = viewProjection * uniforms.model;
+            uniforms.normalMatrix = glm::mat3(glm::transpose(glm::inverse(uniforms.model)));
+            uniforms.objectColor = scene.GetColor(entity);
+            uniforms.specularStrength = scene.GetSpecularStrength(entity);
+            render.Draw(vertices, indices, uniforms);
+        }
+        render.EndMainPass();
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+    const SoftwareRasterStats& stats = raster.GetStats();
+    std::cout << "Software backend: " << frames << " frames, " << elapsed.count() / frames << " ms/frame ("
+        << stats.geometryMs / frames << " geometry, " << stats.rasterMs / frames << " raster), "
+        << stats.shadedPixels / frames << " shaded pixels/frame, " << jobs.GetThreadCount() << " threads" << std::endl;
+
+    raster.SaveImage(outputPath);
+    if (referencePath.empty())
+        return 0;
+
+    unsigned int width = 0, height = 0;
+    std::vector<std::uint32_t> reference;
+    if (!SoftwareRasterizer::LoadImage(referencePath, width, height, reference) || width != SCR_WIDTH || height != SCR_HEIGHT)
+    {
+        std::cerr << "REFERENCE IMAGE DOES NOT MATCH " << SCR_WIDTH << "x" << SCR_HEIGHT << ": " << referencePath << std::endl;
+        return 1;
+    }
+
+    ImageDifference difference = SoftwareRasterizer::CompareImages(raster.GetColorBuffer(), reference);
+    bool matches = SoftwareRasterizer::MatchesGolden(difference);
+    std::cout << "Reference " << referencePath << ": PSNR " << difference.psnr << " dB, max difference " << difference.maxDifference
+        << ", " << difference.differentPixels << " pixels off by more than " << SoftwareRasterizer::GOLDEN_TOLERANCE
+        << (matches ? "" : " - DOES NOT MATCH") << std::endl;
+    return matches ? 0 : 1;
+}
+
+
+//kuha sve slike iz res/textures u .ctex uz izvor, Texture ih nakon toga ucitava bez dekodiranja PNG/JPEG-a
+int CookTextures(const std::string& formatName)
+{
+    TextureFormat format;
+    if (!TextureCooker::ParseFormat(formatName, format))
+    {
+        std::cerr << "UNKNOWN TEXTURE FORMAT: " << formatName << std::endl;
+        return 1;
+    }
+
+    JobSystem jobs;
+    TextureCooker cooker(&jobs);
+    std::size_t uncompressed = 0, compressed = 0;
+    for (const auto& entry : std::filesystem::directory_iterator("res/textures"))
+    {
+        std::string extension = entry.path().extension().string();
+        if (extension != ".png" && extension != ".jpg")
+            continue;
+
+        std::string path = entry.path().generic_string();
+        if (!cooker.CookFile(path, TextureCooker::GetCookedPath(path), format))
+            return 1;
+
+        const TextureCookStats& stats = cooker.GetStats();
+        uncompressed += stats.uncompressedBytes;
+        compressed += stats.compressedBytes;
+        std::cout << path << " " << stats.width << "x" << stats.height << " " << TextureCooker::GetFormatName(format) << ", "
+            << stats.levels << " levels, " << stats.GetMpixPerSecond() << " Mpix/s, PSNR " << stats.psnr << " dB, "
+            << stats.GetSavedBytes() / 1024 << " KB VRAM saved" << std::endl;
+    }
+
+    std::cout << "VRAM " << uncompressed / 1024 << " KB -> " << compressed / 1024 << " KB (" << jobs.GetThreadCount() << " threads)" << std::endl;
+    return 0;
+}
+
 
+//pakira sve ispod root u jedan pack koji --pack montira umjesto pojedinacnih datoteka
+int BuildAssetPack(const std::string& root, const std::string& output)
+{
+    JobSystem jobs;
+    AssetPackBuildStats stats;
+    if (!AssetPack::Build(root, output, AssetPackBuildOptions(), stats, &jobs))
+        return 1;
+
+    std::cout << output << ": " << stats.files << " files (" << stats.compressedFiles << " compressed), "
+        << stats.rawBytes / 1024 << " KB -> " << stats.packBytes / 1024 << " KB in " << stats.totalMs << " ms" << std::endl;
+    return 0;
+}
 
-//boje objekata
-glm::vec3 objectColor[] = {
-    glm::vec3(0.5f, 0.5f, 0.5f),
-    glm::vec3(1.0f, 0.5f, 0.31f),
-    glm::vec3(0.5f, 0.5f, 0.5f),
-    glm::vec3(0.0f, 1.0f, 0.0f),
-    glm::vec3(0.5f, 0.5f, 0.5f),
-    glm::vec3(0.5f, 0.5f, 0.1f),
-    glm::vec3(0.5f, 0.5f, 0.5f),
-    glm::vec3(1.0f, 0.0f, 0.0f)
-};
-
-//sjajnost objekata
-float specularStrength[] = {
-    0.5f,
-    1.0f,
-    0.3f,
-    0.9f,
-    0.3f,
-    0.3f,
-    0.3f,
-    0.3f
-};
-
-
-int main()
+
+int main(int argc, char** argv)
 {
+    if (argc > 1 && std::string(argv[1]) == "--bench")
+        return RunBenchmarks(argc > 2 ? argv[2] : "");
+    //--cook [bc1|bc3|bc7] kuha teksture u blok kompresirane .ctex datoteke pa izlazi
+    if (argc > 1 && std::string(argv[1]) == "--cook")
+        return CookTextures(argc > 2 ? argv[2] : "bc7");
+    //--build-pack [direktorij] [pack] pakira res/ u assets.pak pa izlazi
+    if (argc > 1 && std::string(argv[1]) == "--build-pack")
+        return BuildAssetPack(argc > 2 ? argv[2] : "res", argc > 3 ? argv[3] : "assets.pak");
+
+    //--render-thread [dubina] ukljucuje zasebnu render dretvu
+    //--lights N ukljucuje klasterirano osvjetljenje s N tockastih svjetala, --deferred odgodeno sjencanje
+    //--depth-prepass ukljucuje depth pre-pass, --prepass-bench [N] mjeri N frameova bez i N s pre-passom pa izlazi
+    //--shadows ukljucuje kaskadne sjene sunca, --no-shadow-cache iskljucuje cache staticnih bacaca
+    //--software [N] crta N frameova software backendom bez prozora i sprema software.ppm, --reference slika.ppm ga usporeduje
+    //bez N crta jedan frame i usporeduje ga sa zlatnom res/reference/software.ppm (izlazni kod 1 ako se ne poklapa)
+    //--bake [N] pri ucitavanju pece ambijentalnu okluziju i irradijanciju neba po vrhu s N zraka
+    //--stream-textures [KB] puni teksture kroz PBO-ove s najvise KB kilobajta po frameu
+    //--texture-budget [KB] drzi rezidentne samo mip nivoe koje scena treba, u najvise KB kilobajta alociranog VRAM-a
+    //--virtual-texture [slika] crta kocke s virtualnom teksturom koja se puni po stranicama iz feedback prolaza
+    //--pack [pack] cita shadere, modele i teksture iz packa (--build-pack), ono cega u njemu nema s diska
+    //--texture-array pakira sve teksture u nizove i atlase pa se tekstura veze jednom po passu umjesto po drawu
+    //--async-io [dubina] uz --texture-array cita slike skupno (io_uring ili pread dretve) s najvise dubina citanja u letu
+    //--cooked [direktorij] ucitava model i teksturu iz izlaza assetcook-a (.cmesh, .ctex) ako ondje postoje
+    bool useRenderThread = false;
+    bool useDeferred = false;
+    bool useDepthPrePass = false;
+    bool useShadows = false;
+    bool shadowCache = true;
+    bool useTextureArray = false;
+    unsigned int pipelineDepth = 2;
+    unsigned int asyncQueueDepth = 0;
+    unsigned int lightCount = 0;
+    unsigned int prePassBenchFrames = 0;
+    unsigned int bakeSamples = 0;
+    unsigned int softwareFrames = 0;
+    unsigned int streamKilobytes = 0;
+    unsigned int budgetKilobytes = 0;
+    std::string referencePath;
+    std::string virtualTexturePath;
+    std::string cookedDirectory;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::string(argv[i]) == "--render-thread")
+        {
+            useRenderThread = true;
+            if (i + 1 < argc && std::isdigit((unsigned char)argv[i + 1][0]))
+                pipelineDepth = std::stoi(argv[++i]);
+        }
+        else if (std::string(argv[i]) == "--lights" && i + 1 < argc)
+        {
+            lightCount = std::stoi(argv[++i]);
+        }
+        else if (std::string(argv[i]) == "--deferred")
+        {
+            useDeferred = true;
+        }
+        else if (std::string(argv[i]) == "--depth-prepass")
+        {
+            useDepthPrePass = true;
+        }
+        else if (std::string(argv[i]) == "--shadows")
+        {
+            useShadows = true;
+        }
+        else if (std::string(argv[i]) == "--no-shadow-cache")
+        {
+            shadowCache = false;
+        }
+        else if (std::string(argv[i]) == "--prepass-bench")
+        {
+            prePassBenchFrames = 300;
+            if (i + 1 < argc && std::isdigit((unsigned char)argv[i + 1][0]))
+                prePassBenchFrames = std::stoi(argv[++i]);
+        }
+        else if (std::string(argv[i]) == "--software")
+        {
+            softwareFrames = 1;
+            if (i + 1 < argc && std::isdigit((unsigned char)argv[i + 1][0]))
+                softwareFrames = std::stoi(argv[++i]);
+            else if (referencePath.empty())
+                referencePath = "res/reference/software.ppm";
+        }
+        else if (std::string(argv[i]) == "--reference" && i + 1 < argc)
+        {
+            referencePath = argv[++i];
+        }
+        else if (std::string(argv[i]) == "--bake")
+        {
+            bakeSamples = 64;
+            if (i + 1 < argc && std::isdigit((unsigned char)argv[i + 1][0]))
+                bakeSamples = std::stoi(argv[++i]);
+        }
+        else if (std::string(argv[i]) == "--stream-textures")
+        {
+            streamKilobytes = 256;
+            if (i + 1 < argc && std::isdigit((unsigned char)argv[i + 1][0]))
+                streamKilobytes = std::stoi(argv[++i]);
+        }
+        else if (std::string(argv[i]) == "--texture-budget")
+        {
+            budgetKilobytes = 512;
+            if (i + 1 < argc && std::isdigit((unsigned char)argv[i + 1][0]))
+                budgetKilobytes = std::stoi(argv[++i]);
+        }
+        else if (std::string(argv[i]) == "--virtual-texture")
+        {
+            virtualTexturePath = "res/textures/awesomeface.png";
+            if (i + 1 < argc && std::string(argv[i + 1]).compare(0, 2, "--") != 0)
+                virtualTexturePath = argv[++i];
+        }
+        else if (std::string(argv[i]) == "--texture-array")
+        {
+            useTextureArray = true;
+        }
+        else if (std::string(argv[i]) == "--async-io")
+        {
+            asyncQueueDepth = 32;
+            if (i + 1 < argc && std::isdigit((unsigned char)argv[i + 1][0]))
+                asyncQueueDepth = std::stoi(argv[++i]);
+        }
+        else if (std::string(argv[i]) == "--pack")
+        {
+            std::string packPath = "assets.pak";
+            if (i + 1 < argc && std::string(argv[i + 1]).compare(0, 2, "--") != 0)
+                packPath = argv[++i];
+            if (!FileSystem::Mount(packPath))
+                return 1;
+        }
+        else if (std::string(argv[i]) == "--cooked")
+        {
+            cookedDirectory = "cooked";
+            if (i + 1 < argc && std::string(argv[i + 1]).compare(0, 2, "--") != 0)
+                cookedDirectory = argv[++i];
+        }
+    }
+
+    if (softwareFrames > 0)
+        return RenderSoftware(softwareFrames, "software.ppm", referencePath);
+
     Window window("Vjezba5", SCR_WIDTH, SCR_HEIGHT);
 
     glEnable(GL_DEPTH_TEST);
 
-    Model model("res/models/kocka.obj");
-    Model lightModel("res/models/kocka.obj");
+    auto loadStart = std::chrono::high_resolution_clock::now();
+    auto resolveAsset = [&](const std::string& path) { return cookedDirectory.empty() ? path : AssetCooker::Resolve("res", cookedDirectory, path); };
+    const std::string modelPath = resolveAsset("res/models/kocka.obj");
+    const std::string texturePath = resolveAsset("res/textures/container.jpg");
+    Model model(modelPath);
+    Model lightModel(modelPath);
     Shader shader("res/shaders/vShader.glsl", "res/shaders/fShader.glsl");
-    Texture tex("res/textures/container.jpg");
+    JobSystem jobs;
+    std::unique_ptr<TextureStreamer> textureStreamer;
+    std::unique_ptr<TextureResidency> textureResidency;
+    std::unique_ptr<Texture> texture;
+    if (budgetKilobytes > 0)
+    {
+        textureStreamer = std::make_unique<TextureStreamer>((std::size_t)(streamKilobytes > 0 ? streamKilobytes : 256) * 1024, &jobs);
+        textureResidency = std::make_unique<TextureResidency>((std::size_t)budgetKilobytes * 1024, textureStreamer.get());
+        texture = std::make_unique<Texture>(texturePath, *textureResidency, &jobs);
+    }
+    else if (streamKilobytes > 0)
+    {
+        textureStreamer = std::make_unique<TextureStreamer>((std::size_t)streamKilobytes * 1024, &jobs);
+        texture = std::make_unique<Texture>(texturePath, *textureStreamer, &jobs);
+    }
+    else
+    {
+        texture = std::make_unique<Texture>(texturePath, &jobs);
+    }
+    const Texture& tex = *texture;
+    std::chrono::duration<double, std::milli> loadTime = std::chrono::high_resolution_clock::now() - loadStart;
+    std::cout << "assets loaded in " << loadTime.count() << " ms from " << (FileSystem::GetMountCount() > 0 ? "pack" : "loose files")
+        << (modelPath != "res/models/kocka.obj" || texturePath != "res/textures/container.jpg" ? " (cooked)" : "") << std::endl;
 
     Renderer render;
+    render.SetDepthPrePass(useDepthPrePass);
+
+    std::unique_ptr<Shader> clusteredShader;
+    std::unique_ptr<ClusteredLighting> clusters;
+    std::unique_ptr<RingBuffer> frameData;
+    std::unique_ptr<DeferredRenderer> deferred;
+    //frameovi kad ring buffer nije imao mjesta pa je crtano obicnim shaderom, i reference svjetala odbacene zbog punih klastera
+    unsigned long long clusterFrames = 0, clusterFallbackFrames = 0, clusterDroppedLights = 0, clusterOverflowFrames = 0;
+    std::vector<PointLight> lights;
+    if (useDeferred)
+    {
+        deferred = std::make_unique<DeferredRenderer>(SCR_WIDTH, SCR_HEIGHT);
+        lights = MakeLights(lightCount > 0 ? lightCount : 64);
+    }
+    else if (lightCount > 0)
+    {
+        clusteredShader = std::make_unique<Shader>("res/shaders/vShader.glsl", "res/shaders/fShaderClustered.glsl");
+        clusters = std::make_unique<ClusteredLighting>();
+        clusters->SetProjection(projection, 0.1f, 100.0f);
+        frameData = std::make_unique<RingBuffer>(4 * 1024 * 1024);
+        lights = MakeLights(lightCount);
+    }
+
+    Scene scene;
+    BuildScene(scene);
+    const Model* meshes[] = { &model };
+    std::vector<glm::vec4> meshBounds = { model.GetMesh().GetBoundingSphere() };
+
+    //sjene: pod i sve kocke su staticne osim zelene koja se okrece
+    const glm::vec3 sunDirection = glm::normalize(glm::vec3(-0.4f, -1.0f, -0.3f));
+    const Entity spinningCube = 3;
+    std::unique_ptr<Shader> shadowedShader;
+    std::unique_ptr<CascadedShadowMaps> shadows;
+    unsigned long long shadowFrames = 0, shadowDrawCalls = 0, shadowCascades = 0;
+    if (useShadows && !useDeferred)
+    {
+        Entity floor = scene.CreateEntity(glm::vec3(0.0f, -2.2f, 0.0f));
+        scene.SetScale(floor, glm::vec3(12.0f, 0.2f, 12.0f));
+        scene.SetMaterial(floor, glm::vec3(0.6f, 0.6f, 0.6f), 0.1f);
+        scene.SetMesh(floor, CUBE_MESH);
+
+        for (Entity entity = 0; entity < scene.GetEntityCount(); entity++)
+            scene.SetStatic(entity, entity != spinningCube);
+
+        shadowedShader = std::make_unique<Shader>("res/shaders/vShader.glsl", "res/shaders/fShaderShadowed.glsl");
+        shadows = std::make_unique<CascadedShadowMaps>();
+        shadows->SetCamera(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 30.0f);
+        shadows->SetCaching(shadowCache);
+    }
+
+    //virtualna tekstura zamjenjuje osnovni shader, uz klastere, sjene i deferred se ne koristi
+    std::unique_ptr<VirtualTexture> virtualTexture;
+    std::unique_ptr<Shader> virtualShader;
+    if (!virtualTexturePath.empty() && !useDeferred && !clusters && !shadows)
+    {
+        virtualTexture = std::make_unique<VirtualTexture>(virtualTexturePath, SCR_WIDTH, SCR_HEIGHT, VirtualTextureSettings(), &jobs);
+        if (virtualTexture->IsValid())
+            virtualShader = std::make_unique<Shader>("res/shaders/vShader.glsl", "res/shaders/fShaderVirtual.glsl");
+        else
+            virtualTexture.reset();
+    }
+
+    //peceni ambient po entitetu; scena je staticna osim kocke koja se okrece pa je pecenje jednom dovoljno
+    std::unique_ptr<LightBaker> baker;
+    if (bakeSamples > 0)
+    {
+        scene.UpdateTransforms(&jobs);
+
+        LightBakeSettings bakeSettings;
+        bakeSettings.samples = bakeSamples;
+        bakeSettings.skyColor = glm::vec3(1.2f, 1.25f, 1.4f);
+        bakeSettings.groundColor = glm::vec3(0.35f, 0.3f, 0.25f);
+
+        baker = std::make_unique<LightBaker>();
+        baker->BuildOccluders(scene, meshes);
+        baker->BakeScene(scene, meshes, bakeSettings, &jobs);
+        baker->Upload();
+
+        const LightBakeStats& bakeStats = baker->GetStats();
+        std::cout << "Baked " << bakeStats.vertices << " vertices, " << bakeStats.rays << " rays in " << bakeStats.bakeMs << " ms ("
+            << bakeStats.GetMraysPerSecond() << " Mrays/s, " << bakeStats.threads << " threads)" << std::endl;
+    }
+
+    //entiteti redom dijele teksture iz res/textures, a crtaju se grupirani po nizu
+    std::unique_ptr<TexturePacker> texturePacker;
+    std::vector<int> entityTextures;
+    std::vector<Entity> drawOrder(scene.GetEntityCount());
+    for (Entity entity = 0; entity < scene.GetEntityCount(); entity++)
+        drawOrder[entity] = entity;
+    if (useTextureArray)
+    {
+        std::vector<std::string> paths;
+        for (const auto& entry : std::filesystem::directory_iterator("res/textures"))
+        {
+            std::string extension = entry.path().extension().string();
+            if (extension == ".png" || extension == ".jpg")
+                paths.push_back(entry.path().generic_string());
+        }
+
+        //sve slike se dekodiraju odjednom na radnim dretvama, uz --async-io dekodiranje krece cim pojedina datoteka stigne
+        std::unique_ptr<AsyncIO> io;
+        if (asyncQueueDepth > 0)
+        {
+            AsyncIOSettings ioSettings;
+            ioSettings.queueDepth = asyncQueueDepth;
+            io = std::make_unique<AsyncIO>(ioSettings);
+        }
+        ImageDecoder decoder(&jobs, io.get());
+        std::vector<DecodedImage> images;
+        decoder.Decode(paths, images);
+        const ImageDecodeStats& decodeStats = decoder.GetStats();
+        std::cout << "Decoded " << decodeStats.images - decodeStats.failed << " images in " << decodeStats.wallMs << " ms ("
+            << decodeStats.GetMpixPerSecondPerCore() << " Mpix/s per core, " << decodeStats.threads << " threads)" << std::endl;
+        if (io)
+        {
+            const AsyncIOStats& ioStats = io->GetStats();
+            std::cout << "Read " << ioStats.bytes / 1024 << " KB through " << AsyncIO::GetBackendName(io->GetBackend()) << " (depth "
+                << io->GetQueueDepth() << ") in " << ioStats.blockReads << " reads, " << ioStats.submitCalls << " submits" << std::endl;
+        }
+
+        texturePacker = std::make_unique<TexturePacker>(2048, 8, &jobs);
+        std::vector<int> handles;
+        for (const DecodedImage& image : images)
+        {
+            int handle = image.IsValid() ? texturePacker->Add(image.pixels.data(), image.width, image.height) : -1;
+            if (handle >= 0)
+                handles.push_back(handle);
+        }
+
+        if (!handles.empty() && texturePacker->Pack())
+        {
+            texturePacker->Upload();
+            for (Entity entity = 0; entity < scene.GetEntityCount(); entity++)
+                entityTextures.push_back(handles[entity % handles.size()]);
+            std::stable_sort(drawOrder.begin(), drawOrder.end(), [&](Entity a, Entity b)
+            {
+                return texturePacker->GetRegion(entityTextures[a]).array < texturePacker->GetRegion(entityTextures[b]).array;
+            });
+
+            const TexturePackStats& packStats = texturePacker->GetStats();
+            std::cout << "Packed " << packStats.textures << " textures into " << packStats.arrays << " arrays (" << packStats.layers << " layers, "
+                << packStats.atlasPages << " atlas pages, " << packStats.atlasOccupancy * 100.0f << "% occupancy), "
+                << packStats.bytes / 1024 << " KB in " << packStats.packMs << " ms" << std::endl;
+        }
+        else
+        {
+            texturePacker.reset();
+        }
+    }
+    unsigned long long textureBinds = 0, textureBindFrames = 0;
+
+    //DrawData svih entiteta i svjetla po frameu, slot je poravnat na GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT koji nije veci od 256
+    RingBuffer drawData((scene.GetEntityCount() + 1) * 256);
+
+    std::unique_ptr<RenderThread> renderThread;
+    if (useRenderThread)
+        renderThread = std::make_unique<RenderThread>(window, pipelineDepth);
 
-    while (!window.isClosed())
+    //[0] bez pre-passa, [1] s pre-passom; prvi frame svake polovice se preskace jer upiti kasne jedan frame
+    struct PrePassBenchmark
     {
+        unsigned long long fragments[2] = { 0, 0 };
+        double gpuMs[2] = { 0.0, 0.0 };
+        unsigned int frames[2] = { 0, 0 };
+    } prePassBench;
+
+    unsigned long long frame = 0;
+    while (!window.isClosed() && (prePassBenchFrames == 0 || frame < 2ull * prePassBenchFrames + 2))
+    {
+        auto simulateStart = std::chrono::high_resolution_clock::now();
         window.ProcessInput();
-        render.Clear();
+        if (shadows)
+            scene.SetRotation(spinningCube, glm::angleAxis((float)glfwGetTime(), glm::vec3(0.0f, 1.0f, 0.0f)));
+        scene.UpdateTransforms(&jobs);
 
-        float camX = sin(glfwGetTime()) * radius;
-        float camZ = cos(glfwGetTime()) * radius;
+        float t = glfwGetTime();
+        float camX = sin(t) * radius;
+        float camZ = cos(t) * radius;
 
         glm::vec3 lightPos(camX, 5.0f, camZ);
 
-        shader.Bind();
-        shader.SetUniform4x4("projection", projection);
-        shader.SetUniform4x4("view", view);
-
-		float t = glfwGetTime();
         float mixValue = (sin(t) + 1.0f) / 2.0f; // varies between 0.0 and 1.0 over time
         glm::vec3 lightColor = glm::mix(
             glm::vec3(0.9f, 0.1f, 0.1f),
             glm::vec3(0.1f, 0.9f, 0.1f),
-			mixValue
+            mixValue
         );
 
-        shader.SetUniformVec3("lightColor", lightColor);
-        shader.SetUniformVec3("lightPos", lightPos);
-        shader.SetUniformVec3("viewPos", cameraPosition);
-
-        lightModel.Draw(shader, tex);
+        std::vector<PointLight> frameLights = lights;
+        glm::mat4 lightRotation = glm::rotate(glm::mat4(1.0f), t * 0.5f, glm::vec3(0.0f, 1.0f, 0.0f));
+        for (PointLight& light : frameLights)
+            light.position = glm::vec3(lightRotation * glm::vec4(light.position, 1.0f));
 
-        unsigned int cubeCount = sizeof(cubePositions) / sizeof(cubePositions[0]);
+        //MVP i matrice normala za sve objekte racunaju se odjednom na CPU-u
+        std::size_t entityCount = scene.GetEntityCount();
+        std::vector<glm::mat4> mvps(entityCount);
+        std::vector<glm::mat3x4> normalMatrices(entityCount);
+        BatchMath::MultiplyMatrices(viewProjection, scene.GetWorldMatrices().data(), entityCount, mvps.data(), sizeof(glm::mat4));
+        BatchMath::ComputeNormalMatrices(scene.GetWorldMatrices().data(), entityCount, normalMatrices.data(), sizeof(glm::mat3x4));
+        SceneSnapshot sceneSnapshot;
+        scene.Snapshot(sceneSnapshot);
 
-        for (unsigned int i = 0; i < cubeCount; i++)
+        //sve sto frame treba kopira se u lambdu kako bi simulacija sljedeceg framea mogla krenuti odmah;
+        //render ne smije citati scene jer je glavna dretva vec mijenja za sljedeci frame
+        auto renderFrame = [&, lightPos, lightColor, mvps = std::move(mvps), normalMatrices = std::move(normalMatrices),
+            frameLights = std::move(frameLights), frameScene = std::move(sceneSnapshot), currentFrame = frame]()
         {
-            glm::mat4 mat_model = glm::mat4(1.0f);
-            mat_model = glm::translate(mat_model, cubePositions[i]);
-            mat_model = glm::scale(mat_model, glm::vec3(0.5f));
-            
-            shader.SetUniform4x4("model", mat_model);
-            shader.SetUniformVec3("objectColor", objectColor[i]);
-            shader.SetUniformFloat("specularStrength", specularStrength[i]);
+            //najfiniji nivo koji treba bilo koji entitet, iz projicirane velicine njegove sfere
+            if (textureResidency)
+            {
+                for (Entity entity = 0; entity < frameScene.GetEntityCount(); entity++)
+                {
+                    const glm::mat4& world = frameScene.GetWorldMatrix(entity);
+                    glm::vec4 sphere = meshBounds[frameScene.GetMesh(entity)];
+                    float scale = std::max(glm::length(glm::vec3(world[0])), std::max(glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2]))));
+                    float pixels = TextureResidency::GetProjectedSize(glm::vec3(world * glm::vec4(glm::vec3(sphere), 1.0f)), sphere.w * scale,
+                        cameraPosition, glm::radians(45.0f), (float)SCR_HEIGHT);
+                    textureResidency->Request(tex.GetResidencyKey(), TextureResidency::GetRequiredLevel(tex.GetWidth(), tex.GetHeight(), pixels));
+                }
+                textureResidency->Update();
+            }
+            if (textureStreamer)
+                textureStreamer->Update();
+            textureBindFrames++;
+
+            //DrawData svih entiteta ide jednom u ring buffer, glavni i feedback prolaz snimaju samo naredbe s rasponom u njemu
+            drawData.BeginFrame();
+            auto writeDrawData = [&](const DrawData& data)
+            {
+                BufferSlice slice = drawData.AllocateUniform(sizeof(DrawData));
+                if (slice.IsValid())
+                    std::memcpy(slice.data, &data, sizeof(DrawData));
+                return slice;
+            };
+            std::vector<BufferSlice> drawSlices(frameScene.GetEntityCount());
+            for (Entity entity = 0; entity < frameScene.GetEntityCount(); entity++)
+            {
+                DrawData data;
+                data.model = frameScene.GetWorldMatrix(entity);
+                data.mvp = mvps[entity];
+                data.normalMatrix = normalMatrices[entity];
+                data.colorSpecular = glm::vec4(frameScene.GetColor(entity), frameScene.GetSpecularStrength(entity));
+                data.uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+                data.textureLayer = glm::vec4(0.0f);
+                if (texturePacker)
+                {
+                    const TextureRegion& region = texturePacker->GetRegion(entityTextures[entity]);
+                    data.uvRect = region.uvRect;
+                    data.textureLayer.x = (float)region.layer;
+                }
+                drawSlices[entity] = writeDrawData(data);
+            }
 
+            auto drawEntities = [&](const Shader& activeShader)
+            {
+                //s nizovima se tekstura mijenja samo izmedu nizova, ponovljena vezanja iste teksture preskace Renderer
+                activeShader.Bind();
+                activeShader.SetUniformInt("useTextureArray", texturePacker ? 1 : 0);
+                render.BeginCommands(1, 1);
+                CommandBuffer& commands = render.GetCommandBuffer(0, 0);
+                for (Entity entity : drawOrder)
+                {
+                    if (!drawSlices[entity].IsValid())
+                        continue;
 
-            model.Draw(shader, tex);
+                    const Model& mesh = *meshes[frameScene.GetMesh(entity)];
+                    if (baker)
+                        baker->Record(commands, mesh.GetMesh(), entity);
+
+                    if (texturePacker)
+                    {
+                        commands.BindTextureArray(0, texturePacker->GetTexture(texturePacker->GetRegion(entityTextures[entity]).array));
+                        mesh.Record(commands, activeShader, drawSlices[entity]);
+                    }
+                    else
+                    {
+                        mesh.Record(commands, activeShader, tex, drawSlices[entity]);
+                    }
+                }
+                render.Submit();
+                textureBinds += render.GetStats().textureBinds;
+                activeShader.SetUniformInt("useTextureArray", 0);
+            };
+
+            if (deferred)
+            {
+                deferred->BeginGeometryPass();
+                drawEntities(deferred->GetGeometryShader());
+                deferred->EndGeometryPass();
+
+                deferred->LightingPass(frameLights, viewProjection, cameraPosition);
+                deferred->Composite(lightColor, glm::vec3(0.2f, 0.3f, 0.3f));
+                drawData.EndFrame();
+                return;
+            }
+
+            if (prePassBenchFrames > 0)
+            {
+                int half = currentFrame <= prePassBenchFrames ? 0 : 1;
+                if (currentFrame == 0 || currentFrame == prePassBenchFrames + 1)
+                {
+                    render.SetDepthPrePass(half == 1);
+                }
+                else
+                {
+                    prePassBench.fragments[half] += render.GetPassStats().shadedFragments;
+                    prePassBench.gpuMs[half] += render.GetPassStats().gpuMs;
+                    prePassBench.frames[half]++;
+                }
+            }
+
+            if (shadows)
+            {
+                shadows->Update(frameScene, meshBounds, view, sunDirection);
+                shadows->Render(meshes);
+
+                shadowFrames++;
+                shadowDrawCalls += shadows->GetStats().drawCalls;
+                shadowCascades += shadows->GetStats().refreshedCascades;
+            }
+
+            if (virtualTexture)
+            {
+                const Shader& feedbackShader = virtualTexture->BeginFeedback();
+                render.BeginCommands(1, 1);
+                for (Entity entity = 0; entity < frameScene.GetEntityCount(); entity++)
+                {
+                    if (drawSlices[entity].IsValid())
+                        meshes[frameScene.GetMesh(entity)]->Record(render.GetCommandBuffer(0, 0), feedbackShader, drawSlices[entity]);
+                }
+                render.Submit();
+                virtualTexture->EndFeedback();
+            }
+
+            render.Clear();
+
+            //svjetlo je mala kocka na lightPos u boji svjetla
+            glm::mat4 lightWorld = glm::scale(glm::translate(glm::mat4(1.0f), lightPos), glm::vec3(0.2f));
+
+            //i kocka svjetla mora upisati dubinu, inace glavni prolaz s GL_EQUAL odbaci sve njezine fragmente
+            if (const Shader* depthShader = render.BeginDepthPrePass())
+            {
+                for (Entity entity = 0; entity < frameScene.GetEntityCount(); entity++)
+                {
+                    depthShader->SetUniform4x4("mvp", mvps[entity]);
+                    meshes[frameScene.GetMesh(entity)]->DrawDepth();
+                }
+                depthShader->SetUniform4x4("mvp", viewProjection * lightWorld);
+                lightModel.DrawDepth();
+            }
+            render.BeginMainPass();
+
+            //bez uploadanih SSBO-ova klasterirani shader bi citao stare ili nevezane buffere, pa frame ide obicnim shaderom
+            bool clustered = false;
+            if (clusters)
+            {
+                frameData->BeginFrame();
+                clusters->Build(frameLights, view, &jobs);
+                clustered = clusters->Upload(*frameData);
+
+                clusterFrames++;
+                clusterFallbackFrames += clustered ? 0 : 1;
+                clusterDroppedLights += clusters->GetStats().droppedLightReferences;
+                clusterOverflowFrames += clusters->GetStats().droppedLightReferences > 0 ? 1 : 0;
+            }
+
+            const Shader& activeShader = clustered ? *clusteredShader : shadows ? *shadowedShader : virtualShader ? *virtualShader : shader;
+            activeShader.Bind();
+
+            if (virtualTexture)
+                virtualTexture->Bind(activeShader, 2, 3);
+
+            if (shadows)
+            {
+                shadows->SetUniforms(activeShader, 1);
+                activeShader.SetUniform4x4("cameraView", view);
+                activeShader.SetUniformVec3("sunColor", glm::vec3(0.6f, 0.6f, 0.55f));
+            }
+
+            if (clustered)
+            {
+                clusters->SetUniforms(activeShader, view, (float)SCR_WIDTH, (float)SCR_HEIGHT);
+                activeShader.SetUniformInt("bruteForce", 0);
+                activeShader.SetUniformVec3("ambientColor", lightColor);
+            }
+            else
+            {
+                activeShader.SetUniformVec3("lightColor", lightColor);
+                activeShader.SetUniformVec3("lightPos", lightPos);
+            }
+            activeShader.SetUniformVec3("viewPos", cameraPosition);
+
+            DrawData lightData;
+            lightData.model = lightWorld;
+            lightData.mvp = viewProjection * lightWorld;
+            lightData.normalMatrix = glm::mat3x4(glm::transpose(glm::inverse(glm::mat3(lightWorld))));
+            lightData.colorSpecular = glm::vec4(lightColor, 0.0f);
+            lightData.uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+            lightData.textureLayer = glm::vec4(0.0f);
+            BufferSlice lightSlice = writeDrawData(lightData);
+            if (lightSlice.IsValid())
+            {
+                render.BeginCommands(1, 1);
+                if (texturePacker)
+                    lightModel.Record(render.GetCommandBuffer(0, 0), activeShader, lightSlice);
+                else
+                    lightModel.Record(render.GetCommandBuffer(0, 0), activeShader, tex, lightSlice);
+                render.Submit();
+                textureBinds += render.GetStats().textureBinds;
+            }
+
+            drawEntities(activeShader);
+
+            render.EndMainPass();
+
+            if (clusters)
+                frameData->EndFrame();
+            drawData.EndFrame();
+        };
+
+        if (renderThread)
+        {
+            FramePacket packet;
+            packet.frame = frame;
+            packet.simulateStart = simulateStart;
+            packet.render = renderFrame;
+            renderThread->Submit(std::move(packet));
+            window.PollEvents();
+        }
+        else
+        {
+            renderFrame();
+            window.SwapAndPoll();
         }
+        frame++;
+    }
+
+    if (renderThread)
+    {
+        RenderThreadStats stats = renderThread->GetStats();
+        std::cout << "render thread: depth " << renderThread->GetPipelineDepth()
+            << ", " << stats.FramesPerSecond() << " fps, latency avg " << stats.AverageLatencyMs()
+            << " ms, max " << stats.maxLatencyMs << " ms" << std::endl;
+        renderThread.reset();
+    }
+
+    if (clusterFrames > 0)
+    {
+        std::cout << "clustered lighting: " << clusterFrames << " frames, " << clusterFallbackFrames << " drawn without clusters (upload failed), "
+            << clusterOverflowFrames << " with full clusters (" << clusterDroppedLights << " light references dropped, max "
+            << ClusteredLighting::MAX_LIGHTS_PER_CLUSTER << " per cluster)" << std::endl;
+    }
+
+    if (shadows && shadowFrames > 0)
+    {
+        std::cout << "shadows (cache " << (shadows->IsCachingEnabled() ? "on" : "off") << "): "
+            << (double)shadowDrawCalls / shadowFrames << " draw calls/frame, "
+            << (double)shadowCascades / shadowFrames << " cascades refreshed/frame" << std::endl;
+    }
+
+    if (textureStreamer)
+    {
+        const TextureStreamStats& stats = textureStreamer->GetStats();
+        std::cout << "texture streaming: " << stats.uploadedBytes / 1024 << " KB over " << stats.uploadFrames << " frames, peak "
+            << stats.peakFrameBytes / 1024 << " KB/frame (budget " << textureStreamer->GetBytesPerFrame() / 1024 << "), max update "
+            << stats.maxUpdateMs << " ms, " << stats.completedTextures << " textures completed" << std::endl;
+    }
+
+    if (textureResidency)
+    {
+        const TextureResidencyStats& stats = textureResidency->GetStats();
+        std::cout << "texture residency: " << stats.residentBytes / 1024 << " KB resident (peak " << stats.peakResidentBytes / 1024
+            << ", VRAM budget " << stats.budgetBytes / 1024 << ", all levels " << stats.fullBytes / 1024 << " KB kept in RAM), "
+            << stats.mipRequests << " mip requests, " << stats.evictions << " evictions, " << stats.reallocations << " reallocations ("
+            << stats.copiedBytes / 1024 << " KB copied on GPU) over " << stats.frames << " frames" << std::endl;
+    }
+
+    if (virtualTexture)
+    {
+        const VirtualTextureStats& stats = virtualTexture->GetStats();
+        std::cout << "virtual texture: " << stats.residentPages << " pages resident, " << stats.totalUploads << " uploads, "
+            << stats.totalEvictions << " evictions over " << stats.frames << " frames, last frame " << stats.requestedPages
+            << " pages requested (" << stats.missingPages << " missing) in " << stats.lastProcessMs << " ms" << std::endl;
+    }
 
+    if (textureBindFrames > 0)
+    {
+        std::cout << "texture binds (" << (texturePacker ? "arrays" : "single texture") << "): "
+            << (double)textureBinds / textureBindFrames << "/frame" << std::endl;
+    }
 
-        window.SwapAndPoll();
+    if (prePassBenchFrames > 0)
+    {
+        const char* names[] = { "off", "on" };
+        for (int i = 0; i < 2; i++)
+        {
+            double frames = std::max(1u, prePassBench.frames[i]);
+            double fragments = prePassBench.fragments[i] / frames;
+            std::cout << "depth pre-pass " << names[i] << ": " << (unsigned long long)fragments << " shaded fragments/frame ("
+                << fragments / (SCR_WIDTH * SCR_HEIGHT) << " per pixel), GPU " << prePassBench.gpuMs[i] / frames << " ms" << std::endl;
+        }
     }
 
     window.CloseWindow();
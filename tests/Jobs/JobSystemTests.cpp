@@ -0,0 +1,181 @@
+#include "JobSystem.h"
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+//namijenjeno za build s -fsanitize=thread (tests/Makefile), podaci se namjerno pisu bez atomika
+//pa TSan javlja svaki posao koji nije uredno odvojen od citanja preko Wait ili ovisnosti
+
+static int s_Failures = 0;
+
+#define CHECK(condition) \
+	do { if (!(condition)) { std::cerr << "CHECK FAILED: " #condition " (" << __FILE__ << ":" << __LINE__ << ")" << std::endl; s_Failures++; } } while (0)
+
+static void TestRunWait(JobSystem& jobs)
+{
+	const unsigned int count = 4096;
+	std::vector<std::uint32_t> values(count, 0);
+	JobCounter counter;
+	for (unsigned int i = 0; i < count; i++)
+		jobs.Run([&values, i]() { values[i] = i * 3; }, &counter);
+	jobs.Wait(counter);
+
+	CHECK(counter.IsDone());
+	for (unsigned int i = 0; i < count; i++)
+		CHECK(values[i] == i * 3);
+}
+
+static void TestDependencies(JobSystem& jobs)
+{
+	for (int round = 0; round < 200; round++)
+	{
+		std::vector<int> data(64, 0);
+		int sum = 0;
+		JobCounter first, second, third;
+		//brojac bez predanih poslova je gotov, zato se lanac predaje redom
+		jobs.Run([&]() { for (std::size_t i = 0; i < data.size(); i++) data[i] = (int)i; }, &first);
+		jobs.Run([&]() { for (int& value : data) value *= 2; }, &second, &first);
+		jobs.Run([&]() { sum = std::accumulate(data.begin(), data.end(), 0); }, &third, &second);
+		jobs.Wait(third);
+
+		CHECK(first.IsDone() && second.IsDone());
+		CHECK(sum == 64 * 63);
+	}
+}
+
+static void TestParallelFor(JobSystem& jobs)
+{
+	const std::uint32_t count = 100000;
+	std::vector<std::uint32_t> values(count, 0);
+	jobs.ParallelFor(count, 1000, [&values](std::uint32_t begin, std::uint32_t end)
+	{
+		for (std::uint32_t i = begin; i < end; i++)
+			values[i] = i + 1;
+	});
+	for (std::uint32_t i = 0; i < count; i++)
+		CHECK(values[i] == i + 1);
+
+	//ugnijezdeni ParallelFor: vanjski poslovi cekaju unutarnje i pritom ih izvode
+	std::vector<std::uint32_t> grid(64 * 64, 0);
+	jobs.ParallelFor(64, 1, [&jobs, &grid](std::uint32_t rowBegin, std::uint32_t rowEnd)
+	{
+		for (std::uint32_t row = rowBegin; row < rowEnd; row++)
+		{
+			jobs.ParallelFor(64, 8, [&grid, row](std::uint32_t begin, std::uint32_t end)
+			{
+				for (std::uint32_t column = begin; column < end; column++)
+					grid[row * 64 + column] = row ^ column;
+			});
+		}
+	});
+	for (std::uint32_t i = 0; i < grid.size(); i++)
+		CHECK(grid[i] == ((i / 64) ^ (i % 64)));
+}
+
+static void TestStealing(JobSystem& jobs)
+{
+	//svi poslovi nastaju na jednoj radnoj dretvi pa ostale do njih dolaze samo kradom
+	const unsigned int count = 2000;
+	std::vector<int> executedBy(count, -2);
+	JobCounter spawned;
+	JobCounter root;
+	jobs.Run([&]()
+	{
+		for (unsigned int i = 0; i < count; i++)
+		{
+			jobs.Run([&executedBy, &jobs, i]()
+			{
+				volatile std::uint32_t spin = 0;
+				for (int k = 0; k < 2000; k++)
+					spin += k;
+				executedBy[i] = jobs.GetThreadIndex();
+			}, &spawned);
+		}
+	}, &root);
+	jobs.Wait(root);
+	jobs.Wait(spawned);
+
+	std::vector<unsigned int> perThread(jobs.GetThreadCount(), 0);
+	for (int index : executedBy)
+	{
+		CHECK(index >= 0 && index < (int)jobs.GetThreadCount());
+		if (index >= 0 && index < (int)jobs.GetThreadCount())
+			perThread[index]++;
+	}
+	unsigned int threadsUsed = 0;
+	for (unsigned int executed : perThread)
+		threadsUsed += executed > 0 ? 1 : 0;
+	std::cout << "  stealing: " << count << " jobs ran on " << threadsUsed << " of " << jobs.GetThreadCount() << " threads" << std::endl;
+}
+
+static void TestMultipleSystems()
+{
+	JobSystem first(4);
+	CHECK(first.GetThreadIndex() == 0);
+	{
+		//drugi sustav na istoj dretvi ne smije preuzeti identitet prvog
+		JobSystem second(3);
+		CHECK(first.GetThreadIndex() == 0);
+		CHECK(second.GetThreadIndex() == 0);
+
+		//radna dretva prvog sustava je strana dretva za drugi i ceka njegove poslove kradom
+		std::vector<int> indices(16, -2);
+		std::vector<std::uint32_t> values(256, 0);
+		JobCounter counter;
+		first.Run([&]()
+		{
+			indices[0] = first.GetThreadIndex();
+			indices[1] = second.GetThreadIndex();
+			second.ParallelFor((std::uint32_t)values.size(), 16, [&values](std::uint32_t begin, std::uint32_t end)
+			{
+				for (std::uint32_t i = begin; i < end; i++)
+					values[i] = i;
+			});
+		}, &counter);
+		first.Wait(counter);
+
+		CHECK(indices[0] >= 0 && indices[0] < 4);
+		CHECK(indices[1] == -1 || indices[0] == 0);
+		for (std::uint32_t i = 0; i < values.size(); i++)
+			CHECK(values[i] == i);
+	}
+	CHECK(first.GetThreadIndex() == 0);
+
+	//dretva koja nije ni u jednom sustavu predaje posao i ceka ga
+	std::uint32_t result = 0;
+	std::thread foreign([&]()
+	{
+		CHECK(first.GetThreadIndex() == -1);
+		JobCounter counter;
+		first.Run([&result]() { result = 42; }, &counter);
+		first.Wait(counter);
+	});
+	foreign.join();
+	CHECK(result == 42);
+}
+
+int main()
+{
+	for (unsigned int threads : { 1u, 2u, 4u, 8u })
+	{
+		std::cout << threads << " threads" << std::endl;
+		JobSystem jobs(threads);
+		TestRunWait(jobs);
+		TestDependencies(jobs);
+		TestParallelFor(jobs);
+		TestStealing(jobs);
+	}
+	TestMultipleSystems();
+
+	if (s_Failures > 0)
+	{
+		std::cerr << s_Failures << " CHECKS FAILED" << std::endl;
+		return 1;
+	}
+	std::cout << "all JobSystem tests passed" << std::endl;
+	return 0;
+}
@@ -0,0 +1,97 @@
+#include "AssetCooker.h"
+#include "JobSystem.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+//assetcook [izvori] [izlaz] [--format rgba8|bc1|bc3|bc7] [--weld-angle stupnjevi] [--cache-size N] [--force] [--quiet]
+//kuha res/ u cooked/ i pri ponovnom pokretanju kuha samo ono sto se promijenilo; aplikacija ga koristi s --cooked [izlaz]
+int main(int argc, char** argv)
+{
+    std::string root = "res";
+    std::string outputDir = "cooked";
+    AssetCookSettings settings;
+    bool quiet = false;
+    int positional = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        if (argument == "--format" && i + 1 < argc)
+        {
+            if (!TextureCooker::ParseFormat(argv[++i], settings.textureFormat))
+            {
+                std::cerr << "UNKNOWN TEXTURE FORMAT: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (argument == "--weld-angle" && i + 1 < argc)
+        {
+            char* end = nullptr;
+            float angle = std::strtof(argv[++i], &end);
+            if (end == argv[i] || *end != '\0' || !(angle >= 0.0f && angle <= 180.0f))
+            {
+                std::cerr << "INVALID WELD ANGLE (0 - 180): " << argv[i] << std::endl;
+                return 1;
+            }
+            settings.mesh.normalWeldAngle = angle;
+        }
+        else if (argument == "--cache-size" && i + 1 < argc)
+        {
+            //manji cache nema smisla za trokute, a optimizator prati najvise 64 vrha
+            char* end = nullptr;
+            long size = std::strtol(argv[++i], &end, 10);
+            if (end == argv[i] || *end != '\0' || size < 4 || size > 64)
+            {
+                std::cerr << "INVALID CACHE SIZE (4 - 64): " << argv[i] << std::endl;
+                return 1;
+            }
+            settings.mesh.cacheSize = (unsigned int)size;
+        }
+        else if (argument == "--force")
+        {
+            settings.force = true;
+        }
+        else if (argument == "--quiet")
+        {
+            quiet = true;
+        }
+        else if (argument.compare(0, 2, "--") != 0 && positional < 2)
+        {
+            (positional++ == 0 ? root : outputDir) = argument;
+        }
+        else
+        {
+            std::cerr << "UNKNOWN ARGUMENT: " << argument << std::endl;
+            return 1;
+        }
+    }
+
+    JobSystem jobs;
+    AssetCooker cooker(&jobs);
+    bool cooked = cooker.Cook(root, outputDir, settings);
+
+    if (!quiet)
+    {
+        for (const AssetCookRecord& record : cooker.GetRecords())
+        {
+            const char* state = record.failed ? "FAILED" : (record.cached ? "cached" : "cooked");
+            std::cout << state << "  " << AssetCooker::GetKindName(record.kind) << "  " << record.source << " -> " << record.output
+                << "  " << record.inputBytes / 1024 << " KB -> " << record.outputBytes / 1024 << " KB";
+            if (!record.cached && !record.failed)
+                std::cout << " in " << record.cookMs << " ms";
+            if (!record.cached && !record.failed && record.kind == AssetCookKind::Mesh)
+                std::cout << "  (" << record.mesh.inputVertices << " -> " << record.mesh.vertices << " vertices, ACMR "
+                    << record.mesh.acmrBefore << " -> " << record.mesh.acmrAfter << ", max position error " << record.mesh.maxPositionError << ")";
+            std::cout << std::endl;
+        }
+    }
+
+    const AssetCookStats& stats = cooker.GetStats();
+    std::cout << root << " -> " << outputDir << ": " << stats.assets << " assets, " << stats.cooked << " cooked, "
+        << stats.cacheHits << " cache hits, " << stats.failed << " failed, " << stats.inputBytes / 1024 << " KB -> "
+        << stats.outputBytes / 1024 << " KB in " << stats.totalMs << " ms (hash " << stats.hashMs << " ms, cook "
+        << stats.cookMs << " ms over " << stats.threads << " threads, " << TextureCooker::GetFormatName(settings.textureFormat) << ")" << std::endl;
+    return cooked ? 0 : 1;
+}